@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+
+"""
+Throughput benchmark for the microdds_client.
+
+Acts as a minimal stand-in for the Micro XRCE-DDS agent over UDP: it answers
+the pings, session and entity creation requests of the client with success,
+acknowledges the reliable streams, and counts the samples (WRITE_DATA
+submessages) and packets the client sends on its best-effort streams.
+Nothing is forwarded to DDS, so the result is the raw client throughput
+without the agent and ROS 2 being in the way.
+
+Once a second it prints the sample, packet and byte rates, the average number
+of samples per packet and the packets lost on the best-effort streams. At
+the end it prints a per topic summary.
+
+Examples (SITL):
+    Tools/microdds_agent_bench.py -p 15555 -d 30
+    pxh> microdds_client start -t udp -h 127.0.0.1 -p 15555 [-f 2000]
+"""
+
+import argparse
+import re
+import socket
+import struct
+import time
+
+
+# submessage ids
+CREATE_CLIENT = 0
+CREATE = 1
+GET_INFO = 2
+DELETE = 3
+STATUS_AGENT = 4
+STATUS = 5
+INFO = 6
+WRITE_DATA = 7
+ACKNACK = 10
+HEARTBEAT = 11
+
+FLAG_LITTLE_ENDIAN = 0x01
+SESSION_ID_WITHOUT_CLIENT_KEY = 0x80
+OBJK_DATAWRITER = 0x05
+OBJK_AGENT = 0x0D
+STATUS_OK = 0x00
+
+
+def message_header(session_id, client_key):
+    """Header of a message to the client on the builtin (none) stream"""
+    header = struct.pack('<BBH', session_id, 0, 0)
+    if session_id < SESSION_ID_WITHOUT_CLIENT_KEY:
+        header += client_key
+    return header
+
+
+def submessage(submessage_id, payload):
+    """Serialized submessage, padded to the 4 byte alignment of the next one"""
+    data = struct.pack('<BBH', submessage_id, FLAG_LITTLE_ENDIAN, len(payload)) + payload
+    return data + b'\0' * (-len(data) % 4)
+
+
+def parse_message(data):
+    """Split a message into header fields and a list of (id, payload) submessages"""
+    session_id, stream_id, sequence = struct.unpack_from('<BBH', data, 0)
+    offset = 4
+    client_key = b''
+
+    if session_id < SESSION_ID_WITHOUT_CLIENT_KEY:
+        client_key = data[4:8]
+        offset = 8
+
+    submessages = []
+
+    while offset + 4 <= len(data):
+        submessage_id, _, length = struct.unpack_from('<BBH', data, offset)
+        submessages.append((submessage_id, data[offset + 4:offset + 4 + length]))
+        offset += 4 + length
+        offset += -offset % 4
+
+    return session_id, stream_id, sequence, client_key, submessages
+
+
+class Topic:
+    def __init__(self, name):
+        self.name = name
+        self.samples = 0
+        self.bytes = 0
+
+
+class Agent:
+    def __init__(self, sock):
+        self._sock = sock
+        self.topics = {}
+        self.samples = 0
+        self.packets = 0
+        self.payload_bytes = 0
+        self.wire_bytes = 0
+        self.lost = 0
+        self._last_sequence = {}
+
+    def handle(self, data, address):
+        session_id, stream_id, sequence, client_key, submessages = parse_message(data)
+        replies = b''
+        samples = 0
+
+        for submessage_id, payload in submessages:
+            if submessage_id == GET_INFO:
+                # INFO: reply, optional activity (agent, available, no locators), no config
+                replies += submessage(INFO, payload[0:4] + bytes([STATUS_OK, 0, 1, OBJK_AGENT])
+                                      + struct.pack('<hHIB', 1, 0, 0, 0))
+
+            elif submessage_id == CREATE_CLIENT:
+                # the session of the client is set up by this request
+                self._last_sequence = {}
+                session_id = payload[16]
+                client_key = payload[12:16]
+                replies += submessage(STATUS_AGENT, bytes([STATUS_OK, 0]) + b'XRCE' + payload[8:10]
+                                      + b'\x0f\x0f\x00')
+
+            elif submessage_id in (CREATE, DELETE):
+                object_id = payload[2:4]
+
+                if object_id[1] & 0x0f == OBJK_DATAWRITER:
+                    match = re.search(rb'<name>rt/fmu/out/(\w+)</name>', payload)
+
+                    if match:
+                        self.topics[object_id] = Topic(match.group(1).decode())
+
+                replies += submessage(STATUS, payload[0:4] + bytes([STATUS_OK, 0]))
+
+            elif submessage_id == HEARTBEAT:
+                _, last_unacked, heartbeat_stream = struct.unpack_from('<HHB', payload, 0)
+                replies += submessage(ACKNACK, struct.pack('<HBBB', (last_unacked + 1) & 0xffff, 0, 0,
+                                                           heartbeat_stream))
+
+            elif submessage_id == WRITE_DATA:
+                topic = self.topics.setdefault(payload[2:4], Topic('0x' + payload[2:4].hex()))
+                topic.samples += 1
+                topic.bytes += len(payload) - 4
+                self.payload_bytes += len(payload) - 4
+                samples += 1
+
+        if stream_id >= 0x80:
+            # reliable stream: acknowledge everything up to this message
+            replies += submessage(ACKNACK, struct.pack('<HBBB', (sequence + 1) & 0xffff, 0, 0, stream_id))
+
+        elif stream_id != 0 and samples > 0:
+            last_sequence = self._last_sequence.get(stream_id)
+
+            if last_sequence is not None:
+                self.lost += max((sequence - last_sequence - 1) & 0xffff, 0)
+
+            self._last_sequence[stream_id] = sequence
+            self.samples += samples
+            self.packets += 1
+            self.wire_bytes += len(data)
+
+        if replies:
+            self._sock.sendto(message_header(session_id, client_key) + replies, address)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Micro XRCE-DDS agent stand-in measuring the client throughput')
+    parser.add_argument('-p', '--port', type=int, default=15555, help='UDP port to listen on (default: 15555)')
+    parser.add_argument('-d', '--duration', type=float, default=0,
+                        help='seconds to measure after the first sample, 0 to run until interrupted (default: 0)')
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(('127.0.0.1', args.port))
+    sock.settimeout(0.1)
+    agent = Agent(sock)
+
+    print('listening on 127.0.0.1:{:}'.format(args.port))
+
+    start = None
+    last_report = None
+    last = (0, 0, 0, 0)
+
+    try:
+        while True:
+            try:
+                data, address = sock.recvfrom(65536)
+                agent.handle(data, address)
+            except socket.timeout:
+                pass
+
+            now = time.monotonic()
+
+            if start is None:
+                if agent.samples > 0:
+                    start = last_report = now
+                    last = (agent.samples, agent.packets, agent.wire_bytes, agent.lost)
+                continue
+
+            if now - last_report >= 1.0:
+                dt = now - last_report
+                samples = agent.samples - last[0]
+                packets = agent.packets - last[1]
+                print('{:8.0f} samples/s {:7.0f} packets/s {:8.1f} kB/s {:5.2f} samples/packet {:4d} lost'.format(
+                    samples / dt, packets / dt, (agent.wire_bytes - last[2]) / dt / 1e3,
+                    samples / max(packets, 1), agent.lost - last[3]))
+                last_report = now
+                last = (agent.samples, agent.packets, agent.wire_bytes, agent.lost)
+
+            if args.duration > 0 and now - start >= args.duration:
+                break
+
+    except KeyboardInterrupt:
+        pass
+
+    if start is None:
+        print('no samples received')
+        return
+
+    elapsed = time.monotonic() - start
+    print('')
+    print('{:<32} {:>10} {:>12}'.format('topic', 'samples/s', 'payload B/s'))
+
+    for topic in sorted(agent.topics.values(), key=lambda t: t.name):
+        print('{:<32} {:10.1f} {:12.0f}'.format(topic.name, topic.samples / elapsed, topic.bytes / elapsed))
+
+    print('')
+    print('total: {:.0f} samples/s in {:.0f} packets/s ({:.2f} samples/packet), payload {:.1f} kB/s, '
+          'on the wire {:.1f} kB/s, {:d} packets lost'.format(
+              agent.samples / elapsed, agent.packets / elapsed, agent.samples / max(agent.packets, 1),
+              agent.payload_bytes / elapsed / 1e3, agent.wire_bytes / elapsed / 1e3, agent.lost))
+
+
+if __name__ == '__main__':
+    main()
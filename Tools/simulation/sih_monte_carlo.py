@@ -0,0 +1,482 @@
+#!/usr/bin/env python3
+
+"""
+Monte-Carlo flight tests with SIH in SITL.
+
+Runs many randomized flights of lockstepped PX4 SITL instances simulated by SIH, in
+parallel, and summarizes the ULogs of all of them. Every run:
+  - gets its own working directory, so parameters and logs are not shared,
+  - draws a set of parameter perturbations (vehicle model, sensor offsets, gains, ...)
+    that are applied through a run specific px4-rc.params found first in the PATH,
+  - takes off, holds the position for a while and lands, driven through the px4-*
+    client commands of the instance (no MAVLink connection required),
+  - is evaluated from its ULog: position tracking error, estimator innovation test
+    ratios and CPU load.
+
+The results of every run are written to runs.csv and the statistics over all runs to
+summary.json in the output directory. With --limit the script fails if a statistic is
+above a limit, e.g. to catch control or performance regressions in CI.
+
+Examples (after 'make px4_sitl_default'):
+    Tools/simulation/sih_monte_carlo.py -n 200 -j 32 --speed-factor 10
+    Tools/simulation/sih_monte_carlo.py -n 50 --perturb SIH_MASS=uniform:0.8:1.4 --perturb MC_ROLLRATE_P=normal:0.15:0.02
+    Tools/simulation/sih_monte_carlo.py -n 100 --limit tracking_rms_xy.p95=0.5 --limit cpu_load_max.max=0.9
+
+With --server, all the instances are simulated by a single px4_sih_server process
+(multi-vehicle server over shared memory, Linux only) instead of one SIH per instance.
+
+The logs are parsed with pyulog (pip3 install --user pyulog).
+"""
+
+import argparse
+import csv
+import glob
+import json
+import os
+import random
+import shutil
+import subprocess
+import sys
+import threading
+import time
+
+from concurrent.futures import ThreadPoolExecutor
+
+try:
+    import numpy as np
+    from pyulog import ULog
+except ImportError as e:
+    print("Failed to import pyulog: " + str(e))
+    print("")
+    print("You may need to install it with:")
+    print("    pip3 install --user pyulog")
+    print("")
+    sys.exit(1)
+
+
+# default perturbations of the SIH quadx airframe, PARAM=distribution
+DEFAULT_PERTURBATIONS = [
+    'SIH_MASS=uniform:0.9:1.2',
+    'SIH_IXX=uniform:0.02:0.03',
+    'SIH_IYY=uniform:0.02:0.03',
+    'SIH_T_MAX=uniform:4.5:5.5',
+    'SIH_T_TAU=uniform:0.03:0.08',
+    'SIH_KDV=uniform:0.5:1.5',
+    'SIH_BARO_OFFSET=normal:0:2',
+    'SIH_MAG_OFFSET_X=normal:0:0.02',
+    'SIH_MAG_OFFSET_Y=normal:0:0.02',
+    'SIH_MAG_OFFSET_Z=normal:0:0.02',
+]
+
+VEHICLE_STATUS_ARMED = 2
+
+
+class Perturbation:
+    """ Random distribution of a parameter: uniform:<min>:<max>, normal:<mean>:<std> or choice:<v1>,<v2>,... """
+
+    def __init__(self, spec):
+        name, _, distribution = spec.partition('=')
+        kind, _, args = distribution.partition(':')
+        self.name = name.strip()
+        self.kind = kind.strip()
+
+        if not self.name or self.kind not in ('uniform', 'normal', 'choice'):
+            raise ValueError("invalid perturbation '{}'".format(spec))
+
+        if self.kind == 'choice':
+            self.values = [v for v in args.split(',') if v]
+        else:
+            self.values = [float(v) for v in args.split(':')]
+
+            if len(self.values) != 2:
+                raise ValueError("invalid perturbation '{}'".format(spec))
+
+    def draw(self, rng):
+        if self.kind == 'uniform':
+            return rng.uniform(self.values[0], self.values[1])
+
+        if self.kind == 'normal':
+            return rng.gauss(self.values[0], self.values[1])
+
+        return rng.choice(self.values)
+
+
+class Instance:
+    """ PX4 SITL instance of a single run, controlled with the px4-* client commands """
+
+    def __init__(self, args, run_dir, index, env):
+        self.args = args
+        self.run_dir = run_dir
+        self.index = index
+        self.env = env
+        self.process = None
+        self.log_file = None
+
+    def start(self):
+        self.log_file = open(os.path.join(self.run_dir, 'px4.log'), 'w')
+        self.process = subprocess.Popen(
+            [os.path.join(self.args.build_dir, 'bin', 'px4'), '-i', str(self.index), '-d',
+             os.path.join(self.args.build_dir, 'etc')],
+            cwd=self.run_dir, env=self.env, stdout=self.log_file, stderr=subprocess.STDOUT)
+
+    def stop(self):
+        if self.process is None:
+            return
+
+        if self.process.poll() is None:
+            self.command('shutdown')
+
+            try:
+                self.process.wait(timeout=10)
+            except subprocess.TimeoutExpired:
+                self.process.kill()
+                self.process.wait()
+
+        self.log_file.close()
+        self.process = None
+
+    def running(self):
+        return self.process is not None and self.process.poll() is None
+
+    def command(self, *cmd):
+        """ Run a command in the instance, returns its output or None on error """
+        try:
+            result = subprocess.run(
+                [os.path.join(self.args.build_dir, 'bin', 'px4-' + cmd[0]), '--instance', str(self.index)] + list(cmd[1:]),
+                env=self.env, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True, timeout=10)
+        except subprocess.TimeoutExpired:
+            return None
+
+        return result.stdout if result.returncode == 0 else None
+
+    def listen(self, topic):
+        """ Latest sample of a topic as a dict of its fields (as strings), None if not published yet """
+        output = self.command('listener', topic, '-n', '1')
+
+        if output is None or 'never published' in output:
+            return None
+
+        fields = {}
+
+        for line in output.splitlines():
+            key, sep, value = line.strip().partition(':')
+
+            if sep:
+                fields[key.strip()] = value.strip().split(' ')[0]
+
+        return fields if 'timestamp' in fields else None
+
+    def sim_time(self):
+        """ Simulation time in s, from the timestamp of vehicle_status """
+        status = self.listen('vehicle_status')
+        return int(status['timestamp']) * 1e-6 if status else None
+
+    def wait_for(self, condition, sim_timeout):
+        """ Poll condition() until it is true or sim_timeout simulated seconds passed (wall clock if not booted) """
+        start_sim = self.sim_time()
+        start_wall = time.monotonic()
+
+        while self.running():
+            if condition():
+                return True
+
+            now_sim = self.sim_time()
+
+            if start_sim is None:
+                start_sim = now_sim
+
+            if start_sim is not None and now_sim is not None:
+                if now_sim - start_sim > sim_timeout:
+                    return False
+
+            elif time.monotonic() - start_wall > sim_timeout:
+                return False
+
+            time.sleep(0.1)
+
+        return False
+
+
+def fly(instance, args):
+    """ Take off, hold the position and land, returns an error string or None """
+
+    if not instance.wait_for(lambda: instance.listen('vehicle_status') is not None, args.boot_timeout):
+        return 'boot timeout'
+
+    def armed():
+        status = instance.listen('vehicle_status')
+        return status is not None and int(status.get('arming_state', 0)) == VEHICLE_STATUS_ARMED
+
+    # takeoff is rejected until the preflight checks pass (estimator converged, GPS fix), retry
+    def takeoff():
+        if armed():
+            return True
+
+        instance.command('commander', 'takeoff')
+        return False
+
+    if not instance.wait_for(takeoff, args.arm_timeout):
+        return 'arming timeout'
+
+    takeoff_time = instance.sim_time()
+
+    def held():
+        now = instance.sim_time()
+        return takeoff_time is not None and now is not None and now - takeoff_time > args.hold_time
+
+    if not instance.wait_for(held, args.hold_time + 30):
+        return 'hold timeout'
+
+    instance.command('commander', 'land')
+
+    # auto disarm after landing
+    if not instance.wait_for(lambda: not armed(), args.land_timeout):
+        return 'landing timeout'
+
+    return None
+
+
+def finite(values):
+    values = np.asarray(values, dtype=float)
+    return values[np.isfinite(values)]
+
+
+def analyse(ulog_file):
+    """ Summary metrics of a flight log """
+    ulog = ULog(ulog_file, ['vehicle_local_position', 'vehicle_local_position_setpoint', 'vehicle_land_detected',
+                            'estimator_status', 'cpuload'])
+    data = {(d.name, d.multi_id): d.data for d in ulog.data_list}
+    metrics = {}
+
+    # position tracking error while airborne
+    lpos = data.get(('vehicle_local_position', 0))
+    lpos_sp = data.get(('vehicle_local_position_setpoint', 0))
+    land = data.get(('vehicle_land_detected', 0))
+
+    if lpos is not None and lpos_sp is not None and land is not None:
+        t = lpos['timestamp']
+        airborne = np.interp(t, land['timestamp'], 1 - land['landed'].astype(float)) > 0.5
+        err = {}
+
+        for axis in 'xyz':
+            sp = np.interp(t, lpos_sp['timestamp'], lpos_sp[axis])
+            sp_valid = np.interp(t, lpos_sp['timestamp'], np.isfinite(lpos_sp[axis]).astype(float)) > 0.5
+            airborne &= sp_valid
+            err[axis] = lpos[axis] - sp
+
+        if np.any(airborne):
+            err_xy = np.hypot(err['x'][airborne], err['y'][airborne])
+            err_z = np.abs(err['z'][airborne])
+            metrics['tracking_rms_xy'] = float(np.sqrt(np.mean(err_xy ** 2)))
+            metrics['tracking_max_xy'] = float(np.max(err_xy))
+            metrics['tracking_rms_z'] = float(np.sqrt(np.mean(err_z ** 2)))
+            metrics['tracking_max_z'] = float(np.max(err_z))
+            metrics['flight_time'] = float(np.count_nonzero(airborne) * np.median(np.diff(t)) * 1e-6)
+
+    # estimator innovation test ratios (> 1: innovation rejected)
+    status = data.get(('estimator_status', 0))
+
+    if status is not None:
+        for name in ('pos', 'vel', 'hgt', 'mag'):
+            ratios = finite(status[name + '_test_ratio'])
+
+            if len(ratios) > 0:
+                metrics[name + '_test_ratio_mean'] = float(np.mean(ratios))
+                metrics[name + '_test_ratio_max'] = float(np.max(ratios))
+
+    cpuload = data.get(('cpuload', 0))
+
+    if cpuload is not None and len(cpuload['load']) > 0:
+        metrics['cpu_load_mean'] = float(np.mean(cpuload['load']))
+        metrics['cpu_load_max'] = float(np.max(cpuload['load']))
+
+    return metrics
+
+
+def run(args, run_index, slots, print_lock):
+    """ Run a single randomized flight, returns its result dict """
+    rng = random.Random(args.seed * 1000003 + run_index)
+    params = {p.name: p.draw(rng) for p in args.perturbations}
+
+    run_dir = os.path.join(args.output, 'run_{:04d}'.format(run_index))
+    shutil.rmtree(run_dir, ignore_errors=True)
+    os.makedirs(run_dir)
+
+    # sourced by rcS (PATH lookup) before the simulator is started
+    with open(os.path.join(run_dir, 'px4-rc.params'), 'w') as f:
+        f.write('#!/bin/sh\n')
+
+        for name, value in sorted(params.items()):
+            f.write('param set {} {}\n'.format(name, value))
+
+    env = os.environ.copy()
+    env['PATH'] = run_dir + os.pathsep + env.get('PATH', '')
+    env['PX4_SIM_MODEL'] = args.model
+    env['PX4_SIMULATOR'] = 'sihshm' if args.server else 'sihsim'
+    env['PX4_SIM_SPEED_FACTOR'] = str(args.speed_factor)
+
+    index = slots.pop()
+    instance = Instance(args, run_dir, index, env)
+    result = {'run': run_index, 'instance': index}
+    result.update(params)
+    wall_start = time.monotonic()
+
+    try:
+        instance.start()
+        error = fly(instance, args)
+    finally:
+        instance.stop()
+        slots.append(index)
+
+    result['wall_time'] = time.monotonic() - wall_start
+    result['error'] = error or ''
+
+    ulog_files = sorted(glob.glob(os.path.join(run_dir, 'log', '**', '*.ulg'), recursive=True))
+
+    if ulog_files:
+        result['ulog'] = os.path.relpath(ulog_files[-1], args.output)
+
+        try:
+            result.update(analyse(ulog_files[-1]))
+        except Exception as e:  # pylint: disable=broad-except
+            result['error'] = result['error'] or 'log analysis failed: {}'.format(e)
+
+    elif not error:
+        result['error'] = 'no log'
+
+    with print_lock:
+        print('run {:4d}: {} ({:.1f} s)'.format(run_index, result['error'] or 'ok', result['wall_time']))
+
+    return result
+
+
+def summarize(results, metric_names):
+    """ Statistics of every metric over the successful runs """
+    summary = {'runs': len(results), 'failed': sum(1 for r in results if r['error'])}
+
+    for name in metric_names:
+        values = finite([r[name] for r in results if not r['error'] and name in r])
+
+        if len(values) == 0:
+            continue
+
+        summary[name] = {
+            'mean': float(np.mean(values)),
+            'std': float(np.std(values)),
+            'p95': float(np.percentile(values, 95)),
+            'max': float(np.max(values)),
+        }
+
+    return summary
+
+
+def check_limits(summary, limits):
+    """ Returns the violated limits of the form <metric>.<statistic>=<max> """
+    violations = []
+
+    for limit in limits:
+        key, _, value = limit.partition('=')
+        metric, _, statistic = key.partition('.')
+        actual = summary.get(metric, {}).get(statistic or 'max')
+
+        if actual is None or actual > float(value):
+            violations.append('{}: {} > {}'.format(key, actual, value))
+
+    return violations
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Monte-Carlo flight tests with SIH in SITL')
+    parser.add_argument('-n', '--runs', type=int, default=20, help='number of flights')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(), help='number of parallel instances')
+    parser.add_argument('-o', '--output', default='build/monte_carlo', help='output directory')
+    parser.add_argument('--build-dir', default='build/px4_sitl_default', help='PX4 SITL build directory')
+    parser.add_argument('--model', default='quadx', help='SIH airframe: quadx, airplane or xvert')
+    parser.add_argument('--speed-factor', type=float, default=10., help='lockstep speed factor of each instance')
+    parser.add_argument('--seed', type=int, default=0, help='seed of the perturbations')
+    parser.add_argument('--perturb', action='append', default=[], metavar='PARAM=DIST',
+                        help='parameter perturbation: uniform:<min>:<max>, normal:<mean>:<std> or choice:<v1>,<v2>. '
+                        'Replaces the default set of perturbations')
+    parser.add_argument('--no-default-perturbations', action='store_true', help='only apply the --perturb ones')
+    parser.add_argument('--hold-time', type=float, default=20., help='hover time after takeoff [simulated s]')
+    parser.add_argument('--boot-timeout', type=float, default=30., help='[s]')
+    parser.add_argument('--arm-timeout', type=float, default=60., help='[simulated s]')
+    parser.add_argument('--land-timeout', type=float, default=60., help='[simulated s]')
+    parser.add_argument('--limit', action='append', default=[], metavar='METRIC.STAT=MAX',
+                        help='fail if a statistic over all runs exceeds a limit, e.g. tracking_rms_xy.p95=0.5')
+    parser.add_argument('--server', action='store_true', help='simulate all instances with px4_sih_server')
+    args = parser.parse_args()
+
+    if not os.path.isfile(os.path.join(args.build_dir, 'bin', 'px4')):
+        print("px4 not found in {}, build it with 'make px4_sitl_default'".format(args.build_dir))
+        return 1
+
+    args.build_dir = os.path.abspath(args.build_dir)
+    args.output = os.path.abspath(args.output)
+    args.jobs = max(1, min(args.jobs, args.runs))
+
+    specs = args.perturb if args.perturb or args.no_default_perturbations else DEFAULT_PERTURBATIONS
+    args.perturbations = [Perturbation(spec) for spec in specs]
+
+    os.makedirs(args.output, exist_ok=True)
+
+    server = None
+
+    if args.server:
+        server = subprocess.Popen([os.path.join(args.build_dir, 'bin', 'px4_sih_server'), '-n', str(args.jobs),
+                                   '-f', str(args.speed_factor)],
+                                  stdout=subprocess.DEVNULL, stderr=subprocess.STDOUT)
+
+    print('{} runs, {} in parallel, speed factor {}, perturbing {}'.format(
+        args.runs, args.jobs, args.speed_factor, ', '.join(p.name for p in args.perturbations) or 'nothing'))
+
+    # instance indices in use define the MAVLink ports and lock files of px4, reuse them
+    slots = list(range(args.jobs))
+    lock = threading.Lock()
+    start = time.monotonic()
+
+    try:
+        with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+            results = list(executor.map(lambda i: run(args, i, slots, lock), range(args.runs)))
+
+    finally:
+        if server is not None:
+            server.terminate()
+            server.wait()
+
+    param_names = [p.name for p in args.perturbations]
+    metric_names = sorted({key for r in results for key in r} -
+                          set(param_names) - {'run', 'instance', 'error', 'ulog', 'wall_time'})
+
+    with open(os.path.join(args.output, 'runs.csv'), 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=['run', 'instance', 'error', 'wall_time', 'ulog'] + param_names + metric_names)
+        writer.writeheader()
+        writer.writerows(results)
+
+    summary = summarize(results, metric_names)
+    summary['wall_time'] = time.monotonic() - start
+
+    with open(os.path.join(args.output, 'summary.json'), 'w') as f:
+        json.dump(summary, f, indent=2)
+
+    print('')
+    print('{} runs, {} failed, {:.0f} s'.format(summary['runs'], summary['failed'], summary['wall_time']))
+    print('{:28s} {:>10s} {:>10s} {:>10s} {:>10s}'.format('metric', 'mean', 'std', 'p95', 'max'))
+
+    for name in metric_names:
+        if name in summary:
+            s = summary[name]
+            print('{:28s} {:10.4f} {:10.4f} {:10.4f} {:10.4f}'.format(name, s['mean'], s['std'], s['p95'], s['max']))
+
+    print('results in {}'.format(args.output))
+
+    violations = check_limits(summary, args.limit)
+
+    for violation in violations:
+        print('limit exceeded: ' + violation)
+
+    return 1 if summary['failed'] > 0 or violations else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
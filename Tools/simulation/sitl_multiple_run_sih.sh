@@ -0,0 +1,48 @@
+#!/bin/bash
+# run multiple instances of the 'px4' binary, all simulated by a single
+# multi-vehicle SIH server process (px4_sih_server) over shared memory.
+# It assumes px4 is already built, with 'make px4_sitl_default'
+
+# Usage: sitl_multiple_run_sih.sh [number of vehicles] [model]
+# The model is one of the SIH airframes: quadx (default), airplane, xvert.
+# Set PX4_SIM_SPEED_FACTOR to run faster than realtime.
+
+sitl_num=2
+[ -n "$1" ] && sitl_num="$1"
+
+sim_model=quadx
+[ -n "$2" ] && sim_model="$2"
+
+SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+src_path="$SCRIPT_DIR/../.."
+
+build_path=${src_path}/build/px4_sitl_default
+
+echo "killing running instances"
+pkill -x px4 || true
+pkill -x px4_sih_server || true
+
+sleep 1
+
+export PX4_SIM_MODEL=${sim_model}
+export PX4_SIMULATOR=sihshm
+
+echo "starting the simulation server for $sitl_num vehicles"
+$build_path/bin/px4_sih_server -n $sitl_num &
+server_pid=$!
+
+n=0
+while [ $n -lt $sitl_num ]; do
+	working_dir="$build_path/instance_$n"
+	[ ! -d "$working_dir" ] && mkdir -p "$working_dir"
+
+	pushd "$working_dir" &>/dev/null
+	echo "starting instance $n in $(pwd)"
+	$build_path/bin/px4 -i $n -d "$build_path/etc" >out.log 2>err.log &
+	popd &>/dev/null
+
+	n=$(($n + 1))
+done
+
+trap "pkill -x px4; kill $server_pid" SIGINT SIGTERM
+wait $server_pid
@@ -28,7 +28,10 @@ receive_base_types = [s.short_name for idx, s in enumerate(spec) if scope[idx] =
 #include <uxr/client/client.h>
 #include <ucdr/microcdr.h>
 
-#include <uORB/Subscription.hpp>
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/sem.h>
+#include <uORB/SubscriptionCallback.hpp>
 #include <uORB/Publication.hpp>
 @[for idx, topic in enumerate(send_topics)]@
 #include <uORB/ucdr/@(send_base_types[idx]).h>
@@ -37,21 +40,92 @@ receive_base_types = [s.short_name for idx, s in enumerate(spec) if scope[idx] =
 #include <uORB/ucdr/@(receive_base_types[idx]).h>
 @[end for]@
 
+// Subscription waking up the send loop on new publications
+class SendSubscription : public uORB::SubscriptionCallback
+{
+public:
+	SendSubscription(const orb_metadata *meta, px4_sem_t &sem, px4::atomic_bool &pending) :
+		SubscriptionCallback(meta),
+		_sem(sem),
+		_pending(pending)
+	{
+	}
+
+	void call() override
+	{
+		// post only once until the send loop runs again, not for every publication
+		bool expected = false;
+
+		if (_pending.compare_exchange(&expected, true)) {
+			px4_sem_post(&_sem);
+		}
+	}
+
+private:
+	px4_sem_t &_sem;
+	px4::atomic_bool &_pending;
+};
+
 // Subscribers for messages to send
 struct SendTopicsSubs {
+	px4_sem_t sem;
+	px4::atomic_bool pending{false};
+
 @[    for idx, topic in enumerate(send_topics)]@
-	uORB::Subscription @(topic)_sub{ORB_ID(@(topic))};
+	SendSubscription @(topic)_sub{ORB_ID(@(topic)), sem, pending};
 	uxrObjectId @(topic)_data_writer;
 @[    end for]@
 
 	uxrSession* session;
 
+	hrt_abstime unsent_since{0}; ///< time of the oldest sample in the output stream, 0 if empty
+
 	uint32_t num_payload_sent{};
+	uint32_t num_samples_sent{};
+	uint32_t num_packets_sent{};
+
+	SendTopicsSubs();
+	~SendTopicsSubs();
 
 	bool init(uxrSession* session_, uxrStreamId stream_id, uxrObjectId participant_id);
-	void update(uxrStreamId stream_id);
+
+	/**
+	 * Wait for new samples on any of the topics
+	 * @@param timeout_us maximum time to wait
+	 */
+	void wait(uint32_t timeout_us);
+
+	/**
+	 * Serialize all new samples into the output stream. It is sent when it is full or the oldest
+	 * sample in it is older than flush_interval_us, so that several samples share one packet.
+	 * @@return time in us until the pending samples need to be sent, 0 if there are none
+	 */
+	uint32_t update(uxrStreamId stream_id, uint32_t flush_interval_us);
+
+	/**
+	 * Send out the pending samples
+	 */
+	void flush();
+
+private:
+	bool prepare(uxrStreamId stream_id, uxrObjectId data_writer, ucdrBuffer &ub, uint32_t topic_size);
 };
 
+SendTopicsSubs::SendTopicsSubs()
+{
+	px4_sem_init(&sem, 0, 0);
+	// sem use case is a signal
+	px4_sem_setprotocol(&sem, SEM_PRIO_NONE);
+}
+
+SendTopicsSubs::~SendTopicsSubs()
+{
+@[    for idx, topic in enumerate(send_topics)]@
+	@(topic)_sub.unregisterCallback();
+@[    end for]@
+	px4_sem_destroy(&sem);
+}
+
 bool SendTopicsSubs::init(uxrSession* session_, uxrStreamId stream_id, uxrObjectId participant_id)
 {
 	session = session_;
@@ -100,6 +174,8 @@ topic_pascal = topic.replace("_", " ").title().replace(" ", "")
 			PX4_ERR("create entities failed: %s, topic: %i publisher: %i datawriter: %i", "@(topic_pascal)", status[0], status[1], status[2]);
 			return false;
 		}
+
+		@(topic)_sub.registerCallback();
 	}
 
 @[    end for]@
@@ -107,24 +183,87 @@ topic_pascal = topic.replace("_", " ").title().replace(" ", "")
 	return true;
 }
 
-void SendTopicsSubs::update(uxrStreamId stream_id)
+void SendTopicsSubs::wait(uint32_t timeout_us)
+{
+	if (!pending.load()) {
+		struct timespec ts;
+#if defined(__PX4_NUTTX)
+		px4_clock_gettime(CLOCK_REALTIME, &ts);
+#else
+		px4_clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif // __PX4_NUTTX
+
+		const uint64_t nsecs = ts.tv_nsec + (uint64_t)timeout_us * 1000;
+		ts.tv_sec += nsecs / 1000000000;
+		ts.tv_nsec = nsecs % 1000000000;
+
+		px4_sem_timedwait(&sem, &ts);
+	}
+
+	pending.store(false);
+}
+
+uint32_t SendTopicsSubs::update(uxrStreamId stream_id, uint32_t flush_interval_us)
 {
 @[    for idx, topic in enumerate(send_topics)]@
 	{
 		@(send_base_types[idx])_s data;
 
-		if (@(topic)_sub.update(&data)) {
+		// all queued samples, serialized directly into the output stream
+		while (@(topic)_sub.update(&data)) {
 			ucdrBuffer ub{};
 			uint32_t topic_size = ucdr_topic_size_@(send_base_types[idx])();
-			uxr_prepare_output_stream(session, stream_id, @(topic)_data_writer, &ub, topic_size);
+
+			if (!prepare(stream_id, @(topic)_data_writer, ub, topic_size)) {
+				break;
+			}
+
 			ucdr_serialize_@(send_base_types[idx])(data, ub);
-			// TODO: fill up the MTU and then flush, which reduces the packet overhead
-			uxr_flash_output_streams(session);
 			num_payload_sent += topic_size;
+			num_samples_sent++;
 		}
 	}
 @[    end for]@
 
+	if (unsent_since != 0) {
+		const hrt_abstime elapsed = hrt_elapsed_time(&unsent_since);
+
+		if (elapsed >= flush_interval_us) {
+			flush();
+
+		} else {
+			return flush_interval_us - elapsed;
+		}
+	}
+
+	return 0;
+}
+
+void SendTopicsSubs::flush()
+{
+	if (unsent_since != 0) {
+		uxr_flash_output_streams(session);
+		unsent_since = 0;
+		num_packets_sent++;
+	}
+}
+
+bool SendTopicsSubs::prepare(uxrStreamId stream_id, uxrObjectId data_writer, ucdrBuffer &ub, uint32_t topic_size)
+{
+	if (uxr_prepare_output_stream(session, stream_id, data_writer, &ub, topic_size) == UXR_INVALID_REQUEST_ID) {
+		// the stream is full, send it out and start a new packet
+		flush();
+
+		if (uxr_prepare_output_stream(session, stream_id, data_writer, &ub, topic_size) == UXR_INVALID_REQUEST_ID) {
+			return false;
+		}
+	}
+
+	if (unsent_since == 0) {
+		unsent_since = hrt_absolute_time();
+	}
+
+	return true;
 }
 
 static void on_topic_update(uxrSession* session, uxrObjectId object_id,
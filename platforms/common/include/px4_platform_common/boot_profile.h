@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file boot_profile.h
+ *
+ * Boot profiler: records the wall clock time spent in the startup commands and in
+ * the module start (task_spawn) during boot. Enabled on POSIX by setting the
+ * environment variable PX4_BOOT_PROFILE to the path of the CSV file to write.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+__BEGIN_DECLS
+
+#if defined(__PX4_POSIX)
+
+/**
+ * @return true if the boot is profiled (PX4_BOOT_PROFILE is set)
+ */
+__EXPORT bool px4_boot_profile_enabled(void);
+
+/**
+ * Wall clock time in [us] since the process start, independent of the lockstep time.
+ */
+__EXPORT uint64_t px4_boot_profile_time(void);
+
+/**
+ * Record a profiled section.
+ * @param type section type, e.g. "cmd" or "task_spawn"
+ * @param name command line or module name
+ * @param start start time from px4_boot_profile_time()
+ */
+__EXPORT void px4_boot_profile_record(const char *type, const char *name, uint64_t start);
+
+/**
+ * Stop recording, write the profile to PX4_BOOT_PROFILE and print a summary.
+ */
+__EXPORT void px4_boot_profile_finish(void);
+
+#else
+
+static inline bool px4_boot_profile_enabled(void) { return false; }
+static inline uint64_t px4_boot_profile_time(void) { return 0; }
+static inline void px4_boot_profile_record(const char *type, const char *name, uint64_t start) {}
+static inline void px4_boot_profile_finish(void) {}
+
+#endif /* defined(__PX4_POSIX) */
+
+__END_DECLS
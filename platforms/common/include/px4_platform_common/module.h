@@ -42,6 +42,7 @@
 #include <stdbool.h>
 
 #include <px4_platform_common/atomic.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/time.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/tasks.h>
@@ -56,6 +57,8 @@
  *        There could be one mutex per module instantiation, but to reduce the memory footprint
  *        there is only a single global mutex. This sounds bad, but we actually don't expect
  *        contention here, as module startup is sequential.
+ *        On POSIX, where memory is not a concern, every module has its own mutex instead, so
+ *        that independent modules can be started in parallel.
  */
 extern pthread_mutex_t px4_modules_mutex;
 
@@ -206,7 +209,9 @@ public:
 			PX4_ERR("Task already running");
 
 		} else {
+			const uint64_t profile_start = px4_boot_profile_time();
 			ret = T::task_spawn(argc, argv);
+			px4_boot_profile_record("task_spawn", MODULE_NAME, profile_start);
 
 			if (ret < 0) {
 				PX4_ERR("Task start failed (%i)", ret);
@@ -405,7 +410,11 @@ private:
 	 */
 	static void lock_module()
 	{
+#if defined(__PX4_POSIX)
+		pthread_mutex_lock(&_module_mutex);
+#else
 		pthread_mutex_lock(&px4_modules_mutex);
+#endif
 	}
 
 	/**
@@ -413,9 +422,18 @@ private:
 	 */
 	static void unlock_module()
 	{
+#if defined(__PX4_POSIX)
+		pthread_mutex_unlock(&_module_mutex);
+#else
 		pthread_mutex_unlock(&px4_modules_mutex);
+#endif
 	}
 
+#if defined(__PX4_POSIX)
+	/** @var _module_mutex Protects against race conditions during startup & shutdown of this module. */
+	static pthread_mutex_t _module_mutex;
+#endif
+
 	/** @var _task_should_exit Boolean flag to indicate if the task should exit. */
 	px4::atomic_bool _task_should_exit{false};
 };
@@ -426,6 +444,11 @@ px4::atomic<T *> ModuleBase<T>::_object{nullptr};
 template<class T>
 int ModuleBase<T>::_task_id = -1;
 
+#if defined(__PX4_POSIX)
+template<class T>
+pthread_mutex_t ModuleBase<T>::_module_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 
 #endif /* __cplusplus */
 
@@ -0,0 +1,412 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uorb_shm_bench.cpp
+ * Benchmark of the uORB shared memory transport (uorb_shm_bench)
+ *
+ * - latency: a sample is published into PX4 and received back from PX4 on the same topic
+ *   (client -> inbound ring -> PX4 DeviceNode::write() -> outbound ring -> client), one at a
+ *   time or at a fixed rate. The first 8 bytes (the uORB timestamp field) carry the send time.
+ * - latency over UDP: the same round trip through a loopback UDP echo, one datagram per sample,
+ *   as a socket based bridge (e.g. microdds_client and its agent) needs at least twice.
+ * - rate: subscribes to a topic published by PX4 and reports the received rate and lost samples.
+ */
+
+#include "uorb_shm_client.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+static volatile sig_atomic_t should_exit = 0;
+
+static void signal_handler(int)
+{
+	should_exit = 1;
+}
+
+// monotonic wall time in nanoseconds
+static uint64_t nanos()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t time_ns)
+{
+	timespec ts{(time_t)(time_ns / 1000000000ull), (long)(time_ns % 1000000000ull)};
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+}
+
+static void usage(const char *name)
+{
+	printf("Benchmark of the uORB shared memory transport (requires 'uorb shm start' in PX4 for shm)\n\n");
+	printf("usage: %s [-m latency|rate] [-t shm|udp] [-i <instance>] [-T <topic>] [-I <multi>] [-n <count>]"
+	       " [-r <rate>] [-s <size>]\n", name);
+	printf("  -m latency|rate  round trip through PX4, or receive rate of a PX4 topic (default latency)\n");
+	printf("  -t shm|udp       latency: transport, udp is a local echo without PX4 (default shm)\n");
+	printf("  -i <instance>    PX4 instance (default 0)\n");
+	printf("  -T <topic>       topic (default latency: debug_vect, rate: sensor_combined)\n");
+	printf("  -I <multi>       rate: topic instance (default 0)\n");
+	printf("  -n <count>       latency: number of samples, rate: duration in s (default 10000, 10)\n");
+	printf("  -r <rate>        latency: send rate in Hz, 0 to send the next sample once received (default 0)\n");
+	printf("  -s <size>        udp: sample size in bytes (default 32, the size of debug_vect)\n");
+}
+
+/**
+ * One round trip transport: send() a sample, receive() it back.
+ */
+class Transport
+{
+public:
+	virtual ~Transport() = default;
+	virtual size_t size() const = 0;
+	virtual bool send(const uint8_t *data) = 0;
+	virtual bool receive(uint8_t *data, uint32_t timeout_us) = 0;
+};
+
+class ShmTransport : public Transport
+{
+public:
+	ShmTransport(uorb_shm::Client &client, const char *topic) : _pub(client, topic), _sub(client, topic) {}
+
+	bool init()
+	{
+		if (!_pub.advertise() || !_sub.subscribe()) {
+			return false;
+		}
+
+		// skip anything published before
+		std::vector<uint8_t> buffer(_sub.size());
+
+		while (_sub.update(buffer.data(), buffer.size())) {}
+
+		return true;
+	}
+
+	size_t size() const override { return _pub.size(); }
+
+	bool send(const uint8_t *data) override { return _pub.publish(data, _pub.size()); }
+
+	bool receive(uint8_t *data, uint32_t timeout_us) override
+	{
+		return _sub.wait(timeout_us) && _sub.update(data, _sub.size());
+	}
+
+	uint32_t lost() const { return _sub.lost(); }
+
+private:
+	uorb_shm::Publication _pub;
+	uorb_shm::Subscription _sub;
+};
+
+class UdpTransport : public Transport
+{
+public:
+	UdpTransport(size_t size) : _size(size) {}
+
+	~UdpTransport()
+	{
+		if (_echo_fd >= 0) {
+			shutdown(_echo_fd, SHUT_RDWR);
+			pthread_join(_echo_thread, nullptr);
+			close(_echo_fd);
+		}
+
+		if (_fd >= 0) {
+			close(_fd);
+		}
+	}
+
+	bool init()
+	{
+		_echo_fd = socket(AF_INET, SOCK_DGRAM, 0);
+		_fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+		if (_echo_fd < 0 || _fd < 0) {
+			return false;
+		}
+
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socklen_t len = sizeof(addr);
+
+		if (bind(_echo_fd, (sockaddr *)&addr, sizeof(addr)) != 0
+		    || getsockname(_echo_fd, (sockaddr *)&addr, &len) != 0
+		    || connect(_fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+			return false;
+		}
+
+		return pthread_create(&_echo_thread, nullptr, &UdpTransport::echo, this) == 0;
+	}
+
+	size_t size() const override { return _size; }
+
+	bool send(const uint8_t *data) override
+	{
+		// a bridge serializes into its own buffer first
+		std::copy(data, data + _size, _buffer);
+		return ::send(_fd, _buffer, _size, 0) == (ssize_t)_size;
+	}
+
+	bool receive(uint8_t *data, uint32_t timeout_us) override
+	{
+		timeval tv{(time_t)(timeout_us / 1000000), (suseconds_t)(timeout_us % 1000000)};
+		setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+		return recv(_fd, data, _size, 0) == (ssize_t)_size;
+	}
+
+private:
+	static void *echo(void *arg)
+	{
+		UdpTransport *self = static_cast<UdpTransport *>(arg);
+		uint8_t buffer[65536];
+		sockaddr_in from{};
+		socklen_t len = sizeof(from);
+		ssize_t n;
+
+		while ((n = recvfrom(self->_echo_fd, buffer, sizeof(buffer), 0, (sockaddr *)&from, &len)) > 0) {
+			sendto(self->_echo_fd, buffer, n, 0, (sockaddr *)&from, len);
+		}
+
+		return nullptr;
+	}
+
+	const size_t _size;
+	uint8_t _buffer[65536];
+	int _fd{-1};
+	int _echo_fd{-1};
+	pthread_t _echo_thread{};
+};
+
+static void print_latencies(const char *name, std::vector<uint64_t> &latencies, double elapsed_s, unsigned timeouts)
+{
+	if (latencies.empty()) {
+		printf("%s: no samples received\n", name);
+		return;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	uint64_t sum = 0;
+
+	for (uint64_t latency : latencies) {
+		sum += latency;
+	}
+
+	const size_t n = latencies.size();
+	printf("%s: %zu round trips in %.2f s (%.0f/s), %u timeouts\n", name, n, elapsed_s, n / elapsed_s, timeouts);
+	printf("  latency [us]: min %.1f, mean %.1f, p50 %.1f, p99 %.1f, max %.1f\n", latencies[0] * 1e-3,
+	       sum * 1e-3 / n, latencies[n / 2] * 1e-3, latencies[n * 99 / 100] * 1e-3, latencies[n - 1] * 1e-3);
+}
+
+static int run_latency(Transport &transport, const char *name, unsigned count, unsigned rate)
+{
+	std::vector<uint8_t> sample(transport.size());
+	std::vector<uint8_t> received(transport.size());
+	std::vector<uint64_t> latencies;
+	latencies.reserve(count);
+	unsigned timeouts = 0;
+
+	if (sample.size() < sizeof(uint64_t)) {
+		printf("sample too small\n");
+		return 1;
+	}
+
+	const uint64_t interval_ns = rate > 0 ? 1000000000ull / rate : 0;
+	const uint64_t start = nanos();
+
+	for (unsigned i = 0; i < count && !should_exit; i++) {
+		if (interval_ns > 0) {
+			sleep_until(start + i * interval_ns);
+		}
+
+		const uint64_t sent = nanos();
+		memcpy(sample.data(), &sent, sizeof(sent));
+
+		if (!transport.send(sample.data())) {
+			printf("%s: send failed\n", name);
+			return 1;
+		}
+
+		// wait for our sample, anything else published on the topic is skipped
+		uint64_t stamp = 0;
+
+		while (stamp != sent) {
+			if (!transport.receive(received.data(), 1000000)) {
+				timeouts++;
+				break;
+			}
+
+			memcpy(&stamp, received.data(), sizeof(stamp));
+		}
+
+		if (stamp == sent) {
+			latencies.push_back(nanos() - sent);
+		}
+	}
+
+	print_latencies(name, latencies, (nanos() - start) * 1e-9, timeouts);
+	return 0;
+}
+
+static int run_rate(uorb_shm::Client &client, const char *topic, uint8_t instance, unsigned duration_s)
+{
+	uorb_shm::Subscription sub{client, topic, instance};
+	std::vector<uint8_t> buffer;
+
+	const uint64_t start = nanos();
+	const uint64_t end = start + duration_s * 1000000000ull;
+	uint64_t interval_start = start;
+	unsigned received = 0;
+	unsigned interval_received = 0;
+
+	while (!should_exit && nanos() < end) {
+		if (!sub.wait(100000)) {
+			continue;
+		}
+
+		buffer.resize(sub.size());
+
+		while (sub.update(buffer.data(), buffer.size())) {
+			received++;
+			interval_received++;
+		}
+
+		const uint64_t now = nanos();
+
+		if (now - interval_start >= 1000000000ull) {
+			printf("%s: %.0f Hz\n", topic, interval_received / ((now - interval_start) * 1e-9));
+			interval_start = now;
+			interval_received = 0;
+		}
+	}
+
+	const double elapsed_s = (nanos() - start) * 1e-9;
+
+	if (!sub.valid()) {
+		printf("%s instance %u was not published\n", topic, instance);
+		return 1;
+	}
+
+	printf("%s: %u samples in %.2f s, %.0f Hz, %.2f MB/s, %u lost\n", topic, received, elapsed_s,
+	       received / elapsed_s, received * sub.size() / elapsed_s * 1e-6, sub.lost());
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	bool latency = true;
+	bool use_shm = true;
+	unsigned instance = 0;
+	const char *topic = nullptr;
+	uint8_t topic_instance = 0;
+	unsigned count = 0;
+	unsigned rate = 0;
+	size_t size = 32;
+
+	int ch;
+
+	while ((ch = getopt(argc, argv, "m:t:i:T:I:n:r:s:h")) != -1) {
+		switch (ch) {
+		case 'm': latency = strcmp(optarg, "rate") != 0; break;
+
+		case 't': use_shm = strcmp(optarg, "udp") != 0; break;
+
+		case 'i': instance = strtoul(optarg, nullptr, 10); break;
+
+		case 'T': topic = optarg; break;
+
+		case 'I': topic_instance = strtoul(optarg, nullptr, 10); break;
+
+		case 'n': count = strtoul(optarg, nullptr, 10); break;
+
+		case 'r': rate = strtoul(optarg, nullptr, 10); break;
+
+		case 's': size = strtoul(optarg, nullptr, 10); break;
+
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	signal(SIGINT, signal_handler);
+	signal(SIGTERM, signal_handler);
+
+	if (latency && !use_shm) {
+		UdpTransport transport{size};
+
+		if (size < sizeof(uint64_t) || size > 65507 || !transport.init()) {
+			printf("UDP setup failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		return run_latency(transport, "udp", count > 0 ? count : 10000, rate);
+	}
+
+	uorb_shm::Client client;
+
+	if (!client.open(instance)) {
+		printf("PX4 instance %u is not sharing topics (uorb shm start)\n", instance);
+		return 1;
+	}
+
+	if (!latency) {
+		return run_rate(client, topic ? topic : "sensor_combined", topic_instance, count > 0 ? count : 10);
+	}
+
+	topic = topic ? topic : "debug_vect";
+	ShmTransport transport{client, topic};
+
+	if (!transport.init()) {
+		printf("advertising %s failed\n", topic);
+		return 1;
+	}
+
+	const int ret = run_latency(transport, "shm", count > 0 ? count : 10000, rate);
+	printf("  %u lost\n", transport.lost());
+	return ret;
+}
@@ -0,0 +1,320 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uorb_shm_client.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+
+using namespace uORB;
+
+namespace uorb_shm
+{
+
+bool Client::open(unsigned px4_instance)
+{
+	close();
+
+	char name[32];
+	shm::segment_name(name, sizeof(name), px4_instance);
+
+	int fd = shm_open(name, O_RDWR, 0);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	void *ptr = mmap(nullptr, shm::SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (ptr == MAP_FAILED) {
+		return false;
+	}
+
+	shm::Header *header = static_cast<shm::Header *>(ptr);
+
+	if (header->magic != shm::MAGIC || header->version != shm::VERSION || header->size != shm::SEGMENT_SIZE) {
+		fprintf(stderr, "uorb_shm: %s has an incompatible layout\n", name);
+		munmap(ptr, shm::SEGMENT_SIZE);
+		return false;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	_header = header;
+	return true;
+}
+
+void Client::close()
+{
+	if (_header) {
+		munmap(_header, shm::SEGMENT_SIZE);
+		_header = nullptr;
+	}
+}
+
+bool Client::px4_alive() const
+{
+	return _header && (kill(_header->pid, 0) == 0 || errno == EPERM);
+}
+
+shm::Topic *Client::find(const char *name, uint8_t instance) const
+{
+	if (_header == nullptr) {
+		return nullptr;
+	}
+
+	const uint32_t count = _header->topic_count.load(std::memory_order_acquire);
+	shm::Topic *topics = shm::topics(_header);
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (topics[i].instance == instance && strncmp(topics[i].name, name, shm::NAME_LEN) == 0) {
+			return &topics[i];
+		}
+	}
+
+	return nullptr;
+}
+
+shm::Topic *Client::advertise(const char *name, uint16_t size, uint8_t queue_size, uint32_t timeout_us)
+{
+	if (_header == nullptr) {
+		return nullptr;
+	}
+
+	for (shm::Request &request : _header->requests) {
+		shm::RequestState state = shm::RequestState::Free;
+
+		if (!request.state.compare_exchange_strong(state, shm::RequestState::Writing)) {
+			continue;
+		}
+
+		strncpy(request.name, name, sizeof(request.name) - 1);
+		request.name[sizeof(request.name) - 1] = '\0';
+		request.instance = 0;
+		request.queue_size = queue_size;
+		request.size = size;
+		request.state.store(shm::RequestState::Pending, std::memory_order_release);
+		ring_doorbell();
+
+		// PX4 handles requests within its own loop, a short poll is good enough
+		for (uint32_t waited_us = 0; waited_us < timeout_us; waited_us += 1000) {
+			state = request.state.load(std::memory_order_acquire);
+
+			if (state == shm::RequestState::Done || state == shm::RequestState::Failed) {
+				shm::Topic *topic = nullptr;
+
+				if (state == shm::RequestState::Done && request.topic < shm::MAX_TOPICS) {
+					topic = &shm::topics(_header)[request.topic];
+				}
+
+				request.state.store(shm::RequestState::Free, std::memory_order_release);
+				return topic;
+			}
+
+			timespec ts{0, 1000000};
+			nanosleep(&ts, nullptr);
+		}
+
+		// if PX4 is stuck the slot stays in use
+		return nullptr;
+	}
+
+	fprintf(stderr, "uorb_shm: no free request slot\n");
+	return nullptr;
+}
+
+void Client::ring_doorbell()
+{
+	_header->doorbell.fetch_add(1, std::memory_order_seq_cst);
+
+	// PX4 sets px4_waiting before checking the doorbell a last time
+	if (_header->px4_waiting.load(std::memory_order_seq_cst) != 0) {
+		shm::futex_wake(_header->doorbell);
+	}
+}
+
+Subscription::Subscription(Client &client, const char *name, uint8_t instance, uint16_t size) :
+	_client(client),
+	_instance(instance),
+	_size(size)
+{
+	strncpy(_name, name, sizeof(_name) - 1);
+	_name[sizeof(_name) - 1] = '\0';
+}
+
+Subscription::~Subscription()
+{
+	if (_topic) {
+		_topic->subscribers.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+bool Subscription::subscribe()
+{
+	if (_topic) {
+		return true;
+	}
+
+	if (_size_mismatch) {
+		return false;
+	}
+
+	// topics are only appended, only search again when there are new ones
+	const uint32_t topic_count = _client.topic_count();
+
+	if (topic_count == _searched_count) {
+		return false;
+	}
+
+	_searched_count = topic_count;
+	shm::Topic *topic = _client.find(_name, _instance);
+
+	if (topic == nullptr) {
+		return false;
+	}
+
+	if (_size != 0 && topic->size != _size) {
+		fprintf(stderr, "uorb_shm: %s size mismatch (PX4: %u, expected: %u)\n", _name, topic->size, _size);
+		_size_mismatch = true;
+		return false;
+	}
+
+	// like uORB, the latest sample published before subscribing is available
+	const uint32_t generation = topic->outbound.generation.load(std::memory_order_acquire);
+	_generation = (generation > 0) ? generation - 1 : 0;
+
+	topic->subscribers.fetch_add(1, std::memory_order_relaxed);
+	_topic = topic;
+	return true;
+}
+
+bool Subscription::updated()
+{
+	return subscribe() && (_topic->outbound.generation.load(std::memory_order_acquire) != _generation);
+}
+
+bool Subscription::copy(void *dst, size_t size)
+{
+	if (!subscribe() || size < _topic->size) {
+		return false;
+	}
+
+	const uint32_t queue_size = _topic->queue_size;
+
+	// a retry is only needed if the publisher laps the whole queue while copying
+	for (int attempt = 0; attempt < 4; attempt++) {
+		const uint32_t current = _topic->outbound.generation.load(std::memory_order_acquire);
+
+		if (current == 0) {
+			return false;
+		}
+
+		uint32_t generation = _generation;
+
+		if (current == generation) {
+			// nothing new, return the previous sample
+			--generation;
+
+		} else if (current - generation > queue_size) {
+			// too far behind
+			_lost += current - generation - queue_size;
+			generation = current - queue_size;
+		}
+
+		if (shm::read(_client.base(), _topic->outbound, queue_size, _topic->size, generation, dst)) {
+			_generation = generation + 1;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool Subscription::wait(uint32_t timeout_us)
+{
+	if (!subscribe()) {
+		// not published yet
+		timespec ts{0, (long)(timeout_us < 10000 ? timeout_us : 10000) * 1000};
+		nanosleep(&ts, nullptr);
+		return false;
+	}
+
+	return shm::wait(_topic->outbound, _generation, timeout_us);
+}
+
+Publication::Publication(Client &client, const char *name, uint16_t size, uint8_t queue_size) :
+	_client(client),
+	_size(size),
+	_queue_size(queue_size)
+{
+	strncpy(_name, name, sizeof(_name) - 1);
+	_name[sizeof(_name) - 1] = '\0';
+}
+
+bool Publication::advertise(uint32_t timeout_us)
+{
+	if (_topic == nullptr) {
+		_topic = _client.advertise(_name, _size, _queue_size, timeout_us);
+	}
+
+	return _topic != nullptr;
+}
+
+bool Publication::publish(const void *data, size_t size)
+{
+	if (!advertise() || size != _topic->size) {
+		return false;
+	}
+
+	shm::Ring &ring = _topic->inbound;
+
+	// publishers of other processes are serialized, the critical section is a single copy
+	while (_topic->inbound_lock.exchange(1, std::memory_order_acquire) != 0) {
+		sched_yield();
+	}
+
+	const uint32_t generation = ring.generation.load(std::memory_order_relaxed);
+	uint8_t *slot = shm::write_begin(_client.base(), ring, shm::INBOUND_QUEUE_SIZE, _topic->size, generation);
+	memcpy(slot, data, _topic->size);
+	shm::write_end(_client.base(), ring, shm::INBOUND_QUEUE_SIZE, generation);
+
+	_topic->inbound_lock.store(0, std::memory_order_release);
+
+	_client.ring_doorbell();
+	return true;
+}
+
+} // namespace uorb_shm
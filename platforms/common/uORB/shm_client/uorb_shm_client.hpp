@@ -0,0 +1,210 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uorb_shm_client.hpp
+ * Client library for processes on the same host to subscribe and publish uORB topics of a
+ * running PX4 instance (started with 'uorb shm start'). Samples are copied directly from and
+ * to the shared memory segment, there is no serialization and no socket involved.
+ *
+ * The message structs are the ones generated by PX4 (uORB/topics/<topic>.h), the size is
+ * checked against the one of PX4. The API follows uORB::Subscription and uORB::Publication:
+ * @code
+ * uorb_shm::Client client;
+ * client.open(0);
+ * uorb_shm::Subscription sub{client, "sensor_combined"};
+ * sensor_combined_s sensor_combined;
+ *
+ * while (sub.wait(100000)) {
+ * 	sub.update(&sensor_combined, sizeof(sensor_combined));
+ * }
+ * @endcode
+ *
+ * Not thread safe, use one Subscription/Publication per thread.
+ */
+
+#pragma once
+
+#include <uORBSharedMemory.hpp>
+
+namespace uorb_shm
+{
+
+class Client
+{
+public:
+	Client() = default;
+	~Client() { close(); }
+
+	Client(const Client &) = delete;
+	Client &operator=(const Client &) = delete;
+
+	/**
+	 * Map the segment of a PX4 instance.
+	 * @return false if PX4 is not running or did not start sharing
+	 */
+	bool open(unsigned px4_instance = 0);
+	void close();
+
+	bool is_open() const { return _header != nullptr; }
+
+	/**
+	 * Check that the PX4 process of the segment is still running. After a restart of PX4
+	 * the client has to be closed and opened again.
+	 */
+	bool px4_alive() const;
+
+	/**
+	 * Number of topics shared so far, the table is only appended to.
+	 */
+	uint32_t topic_count() const { return _header ? _header->topic_count.load(std::memory_order_acquire) : 0; }
+
+	/**
+	 * Find a topic instance shared by PX4, which happens on its first publication.
+	 * @return topic or nullptr if not (yet) shared
+	 */
+	uORB::shm::Topic *find(const char *name, uint8_t instance) const;
+
+	/**
+	 * Ask PX4 to advertise a topic for publications of this process (instance 0 only).
+	 * @param size expected message size, 0 to accept PX4's size
+	 * @return topic or nullptr on failure or timeout
+	 */
+	uORB::shm::Topic *advertise(const char *name, uint16_t size, uint8_t queue_size, uint32_t timeout_us = 1000000);
+
+	/**
+	 * Wake up PX4 after a publication.
+	 */
+	void ring_doorbell();
+
+	void *base() const { return _header; }
+
+private:
+	uORB::shm::Header *_header{nullptr};
+};
+
+class Subscription
+{
+public:
+	/**
+	 * @param size expected message size (e.g. sizeof(sensor_combined_s)), 0 to accept any
+	 */
+	Subscription(Client &client, const char *name, uint8_t instance = 0, uint16_t size = 0);
+	~Subscription();
+
+	Subscription(const Subscription &) = delete;
+	Subscription &operator=(const Subscription &) = delete;
+
+	/**
+	 * Look up the topic if not done yet, called by all the other methods.
+	 */
+	bool subscribe();
+
+	bool valid() const { return _topic != nullptr; }
+
+	bool updated();
+
+	/**
+	 * Copy the next unread sample (of the queue), or the latest if there is no unread one.
+	 * @param size size of dst, must be at least the message size
+	 */
+	bool copy(void *dst, size_t size);
+
+	/**
+	 * Copy the next unread sample if there is one.
+	 */
+	bool update(void *dst, size_t size) { return updated() && copy(dst, size); }
+
+	/**
+	 * Block until there is an unread sample, in wall time.
+	 * @return false on timeout
+	 */
+	bool wait(uint32_t timeout_us);
+
+	uint16_t size() const { return _topic ? _topic->size : 0; }
+
+	/**
+	 * Number of samples that were overwritten before they were read.
+	 */
+	uint32_t lost() const { return _lost; }
+
+private:
+	Client &_client;
+	char _name[uORB::shm::NAME_LEN];
+	const uint8_t _instance;
+	const uint16_t _size;
+
+	uORB::shm::Topic *_topic{nullptr};
+	uint32_t _generation{0};
+	uint32_t _lost{0};
+	uint32_t _searched_count{0};
+	bool _size_mismatch{false};
+};
+
+class Publication
+{
+public:
+	/**
+	 * @param size message size (e.g. sizeof(vehicle_odometry_s)), 0 to accept PX4's size
+	 * @param queue_size queue size of the topic in PX4
+	 */
+	Publication(Client &client, const char *name, uint16_t size = 0, uint8_t queue_size = 1);
+
+	Publication(const Publication &) = delete;
+	Publication &operator=(const Publication &) = delete;
+
+	/**
+	 * Advertise the topic if not done yet, called by publish().
+	 */
+	bool advertise(uint32_t timeout_us = 1000000);
+
+	bool advertised() const { return _topic != nullptr; }
+
+	/**
+	 * Publish a sample, which PX4 then publishes as if it was published locally.
+	 * @param size size of data, must be the message size
+	 */
+	bool publish(const void *data, size_t size);
+
+	uint16_t size() const { return _topic ? _topic->size : 0; }
+
+private:
+	Client &_client;
+	char _name[uORB::shm::NAME_LEN];
+	const uint16_t _size;
+	const uint8_t _queue_size;
+
+	uORB::shm::Topic *_topic{nullptr};
+};
+
+} // namespace uorb_shm
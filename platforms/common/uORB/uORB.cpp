@@ -50,6 +50,10 @@
 #include <sys/boardctl.h>
 #endif
 
+#if defined(__PX4_LINUX)
+#include "uORBSharedMemoryServer.hpp"
+#endif
+
 static uORB::DeviceMaster *g_dev = nullptr;
 
 int uorb_start(void)
@@ -112,6 +116,32 @@ int uorb_top(char **topic_filter, int num_filters)
 	return OK;
 }
 
+#if defined(__PX4_LINUX)
+int uorb_shm_start(unsigned instance)
+{
+	if (g_dev == nullptr) {
+		PX4_INFO("uorb is not running");
+		return PX4_ERROR;
+	}
+
+	return uORB::SharedMemoryServer::start(instance);
+}
+
+int uorb_shm_status(void)
+{
+	uORB::SharedMemoryServer *server = uORB::SharedMemoryServer::instance();
+
+	if (server != nullptr) {
+		server->print_status();
+
+	} else {
+		PX4_INFO("shared memory not running");
+	}
+
+	return OK;
+}
+#endif
+
 orb_advert_t orb_advertise(const struct orb_metadata *meta, const void *data)
 {
 	return uORB::Manager::get_instance()->orb_advertise(meta, data);
@@ -117,6 +117,11 @@ int uorb_start(void);
 int uorb_status(void);
 int uorb_top(char **topic_filter, int num_filters);
 
+#if defined(__PX4_LINUX)
+int uorb_shm_start(unsigned instance);
+int uorb_shm_status(void);
+#endif
+
 /**
  * ORB topic advertiser handle.
  *
@@ -168,6 +168,20 @@ int uORB::DeviceMaster::advertise(const struct orb_metadata *meta, bool is_adver
 	return ret;
 }
 
+#if defined(__PX4_LINUX)
+void uORB::DeviceMaster::shareDeviceNodes()
+{
+	SmartLock smart_lock(_lock);
+
+	for (uORB::DeviceNode *node : _node_list) {
+		// the data buffer is only allocated on the first publication, the queue size can change until then
+		if (node->updates_available(0) > 0) {
+			node->share();
+		}
+	}
+}
+#endif
+
 void uORB::DeviceMaster::printStatistics()
 {
 	/* Add all nodes to a list while locked, and then print them in unlocked state, to avoid potential
@@ -115,6 +115,13 @@ public:
 	 */
 	void showTop(char **topic_filter, int num_filters);
 
+#if defined(__PX4_LINUX)
+	/**
+	 * Move the data of all nodes published so far into the shared memory segment.
+	 */
+	void shareDeviceNodes();
+#endif
+
 private:
 	// Private constructor, uORB::Manager takes care of its creation
 	DeviceMaster();
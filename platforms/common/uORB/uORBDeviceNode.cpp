@@ -42,6 +42,10 @@
 #include "uORBCommunicator.hpp"
 #endif /* ORB_COMMUNICATOR */
 
+#if defined(__PX4_LINUX)
+#include "uORBSharedMemoryServer.hpp"
+#endif
+
 #if defined(__PX4_NUTTX)
 #include <nuttx/mm/mm.h>
 #endif
@@ -84,6 +88,15 @@ uORB::DeviceNode::DeviceNode(const struct orb_metadata *meta, const uint8_t inst
 
 uORB::DeviceNode::~DeviceNode()
 {
+#if defined(__PX4_LINUX)
+
+	// the segment owns shared buffers
+	if (_shm_topic != nullptr) {
+		_data = nullptr;
+	}
+
+#endif
+
 	free(_data);
 
 	const char *devname = get_devname();
@@ -185,6 +198,14 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 			lock();
 
 			/* re-check size */
+#if defined(__PX4_LINUX)
+
+			if (nullptr == _data) {
+				share_locked();
+			}
+
+#endif
+
 			if (nullptr == _data) {
 				const size_t data_size = _meta->o_size * _queue_size;
 				_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
@@ -214,8 +235,24 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
 	unsigned generation = _generation.fetch_add(1);
 
+#if defined(__PX4_LINUX)
+
+	if (_shm_topic) {
+		uORB::shm::write_begin(_shm_base, _shm_topic->outbound, _queue_size, _meta->o_size, generation);
+	}
+
+#endif
+
 	memcpy(_data + (_meta->o_size * (generation % _queue_size)), buffer, _meta->o_size);
 
+#if defined(__PX4_LINUX)
+
+	if (_shm_topic) {
+		uORB::shm::write_end(_shm_base, _shm_topic->outbound, _queue_size, generation);
+	}
+
+#endif
+
 	// callbacks
 	for (auto item : _callbacks) {
 		item->call();
@@ -507,6 +544,56 @@ int uORB::DeviceNode::update_queue_size(unsigned int queue_size)
 	return PX4_OK;
 }
 
+#if defined(__PX4_LINUX)
+uORB::shm::Topic *uORB::DeviceNode::share()
+{
+	lock();
+	uORB::shm::Topic *topic = share_locked();
+	unlock();
+	return topic;
+}
+
+uORB::shm::Topic *uORB::DeviceNode::share_locked()
+{
+	SharedMemoryServer *server = SharedMemoryServer::instance();
+
+	if ((_shm_topic != nullptr) || (server == nullptr)) {
+		return _shm_topic;
+	}
+
+	uint8_t *data = nullptr;
+	uORB::shm::Topic *topic = server->add_topic(this, &data);
+
+	if (topic == nullptr) {
+		return nullptr;
+	}
+
+	void *base = server->base();
+	const unsigned generation = _generation.load();
+
+	if (_data != nullptr) {
+		// move the queue over, marking the slots that were published as complete
+		memcpy(data, _data, _meta->o_size * _queue_size);
+		auto *sequence = uORB::shm::at<std::atomic<uint32_t>>(base, topic->outbound.sequence_offset);
+		const unsigned published = !_data_valid ? 0 : (generation < _queue_size ? generation : _queue_size);
+
+		for (unsigned g = generation - published; g != generation; g++) {
+			sequence[g & (_queue_size - 1)].store(2 * g + 2, std::memory_order_relaxed);
+		}
+
+		free(_data);
+	}
+
+	topic->outbound.generation.store(generation, std::memory_order_release);
+
+	_data = data;
+	_shm_base = base;
+	_shm_topic = topic;
+
+	return topic;
+}
+#endif
+
 unsigned uORB::DeviceNode::get_initial_generation()
 {
 	ATOMIC_ENTER;
@@ -48,6 +48,11 @@ class DeviceNode;
 class DeviceMaster;
 class Manager;
 class SubscriptionCallback;
+
+namespace shm
+{
+struct Topic;
+}
 }
 
 namespace uORBTest
@@ -271,6 +276,15 @@ public:
 	// remove item from list of work items
 	void unregister_callback(SubscriptionCallback *callback_sub);
 
+#if defined(__PX4_LINUX)
+	/**
+	 * Move the data buffer into the shared memory segment (allocating it if nobody published yet),
+	 * so that other processes can subscribe.
+	 * @return the topic in the segment or nullptr if not running or the segment is full
+	 */
+	uORB::shm::Topic *share();
+#endif
+
 protected:
 
 	px4_pollevent_t poll_state(cdev::file_t *filp) override;
@@ -292,6 +306,13 @@ private:
 	uint8_t _queue_size; /**< maximum number of elements in the queue */
 	int8_t _subscriber_count{0};
 
+#if defined(__PX4_LINUX)
+	uORB::shm::Topic *_shm_topic{nullptr}; /**< entry in the shared memory segment, _data is its outbound ring */
+	void *_shm_base{nullptr};
+
+	uORB::shm::Topic *share_locked();
+#endif
+
 
 // Determine the data range
 	static inline bool is_in_range(unsigned left, unsigned value, unsigned right)
@@ -0,0 +1,273 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBSharedMemory.hpp
+ * Layout of the uORB shared memory segment (Linux only), shared between PX4 and the
+ * client library in shm_client/ for other processes on the same host.
+ *
+ * PX4 creates the segment and owns all allocations. Each shared topic is a fixed table entry
+ * pointing to two rings inside the segment:
+ * - outbound: the DeviceNode data buffer itself (queue_size * o_size), written by PX4 on publish.
+ * - inbound: samples published by other processes, forwarded by PX4 through DeviceNode::write().
+ *
+ * Both rings are read lock-free: each slot has a sequence number (2 * generation + 1 while
+ * being written, 2 * generation + 2 when complete), and the generation counter of the ring
+ * is advanced after the slot is complete. Readers copy the slot and retry if the sequence
+ * changed meanwhile. Waiting is done with a futex on the generation counter.
+ *
+ * Only fixed size types are used and all references are offsets, as every process maps the
+ * segment at a different address.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace uORB
+{
+namespace shm
+{
+
+static constexpr uint32_t MAGIC = 0x31534f55; // "UOS1"
+static constexpr uint32_t VERSION = 1;
+
+static constexpr uint32_t MAX_TOPICS = 1024;            ///< topic table entries (node instances)
+static constexpr uint32_t NAME_LEN = 64;
+static constexpr uint32_t MAX_REQUESTS = 16;            ///< concurrent advertise requests of clients
+static constexpr uint32_t INBOUND_QUEUE_SIZE = 8;       ///< inbound ring size, power of two
+static constexpr uint32_t SEGMENT_SIZE = 16 * 1024 * 1024; ///< virtual size, pages are only backed when used
+static constexpr uint32_t ALIGNMENT = 64;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain uint32_t");
+
+/**
+ * Single ring of samples with lock-free readers. The slots are not part of the struct,
+ * see data_offset and sequence_offset.
+ */
+struct Ring {
+	std::atomic<uint32_t> generation;       ///< number of completed writes, futex word
+	std::atomic<uint32_t> waiters;          ///< readers blocked on the generation futex
+	uint32_t data_offset;                   ///< queue_size * size bytes
+	uint32_t sequence_offset;               ///< queue_size * uint32_t slot sequence numbers
+};
+
+struct Topic {
+	char name[NAME_LEN];
+	uint32_t fields_hash;                   ///< fields_hash() of the orb_metadata fields
+	uint16_t size;                          ///< o_size
+	uint8_t instance;
+	uint8_t queue_size;                     ///< outbound queue size, power of two
+
+	Ring outbound;                          ///< PX4 -> other processes (DeviceNode data)
+	Ring inbound;                           ///< other processes -> PX4, data_offset == 0 if not advertised
+
+	std::atomic<uint32_t> inbound_lock;     ///< serializes publishing clients
+	std::atomic<uint32_t> subscribers;      ///< subscriptions of other processes
+	uint32_t reserved[2];
+};
+
+enum class RequestState : uint32_t {
+	Free = 0,
+	Writing,                                ///< claimed by a client, not yet complete
+	Pending,                                ///< waiting for PX4
+	Done,                                   ///< topic index is valid
+	Failed
+};
+
+/**
+ * Request of a client to publish a topic. PX4 advertises it and allocates the inbound ring.
+ */
+struct Request {
+	std::atomic<RequestState> state;
+	char name[NAME_LEN];
+	uint8_t instance;
+	uint8_t queue_size;
+	uint16_t size;
+	uint32_t topic;                         ///< result: index into the topic table
+};
+
+struct Header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t size;                          ///< segment size
+	uint32_t topics_offset;                 ///< Topic[MAX_TOPICS]
+	uint64_t session;                       ///< changes on every PX4 start
+	int32_t pid;                            ///< of PX4
+
+	std::atomic<uint32_t> topic_count;      ///< entries below are complete (only PX4 appends)
+	std::atomic<uint32_t> data_used;        ///< allocator position (only PX4 allocates)
+
+	alignas(ALIGNMENT) std::atomic<uint32_t> doorbell; ///< incremented by clients for PX4, futex word
+	std::atomic<uint32_t> px4_waiting;
+
+	Request requests[MAX_REQUESTS];
+};
+
+/**
+ * Name of the segment of a PX4 instance.
+ */
+static inline void segment_name(char *buf, size_t len, unsigned instance)
+{
+	snprintf(buf, len, "/px4_uorb_%u", instance);
+}
+
+/**
+ * FNV-1a hash of the orb_metadata fields, to detect mismatching message definitions.
+ */
+static inline uint32_t fields_hash(const char *fields)
+{
+	uint32_t hash = 2166136261u;
+
+	for (const char *c = fields; c && *c; ++c) {
+		hash = (hash ^ (uint8_t)*c) * 16777619u;
+	}
+
+	return hash;
+}
+
+template<typename T>
+static inline T *at(void *base, uint32_t offset)
+{
+	return reinterpret_cast<T *>(static_cast<uint8_t *>(base) + offset);
+}
+
+static inline Topic *topics(Header *header)
+{
+	return at<Topic>(header, header->topics_offset);
+}
+
+static inline void futex_wake(std::atomic<uint32_t> &word)
+{
+#if defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+/**
+ * Wait until word != value, in wall time. Can return early.
+ */
+static inline void futex_wait(std::atomic<uint32_t> &word, uint32_t value, uint32_t timeout_us)
+{
+#if defined(__linux__)
+	timespec ts{(time_t)(timeout_us / 1000000), (long)(timeout_us % 1000000) * 1000};
+	syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, value, &ts, nullptr, 0);
+#else
+	timespec ts{0, (long)(timeout_us < 100 ? timeout_us : 100) * 1000};
+	nanosleep(&ts, nullptr);
+#endif
+}
+
+/**
+ * Start writing generation into its slot, to be followed by write_end(). Writers of a ring
+ * must be serialized.
+ * @return slot to copy the data into
+ */
+static inline uint8_t *write_begin(void *base, Ring &ring, uint32_t queue_size, uint32_t size, uint32_t generation)
+{
+	const uint32_t index = generation & (queue_size - 1);
+	std::atomic<uint32_t> *sequence = at<std::atomic<uint32_t>>(base, ring.sequence_offset);
+	sequence[index].store(2 * generation + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	return at<uint8_t>(base, ring.data_offset + index * size);
+}
+
+static inline void write_end(void *base, Ring &ring, uint32_t queue_size, uint32_t generation)
+{
+	const uint32_t index = generation & (queue_size - 1);
+	std::atomic<uint32_t> *sequence = at<std::atomic<uint32_t>>(base, ring.sequence_offset);
+	sequence[index].store(2 * generation + 2, std::memory_order_release);
+	ring.generation.store(generation + 1, std::memory_order_seq_cst);
+
+	// readers increment waiters before checking the generation a last time,
+	// so either they see the new generation or we see them waiting
+	if (ring.waiters.load(std::memory_order_seq_cst) != 0) {
+		futex_wake(ring.generation);
+	}
+}
+
+/**
+ * Copy the sample of a given generation.
+ * @return false if the slot does not (or no longer) hold that generation
+ */
+static inline bool read(void *base, const Ring &ring, uint32_t queue_size, uint32_t size, uint32_t generation,
+			void *dst)
+{
+	const uint32_t index = generation & (queue_size - 1);
+	const std::atomic<uint32_t> &sequence = at<std::atomic<uint32_t>>(base, ring.sequence_offset)[index];
+	const uint32_t expected = 2 * generation + 2;
+
+	if (sequence.load(std::memory_order_acquire) != expected) {
+		return false;
+	}
+
+	memcpy(dst, at<uint8_t>(base, ring.data_offset + index * size), size);
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	return sequence.load(std::memory_order_relaxed) == expected;
+}
+
+/**
+ * Block until the generation of the ring differs from generation, in wall time.
+ * @return true if it changed
+ */
+static inline bool wait(Ring &ring, uint32_t generation, uint32_t timeout_us)
+{
+	if (ring.generation.load(std::memory_order_acquire) != generation) {
+		return true;
+	}
+
+	ring.waiters.fetch_add(1, std::memory_order_seq_cst);
+
+	if (ring.generation.load(std::memory_order_seq_cst) == generation) {
+		futex_wait(ring.generation, generation, timeout_us);
+	}
+
+	ring.waiters.fetch_sub(1, std::memory_order_relaxed);
+
+	return ring.generation.load(std::memory_order_acquire) != generation;
+}
+
+} // namespace shm
+} // namespace uORB
@@ -0,0 +1,327 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "uORBSharedMemoryServer.hpp"
+
+#include "uORBDeviceMaster.hpp"
+#include "uORBDeviceNode.hpp"
+#include "uORBManager.hpp"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/tasks.h>
+#include <uORB/topics/uORBTopics.hpp>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+using namespace time_literals;
+
+namespace uORB
+{
+
+px4::atomic<SharedMemoryServer *> SharedMemoryServer::_instance{nullptr};
+char SharedMemoryServer::_segment_name[32] {};
+
+static constexpr uint32_t align(uint32_t size)
+{
+	return (size + shm::ALIGNMENT - 1) & ~(shm::ALIGNMENT - 1);
+}
+
+int SharedMemoryServer::start(unsigned instance)
+{
+	if (_instance.load() != nullptr) {
+		PX4_WARN("already running");
+		return PX4_OK;
+	}
+
+	char name[32];
+	shm::segment_name(name, sizeof(name), instance);
+
+	// replace the segment of a previous run
+	shm_unlink(name);
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+
+	if (fd < 0) {
+		PX4_ERR("shm_open %s failed (%i)", name, errno);
+		return PX4_ERROR;
+	}
+
+	void *ptr = MAP_FAILED;
+
+	if (ftruncate(fd, shm::SEGMENT_SIZE) == 0) {
+		ptr = mmap(nullptr, shm::SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+
+	close(fd);
+
+	if (ptr == MAP_FAILED) {
+		PX4_ERR("mapping %s failed (%i)", name, errno);
+		shm_unlink(name);
+		return PX4_ERROR;
+	}
+
+	// the new pages are zero filled, which is the empty state of everything else
+	shm::Header *header = static_cast<shm::Header *>(ptr);
+	header->version = shm::VERSION;
+	header->size = shm::SEGMENT_SIZE;
+	header->topics_offset = align(sizeof(shm::Header));
+	header->session = ((uint64_t)getpid() << 32) ^ hrt_absolute_time();
+	header->pid = getpid();
+	header->data_used.store(header->topics_offset + align(sizeof(shm::Topic) * shm::MAX_TOPICS));
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = shm::MAGIC;
+
+	SharedMemoryServer *server = new SharedMemoryServer(header);
+
+	if (server == nullptr) {
+		munmap(ptr, shm::SEGMENT_SIZE);
+		shm_unlink(name);
+		return -ENOMEM;
+	}
+
+	_instance.store(server);
+
+	// remove the name on shutdown, mappings of other processes stay valid until they unmap
+	strncpy(_segment_name, name, sizeof(_segment_name) - 1);
+	atexit(&SharedMemoryServer::unlink_segment);
+
+	// nodes that got data before are moved into the segment, all others when they are first published
+	uORB::Manager::get_instance()->get_device_master()->shareDeviceNodes();
+
+	int task_id = px4_task_spawn_cmd("uorb_shm", SCHED_DEFAULT, SCHED_PRIORITY_DEFAULT, PX4_STACK_ADJUSTED(1500),
+					 &SharedMemoryServer::run_trampoline, nullptr);
+
+	if (task_id < 0) {
+		PX4_ERR("task start failed, no publications from other processes");
+	}
+
+	PX4_INFO("sharing topics in %s", name);
+	return PX4_OK;
+}
+
+int SharedMemoryServer::run_trampoline(int argc, char *argv[])
+{
+	_instance.load()->run();
+	return 0;
+}
+
+void SharedMemoryServer::unlink_segment()
+{
+	shm_unlink(_segment_name);
+}
+
+void SharedMemoryServer::run()
+{
+	uint32_t doorbell = _header->doorbell.load(std::memory_order_acquire);
+
+	while (true) {
+		process_requests();
+		process_inbound();
+
+		// clients ring the doorbell after a request or publication, the timeout only catches missed ones
+		_header->px4_waiting.store(1, std::memory_order_seq_cst);
+
+		if (_header->doorbell.load(std::memory_order_seq_cst) == doorbell) {
+			shm::futex_wait(_header->doorbell, doorbell, 100_ms);
+		}
+
+		_header->px4_waiting.store(0, std::memory_order_relaxed);
+		doorbell = _header->doorbell.load(std::memory_order_acquire);
+	}
+}
+
+uint32_t SharedMemoryServer::allocate(uint32_t size)
+{
+	const uint32_t offset = _header->data_used.load(std::memory_order_relaxed);
+
+	if (size > shm::SEGMENT_SIZE - offset) {
+		return 0;
+	}
+
+	_header->data_used.store(offset + align(size), std::memory_order_relaxed);
+	return offset;
+}
+
+shm::Topic *SharedMemoryServer::add_topic(DeviceNode *node, uint8_t **data)
+{
+	const orb_metadata *meta = node->get_meta();
+	const uint32_t queue_size = node->get_queue_size();
+	shm::Topic *topic = nullptr;
+
+	pthread_mutex_lock(&_mutex);
+
+	const uint32_t index = _header->topic_count.load(std::memory_order_relaxed);
+
+	if (index < shm::MAX_TOPICS) {
+		const uint32_t sequence_offset = allocate(queue_size * sizeof(uint32_t));
+		const uint32_t data_offset = (sequence_offset != 0) ? allocate(queue_size * meta->o_size) : 0;
+
+		if (data_offset != 0) {
+			topic = &shm::topics(_header)[index];
+			strncpy(topic->name, meta->o_name, sizeof(topic->name) - 1);
+			topic->fields_hash = shm::fields_hash(meta->o_fields);
+			topic->size = meta->o_size;
+			topic->instance = node->get_instance();
+			topic->queue_size = queue_size;
+			topic->outbound.data_offset = data_offset;
+			topic->outbound.sequence_offset = sequence_offset;
+			*data = shm::at<uint8_t>(_header, data_offset);
+
+			_nodes[index] = node;
+			_header->topic_count.store(index + 1, std::memory_order_release);
+		}
+	}
+
+	pthread_mutex_unlock(&_mutex);
+
+	if (topic == nullptr) {
+		PX4_ERR("segment full, %s not shared", meta->o_name);
+	}
+
+	return topic;
+}
+
+void SharedMemoryServer::process_requests()
+{
+	for (shm::Request &request : _header->requests) {
+		if (request.state.load(std::memory_order_acquire) != shm::RequestState::Pending) {
+			continue;
+		}
+
+		shm::RequestState result = shm::RequestState::Failed;
+		request.name[sizeof(request.name) - 1] = '\0';
+
+		const orb_metadata *meta = nullptr;
+
+		for (size_t i = 0; i < ORB_TOPICS_COUNT; i++) {
+			if (strcmp(orb_get_topics()[i]->o_name, request.name) == 0) {
+				meta = orb_get_topics()[i];
+				break;
+			}
+		}
+
+		// other processes publish as a single-instance advertiser
+		if (meta && (request.size == 0 || request.size == meta->o_size) && request.instance == 0) {
+			request.size = meta->o_size;
+			orb_advertise_queue(meta, nullptr, request.queue_size > 0 ? request.queue_size : 1);
+			DeviceNode *node = uORB::Manager::get_instance()->get_device_master()->getDeviceNode(meta, 0);
+			shm::Topic *topic = (node != nullptr) ? node->share() : nullptr;
+
+			if (topic != nullptr) {
+				pthread_mutex_lock(&_mutex);
+
+				if (topic->inbound.data_offset == 0) {
+					const uint32_t queue_size = shm::INBOUND_QUEUE_SIZE;
+					const uint32_t sequence_offset = allocate(queue_size * sizeof(uint32_t));
+					const uint32_t data_offset = (sequence_offset != 0)
+								     ? allocate(queue_size * topic->size) : 0;
+
+					if (data_offset != 0) {
+						topic->inbound.sequence_offset = sequence_offset;
+						topic->inbound.data_offset = data_offset;
+					}
+				}
+
+				pthread_mutex_unlock(&_mutex);
+
+				if (topic->inbound.data_offset != 0) {
+					request.topic = topic - shm::topics(_header);
+					result = shm::RequestState::Done;
+				}
+			}
+		}
+
+		if (result != shm::RequestState::Done) {
+			PX4_WARN("publication of '%s' from another process rejected", request.name);
+		}
+
+		request.state.store(result, std::memory_order_release);
+	}
+}
+
+void SharedMemoryServer::process_inbound()
+{
+	const uint32_t count = _header->topic_count.load(std::memory_order_acquire);
+	shm::Topic *topics = shm::topics(_header);
+
+	for (uint32_t i = 0; i < count; i++) {
+		shm::Topic &topic = topics[i];
+
+		if (topic.inbound.data_offset == 0) {
+			continue;
+		}
+
+		const uint32_t generation = topic.inbound.generation.load(std::memory_order_acquire);
+		uint32_t &next = _inbound_next[i];
+
+		if (generation - next > shm::INBOUND_QUEUE_SIZE) {
+			_inbound_lost += generation - next - shm::INBOUND_QUEUE_SIZE;
+			next = generation - shm::INBOUND_QUEUE_SIZE;
+		}
+
+		for (; next != generation; next++) {
+			if (shm::read(_header, topic.inbound, shm::INBOUND_QUEUE_SIZE, topic.size, next, _buffer)) {
+				DeviceNode::publish(_nodes[i]->get_meta(), (orb_advert_t)_nodes[i], _buffer);
+				_inbound_count++;
+
+			} else {
+				_inbound_lost++;
+			}
+		}
+	}
+}
+
+void SharedMemoryServer::print_status()
+{
+	const uint32_t count = _header->topic_count.load(std::memory_order_acquire);
+	shm::Topic *topics = shm::topics(_header);
+
+	PX4_INFO("segment: %u topics, %u of %u kB used", (unsigned)count,
+		 (unsigned)(_header->data_used.load() / 1024), (unsigned)(shm::SEGMENT_SIZE / 1024));
+	PX4_INFO("publications from other processes: %u forwarded, %u lost", (unsigned)_inbound_count,
+		 (unsigned)_inbound_lost);
+
+	for (uint32_t i = 0; i < count; i++) {
+		const shm::Topic &topic = topics[i];
+		const uint32_t subscribers = topic.subscribers.load(std::memory_order_relaxed);
+
+		if (subscribers > 0 || topic.inbound.data_offset != 0) {
+			PX4_INFO_RAW("%-40s %2u subscribers: %2u %s\n", topic.name, (unsigned)topic.instance,
+				     (unsigned)subscribers, topic.inbound.data_offset != 0 ? "publisher" : "");
+		}
+	}
+}
+
+} // namespace uORB
@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file uORBSharedMemoryServer.hpp
+ * PX4 side of the uORB shared memory segment, see uORBSharedMemory.hpp.
+ */
+
+#pragma once
+
+#include "uORBSharedMemory.hpp"
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/posix.h>
+
+struct orb_metadata;
+
+namespace uORB
+{
+class DeviceNode;
+
+class SharedMemoryServer
+{
+public:
+	/**
+	 * Create the segment of a PX4 instance, share all existing topics with data and
+	 * start the thread handling publications of other processes.
+	 */
+	static int start(unsigned instance);
+
+	static SharedMemoryServer *instance() { return _instance.load(); }
+
+	void print_status();
+
+	/**
+	 * Add a topic to the table and allocate its outbound ring, which then is the data buffer of the node.
+	 * To be called with the node locked.
+	 * @return topic or nullptr if the segment is full
+	 */
+	shm::Topic *add_topic(DeviceNode *node, uint8_t **data);
+
+	void *base() const { return _header; }
+
+private:
+	SharedMemoryServer(shm::Header *header) : _header(header) {}
+	~SharedMemoryServer() = default;
+
+	static int run_trampoline(int argc, char *argv[]);
+	static void unlink_segment();
+	void run();
+
+	uint32_t allocate(uint32_t size);
+
+	void process_requests();
+	void process_inbound();
+
+	static px4::atomic<SharedMemoryServer *> _instance;
+	static char _segment_name[32];
+
+	shm::Header *_header;
+
+	pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER; ///< protects the allocator and the topic table
+
+	DeviceNode *_nodes[shm::MAX_TOPICS] {};          ///< node of each topic table entry
+	uint32_t _inbound_next[shm::MAX_TOPICS] {};      ///< next inbound generation to forward
+	uint8_t _buffer[UINT16_MAX] {};
+
+	uint32_t _inbound_count{0};
+	uint32_t _inbound_lost{0};
+};
+
+} // namespace uORB
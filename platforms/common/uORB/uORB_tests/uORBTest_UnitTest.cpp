@@ -42,6 +42,10 @@
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
 
+#if defined(__PX4_LINUX)
+#include "../uORBSharedMemoryServer.hpp"
+#endif
+
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
 {
 	static uORBTest::UnitTest t;
@@ -206,7 +210,18 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+#if defined(__PX4_LINUX)
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_shared_memory();
+#endif
+
+	return ret;
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -1085,6 +1100,118 @@ int uORBTest::UnitTest::latency_test(bool print)
 	return pubsubtest_res;
 }
 
+#if defined(__PX4_LINUX)
+int uORBTest::UnitTest::test_shared_memory()
+{
+	using namespace uORB;
+
+	test_note("Testing shared memory");
+
+	if (SharedMemoryServer::instance() == nullptr) {
+		// use a private segment (not the one of a PX4 instance), it is unlinked when the process exits.
+		// The server can't be stopped again as the shared topics keep their data in the segment.
+		const unsigned instance = 10000 + (unsigned)getpid();
+
+		if (uorb_shm_start(instance) != PX4_OK || SharedMemoryServer::instance() == nullptr) {
+			return test_fail("shared memory start failed");
+		}
+	}
+
+	orb_test_large_s t{};
+	t.val = 1;
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_large), &t);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	shm::Header *header = static_cast<shm::Header *>(SharedMemoryServer::instance()->base());
+	shm::Topic *topic = nullptr;
+
+	for (uint32_t i = 0; i < header->topic_count.load(); i++) {
+		if (strcmp(shm::topics(header)[i].name, "orb_test_large") == 0 && shm::topics(header)[i].instance == 0) {
+			topic = &shm::topics(header)[i];
+		}
+	}
+
+	if (topic == nullptr || topic->size != sizeof(orb_test_large_s)) {
+		return test_fail("topic not shared");
+	}
+
+	test_note("  Testing outbound...");
+	t.val = 2;
+	orb_publish(ORB_ID(orb_test_large), ptopic, &t);
+
+	orb_test_large_s u{};
+	const uint32_t generation = topic->outbound.generation.load() - 1;
+
+	if (!shm::read(header, topic->outbound, topic->queue_size, topic->size, generation, &u) || u.val != 2) {
+		return test_fail("outbound copy mismatch: %d expected 2", u.val);
+	}
+
+	test_note("  Testing inbound...");
+	int sfd = orb_subscribe(ORB_ID(orb_test_large));
+	orb_copy(ORB_ID(orb_test_large), sfd, &u);
+
+	// advertise as another process would (see shm_client)
+	shm::Request &request = header->requests[shm::MAX_REQUESTS - 1];
+	shm::RequestState state = shm::RequestState::Free;
+
+	if (!request.state.compare_exchange_strong(state, shm::RequestState::Writing)) {
+		orb_unsubscribe(sfd);
+		return test_fail("request slot busy");
+	}
+
+	strncpy(request.name, "orb_test_large", sizeof(request.name));
+	request.instance = 0;
+	request.queue_size = 1;
+	request.size = sizeof(orb_test_large_s);
+	request.state.store(shm::RequestState::Pending);
+	header->doorbell.fetch_add(1);
+	shm::futex_wake(header->doorbell);
+
+	for (int i = 0; i < 100 && request.state.load() == shm::RequestState::Pending; i++) {
+		px4_usleep(10000);
+	}
+
+	state = request.state.load();
+	request.state.store(shm::RequestState::Free);
+
+	if (state != shm::RequestState::Done || &shm::topics(header)[request.topic] != topic) {
+		orb_unsubscribe(sfd);
+		return test_fail("inbound advertise failed");
+	}
+
+	t.val = 3;
+	const uint32_t inbound_generation = topic->inbound.generation.load();
+	uint8_t *slot = shm::write_begin(header, topic->inbound, shm::INBOUND_QUEUE_SIZE, topic->size, inbound_generation);
+	memcpy(slot, &t, sizeof(t));
+	shm::write_end(header, topic->inbound, shm::INBOUND_QUEUE_SIZE, inbound_generation);
+	header->doorbell.fetch_add(1);
+	shm::futex_wake(header->doorbell);
+
+	px4_pollfd_struct_t fds{};
+	fds.fd = sfd;
+	fds.events = POLLIN;
+
+	if (px4_poll(&fds, 1, 1000) != 1) {
+		orb_unsubscribe(sfd);
+		return test_fail("inbound publication not received");
+	}
+
+	orb_copy(ORB_ID(orb_test_large), sfd, &u);
+	orb_unsubscribe(sfd);
+
+	if (u.val != 3) {
+		return test_fail("inbound copy mismatch: %d expected 3", u.val);
+	}
+
+	orb_unadvertise(ptopic);
+
+	return test_note("PASS shared memory");
+}
+#endif
+
 int uORBTest::UnitTest::test_fail(const char *fmt, ...)
 {
 	va_list ap;
@@ -115,6 +115,10 @@ private:
 	int test_queue_poll_notify();
 	volatile int _num_messages_sent = 0;
 
+#if defined(__PX4_LINUX)
+	int test_shared_memory();
+#endif
+
 	int test_fail(const char *fmt, ...);
 	int test_note(const char *fmt, ...);
 };
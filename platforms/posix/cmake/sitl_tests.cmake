@@ -24,6 +24,7 @@ set(tests
 	perf
 	search_min
 	sleep
+	SpscQueue
 	versioning
 )
 
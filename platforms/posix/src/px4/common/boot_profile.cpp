@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file boot_profile.cpp
+ *
+ * Boot profiler for POSIX, see px4_platform_common/boot_profile.h.
+ */
+
+#include <px4_platform_common/boot_profile.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+#include <algorithm>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr int BOOT_PROFILE_MAX_ENTRIES = 512;
+static constexpr int BOOT_PROFILE_SUMMARY_ENTRIES = 10;
+
+struct boot_profile_entry_s {
+	const char *type;
+	char name[64];
+	uint64_t start;
+	uint64_t duration;
+};
+
+static uint64_t monotonic_time_us()
+{
+	struct timespec ts;
+	system_clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static const uint64_t process_start_time = monotonic_time_us();
+
+static const char *boot_profile_file = getenv("PX4_BOOT_PROFILE");
+static bool boot_profile_recording = (boot_profile_file != nullptr) && (boot_profile_file[0] != '\0');
+
+static pthread_mutex_t boot_profile_mutex = PTHREAD_MUTEX_INITIALIZER;
+static boot_profile_entry_s boot_profile_entries[BOOT_PROFILE_MAX_ENTRIES];
+static int boot_profile_count = 0;
+
+bool px4_boot_profile_enabled()
+{
+	return boot_profile_recording;
+}
+
+uint64_t px4_boot_profile_time()
+{
+	return monotonic_time_us() - process_start_time;
+}
+
+void px4_boot_profile_record(const char *type, const char *name, uint64_t start)
+{
+	if (!boot_profile_recording) {
+		return;
+	}
+
+	const uint64_t now = px4_boot_profile_time();
+
+	pthread_mutex_lock(&boot_profile_mutex);
+
+	if (boot_profile_recording && boot_profile_count < BOOT_PROFILE_MAX_ENTRIES) {
+		boot_profile_entry_s &entry = boot_profile_entries[boot_profile_count++];
+		entry.type = type;
+		strncpy(entry.name, name, sizeof(entry.name) - 1);
+		entry.name[sizeof(entry.name) - 1] = '\0';
+		entry.start = start;
+		entry.duration = now - start;
+	}
+
+	pthread_mutex_unlock(&boot_profile_mutex);
+}
+
+static void print_slowest(const char *type)
+{
+	int indices[BOOT_PROFILE_MAX_ENTRIES];
+	int count = 0;
+	uint64_t total = 0;
+
+	for (int i = 0; i < boot_profile_count; i++) {
+		if (strcmp(boot_profile_entries[i].type, type) == 0) {
+			indices[count++] = i;
+			total += boot_profile_entries[i].duration;
+		}
+	}
+
+	std::sort(indices, indices + count, [](int a, int b) {
+		return boot_profile_entries[a].duration > boot_profile_entries[b].duration;
+	});
+
+	PX4_INFO("%s: %i, total %.1f ms, slowest:", type, count, (double)total * 1e-3);
+
+	for (int i = 0; i < count && i < BOOT_PROFILE_SUMMARY_ENTRIES; i++) {
+		const boot_profile_entry_s &entry = boot_profile_entries[indices[i]];
+		PX4_INFO_RAW("  %8.1f ms  %s\n", (double)entry.duration * 1e-3, entry.name);
+	}
+}
+
+void px4_boot_profile_finish()
+{
+	if (!boot_profile_recording) {
+		return;
+	}
+
+	const uint64_t boot_time = px4_boot_profile_time();
+
+	pthread_mutex_lock(&boot_profile_mutex);
+	boot_profile_recording = false;
+	pthread_mutex_unlock(&boot_profile_mutex);
+
+	FILE *file = fopen(boot_profile_file, "w");
+
+	if (file) {
+		fprintf(file, "type,name,start_ms,duration_ms\n");
+		fprintf(file, "boot,startup,0.000,%.3f\n", (double)boot_time * 1e-3);
+
+		for (int i = 0; i < boot_profile_count; i++) {
+			const boot_profile_entry_s &entry = boot_profile_entries[i];
+			fprintf(file, "%s,\"%s\",%.3f,%.3f\n", entry.type, entry.name, (double)entry.start * 1e-3,
+				(double)entry.duration * 1e-3);
+		}
+
+		fclose(file);
+
+	} else {
+		PX4_ERR("failed to open %s", boot_profile_file);
+	}
+
+	PX4_INFO("boot took %.1f ms (profile: %s)", (double)boot_time * 1e-3, boot_profile_file);
+	print_slowest("cmd");
+	print_slowest("task_spawn");
+
+	if (boot_profile_count == BOOT_PROFILE_MAX_ENTRIES) {
+		PX4_WARN("profile truncated to %i entries", BOOT_PROFILE_MAX_ENTRIES);
+	}
+}
@@ -46,6 +46,7 @@
 #include <drivers/drv_hrt.h>
 
 #include <semaphore.h>
+#include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <errno.h>
@@ -61,9 +62,12 @@ static constexpr unsigned HRT_INTERVAL_MIN = 50;
 static constexpr unsigned HRT_INTERVAL_MAX = 50000000;
 
 /*
- * Queue of callout entries.
+ * Callout entries, as a binary min-heap ordered by deadline. Every entry knows its
+ * position (heap_index), so entering and removing a callout is O(log n).
  */
-static struct sq_queue_s	callout_queue;
+static struct hrt_call		**callout_heap;
+static unsigned			callout_heap_size;
+static unsigned			callout_heap_capacity;
 
 /* latency baseline (last compare value applied) */
 static uint64_t			latency_baseline;
@@ -81,6 +85,9 @@ static struct work_s	_hrt_work;
 
 static void hrt_latency_update();
 
+static bool callout_heap_contains(struct hrt_call *entry);
+static void callout_heap_remove(struct hrt_call *entry);
+
 static void hrt_call_reschedule();
 static void hrt_call_invoke();
 
@@ -163,7 +170,11 @@ bool	hrt_called(struct hrt_call *entry)
 void	hrt_cancel(struct hrt_call *entry)
 {
 	hrt_lock();
-	sq_rem(&entry->link, &callout_queue);
+
+	if (callout_heap_contains(entry)) {
+		callout_heap_remove(entry);
+	}
+
 	entry->deadline = 0;
 
 	/* if this is a periodic call being removed by the callout, prevent it from
@@ -191,6 +202,106 @@ static void hrt_latency_update()
 	latency_counters[index]++;
 }
 
+static void callout_heap_set(unsigned index, struct hrt_call *entry)
+{
+	callout_heap[index] = entry;
+	entry->heap_index = index;
+}
+
+static void callout_heap_sift_up(unsigned index)
+{
+	struct hrt_call *entry = callout_heap[index];
+
+	while (index > 0) {
+		const unsigned parent = (index - 1) / 2;
+
+		if (callout_heap[parent]->deadline <= entry->deadline) {
+			break;
+		}
+
+		callout_heap_set(index, callout_heap[parent]);
+		index = parent;
+	}
+
+	callout_heap_set(index, entry);
+}
+
+static void callout_heap_sift_down(unsigned index)
+{
+	struct hrt_call *entry = callout_heap[index];
+
+	while (true) {
+		unsigned child = 2 * index + 1;
+
+		if (child >= callout_heap_size) {
+			break;
+		}
+
+		if ((child + 1 < callout_heap_size) && (callout_heap[child + 1]->deadline < callout_heap[child]->deadline)) {
+			child++;
+		}
+
+		if (entry->deadline <= callout_heap[child]->deadline) {
+			break;
+		}
+
+		callout_heap_set(index, callout_heap[child]);
+		index = child;
+	}
+
+	callout_heap_set(index, entry);
+}
+
+/*
+ * The entry may be uninitialised, so only trust heap_index if it points back to the entry.
+ */
+static bool callout_heap_contains(struct hrt_call *entry)
+{
+	return (entry->heap_index < callout_heap_size) && (callout_heap[entry->heap_index] == entry);
+}
+
+static bool callout_heap_insert(struct hrt_call *entry)
+{
+	if (callout_heap_size == callout_heap_capacity) {
+		const unsigned capacity = (callout_heap_capacity > 0) ? 2 * callout_heap_capacity : 32;
+		struct hrt_call **heap = (struct hrt_call **)realloc(callout_heap, capacity * sizeof(struct hrt_call *));
+
+		if (heap == nullptr) {
+			PX4_ERR("callout heap alloc failed");
+			return false;
+		}
+
+		callout_heap = heap;
+		callout_heap_capacity = capacity;
+	}
+
+	callout_heap_set(callout_heap_size, entry);
+	callout_heap_sift_up(callout_heap_size++);
+	return true;
+}
+
+static void callout_heap_remove(struct hrt_call *entry)
+{
+	const unsigned index = entry->heap_index;
+	struct hrt_call *last = callout_heap[--callout_heap_size];
+
+	if (last != entry) {
+		callout_heap_set(index, last);
+
+		if ((index > 0) && (last->deadline < callout_heap[(index - 1) / 2]->deadline)) {
+			callout_heap_sift_up(index);
+
+		} else {
+			callout_heap_sift_down(index);
+		}
+	}
+}
+
+static struct hrt_call *callout_heap_peek()
+{
+	return (callout_heap_size > 0) ? callout_heap[0] : nullptr;
+}
+
 /*
  * initialise a hrt_call structure
  */
@@ -216,7 +327,7 @@ void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay)
  */
 void	hrt_init()
 {
-	sq_init(&callout_queue);
+	callout_heap_size = 0;
 
 	int sem_ret = px4_sem_init(&_hrt_lock, 0, 1);
 
@@ -230,26 +341,14 @@ void	hrt_init()
 static void
 hrt_call_enter(struct hrt_call *entry)
 {
-	struct hrt_call	*call, *next;
-
-	call = (struct hrt_call *)sq_peek(&callout_queue);
+	if (!callout_heap_insert(entry)) {
+		entry->deadline = 0;
+		return;
+	}
 
-	if ((call == nullptr) || (entry->deadline < call->deadline)) {
-		sq_addfirst(&entry->link, &callout_queue);
-		//if (call != nullptr) PX4_INFO("call enter at head, reschedule (%lu %lu)", entry->deadline, call->deadline);
+	if (entry->heap_index == 0) {
 		/* we changed the next deadline, reschedule the timer event */
 		hrt_call_reschedule();
-
-	} else {
-		do {
-			next = (struct hrt_call *)sq_next(&call->link);
-
-			if ((next == nullptr) || (entry->deadline < next->deadline)) {
-				//lldbg("call enter after head\n");
-				sq_addafter(&call->link, &entry->link, &callout_queue);
-				break;
-			}
-		} while ((call = next) != nullptr);
 	}
 }
 
@@ -288,7 +387,7 @@ hrt_call_reschedule()
 {
 	hrt_abstime	now = hrt_absolute_time();
 	hrt_abstime	delay = HRT_INTERVAL_MAX;
-	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
+	struct hrt_call	*next = callout_heap_peek();
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
 	/*
@@ -336,15 +435,15 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 
 	//PX4_INFO("hrt_call_internal after lock");
 	/* if the entry is currently queued, remove it */
-	/* note that we are using a potentially uninitialised
-	   entry->link here, but it is safe as sq_rem() doesn't
-	   dereference the passed node unless it is found in the
-	   list. So we potentially waste a bit of time searching the
-	   queue for the uninitialised entry->link but we don't do
-	   anything actually unsafe.
-	*/
-	if (entry->deadline != 0) {
-		sq_rem(&entry->link, &callout_queue);
+	if (callout_heap_contains(entry)) {
+		callout_heap_remove(entry);
+	}
+
+	/* keep the jitter statistics of callouts that re-arm themselves */
+	if ((entry->callout != callout) || (entry->arg != arg)) {
+		entry->jitter_count = 0;
+		entry->jitter_sum = 0;
+		entry->jitter_max = 0;
 	}
 
 #if 1
@@ -416,7 +515,7 @@ hrt_call_invoke()
 		/* get the current time */
 		hrt_abstime now = hrt_absolute_time();
 
-		call = (struct hrt_call *)sq_peek(&callout_queue);
+		call = callout_heap_peek();
 
 		if (call == nullptr) {
 			break;
@@ -426,12 +525,21 @@ hrt_call_invoke()
 			break;
 		}
 
-		sq_rem(&call->link, &callout_queue);
+		callout_heap_remove(call);
 		//PX4_INFO("call pop");
 
 		/* save the intended deadline for periodic calls */
 		deadline = call->deadline;
 
+		/* track how late the call is invoked */
+		const hrt_abstime jitter = now - deadline;
+		call->jitter_count++;
+		call->jitter_sum += jitter;
+
+		if (jitter > call->jitter_max) {
+			call->jitter_max = jitter;
+		}
+
 		/* zero the deadline, as the call has occurred */
 		call->deadline = 0;
 
@@ -446,8 +554,8 @@ hrt_call_invoke()
 			hrt_lock();
 		}
 
-		/* if the callout has a non-zero period, it has to be re-entered */
-		if (call->period != 0) {
+		/* if the callout has a non-zero period, it has to be re-entered (unless it did so itself) */
+		if ((call->period != 0) && !callout_heap_contains(call)) {
 			// re-check call->deadline to allow for
 			// callouts to re-schedule themselves
 			// using hrt_call_delay()
@@ -463,6 +571,37 @@ hrt_call_invoke()
 	hrt_unlock();
 }
 
+void hrt_print_callout_jitter(int fd)
+{
+	hrt_lock();
+
+	dprintf(fd, "callouts: %u\n", callout_heap_size);
+	dprintf(fd, "%-18s %-18s %10s %10s %10s %10s\n", "callout", "arg", "period", "calls", "mean [us]", "max [us]");
+
+	for (unsigned i = 0; i < callout_heap_size; i++) {
+		const struct hrt_call *call = callout_heap[i];
+		const unsigned mean = (call->jitter_count > 0) ? (unsigned)(call->jitter_sum / call->jitter_count) : 0;
+
+		dprintf(fd, "%-18p %-18p %10" PRIu64 " %10" PRIu32 " %10u %10" PRIu64 "\n", (void *)call->callout, call->arg,
+			call->period, call->jitter_count, mean, call->jitter_max);
+	}
+
+	hrt_unlock();
+}
+
+void hrt_reset_callout_jitter()
+{
+	hrt_lock();
+
+	for (unsigned i = 0; i < callout_heap_size; i++) {
+		callout_heap[i]->jitter_count = 0;
+		callout_heap[i]->jitter_sum = 0;
+		callout_heap[i]->jitter_max = 0;
+	}
+
+	hrt_unlock();
+}
+
 int px4_clock_gettime(clockid_t clk_id, struct timespec *tp)
 {
 	if (clk_id == CLOCK_MONOTONIC) {
@@ -75,10 +75,10 @@ private:
 			}
 
 			// If a thread quickly exits after a cond_timedwait(), the
-			// thread_local object can still be in the linked list. In that case
-			// we need to wait until it's removed.
-			while (!removed) {
-				system_usleep(5000);
+			// thread_local object can still be in the heap (its deadline
+			// has not passed yet). In that case we need to remove it.
+			if (!removed) {
+				scheduler->remove_timed_wait(this);
 			}
 		}
 
@@ -89,14 +89,23 @@ private:
 		std::atomic<bool> done{false};
 		std::atomic<bool> removed{true};
 
-		TimedWait *next{nullptr}; ///< linked list
+		LockstepScheduler *scheduler{nullptr}; ///< scheduler the object is queued in (if not removed)
+		size_t heap_index{0}; ///< position in _timed_waits (if not removed)
 	};
 
+	void remove_timed_wait(TimedWait *timed_wait);
+
+	// binary min-heap of _timed_waits ordered by time_us, _timed_waits_mutex must be held
+	void heap_push(TimedWait *timed_wait);
+	void heap_erase(size_t index);
+	void heap_sift_up(size_t index);
+	void heap_sift_down(size_t index);
+
 	LockstepComponents _components;
 
 	std::atomic<uint64_t> _time_us{0};
 
-	TimedWait *_timed_waits{nullptr}; ///< head of linked list
+	std::vector<TimedWait *> _timed_waits; ///< heap of the pending waits, earliest deadline first
 	std::mutex _timed_waits_mutex;
 	std::atomic<bool> _setting_time{false}; ///< true if set_absolute_time() is currently being executed
 };
@@ -35,14 +35,14 @@
 
 LockstepScheduler::~LockstepScheduler()
 {
-	// cleanup the linked list
+	// cleanup the heap
 	std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
 
-	while (_timed_waits) {
-		TimedWait *tmp = _timed_waits;
-		_timed_waits = _timed_waits->next;
-		tmp->removed = true;
+	for (TimedWait *timed_wait : _timed_waits) {
+		timed_wait->removed = true;
 	}
+
+	_timed_waits.clear();
 }
 
 void LockstepScheduler::set_absolute_time(uint64_t time_us)
@@ -53,28 +53,13 @@ void LockstepScheduler::set_absolute_time(uint64_t time_us)
 		std::unique_lock<std::mutex> lock_timed_waits(_timed_waits_mutex);
 		_setting_time = true;
 
-		TimedWait *timed_wait = _timed_waits;
-		TimedWait *timed_wait_prev = nullptr;
-
-		while (timed_wait) {
-			// Clean up the ones that are already done from last iteration.
-			if (timed_wait->done) {
-				// Erase from the linked list
-				if (timed_wait_prev) {
-					timed_wait_prev->next = timed_wait->next;
-
-				} else {
-					_timed_waits = timed_wait->next;
-				}
+		// Only the expired entries are visited, earliest deadline first.
+		while (!_timed_waits.empty() && _timed_waits.front()->time_us <= time_us) {
+			TimedWait *timed_wait = _timed_waits.front();
+			heap_erase(0);
 
-				TimedWait *tmp = timed_wait;
-				timed_wait = timed_wait->next;
-				tmp->removed = true;
-				continue;
-			}
-
-			if (timed_wait->time_us <= time_us &&
-			    !timed_wait->timeout) {
+			// The ones that are already done got woken up before their deadline.
+			if (!timed_wait->done) {
 				// We are abusing the condition here to signal that the time
 				// has passed.
 				pthread_mutex_lock(timed_wait->passed_lock);
@@ -83,8 +68,7 @@ void LockstepScheduler::set_absolute_time(uint64_t time_us)
 				pthread_mutex_unlock(timed_wait->passed_lock);
 			}
 
-			timed_wait_prev = timed_wait;
-			timed_wait = timed_wait->next;
+			timed_wait->removed = true;
 		}
 
 		_setting_time = false;
@@ -93,7 +77,7 @@ void LockstepScheduler::set_absolute_time(uint64_t time_us)
 
 int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *lock, uint64_t time_us)
 {
-	// A TimedWait object might still be in timed_waits_ after we return, so its lifetime needs to be
+	// A TimedWait object might still be in _timed_waits after we return, so its lifetime needs to be
 	// longer. And using thread_local is more efficient than malloc.
 	static thread_local TimedWait timed_wait;
 	{
@@ -110,11 +94,16 @@ int LockstepScheduler::cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *loc
 		timed_wait.timeout = false;
 		timed_wait.done = false;
 
-		// Add to linked list if not removed yet (otherwise just re-use the object)
+		// Add to the heap if removed already, otherwise re-use the object and
+		// restore the heap order for the new deadline
 		if (timed_wait.removed) {
 			timed_wait.removed = false;
-			timed_wait.next = _timed_waits;
-			_timed_waits = &timed_wait;
+			timed_wait.scheduler = this;
+			heap_push(&timed_wait);
+
+		} else {
+			heap_sift_up(timed_wait.heap_index);
+			heap_sift_down(timed_wait.heap_index);
 		}
 	}
 
@@ -165,3 +154,86 @@ int LockstepScheduler::usleep_until(uint64_t time_us)
 
 	return result;
 }
+
+void LockstepScheduler::remove_timed_wait(TimedWait *timed_wait)
+{
+	std::lock_guard<std::mutex> lock_timed_waits(_timed_waits_mutex);
+
+	if (!timed_wait->removed) {
+		heap_erase(timed_wait->heap_index);
+		timed_wait->removed = true;
+	}
+}
+
+void LockstepScheduler::heap_push(TimedWait *timed_wait)
+{
+	timed_wait->heap_index = _timed_waits.size();
+	_timed_waits.push_back(timed_wait);
+	heap_sift_up(timed_wait->heap_index);
+}
+
+void LockstepScheduler::heap_erase(size_t index)
+{
+	const size_t last = _timed_waits.size() - 1;
+
+	if (index != last) {
+		_timed_waits[index] = _timed_waits[last];
+		_timed_waits[index]->heap_index = index;
+		_timed_waits.pop_back();
+
+		heap_sift_up(index);
+		heap_sift_down(index);
+
+	} else {
+		_timed_waits.pop_back();
+	}
+}
+
+void LockstepScheduler::heap_sift_up(size_t index)
+{
+	TimedWait *timed_wait = _timed_waits[index];
+
+	while (index > 0) {
+		const size_t parent = (index - 1) / 2;
+
+		if (_timed_waits[parent]->time_us <= timed_wait->time_us) {
+			break;
+		}
+
+		_timed_waits[index] = _timed_waits[parent];
+		_timed_waits[index]->heap_index = index;
+		index = parent;
+	}
+
+	_timed_waits[index] = timed_wait;
+	timed_wait->heap_index = index;
+}
+
+void LockstepScheduler::heap_sift_down(size_t index)
+{
+	const size_t size = _timed_waits.size();
+	TimedWait *timed_wait = _timed_waits[index];
+
+	while (true) {
+		size_t child = 2 * index + 1;
+
+		if (child >= size) {
+			break;
+		}
+
+		if (child + 1 < size && _timed_waits[child + 1]->time_us < _timed_waits[child]->time_us) {
+			++child;
+		}
+
+		if (timed_wait->time_us <= _timed_waits[child]->time_us) {
+			break;
+		}
+
+		_timed_waits[index] = _timed_waits[child];
+		_timed_waits[index]->heap_index = index;
+		index = child;
+	}
+
+	_timed_waits[index] = timed_wait;
+	timed_wait->heap_index = index;
+}
@@ -307,6 +307,61 @@ void test_usleep()
 	thread.join(ls);
 }
 
+void test_step_rate(int num_waiters)
+{
+	LockstepScheduler ls;
+	ls.set_absolute_time(some_time_us);
+
+	std::atomic<bool> stop{false};
+	std::atomic<int> num_running{0};
+	std::vector<std::thread> threads;
+
+	// Waiters sleep with a spread of intervals (5 ms - 50 ms), like modules running at
+	// different rates, so only a few of them expire per step.
+	for (int i = 0; i < num_waiters; ++i) {
+		const uint64_t interval_us = 5000 + (i % 10) * 5000;
+		++num_running;
+		threads.emplace_back([&ls, &stop, &num_running, interval_us]() {
+			while (!stop) {
+				ls.usleep_until(ls.get_absolute_time() + interval_us);
+			}
+
+			--num_running;
+		});
+	}
+
+	const int num_steps = 20000;
+	const uint64_t step_us = 100;
+	uint64_t time_us = some_time_us;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int step = 0; step < num_steps; ++step) {
+		time_us += step_us;
+		ls.set_absolute_time(time_us);
+		// Give the woken up threads a chance to wait again, as they would in a lockstep cycle.
+		std::this_thread::yield();
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	// Keep advancing the time until every waiter returned.
+	stop = true;
+
+	while (num_running > 0) {
+		time_us += step_us;
+		ls.set_absolute_time(time_us);
+		std::this_thread::yield();
+	}
+
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	const double elapsed_s = std::chrono::duration<double>(end - start).count();
+	std::cout << num_waiters << " waiters: " << static_cast<int>(num_steps / elapsed_s) << " steps/s\n";
+}
+
 TEST(LockstepScheduler, All)
 {
 	for (unsigned iteration = 1; iteration <= 100; ++iteration) {
@@ -318,3 +373,10 @@ TEST(LockstepScheduler, All)
 		test_multiple_semaphores_waiting();
 	}
 }
+
+TEST(LockstepScheduler, StepRate)
+{
+	for (int num_waiters : {10, 100, 500}) {
+		test_step_rate(num_waiters);
+	}
+}
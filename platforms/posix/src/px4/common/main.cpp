@@ -67,6 +67,7 @@
 #include <sys/mman.h>
 #endif
 
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/time.h>
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/init.h>
@@ -345,6 +346,8 @@ int main(int argc, char **argv)
 
 		ret = run_startup_script(commands_file, absolute_binary_path, instance);
 
+		px4_boot_profile_finish();
+
 		if (ret != 0) {
 			return PX4_ERROR;
 		}
@@ -52,6 +52,7 @@
 #include <sys/un.h>
 #include <vector>
 
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/log.h>
 
 #include "pxh.h"
@@ -279,7 +280,9 @@ void
 	}
 
 	// Run the actual command.
+	const uint64_t profile_start = px4_boot_profile_time();
 	int retval = Pxh::process_line(cmd, true);
+	px4_boot_profile_record("cmd", cmd.c_str(), profile_start);
 
 	// Report return value.
 	char buf[2] = {0, (char)retval};
@@ -84,6 +84,12 @@ typedef struct hrt_call {
 	hrt_callout		usr_callout;
 	void			*usr_arg;
 #endif
+#if defined(__PX4_POSIX)
+	unsigned		heap_index;	/* position in the callout heap while queued */
+	uint32_t		jitter_count;	/* number of invocations since the last reset */
+	hrt_abstime		jitter_sum;	/* sum of the invocation delays after the deadline [us] */
+	hrt_abstime		jitter_max;	/* largest invocation delay after the deadline [us] */
+#endif
 } *hrt_call_t;
 
 
@@ -278,6 +284,20 @@ void reset_latency_counters(void);
 
 #endif
 
+#if defined(__PX4_POSIX)
+
+/**
+ * Print the invocation jitter (delay after the deadline) of every queued callout.
+ */
+__EXPORT extern void hrt_print_callout_jitter(int fd);
+
+/**
+ * Reset the invocation jitter statistics of every queued callout.
+ */
+__EXPORT extern void hrt_reset_callout_jitter(void);
+
+#endif
+
 __END_DECLS
 
 
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SpscQueue.hpp
+ *
+ * Lock-free, fixed-capacity queue for exactly one producer and one consumer thread.
+ * push() must only be called from the producer and pop() only from the consumer.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <px4_platform_common/atomic.h>
+
+template<class T, size_t N>
+class SpscQueue
+{
+public:
+	static_assert(N > 1, "SpscQueue needs at least 2 slots");
+
+	SpscQueue() = default;
+	~SpscQueue() = default;
+
+	/**
+	 * Copy an item into the queue (producer only).
+	 * @return false if the queue is full
+	 */
+	bool push(const T &item)
+	{
+		const size_t tail = _tail.load();
+		const size_t next = (tail + 1) % N;
+
+		if (next == _head.load()) {
+			return false;
+		}
+
+		_data[tail] = item;
+		_tail.store(next);
+		return true;
+	}
+
+	/**
+	 * Copy the oldest item out of the queue (consumer only).
+	 * @return false if the queue is empty
+	 */
+	bool pop(T &item)
+	{
+		const size_t head = _head.load();
+
+		if (head == _tail.load()) {
+			return false;
+		}
+
+		item = _data[head];
+		_head.store((head + 1) % N);
+		return true;
+	}
+
+	bool empty() const { return _head.load() == _tail.load(); }
+
+	size_t size() const
+	{
+		const size_t head = _head.load();
+		const size_t tail = _tail.load();
+		return (tail >= head) ? (tail - head) : (N - head + tail);
+	}
+
+	/**
+	 * Maximum number of items that can be queued at the same time.
+	 */
+	static constexpr size_t capacity() { return N - 1; }
+
+private:
+	T _data[N] {};
+
+	px4::atomic<size_t> _head{0}; ///< next slot to read, only written by the consumer
+	px4::atomic<size_t> _tail{0}; ///< next slot to write, only written by the producer
+
+	// Disallow copy construction and move assignment.
+	SpscQueue(const SpscQueue &) = delete;
+	SpscQueue &operator=(const SpscQueue &) = delete;
+};
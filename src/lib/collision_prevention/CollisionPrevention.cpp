@@ -45,20 +45,20 @@ using namespace time_literals;
 
 namespace
 {
-static constexpr int INTERNAL_MAP_INCREMENT_DEG = 10; //cannot be lower than 5 degrees, should divide 360 evenly
-static constexpr int INTERNAL_MAP_USED_BINS = 360 / INTERNAL_MAP_INCREMENT_DEG;
+static constexpr int OBSTACLE_MSG_BINS = sizeof(obstacle_distance_s::distances) / sizeof(obstacle_distance_s::distances[0]);
+static constexpr float OBSTACLE_MSG_MIN_INCREMENT_DEG = 360.f / OBSTACLE_MSG_BINS;
 
 static float wrap_360(float f)
 {
 	return wrap(f, 0.f, 360.f);
 }
 
-static int wrap_bin(int i)
+static int wrap_bin(int i, int bins)
 {
-	i = i % INTERNAL_MAP_USED_BINS;
+	i = i % bins;
 
 	while (i < 0) {
-		i += INTERNAL_MAP_USED_BINS;
+		i += bins;
 	}
 
 	return i;
@@ -69,24 +69,44 @@ static int wrap_bin(int i)
 CollisionPrevention::CollisionPrevention(ModuleParams *parent) :
 	ModuleParams(parent)
 {
-	static_assert(INTERNAL_MAP_INCREMENT_DEG >= 5, "INTERNAL_MAP_INCREMENT_DEG needs to be at least 5");
-	static_assert(360 % INTERNAL_MAP_INCREMENT_DEG == 0, "INTERNAL_MAP_INCREMENT_DEG should divide 360 evenly");
+	static_assert(360 % MAP_MAX_BINS == 0, "MAP_MAX_BINS should divide 360 evenly");
+	static_assert(MAP_MIN_INCREMENT_DEG <= MAP_MAX_INCREMENT_DEG, "MAP_MAX_BINS too small");
 
 	// initialize internal obstacle map
+	_obstacle_map_body_frame.angle_offset = 0.f;
+	_setMapResolution(_param_cp_map_res.get());
+}
+
+void
+CollisionPrevention::_setMapResolution(int32_t resolution_deg)
+{
+	_map_resolution_deg = resolution_deg;
+
+	// the bins need to divide 360 evenly, fall back to the next finer valid resolution
+	int increment = math::constrain((int)resolution_deg, MAP_MIN_INCREMENT_DEG, MAP_MAX_INCREMENT_DEG);
+
+	while (360 % increment != 0) {
+		increment--;
+	}
+
+	_map_bins = 360 / increment;
+
 	_obstacle_map_body_frame.timestamp = getTime();
-	_obstacle_map_body_frame.frame = obstacle_distance_s::MAV_FRAME_BODY_FRD;
-	_obstacle_map_body_frame.increment = INTERNAL_MAP_INCREMENT_DEG;
+	_obstacle_map_body_frame.increment = increment;
 	_obstacle_map_body_frame.min_distance = UINT16_MAX;
 	_obstacle_map_body_frame.max_distance = 0;
-	_obstacle_map_body_frame.angle_offset = 0.f;
-	uint32_t internal_bins = sizeof(_obstacle_map_body_frame.distances) / sizeof(_obstacle_map_body_frame.distances[0]);
 	uint64_t current_time = getTime();
 
-	for (uint32_t i = 0 ; i < internal_bins; i++) {
+	for (int i = 0 ; i < MAP_MAX_BINS; i++) {
 		_data_timestamps[i] = current_time;
 		_data_maxranges[i] = 0;
 		_data_fov[i] = 0;
 		_obstacle_map_body_frame.distances[i] = UINT16_MAX;
+
+		// bin directions in body frame, only rotated by the vehicle yaw when constraining the setpoint
+		const float angle = math::radians((float)i * increment + _obstacle_map_body_frame.angle_offset);
+		_bin_cos[i] = cosf(angle);
+		_bin_sin[i] = sinf(angle);
 	}
 }
 
@@ -118,14 +138,25 @@ CollisionPrevention::_addObstacleSensorData(const obstacle_distance_s &obstacle,
 	int msg_index = 0;
 	float vehicle_orientation_deg = math::degrees(Eulerf(vehicle_attitude).psi());
 	float increment_factor = 1.f / obstacle.increment;
+	const int msg_bins = (int)ceilf(360.f * increment_factor);
+	const float map_increment = _obstacle_map_body_frame.increment;
 
 	if (obstacle.frame == obstacle.MAV_FRAME_GLOBAL || obstacle.frame == obstacle.MAV_FRAME_LOCAL_NED) {
 		// Obstacle message arrives in local_origin frame (north aligned)
 		// corresponding data index (convert to world frame and shift by msg offset)
-		for (int i = 0; i < INTERNAL_MAP_USED_BINS; i++) {
-			float bin_angle_deg = (float)i * INTERNAL_MAP_INCREMENT_DEG + _obstacle_map_body_frame.angle_offset;
+		for (int i = 0; i < _map_bins; i++) {
+			float bin_angle_deg = (float)i * map_increment + _obstacle_map_body_frame.angle_offset;
 			msg_index = ceil(wrap_360(vehicle_orientation_deg + bin_angle_deg - obstacle.angle_offset) * increment_factor);
 
+			// the last partial bin wraps around to the first one
+			if (msg_index >= msg_bins) {
+				msg_index = 0;
+			}
+
+			if (msg_index >= OBSTACLE_MSG_BINS) {
+				continue;
+			}
+
 			//add all data points inside to FOV
 			if (obstacle.distances[msg_index] != UINT16_MAX) {
 				if (_enterData(i, obstacle.max_distance * 0.01f, obstacle.distances[msg_index] * 0.01f)) {
@@ -140,11 +171,19 @@ CollisionPrevention::_addObstacleSensorData(const obstacle_distance_s &obstacle,
 	} else if (obstacle.frame == obstacle.MAV_FRAME_BODY_FRD) {
 		// Obstacle message arrives in body frame (front aligned)
 		// corresponding data index (shift by msg offset)
-		for (int i = 0; i < INTERNAL_MAP_USED_BINS; i++) {
-			float bin_angle_deg = (float)i * INTERNAL_MAP_INCREMENT_DEG +
-					      _obstacle_map_body_frame.angle_offset;
+		for (int i = 0; i < _map_bins; i++) {
+			float bin_angle_deg = (float)i * map_increment + _obstacle_map_body_frame.angle_offset;
 			msg_index = ceil(wrap_360(bin_angle_deg - obstacle.angle_offset) * increment_factor);
 
+			// the last partial bin wraps around to the first one
+			if (msg_index >= msg_bins) {
+				msg_index = 0;
+			}
+
+			if (msg_index >= OBSTACLE_MSG_BINS) {
+				continue;
+			}
+
 			//add all data points inside to FOV
 			if (obstacle.distances[msg_index] != UINT16_MAX) {
 
@@ -202,6 +241,10 @@ CollisionPrevention::_updateObstacleMap()
 {
 	_sub_vehicle_attitude.update();
 
+	if (_param_cp_map_res.get() != _map_resolution_deg) {
+		_setMapResolution(_param_cp_map_res.get());
+	}
+
 	// add distance sensor data
 	for (auto &dist_sens_sub : _distance_sensor_subs) {
 		distance_sensor_s distance_sensor;
@@ -241,7 +284,33 @@ CollisionPrevention::_updateObstacleMap()
 	}
 
 	// publish fused obtacle distance message with data from offboard obstacle_distance and distance sensor
-	_obstacle_distance_pub.publish(_obstacle_map_body_frame);
+	_publishObstacleDistance();
+}
+
+void
+CollisionPrevention::_publishObstacleDistance()
+{
+	obstacle_distance_s obstacle{};
+	obstacle.timestamp = _obstacle_map_body_frame.timestamp;
+	obstacle.frame = obstacle_distance_s::MAV_FRAME_BODY_FRD;
+	obstacle.angle_offset = _obstacle_map_body_frame.angle_offset;
+	obstacle.min_distance = _obstacle_map_body_frame.min_distance;
+	obstacle.max_distance = _obstacle_map_body_frame.max_distance;
+	obstacle.increment = math::max(_obstacle_map_body_frame.increment, OBSTACLE_MSG_MIN_INCREMENT_DEG);
+
+	for (int i = 0; i < OBSTACLE_MSG_BINS; i++) {
+		obstacle.distances[i] = UINT16_MAX;
+	}
+
+	// message bins are at least as wide as the map bins, keep the closest obstacle of all map bins falling into one
+	const float index_factor = _obstacle_map_body_frame.increment / obstacle.increment;
+
+	for (int i = 0; i < _map_bins; i++) {
+		const int msg_index = (int)((float)i * index_factor);
+		obstacle.distances[msg_index] = math::min(obstacle.distances[msg_index], _obstacle_map_body_frame.distances[i]);
+	}
+
+	_obstacle_distance_pub.publish(obstacle);
 }
 
 void
@@ -258,9 +327,9 @@ CollisionPrevention::_addDistanceSensorData(distance_sensor_s &distance_sensor,
 
 		// calculate the field of view boundary bin indices
 		int lower_bound = (int)floor((sensor_yaw_body_deg  - math::degrees(distance_sensor.h_fov / 2.0f)) /
-					     INTERNAL_MAP_INCREMENT_DEG);
+					     _obstacle_map_body_frame.increment);
 		int upper_bound = (int)floor((sensor_yaw_body_deg  + math::degrees(distance_sensor.h_fov / 2.0f)) /
-					     INTERNAL_MAP_INCREMENT_DEG);
+					     _obstacle_map_body_frame.increment);
 
 		// floor values above zero, ceil values below zero
 		if (lower_bound < 0) { lower_bound++; }
@@ -277,12 +346,16 @@ CollisionPrevention::_addDistanceSensorData(distance_sensor_s &distance_sensor,
 		}
 
 		uint16_t sensor_range = static_cast<uint16_t>(100.0f * distance_sensor.max_distance + 0.5f); // convert to cm
+		const uint16_t distance_reading_cm = static_cast<uint16_t>(100.0f * distance_reading + 0.5f);
+
+		// a sensor wider than 360 degrees must not update the same bins twice
+		upper_bound = math::min(upper_bound, lower_bound + _map_bins - 1);
 
 		for (int bin = lower_bound; bin <= upper_bound; ++bin) {
-			int wrapped_bin = wrap_bin(bin);
+			int wrapped_bin = wrap_bin(bin, _map_bins);
 
 			if (_enterData(wrapped_bin, distance_sensor.max_distance, distance_reading)) {
-				_obstacle_map_body_frame.distances[wrapped_bin] = static_cast<uint16_t>(100.0f * distance_reading + 0.5f);
+				_obstacle_map_body_frame.distances[wrapped_bin] = distance_reading_cm;
 				_data_timestamps[wrapped_bin] = _obstacle_map_body_frame.timestamp;
 				_data_maxranges[wrapped_bin] = sensor_range;
 				_data_fov[wrapped_bin] = 1;
@@ -295,19 +368,23 @@ void
 CollisionPrevention::_adaptSetpointDirection(Vector2f &setpoint_dir, int &setpoint_index, float vehicle_yaw_angle_rad)
 {
 	const float col_prev_d = _param_cp_dist.get();
-	const int guidance_bins = floor(_param_cp_guide_ang.get() / INTERNAL_MAP_INCREMENT_DEG);
+	const float increment = _obstacle_map_body_frame.increment;
+	const int guidance_bins = floor(_param_cp_guide_ang.get() / increment);
 	const int sp_index_original = setpoint_index;
 	float best_cost = 9999.f;
 	int new_sp_index = setpoint_index;
 
+	// keep the filter window and the deviation cost per degree independent of the map resolution
+	const int filter_size = math::max(1, (int)roundf(MAP_MAX_INCREMENT_DEG / increment));
+	const float deviation_cost_per_bin = col_prev_d * 50.f * increment / MAP_MAX_INCREMENT_DEG;
+
 	for (int i = sp_index_original - guidance_bins; i <= sp_index_original + guidance_bins; i++) {
 
 		// apply moving average filter to the distance array to be able to center in larger gaps
-		const int filter_size = 1;
 		float mean_dist = 0;
 
 		for (int j = i - filter_size; j <= i + filter_size; j++) {
-			int bin = wrap_bin(j);
+			int bin = wrap_bin(j, _map_bins);
 
 			if (_obstacle_map_body_frame.distances[bin] == UINT16_MAX) {
 				mean_dist += col_prev_d * 100.f;
@@ -317,9 +394,9 @@ CollisionPrevention::_adaptSetpointDirection(Vector2f &setpoint_dir, int &setpoi
 			}
 		}
 
-		const int bin = wrap_bin(i);
+		const int bin = wrap_bin(i, _map_bins);
 		mean_dist = mean_dist / (2.f * filter_size + 1.f);
-		const float deviation_cost = col_prev_d * 50.f * abs(i - sp_index_original);
+		const float deviation_cost = deviation_cost_per_bin * abs(i - sp_index_original);
 		const float bin_cost = deviation_cost - mean_dist - _obstacle_map_body_frame.distances[bin];
 
 		if (bin_cost < best_cost && _obstacle_map_body_frame.distances[bin] != UINT16_MAX) {
@@ -330,9 +407,11 @@ CollisionPrevention::_adaptSetpointDirection(Vector2f &setpoint_dir, int &setpoi
 
 	//only change setpoint direction if it was moved to a different bin
 	if (new_sp_index != setpoint_index) {
-		float angle = math::radians((float)new_sp_index * INTERNAL_MAP_INCREMENT_DEG + _obstacle_map_body_frame.angle_offset);
-		angle = wrap_2pi(vehicle_yaw_angle_rad + angle);
-		setpoint_dir = {cosf(angle), sinf(angle)};
+		const float yaw_cos = cosf(vehicle_yaw_angle_rad);
+		const float yaw_sin = sinf(vehicle_yaw_angle_rad);
+		setpoint_dir = {_bin_cos[new_sp_index] * yaw_cos - _bin_sin[new_sp_index] * yaw_sin,
+				_bin_sin[new_sp_index] * yaw_cos + _bin_cos[new_sp_index] * yaw_sin
+			       };
 		setpoint_index = new_sp_index;
 	}
 }
@@ -414,40 +493,39 @@ CollisionPrevention::_calculateConstrainedSetpoint(Vector2f &setpoint, const Vec
 			const float sp_angle_body_frame = atan2f(setpoint_dir(1), setpoint_dir(0)) - vehicle_yaw_angle_rad;
 			const float sp_angle_with_offset_deg = wrap_360(math::degrees(sp_angle_body_frame) -
 							       _obstacle_map_body_frame.angle_offset);
-			int sp_index = floor(sp_angle_with_offset_deg / INTERNAL_MAP_INCREMENT_DEG);
+			int sp_index = floor(sp_angle_with_offset_deg / _obstacle_map_body_frame.increment);
 
 			// change setpoint direction slightly (max by _param_cp_guide_ang degrees) to help guide through narrow gaps
 			_adaptSetpointDirection(setpoint_dir, sp_index, vehicle_yaw_angle_rad);
 
-			// limit speed for safe flight
-			for (int i = 0; i < INTERNAL_MAP_USED_BINS; i++) { // disregard unused bins at the end of the message
-
-				// delete stale values
-				const hrt_abstime data_age = constrain_time - _data_timestamps[i];
-
-				if (data_age > RANGE_STREAM_TIMEOUT_US) {
-					_obstacle_map_body_frame.distances[i] = UINT16_MAX;
-				}
-
-				const float distance = _obstacle_map_body_frame.distances[i] * 0.01f; // convert to meters
-				const float max_range = _data_maxranges[i] * 0.01f; // convert to meters
-				float angle = math::radians((float)i * INTERNAL_MAP_INCREMENT_DEG + _obstacle_map_body_frame.angle_offset);
-
-				// convert from body to local frame in the range [0, 2*pi]
-				angle = wrap_2pi(vehicle_yaw_angle_rad + angle);
+			// delete stale values and count the number of bins in the field of view,
+			// kept free of branches so the compiler can vectorize it for fine map resolutions
+			for (int i = 0; i < _map_bins; i++) {
+				const bool stale = (constrain_time - _data_timestamps[i]) > RANGE_STREAM_TIMEOUT_US;
+				_obstacle_map_body_frame.distances[i] = stale ? UINT16_MAX : _obstacle_map_body_frame.distances[i];
+				num_fov_bins += (_obstacle_map_body_frame.distances[i] < UINT16_MAX) ? 1 : 0;
+			}
 
-				// get direction of current bin
-				const Vector2f bin_direction = {cosf(angle), sinf(angle)};
+			// rotation of the bin directions from body to local frame
+			const float yaw_cos = cosf(vehicle_yaw_angle_rad);
+			const float yaw_sin = sinf(vehicle_yaw_angle_rad);
 
-				//count number of bins in the field of valid_new
-				if (_obstacle_map_body_frame.distances[i] < UINT16_MAX) {
-					num_fov_bins ++;
-				}
+			// limit speed for safe flight
+			for (int i = 0; i < _map_bins; i++) { // disregard unused bins at the end of the map
 
 				if (_obstacle_map_body_frame.distances[i] > _obstacle_map_body_frame.min_distance
 				    && _obstacle_map_body_frame.distances[i] < UINT16_MAX) {
 
+					// get direction of current bin
+					const Vector2f bin_direction = {_bin_cos[i] * yaw_cos - _bin_sin[i] * yaw_sin,
+									_bin_sin[i] * yaw_cos + _bin_cos[i] * yaw_sin
+								       };
+
 					if (setpoint_dir.dot(bin_direction) > 0) {
+						const hrt_abstime data_age = constrain_time - _data_timestamps[i];
+						const float distance = _obstacle_map_body_frame.distances[i] * 0.01f; // convert to meters
+						const float max_range = _data_maxranges[i] * 0.01f; // convert to meters
+
 						// calculate max allowed velocity with a P-controller (same gain as in the position controller)
 						const float curr_vel_parallel = math::max(0.f, curr_vel.dot(bin_direction));
 						float delay_distance = curr_vel_parallel * col_prev_dly;
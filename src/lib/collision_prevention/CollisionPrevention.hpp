@@ -84,11 +84,34 @@ public:
 
 protected:
 
-	obstacle_distance_s _obstacle_map_body_frame {};
-	bool _data_fov[sizeof(_obstacle_map_body_frame.distances) / sizeof(_obstacle_map_body_frame.distances[0])];
-	uint64_t _data_timestamps[sizeof(_obstacle_map_body_frame.distances) / sizeof(_obstacle_map_body_frame.distances[0])];
-	uint16_t _data_maxranges[sizeof(_obstacle_map_body_frame.distances) / sizeof(
-										    _obstacle_map_body_frame.distances[0])]; /**< in cm */
+#if defined(CONSTRAINED_MEMORY)
+	static constexpr int MAP_MAX_BINS = 72;		/**< maximum number of bins in the internal obstacle map (5 deg) */
+#else
+	static constexpr int MAP_MAX_BINS = 360;	/**< maximum number of bins in the internal obstacle map (1 deg) */
+#endif
+	static constexpr int MAP_MIN_INCREMENT_DEG = 360 / MAP_MAX_BINS;
+	static constexpr int MAP_MAX_INCREMENT_DEG = 10;
+
+	/**
+	 * Internal obstacle map in body frame. The resolution is set by CP_MAP_RES, bins
+	 * beyond 360 / increment are unused and always UINT16_MAX.
+	 */
+	struct ObstacleMap {
+		hrt_abstime timestamp;
+		float increment;			/**< bin width in degrees */
+		float angle_offset;			/**< angle of the first bin in degrees */
+		uint16_t min_distance;			/**< in cm */
+		uint16_t max_distance;			/**< in cm */
+		uint16_t distances[MAP_MAX_BINS];	/**< in cm, UINT16_MAX if unknown */
+	};
+
+	ObstacleMap _obstacle_map_body_frame {};
+	int _map_bins{360 / MAP_MAX_INCREMENT_DEG};	/**< number of bins used for the current resolution */
+	bool _data_fov[MAP_MAX_BINS];
+	uint64_t _data_timestamps[MAP_MAX_BINS];
+	uint16_t _data_maxranges[MAP_MAX_BINS];		/**< in cm */
+	float _bin_cos[MAP_MAX_BINS];			/**< x component of the bin direction in body frame */
+	float _bin_sin[MAP_MAX_BINS];			/**< y component of the bin direction in body frame */
 
 	void _addDistanceSensorData(distance_sensor_s &distance_sensor, const matrix::Quatf &vehicle_attitude);
 
@@ -141,11 +164,14 @@ private:
 	hrt_abstime	_last_timeout_warning{0};
 	hrt_abstime	_time_activated{0};
 
+	int32_t		_map_resolution_deg{0};	/**< CP_MAP_RES the map is currently set up for */
+
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::CP_DIST>) _param_cp_dist, /**< collision prevention keep minimum distance */
 		(ParamFloat<px4::params::CP_DELAY>) _param_cp_delay, /**< delay of the range measurement data*/
 		(ParamFloat<px4::params::CP_GUIDE_ANG>) _param_cp_guide_ang, /**< collision prevention change setpoint angle */
 		(ParamBool<px4::params::CP_GO_NO_DATA>) _param_cp_go_nodata, /**< movement allowed where no data*/
+		(ParamInt<px4::params::CP_MAP_RES>) _param_cp_map_res, /**< angular resolution of the obstacle map*/
 		(ParamFloat<px4::params::MPC_XY_P>) _param_mpc_xy_p, /**< p gain from position controller*/
 		(ParamFloat<px4::params::MPC_JERK_MAX>) _param_mpc_jerk_max, /**< vehicle maximum jerk*/
 		(ParamFloat<px4::params::MPC_ACC_HOR>) _param_mpc_acc_hor /**< vehicle maximum horizontal acceleration*/
@@ -175,10 +201,16 @@ private:
 	void _publishConstrainedSetpoint(const matrix::Vector2f &original_setpoint, const matrix::Vector2f &adapted_setpoint);
 
 	/**
-	 * Publishes obstacle_distance message with fused data from offboard and from distance sensors
-	 * @param obstacle, obstacle_distance message to be publsihed
+	 * Publishes obstacle_distance message with fused data from offboard and from distance sensors.
+	 * Maps finer than the 72 bins of the message are reduced to 5 degree bins keeping the closest obstacle.
+	 */
+	void _publishObstacleDistance();
+
+	/**
+	 * Resets the internal obstacle map and the per bin direction lookup table for a new resolution
+	 * @param resolution_deg, requested bin width in degrees (CP_MAP_RES)
 	 */
-	void _publishObstacleDistance(obstacle_distance_s &obstacle);
+	void _setMapResolution(int32_t resolution_deg);
 
 	/**
 	 * Aggregates the sensor data into a internal obstacle map in body frame
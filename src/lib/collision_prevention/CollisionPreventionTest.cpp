@@ -52,7 +52,8 @@ class TestCollisionPrevention : public CollisionPrevention
 public:
 	TestCollisionPrevention() : CollisionPrevention(nullptr) {}
 	void paramsChanged() {CollisionPrevention::updateParamsImpl();}
-	obstacle_distance_s &getObstacleMap() {return _obstacle_map_body_frame;}
+	ObstacleMap &getObstacleMap() {return _obstacle_map_body_frame;}
+	int getMapBins() {return _map_bins;}
 	void test_addDistanceSensorData(distance_sensor_s &distance_sensor, const matrix::Quatf &attitude)
 	{
 		_addDistanceSensorData(distance_sensor, attitude);
@@ -702,6 +703,48 @@ TEST_F(CollisionPreventionTest, addDistanceSensorData)
 
 }
 
+TEST_F(CollisionPreventionTest, addDistanceSensorDataHighResolution)
+{
+	// GIVEN: a 1 degree obstacle map, a vehicle attitude and a distance sensor message
+	param_t param = param_handle(px4::params::CP_MAP_RES);
+	int32_t resolution = 1;
+	param_set(param, &resolution);
+	TestCollisionPrevention cp;
+	matrix::Quaternion<float> vehicle_attitude(1, 0, 0, 0); //unit transform
+	distance_sensor_s distance_sensor {};
+	distance_sensor.min_distance = 0.2f;
+	distance_sensor.max_distance = 20.f;
+	distance_sensor.current_distance = 5.f;
+
+	//THEN: the map should use all 360 bins
+	EXPECT_FLOAT_EQ(cp.getObstacleMap().increment, 1.f);
+	EXPECT_EQ(cp.getMapBins(), 360);
+
+	//WHEN: we add distance sensor data to the right
+	distance_sensor.orientation = distance_sensor_s::ROTATION_RIGHT_FACING;
+	distance_sensor.h_fov = math::radians(19.99f);
+	cp.test_addDistanceSensorData(distance_sensor, vehicle_attitude);
+
+	//THEN: only the bins covered by the field of view should be filled
+	for (int i = 0; i < cp.getMapBins(); i++) {
+		if (i >= 80 && i <= 99) {
+			EXPECT_FLOAT_EQ(cp.getObstacleMap().distances[i], 500);
+
+		} else {
+			EXPECT_FLOAT_EQ(cp.getObstacleMap().distances[i], UINT16_MAX);
+		}
+	}
+
+	//WHEN: the resolution does not divide 360 evenly
+	resolution = 7;
+	param_set(param, &resolution);
+	TestCollisionPrevention cp_invalid_resolution;
+
+	//THEN: the next finer valid resolution is used
+	EXPECT_FLOAT_EQ(cp_invalid_resolution.getObstacleMap().increment, 6.f);
+	EXPECT_EQ(cp_invalid_resolution.getMapBins(), 60);
+}
+
 TEST_F(CollisionPreventionTest, addObstacleSensorData_attitude)
 {
 	// GIVEN: a vehicle attitude and obstacle distance message
@@ -84,3 +84,17 @@ PARAM_DEFINE_FLOAT(CP_GUIDE_ANG, 30.f);
  * @group Multicopter Position Control
  */
 PARAM_DEFINE_INT32(CP_GO_NO_DATA, 0);
+
+/**
+ * Angular resolution of the internal obstacle map
+ *
+ * Width of the bins the distance sensor and obstacle distance data is fused into.
+ * Values which do not divide 360 evenly are rounded down to the next valid resolution.
+ * Only used in Position mode.
+ *
+ * @min 1
+ * @max 10
+ * @unit deg
+ * @group Multicopter Position Control
+ */
+PARAM_DEFINE_INT32(CP_MAP_RES, 10);
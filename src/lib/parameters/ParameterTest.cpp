@@ -31,6 +31,7 @@
  *
  ****************************************************************************/
 
+#include <drivers/drv_hrt.h>
 #include <px4_platform_common/module_params.h>
 #include <uORB/Subscription.hpp>
 #include <uORB/topics/obstacle_distance.h>
@@ -38,6 +39,10 @@
 
 #include <gtest/gtest.h>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 class ParameterTest : public ::testing::Test
 {
 public:
@@ -78,6 +83,191 @@ TEST_F(ParameterTest, testParamReadWrite)
 	EXPECT_FLOAT_EQ(42.f, value2);
 }
 
+TEST_F(ParameterTest, testParamFindAll)
+{
+	// WHEN: we look up every parameter by name
+	for (unsigned i = 0; i < param_count(); i++) {
+		const param_t param = param_for_index(i);
+
+		// THEN: the hash lookup should return the same handle
+		EXPECT_EQ(param, param_find_no_notification(param_name(param)));
+	}
+
+	// AND: unknown names should not be found
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification("NOT_A_PARAM"));
+	EXPECT_EQ(PARAM_INVALID, param_find_no_notification(""));
+}
+
+TEST_F(ParameterTest, testParamResetChanged)
+{
+	// GIVEN: a changed parameter
+	param_t param = param_handle(px4::params::CP_DIST);
+	float value = 42.f;
+	EXPECT_EQ(0, param_set(param, &value));
+
+	// WHEN: we reset it and set it again to the same value
+	EXPECT_EQ(0, param_reset(param));
+	EXPECT_TRUE(param_value_is_default(param));
+	EXPECT_EQ(0, param_set(param, &value));
+
+	// THEN: it should be changed and have the value
+	float value2 = -1999.f;
+	EXPECT_FALSE(param_value_is_default(param));
+	EXPECT_EQ(0, param_get(param, &value2));
+	EXPECT_FLOAT_EQ(42.f, value2);
+}
+
+TEST_F(ParameterTest, testParamFindGetThroughput)
+{
+	static constexpr int iterations = 20;
+	const unsigned count = param_count();
+
+	// GIVEN: every other parameter changed (set to its own value)
+	for (unsigned i = 0; i < count; i += 2) {
+		const param_t param = param_for_index(i);
+		int32_t value = 0;
+		param_get(param, &value);
+		param_set_no_notification(param, &value);
+	}
+
+	// WHEN: we look up and read all parameters repeatedly (checked after the timed loops)
+	unsigned find_failures = 0;
+	const hrt_abstime find_start = hrt_absolute_time();
+
+	for (int n = 0; n < iterations; n++) {
+		for (unsigned i = 0; i < count; i++) {
+			find_failures += (param_find_no_notification(param_name(param_for_index(i))) == PARAM_INVALID);
+		}
+	}
+
+	const hrt_abstime find_elapsed = hrt_elapsed_time(&find_start);
+	unsigned get_failures = 0;
+	const hrt_abstime get_start = hrt_absolute_time();
+
+	for (int n = 0; n < iterations; n++) {
+		for (unsigned i = 0; i < count; i++) {
+			int32_t value;
+			get_failures += (param_get(param_for_index(i), &value) != 0);
+		}
+	}
+
+	const hrt_abstime get_elapsed = hrt_elapsed_time(&get_start);
+
+	// THEN: every lookup and read should succeed
+	EXPECT_EQ(0u, find_failures);
+	EXPECT_EQ(0u, get_failures);
+
+	// AND: report the throughput
+	const double calls = (double)iterations * count;
+	printf("param_find: %.0f calls in %" PRIu64 " us (%.1f Mcalls/s)\n", calls, find_elapsed,
+	       calls / (find_elapsed + 1));
+	printf("param_get:  %.0f calls in %" PRIu64 " us (%.1f Mcalls/s)\n", calls, get_elapsed,
+	       calls / (get_elapsed + 1));
+
+	for (unsigned i = 0; i < count; i += 2) {
+		param_reset_no_notification(param_for_index(i));
+	}
+}
+
+TEST_F(ParameterTest, testJournalSaveLoad)
+{
+	static constexpr const char *filename = "param_journal_test.bson";
+	static constexpr const char *journal = "param_journal_test.bson.journal";
+	unlink(filename);
+	unlink(journal);
+
+	// GIVEN: a default file and a changed parameter
+	ASSERT_EQ(0, param_set_default_file(filename));
+	param_t param = param_handle(px4::params::CP_DIST);
+	float value = 5.f;
+	EXPECT_EQ(0, param_set(param, &value));
+
+	// WHEN: we save for the first time (full rewrite)
+	hrt_abstime start = hrt_absolute_time();
+	EXPECT_EQ(0, param_save_default());
+	const hrt_abstime full_save = hrt_elapsed_time(&start);
+
+	// AND: we save a single change (journal append)
+	value = 7.f;
+	EXPECT_EQ(0, param_set(param, &value));
+	start = hrt_absolute_time();
+	EXPECT_EQ(0, param_save_default());
+	const hrt_abstime journal_save = hrt_elapsed_time(&start);
+
+	// AND: a save got interrupted, leaving a partial record behind
+	int fd = open(journal, O_WRONLY | O_APPEND);
+	ASSERT_GE(fd, 0);
+	EXPECT_EQ(6, write(fd, "\xA5\x02\x07""CP_", 6));
+	close(fd);
+
+	// AND: we load the default file again, without an autosave writing the same file meanwhile
+	param_control_autosave(false);
+	param_reset_all();
+	start = hrt_absolute_time();
+	EXPECT_EQ(0, param_load_default());
+	const hrt_abstime load = hrt_elapsed_time(&start);
+
+	// THEN: the journaled value should be restored
+	float value2 = -1999.f;
+	EXPECT_EQ(0, param_get(param, &value2));
+	EXPECT_FLOAT_EQ(7.f, value2);
+
+	// AND: the partial record should be dropped (header + one 18 byte record)
+	struct stat st {};
+	EXPECT_EQ(0, stat(journal, &st));
+	EXPECT_EQ(8 + 18, st.st_size);
+
+	printf("param save: full %" PRIu64 " us, journal %" PRIu64 " us, load %" PRIu64 " us\n",
+	       full_save, journal_save, load);
+
+	param_set_default_file(nullptr);
+	unlink(filename);
+	unlink(journal);
+}
+
+TEST_F(ParameterTest, testSnapshotSaveLoad)
+{
+	static constexpr const char *filename = "param_snapshot_test.bin";
+	unlink(filename);
+
+	// GIVEN: a changed parameter and a custom default
+	param_t param = param_handle(px4::params::CP_DIST);
+	param_t param_default = param_handle(px4::params::CP_DELAY);
+	float system_default = -1999.f;
+	EXPECT_EQ(0, param_get_system_default_value(param_default, &system_default));
+	float value = 5.f;
+	EXPECT_EQ(0, param_set(param, &value));
+	value = 0.3f;
+	EXPECT_EQ(0, param_set_default_value(param_default, &value));
+
+	// WHEN: we save a snapshot and reset all parameters
+	EXPECT_EQ(0, param_snapshot_save(filename, 1, 2));
+	param_reset_all();
+	EXPECT_EQ(0, param_set_default_value(param_default, &system_default));
+
+	// THEN: a snapshot for a different build or configuration should be rejected
+	EXPECT_NE(0, param_snapshot_load(filename, 2, 2));
+	EXPECT_NE(0, param_snapshot_load(filename, 1, 3));
+
+	// AND: the snapshot should restore the parameter state
+	const hrt_abstime start = hrt_absolute_time();
+	EXPECT_EQ(0, param_snapshot_load(filename, 1, 2));
+	const hrt_abstime load = hrt_elapsed_time(&start);
+
+	float value2 = -1999.f;
+	EXPECT_EQ(0, param_get(param, &value2));
+	EXPECT_FLOAT_EQ(5.f, value2);
+	EXPECT_TRUE(param_value_unsaved(param));
+
+	EXPECT_EQ(0, param_get_default_value(param_default, &value2));
+	EXPECT_FLOAT_EQ(0.3f, value2);
+	EXPECT_TRUE(param_value_is_default(param_default));
+
+	printf("param snapshot load %" PRIu64 " us\n", load);
+
+	param_set_default_value(param_default, &system_default);
+	unlink(filename);
+}
 
 TEST_F(ParameterTest, testUorbSendReceive)
 {
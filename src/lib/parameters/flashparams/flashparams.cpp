@@ -66,18 +66,9 @@
 #endif
 
 
-/**
- * Storage for modified parameters.
- */
-struct param_wbuf_s {
-	union param_value_u     val;
-	param_t                 param;
-};
-
 static int
 param_export_internal(param_filter_func filter)
 {
-	struct param_wbuf_s *s = nullptr;
 	bson_encoder_s encoder{};
 	int     result = -1;
 
@@ -85,39 +76,41 @@ param_export_internal(param_filter_func filter)
 
 	bson_encoder_init_buf(&encoder, nullptr, 0);
 
-	/* no modified parameters -> we are done */
-	if (param_values == nullptr) {
-		result = 0;
-		goto out;
-	}
-
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != nullptr) {
+	/* no modified parameters -> empty document */
+	for (unsigned index = 0; index < param_count(); index++) {
 
+		const param_t param = index;
 		int32_t i;
 		float   f;
 
-		if (filter && !filter(s->param)) {
+		if (!param_value_changed_external(param)) {
 			continue;
 		}
 
+		if (filter && !filter(param)) {
+			continue;
+		}
+
+		const param_value_u *val = (const param_value_u *)param_get_value_ptr_external(param);
+
 		/* append the appropriate BSON type object */
 
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 		case PARAM_TYPE_INT32:
-			i = s->val.i;
+			i = val->i;
 
-			if (bson_encoder_append_int32(&encoder, param_name(s->param), i)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_int32(&encoder, param_name(param), i)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
 			break;
 
 		case PARAM_TYPE_FLOAT:
-			f = s->val.f;
+			f = val->f;
 
-			if (bson_encoder_append_double(&encoder, param_name(s->param), f)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_double(&encoder, param_name(param), f)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
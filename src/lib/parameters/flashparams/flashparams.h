@@ -54,10 +54,10 @@ __BEGIN_DECLS
 
 /*
  * When using the flash based parameter store we have to force
- * the param_values and 2 functions to be global
+ * these functions to be global
  */
 
-__EXPORT extern UT_array        *param_values;
+__EXPORT bool param_value_changed_external(param_t param);
 __EXPORT int param_set_external(param_t param, const void *val, bool mark_saved, bool notify_changes);
 __EXPORT const void *param_get_value_ptr_external(param_t param);
 
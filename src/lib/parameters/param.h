@@ -426,6 +426,46 @@ __EXPORT int 		param_save_default(void);
  */
 __EXPORT int 		param_load_default(void);
 
+/**
+ * Replay the journal of the default parameter file.
+ *
+ * param_save_default() appends changes to a journal next to the default file
+ * and only rewrites the file itself once the journal grows too large. This has
+ * to be called after the default file was imported or loaded (param_load_default()
+ * does it already). Records left incomplete by a power loss are dropped.
+ *
+ * @return		Zero on success or if there is no journal.
+ */
+__EXPORT int 		param_load_default_journal(void);
+
+/**
+ * Save a snapshot of the parameter state (values, custom defaults, used and unsaved flags).
+ *
+ * The snapshot is a flat, memory-mappable image that param_snapshot_load() restores on the
+ * next boot instead of loading the default file and applying the startup defaults again.
+ * If the parameters were restored from the snapshot during this boot, the file is left
+ * as is and the time saved is reported instead.
+ *
+ * @param filename	Path to the snapshot file.
+ * @param build_id	Identifier of the firmware build.
+ * @param key		Hash of the boot configuration (e.g. airframe and instance).
+ * @return		Zero on success.
+ */
+__EXPORT int 		param_snapshot_save(const char *filename, uint64_t build_id, uint32_t key);
+
+/**
+ * Restore the parameter state from a snapshot taken by param_snapshot_save().
+ *
+ * Nothing is changed if the snapshot was taken by another build (build_id or parameter
+ * definitions), with another key, or if the default file or its journal changed since.
+ *
+ * @param filename	Path to the snapshot file.
+ * @param build_id	Identifier of the firmware build.
+ * @param key		Hash of the boot configuration.
+ * @return		Zero if the parameters were restored.
+ */
+__EXPORT int 		param_snapshot_load(const char *filename, uint64_t build_id, uint32_t key);
+
 /**
  * Generate the hash of all parameters and their values
  *
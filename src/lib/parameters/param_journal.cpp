@@ -0,0 +1,190 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file param_journal.cpp
+ *
+ * Encoding and replay of the parameter journal, see param_journal.h.
+ */
+
+#include "param_journal.h"
+
+#include <crc32.h>
+#include <string.h>
+#include <unistd.h>
+
+static constexpr uint8_t JOURNAL_MAGIC[4] {'P', 'X', 'P', 'J'};
+static constexpr uint8_t JOURNAL_VERSION = 1;
+static constexpr uint8_t RECORD_MARKER = 0xA5;
+
+size_t param_journal_encode(uint8_t *buf, const char *name, param_journal_record_t type, const param_value_u &value)
+{
+	const size_t name_len = strlen(name);
+
+	if (name_len == 0 || name_len > PARAM_JOURNAL_NAME_MAX) {
+		return 0;
+	}
+
+	size_t pos = 0;
+	buf[pos++] = RECORD_MARKER;
+	buf[pos++] = type;
+	buf[pos++] = (uint8_t)name_len;
+	memcpy(&buf[pos], name, name_len);
+	pos += name_len;
+
+	// values are stored in host byte order
+	switch (type) {
+	case PARAM_JOURNAL_RECORD_INT32:
+		memcpy(&buf[pos], &value.i, sizeof(int32_t));
+		break;
+
+	case PARAM_JOURNAL_RECORD_FLOAT:
+		memcpy(&buf[pos], &value.f, sizeof(float));
+		break;
+
+	default:
+		memset(&buf[pos], 0, sizeof(int32_t));
+		break;
+	}
+
+	pos += sizeof(int32_t);
+
+	const uint32_t crc = crc32part(buf, pos, 0);
+	memcpy(&buf[pos], &crc, sizeof(crc));
+	pos += sizeof(crc);
+
+	return pos;
+}
+
+int param_journal_write_header(int fd)
+{
+	uint8_t header[PARAM_JOURNAL_HEADER_SIZE] {};
+	memcpy(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+	header[4] = JOURNAL_VERSION;
+
+	if (write(fd, header, sizeof(header)) != (ssize_t)sizeof(header)) {
+		return -1;
+	}
+
+	return 0;
+}
+
+off_t param_journal_replay(int fd, param_journal_replay_cb cb, void *arg, int *num_records)
+{
+	*num_records = 0;
+
+	uint8_t header[PARAM_JOURNAL_HEADER_SIZE];
+
+	if ((read(fd, header, sizeof(header)) != (ssize_t)sizeof(header))
+	    || (memcmp(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0)
+	    || (header[4] != JOURNAL_VERSION)) {
+		return -1;
+	}
+
+	off_t valid_end = sizeof(header);
+
+	uint8_t buf[256];
+	size_t len = 0;
+	size_t pos = 0;
+	bool eof = false;
+
+	for (;;) {
+		// keep at least one full record in the buffer
+		if ((len - pos < PARAM_JOURNAL_RECORD_MAX_SIZE) && !eof) {
+			memmove(buf, &buf[pos], len - pos);
+			len -= pos;
+			pos = 0;
+
+			while (len < sizeof(buf)) {
+				const ssize_t ret = read(fd, &buf[len], sizeof(buf) - len);
+
+				if (ret <= 0) {
+					eof = true;
+					break;
+				}
+
+				len += ret;
+			}
+		}
+
+		const size_t available = len - pos;
+
+		if (available == 0) {
+			break;
+		}
+
+		const uint8_t *record = &buf[pos];
+
+		if ((available < 3) || (record[0] != RECORD_MARKER) || (record[1] > PARAM_JOURNAL_RECORD_FLOAT)
+		    || (record[2] == 0) || (record[2] > PARAM_JOURNAL_NAME_MAX)) {
+			// torn or corrupt record, everything after it is dropped
+			break;
+		}
+
+		const size_t name_len = record[2];
+		const size_t record_size = 3 + name_len + sizeof(int32_t) + sizeof(uint32_t);
+
+		if (available < record_size) {
+			break;
+		}
+
+		uint32_t crc;
+		memcpy(&crc, &record[record_size - sizeof(crc)], sizeof(crc));
+
+		if (crc32part(record, record_size - sizeof(crc), 0) != crc) {
+			break;
+		}
+
+		char name[PARAM_JOURNAL_NAME_MAX + 1];
+		memcpy(name, &record[3], name_len);
+		name[name_len] = '\0';
+
+		const param_journal_record_t type = (param_journal_record_t)record[1];
+		param_value_u value{};
+
+		if (type == PARAM_JOURNAL_RECORD_INT32) {
+			memcpy(&value.i, &record[3 + name_len], sizeof(int32_t));
+
+		} else if (type == PARAM_JOURNAL_RECORD_FLOAT) {
+			memcpy(&value.f, &record[3 + name_len], sizeof(float));
+		}
+
+		cb(arg, name, type, value);
+
+		pos += record_size;
+		valid_end += record_size;
+		(*num_records)++;
+	}
+
+	return valid_end;
+}
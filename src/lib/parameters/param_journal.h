@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file param_journal.h
+ *
+ * Append-only journal of parameter changes.
+ *
+ * The journal complements the BSON parameter file: saving appends one small
+ * record per modified parameter instead of rewriting the whole file, and the
+ * records are replayed on top of the BSON file when loading. Each record is
+ * protected by a CRC, so a record torn by a power loss is detected and
+ * dropped together with everything after it.
+ *
+ * File layout: header (magic, version), followed by records of
+ *   [marker][type][name length][name][4 byte value][CRC32]
+ */
+
+#pragma once
+
+#include "param.h"
+
+#include <stdint.h>
+#include <sys/types.h>
+
+enum param_journal_record_t : uint8_t {
+	PARAM_JOURNAL_RECORD_RESET = 0, ///< parameter reset to its default value
+	PARAM_JOURNAL_RECORD_INT32 = 1,
+	PARAM_JOURNAL_RECORD_FLOAT = 2,
+};
+
+/** size of the journal file header in bytes */
+static constexpr size_t PARAM_JOURNAL_HEADER_SIZE = 8;
+
+/** maximum parameter name length in a record */
+static constexpr size_t PARAM_JOURNAL_NAME_MAX = 31;
+
+/** maximum size of a single encoded record in bytes */
+static constexpr size_t PARAM_JOURNAL_RECORD_MAX_SIZE = 3 + PARAM_JOURNAL_NAME_MAX + 4 + 4;
+
+/**
+ * Callback for each valid record during replay.
+ */
+typedef void (*param_journal_replay_cb)(void *arg, const char *name, param_journal_record_t type,
+					const param_value_u &value);
+
+/**
+ * Encode a record into a buffer.
+ *
+ * @param buf		Destination buffer, at least PARAM_JOURNAL_RECORD_MAX_SIZE bytes
+ * @param name		Parameter name
+ * @param type		Record type
+ * @param value		Value (ignored for PARAM_JOURNAL_RECORD_RESET)
+ * @return		Number of bytes encoded, 0 if the name is too long
+ */
+__EXPORT size_t param_journal_encode(uint8_t *buf, const char *name, param_journal_record_t type,
+				     const param_value_u &value);
+
+/**
+ * Write the journal header to an empty file.
+ *
+ * @return		0 on success
+ */
+__EXPORT int param_journal_write_header(int fd);
+
+/**
+ * Replay all valid records of a journal, starting from the beginning of the file.
+ *
+ * @param fd		File descriptor opened for reading
+ * @param cb		Called for every valid record in file order
+ * @param arg		Passed to cb
+ * @param num_records	Set to the number of valid records
+ * @return		Offset of the end of the last valid record (the size the file
+ *			should be truncated to), or -1 if the header is missing or invalid
+ */
+__EXPORT off_t param_journal_replay(int fd, param_journal_replay_cb cb, void *arg, int *num_records);
@@ -43,6 +43,7 @@
 
 #define PARAM_IMPLEMENTATION
 #include "param.h"
+#include "param_journal.h"
 #include "param_translation.h"
 #include <parameters/px4_parameters.hpp>
 #include "tinybson/tinybson.h"
@@ -50,12 +51,14 @@
 #include <crc32.h>
 #include <float.h>
 #include <math.h>
+#include <sys/stat.h>
 
 #include <containers/Bitset.hpp>
 #include <drivers/drv_hrt.h>
 #include <lib/perf/perf_counter.h>
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/atomic_bitset.h>
+#include <px4_platform_common/boot_profile.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/posix.h>
 #include <px4_platform_common/sem.h>
@@ -95,19 +98,34 @@ static struct work_s autosave_work {};
 static px4::atomic_bool autosave_scheduled{false};
 static bool autosave_disabled = false;
 
+/* journal variables (see param_journal.h), the journal is stored next to the default file */
+static char *param_journal_file = nullptr;
+static off_t param_journal_size = 0; ///< protected by param_sem_save
+static px4::atomic_bool param_journal_compact_required{true}; ///< the journal does not describe the current values
+static struct work_s param_journal_compact_work {};
+static constexpr off_t PARAM_JOURNAL_COMPACT_SIZE = 8 * 1024; ///< rewrite the default file once the journal exceeds this
+
 static px4::AtomicBitset<param_info_count> params_active;  // params found
 static px4::AtomicBitset<param_info_count> params_changed; // params non-default
 static px4::Bitset<param_info_count> params_custom_default; // params with runtime default value
 static px4::AtomicBitset<param_info_count> params_unsaved;
 
-// Storage for modified parameters.
+// Storage for custom default values.
 struct param_wbuf_s {
 	union param_value_u val;
 	param_t             param;
 };
 
-/** flexible array holding modified parameter values */
-UT_array *param_values{nullptr};
+/** modified parameter values, indexed by param_t, only valid if the params_changed bit is set */
+static param_value_u param_changed_values[param_info_count] {};
+
+/**
+ * Sequence counter protecting param_changed_values and params_changed for lock-free readers (seqlock).
+ * It is odd while a writer (holding the writer lock) is modifying them.
+ */
+static px4::atomic<uint32_t> param_values_seq{0};
+
+/** flexible array holding custom default values */
 UT_array *param_custom_default_values{nullptr};
 
 const UT_icd param_icd = {sizeof(param_wbuf_s), nullptr, nullptr, nullptr};
@@ -119,11 +137,12 @@ static unsigned int param_instance = 0;
 // the following implements an RW-lock using 2 semaphores (used as mutexes). It gives
 // priority to readers, meaning a writer could suffer from starvation, but in our use-case
 // we only have short periods of reads and writes are rare.
-static px4_sem_t param_sem; ///< this protects against concurrent access to param_values
+static px4_sem_t param_sem; ///< this protects against concurrent access to the parameter values
 static int reader_lock_holders = 0;
 static px4_sem_t reader_lock_holders_lock; ///< this protects against concurrent access to reader_lock_holders
 
 static perf_counter_t param_export_perf;
+static perf_counter_t param_journal_perf;
 static perf_counter_t param_find_perf;
 static perf_counter_t param_get_perf;
 static perf_counter_t param_set_perf;
@@ -194,6 +213,7 @@ param_init()
 	px4_sem_init(&reader_lock_holders_lock, 0, 1);
 
 	param_export_perf = perf_alloc(PC_ELAPSED, "param: export");
+	param_journal_perf = perf_alloc(PC_ELAPSED, "param: journal");
 	param_find_perf = perf_alloc(PC_COUNT, "param: find");
 	param_get_perf = perf_alloc(PC_COUNT, "param: get");
 	param_set_perf = perf_alloc(PC_ELAPSED, "param: set");
@@ -226,24 +246,22 @@ param_compare_values(const void *a, const void *b)
 }
 
 /**
- * Locate the modified parameter structure for a parameter, if it exists.
- *
- * @param param			The parameter being searched.
- * @return			The structure holding the modified value, or
- *				nullptr if the parameter has not been modified.
+ * Mark the start of a modification of param_changed_values or params_changed.
+ * The caller must hold the writer lock.
  */
-static param_wbuf_s *
-param_find_changed(param_t param)
+static inline void
+param_values_write_begin()
 {
-	param_assert_locked();
-
-	if (params_changed[param] && (param_values != nullptr)) {
-		param_wbuf_s key{};
-		key.param = param;
-		return (param_wbuf_s *)utarray_find(param_values, &key, param_compare_values);
-	}
+	param_values_seq.fetch_add(1);
+}
 
-	return nullptr;
+/**
+ * Mark the end of a modification, see param_values_write_begin().
+ */
+static inline void
+param_values_write_end()
+{
+	param_values_seq.fetch_add(1);
 }
 
 void
@@ -268,10 +286,51 @@ param_notify_changes()
 	}
 }
 
+#if !defined(CONSTRAINED_FLASH)
+/**
+ * Hash of a parameter name: FNV-1a with a seeded offset basis and a murmur3 finalizer.
+ * Must match name_hash() in px_generate_params.py.
+ */
+static inline uint32_t param_name_hash(const char *name, uint32_t seed)
+{
+	uint32_t h = 2166136261u ^ seed;
+
+	for (const char *c = name; *c != '\0'; c++) {
+		h ^= (uint8_t) * c;
+		h *= 16777619u;
+	}
+
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+#endif // !CONSTRAINED_FLASH
+
 static param_t param_find_internal(const char *name, bool notification)
 {
 	perf_count(param_find_perf);
 
+#if !defined(CONSTRAINED_FLASH)
+	/* perfect hash lookup: the bucket gives the displacement seed of the final slot */
+	static constexpr uint32_t num_buckets = sizeof(px4::parameters_hash_displacement) / sizeof(
+			px4::parameters_hash_displacement[0]);
+	static constexpr uint32_t num_slots = sizeof(px4::parameters_hash_slots) / sizeof(px4::parameters_hash_slots[0]);
+
+	const uint16_t displacement = px4::parameters_hash_displacement[param_name_hash(name, 0) % num_buckets];
+	const uint16_t index = px4::parameters_hash_slots[param_name_hash(name, displacement) % num_slots];
+
+	if ((index < param_info_count) && (strcmp(name, param_name(index)) == 0)) {
+		if (notification) {
+			param_set_used(index);
+		}
+
+		return index;
+	}
+
+#else
 	param_t middle;
 	param_t front = 0;
 	param_t last = param_info_count;
@@ -301,6 +360,8 @@ static param_t param_find_internal(const char *name, bool notification)
 		}
 	}
 
+#endif // !CONSTRAINED_FLASH
+
 	/* not found */
 	return PARAM_INVALID;
 }
@@ -386,10 +447,8 @@ param_get_value_ptr(param_t param)
 
 	if (handle_in_range(param)) {
 		/* work out whether we're fetching the default or a written value */
-		struct param_wbuf_s *s = param_find_changed(param);
-
-		if (s != nullptr) {
-			return &s->val;
+		if (params_changed[param]) {
+			return &param_changed_values[param];
 
 		} else {
 			if (params_custom_default[param] && param_custom_default_values) {
@@ -434,15 +493,24 @@ param_get(param_t param, void *val)
 	int result = PX4_ERROR;
 
 	if (val) {
-		if (!params_changed[param] && !params_custom_default[param]) {
-			// if parameter is unchanged (static default value) copy immediately and avoid locking
-			switch (param_type(param)) {
-			case PARAM_TYPE_INT32:
+		// without custom default the value is either the static default or in the dense changed
+		// value array: read it without locking, fall back to the locked read if a writer was active
+		const uint32_t seq = param_values_seq.load();
+
+		if (((seq & 1) == 0) && !params_custom_default[param]) {
+			if (params_changed[param]) {
+				memcpy(val, &param_changed_values[param], param_size(param));
+
+			} else if (param_type(param) == PARAM_TYPE_INT32) {
 				memcpy(val, &px4::parameters[param].val.i, sizeof(px4::parameters[param].val.i));
-				return PX4_OK;
 
-			case PARAM_TYPE_FLOAT:
+			} else {
 				memcpy(val, &px4::parameters[param].val.f, sizeof(px4::parameters[param].val.f));
+			}
+
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+			if (param_values_seq.load() == seq) {
 				return PX4_OK;
 			}
 		}
@@ -538,7 +606,7 @@ bool param_value_is_default(param_t param)
 		return true;
 
 	} else {
-		// the param_values dynamic array might carry things that have been set
+		// a changed value might have been set
 		// back to default, so we don't rely on the params_changed bitset here
 		switch (param_type(param)) {
 		case PARAM_TYPE_INT32: {
@@ -683,78 +751,50 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 	param_lock_writer();
 	perf_begin(param_set_perf);
 
-	// create the parameter store if it doesn't exist
-	if (param_values == nullptr) {
-		utarray_new(param_values, &param_icd);
+	{
+		param_value_u &s = param_changed_values[param];
 
-		// mark all parameters unchanged (default)
-		params_changed.reset();
-		params_unsaved.reset();
-	}
+		/* a parameter set for the first time always counts as changed, the slot holds a stale value */
+		const bool first_set = !params_changed[param];
 
-	if (param_values == nullptr) {
-		PX4_ERR("failed to allocate modified values array");
-		goto out;
+		param_values_write_begin();
 
-	} else {
-		param_wbuf_s *s = param_find_changed(param);
+		/* update the changed value */
+		switch (param_type(param)) {
+		case PARAM_TYPE_INT32:
+			if (first_set || (s.i != *(int32_t *)val)) {
+				s.i = *(int32_t *)val;
+				param_changed = true;
+			}
 
-		if (s == nullptr) {
-			/* construct a new parameter */
-			param_wbuf_s buf{};
-			buf.param = param;
+			params_changed.set(param, true);
+			params_unsaved.set(param, !mark_saved);
+			result = PX4_OK;
+			break;
 
-			param_changed = true;
+		case PARAM_TYPE_FLOAT:
+			if (first_set || (fabsf(s.f - * (float *)val) > FLT_EPSILON)) {
+				s.f = *(float *)val;
+				param_changed = true;
+			}
 
-			/* add it to the array and sort */
-			utarray_push_back(param_values, &buf);
-			utarray_sort(param_values, param_compare_values);
 			params_changed.set(param, true);
+			params_unsaved.set(param, !mark_saved);
+			result = PX4_OK;
+			break;
 
-			/* find it after sorting */
-			s = param_find_changed(param);
+		default:
+			PX4_ERR("param_set invalid param type for %s", param_name(param));
+			break;
 		}
 
-		if (s == nullptr) {
-			PX4_ERR("error param_values storage slot invalid");
-
-		} else {
-			/* update the changed value */
-			switch (param_type(param)) {
-			case PARAM_TYPE_INT32:
-				if (s->val.i != *(int32_t *)val) {
-					s->val.i = *(int32_t *)val;
-					param_changed = true;
-				}
-
-				params_changed.set(param, true);
-				params_unsaved.set(param, !mark_saved);
-				result = PX4_OK;
-				break;
-
-			case PARAM_TYPE_FLOAT:
-				if (fabsf(s->val.f - * (float *)val) > FLT_EPSILON) {
-					s->val.f = *(float *)val;
-					param_changed = true;
-				}
-
-				params_changed.set(param, true);
-				params_unsaved.set(param, !mark_saved);
-				result = PX4_OK;
-				break;
-
-			default:
-				PX4_ERR("param_set invalid param type for %s", param_name(param));
-				break;
-			}
-		}
+		param_values_write_end();
 
 		if ((result == PX4_OK) && param_changed && !mark_saved) { // this is false when importing parameters
 			param_autosave();
 		}
 	}
 
-out:
 	perf_end(param_set_perf);
 	param_unlock_writer();
 
@@ -779,6 +819,11 @@ const void *param_get_value_ptr_external(param_t param)
 {
 	return param_get_value_ptr(param);
 }
+
+bool param_value_changed_external(param_t param)
+{
+	return handle_in_range(param) && params_changed[param];
+}
 #endif
 
 int param_set(param_t param, const void *val)
@@ -858,6 +903,9 @@ int param_set_default_value(param_t param, const void *val)
 		s = (param_wbuf_s *)utarray_find(param_custom_default_values, &key, param_compare_values);
 	}
 
+	// lock-free readers use the custom default bit to decide whether to take the lock
+	param_values_write_begin();
+
 	if (setting_to_static_default) {
 		if (s != nullptr) {
 			// param in memory and set to non-default value, clear
@@ -904,6 +952,8 @@ int param_set_default_value(param_t param, const void *val)
 		}
 	}
 
+	param_values_write_end();
+
 	param_unlock_writer();
 
 	if ((result == PX4_OK) && param_used(param)) {
@@ -916,22 +966,19 @@ int param_set_default_value(param_t param, const void *val)
 
 static int param_reset_internal(param_t param, bool notify = true)
 {
-	param_wbuf_s *s = nullptr;
+	bool was_changed = false;
 	bool param_found = false;
 
 	param_lock_writer();
 
 	if (handle_in_range(param)) {
-		/* look for a saved value */
-		s = param_find_changed(param);
-
-		/* if we found one, erase it */
-		if (s != nullptr) {
-			int pos = utarray_eltidx(param_values, s);
-			utarray_erase(param_values, pos, 1);
-		}
+		/* dropping the changed bit is enough, the stale value is overwritten on the next set */
+		was_changed = params_changed[param];
 
+		param_values_write_begin();
 		params_changed.set(param, false);
+		param_values_write_end();
+
 		params_unsaved.set(param, true);
 
 		param_found = true;
@@ -941,7 +988,7 @@ static int param_reset_internal(param_t param, bool notify = true)
 
 	param_unlock_writer();
 
-	if (s != nullptr && notify) {
+	if (was_changed && notify) {
 		param_notify_changes();
 	}
 
@@ -956,16 +1003,14 @@ param_reset_all_internal(bool auto_save)
 {
 	param_lock_writer();
 
-	if (param_values != nullptr) {
-		utarray_free(param_values);
-
-		params_changed.reset();
-	}
-
 	/* mark as reset / deleted */
-	param_values = nullptr;
+	param_values_write_begin();
+	params_changed.reset();
+	param_values_write_end();
 
 	if (auto_save) {
+		// resets are not tracked per parameter, the default file has to be rewritten
+		param_journal_compact_required.store(true);
 		param_autosave();
 	}
 
@@ -1049,10 +1094,34 @@ param_set_default_file(const char *filename)
 		param_default_file = nullptr;
 	}
 
-	if (filename) {
+	if (param_journal_file != nullptr) {
+		free(param_journal_file);
+		param_journal_file = nullptr;
+	}
+
+	struct stat st {};
+
+	if (filename && (stat(filename, &st) == 0) && !S_ISREG(st.st_mode)) {
+		// e.g. an MTD partition, which has no place for the journal next to it
+		param_default_file = strdup(filename);
+		PX4_DEBUG("%s is not a regular file, journal disabled", filename);
+
+	} else if (filename) {
 		param_default_file = strdup(filename);
+
+		static constexpr char journal_suffix[] = ".journal";
+		param_journal_file = (char *)malloc(strlen(filename) + sizeof(journal_suffix));
+
+		if (param_journal_file) {
+			strcpy(param_journal_file, filename);
+			strcat(param_journal_file, journal_suffix);
+		}
 	}
 
+	// until the new file is loaded the journal can't be trusted
+	param_journal_size = 0;
+	param_journal_compact_required.store(true);
+
 #endif /* FLASH_BASED_PARAMS */
 
 	return 0;
@@ -1094,6 +1163,101 @@ const char *param_get_backup_file()
 static int param_export_internal(int fd, param_filter_func filter);
 static int param_verify(int fd);
 
+/**
+ * Truncate the journal to an empty one (header only).
+ * The caller must hold param_sem_save.
+ */
+static int param_journal_reset()
+{
+	param_journal_size = 0;
+
+	int fd = ::open(param_journal_file, O_WRONLY | O_CREAT | O_TRUNC, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		return PX4_ERROR;
+	}
+
+	int ret = param_journal_write_header(fd);
+
+	if ((ret == 0) && (fsync(fd) == 0)) {
+		param_journal_size = PARAM_JOURNAL_HEADER_SIZE;
+	}
+
+	::close(fd);
+
+	return (param_journal_size > 0) ? PX4_OK : PX4_ERROR;
+}
+
+/**
+ * Append a record for every unsaved parameter to the journal.
+ * The caller must hold param_sem_save and the reader lock.
+ */
+static int param_journal_append_unsaved()
+{
+	if ((param_journal_size == 0) && (param_journal_reset() != PX4_OK)) {
+		return PX4_ERROR;
+	}
+
+	int fd = ::open(param_journal_file, O_WRONLY | O_APPEND);
+
+	if (fd < 0) {
+		return PX4_ERROR;
+	}
+
+	int result = PX4_OK;
+	uint8_t buf[256];
+	size_t len = 0;
+
+	for (param_t param = 0; handle_in_range(param) && (result == PX4_OK); param++) {
+		if (!params_unsaved[param]) {
+			continue;
+		}
+
+		param_journal_record_t type = PARAM_JOURNAL_RECORD_RESET;
+
+		if (params_changed[param]) {
+			type = (param_type(param) == PARAM_TYPE_INT32) ? PARAM_JOURNAL_RECORD_INT32 : PARAM_JOURNAL_RECORD_FLOAT;
+		}
+
+		len += param_journal_encode(&buf[len], param_name(param), type, param_changed_values[param]);
+
+		if (len + PARAM_JOURNAL_RECORD_MAX_SIZE > sizeof(buf)) {
+			result = (::write(fd, buf, len) == (ssize_t)len) ? PX4_OK : PX4_ERROR;
+			param_journal_size += len;
+			len = 0;
+		}
+	}
+
+	if ((result == PX4_OK) && (len > 0)) {
+		result = (::write(fd, buf, len) == (ssize_t)len) ? PX4_OK : PX4_ERROR;
+		param_journal_size += len;
+	}
+
+	if ((result == PX4_OK) && (fsync(fd) != 0)) {
+		result = PX4_ERROR;
+	}
+
+	::close(fd);
+
+	if (result != PX4_OK) {
+		// the journal might end with a partial record now, start over with a full save
+		param_journal_compact_required.store(true);
+	}
+
+	return result;
+}
+
+static void
+param_journal_compact_worker(void *arg)
+{
+	// the journal is over the size limit, so this rewrites the default file
+	int ret = param_save_default();
+
+	if (ret != 0) {
+		PX4_ERR("param journal compaction failed (%i)", ret);
+	}
+}
+
 int param_save_default()
 {
 	PX4_DEBUG("param_save_default");
@@ -1110,10 +1274,47 @@ int param_save_default()
 
 	int res = PX4_ERROR;
 	const char *filename = param_get_default_file();
+	bool journaled = false;
+
+	if (filename && param_journal_file && !param_journal_compact_required.load()
+	    && (param_journal_size < PARAM_JOURNAL_COMPACT_SIZE)) {
+		// only append the modified parameters instead of rewriting the whole file
+		perf_begin(param_journal_perf);
+		res = param_journal_append_unsaved();
+		perf_end(param_journal_perf);
+
+		if (res == PX4_OK) {
+			journaled = true;
+			params_unsaved.reset();
+
+			if (param_journal_size >= PARAM_JOURNAL_COMPACT_SIZE) {
+				// compact in the background, outside of the caller's context
+				work_queue(LPWORK, &param_journal_compact_work, (worker_t)&param_journal_compact_worker, nullptr, 0);
+			}
 
-	if (filename) {
+		} else {
+			PX4_ERR("param journal append to %s failed, saving all", param_journal_file);
+		}
+	}
+
+	if (journaled) {
+		// the default file is left untouched, the journal holds the modifications
+
+	} else if (filename) {
 		static constexpr int MAX_ATTEMPTS = 3;
 
+		if (param_journal_file) {
+			if (param_journal_compact_required.load()) {
+				// the journal doesn't describe the current values, it must not be replayed on top of the new file
+				param_journal_reset();
+
+			} else {
+				// bring the journal up to date first: replaying it on top of either the old or the new file
+				// then results in the current values, whenever a power loss interrupts the rewrite
+				param_journal_append_unsaved();
+			}
+		}
+
 		for (int attempt = 1; attempt <= MAX_ATTEMPTS; attempt++) {
 			// write parameters to file
 			int fd = ::open(filename, O_WRONLY | O_CREAT, PX4_O_MODE_666);
@@ -1153,8 +1354,20 @@ int param_save_default()
 	} else {
 		params_unsaved.reset();
 
-		// backup file
-		if (param_backup_file) {
+		if (!journaled && filename && param_journal_file) {
+			// the file now holds all values
+			if (param_journal_reset() == PX4_OK) {
+				param_journal_compact_required.store(false);
+
+			} else {
+				PX4_ERR("param journal reset of %s failed", param_journal_file);
+				param_journal_compact_required.store(true);
+			}
+		}
+
+		// backup file, only written with the full file: rewriting it on journaled saves would defeat the journal.
+		// It lags behind by at most the changes in the journal until the next compaction.
+		if (param_backup_file && !journaled) {
 			int fd_backup_file = ::open(param_backup_file, O_WRONLY | O_CREAT, PX4_O_MODE_666);
 
 			if (fd_backup_file > -1) {
@@ -1217,6 +1430,8 @@ param_load_default()
 		return -2;
 	}
 
+	param_load_default_journal();
+
 	return res;
 }
 
@@ -1370,7 +1585,6 @@ static int param_export_internal(int fd, param_filter_func filter)
 	PX4_DEBUG("param_export_internal");
 
 	int result = -1;
-	param_wbuf_s *s = nullptr;
 	bson_encoder_s encoder{};
 	uint8_t bson_buffer[256];
 
@@ -1378,25 +1592,26 @@ static int param_export_internal(int fd, param_filter_func filter)
 		goto out;
 	}
 
-	// no modified parameters, export empty BSON document
-	if (param_values == nullptr) {
-		result = 0;
-		goto out;
-	}
+	for (param_t param = 0; handle_in_range(param); param++) {
+		// only modified parameters, none results in an empty BSON document
+		if (!params_changed[param]) {
+			continue;
+		}
 
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != nullptr) {
-		if (filter && !filter(s->param)) {
+		if (filter && !filter(param)) {
 			continue;
 		}
 
+		const param_value_u *s = &param_changed_values[param];
+
 		// don't export default values
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 		case PARAM_TYPE_INT32: {
 				int32_t default_value = 0;
-				param_get_default_value_internal(s->param, &default_value);
+				param_get_default_value_internal(param, &default_value);
 
-				if (s->val.i == default_value) {
-					PX4_DEBUG("skipping %s %" PRIi32 " export", param_name(s->param), default_value);
+				if (s->i == default_value) {
+					PX4_DEBUG("skipping %s %" PRIi32 " export", param_name(param), default_value);
 					continue;
 				}
 			}
@@ -1404,24 +1619,24 @@ static int param_export_internal(int fd, param_filter_func filter)
 
 		case PARAM_TYPE_FLOAT: {
 				float default_value = 0;
-				param_get_default_value_internal(s->param, &default_value);
+				param_get_default_value_internal(param, &default_value);
 
-				if (fabsf(s->val.f - default_value) <= FLT_EPSILON) {
-					PX4_DEBUG("skipping %s %.3f export", param_name(s->param), (double)default_value);
+				if (fabsf(s->f - default_value) <= FLT_EPSILON) {
+					PX4_DEBUG("skipping %s %.3f export", param_name(param), (double)default_value);
 					continue;
 				}
 			}
 			break;
 		}
 
-		const char *name = param_name(s->param);
-		const size_t size = param_size(s->param);
+		const char *name = param_name(param);
+		const size_t size = param_size(param);
 
 		/* append the appropriate BSON type object */
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 		case PARAM_TYPE_INT32: {
-				const int32_t i = s->val.i;
-				PX4_DEBUG("exporting: %s (%d) size: %lu val: %" PRIi32, name, s->param, (long unsigned int)size, i);
+				const int32_t i = s->i;
+				PX4_DEBUG("exporting: %s (%d) size: %lu val: %" PRIi32, name, param, (long unsigned int)size, i);
 
 				if (bson_encoder_append_int32(&encoder, name, i) != 0) {
 					PX4_ERR("BSON append failed for '%s'", name);
@@ -1431,8 +1646,8 @@ static int param_export_internal(int fd, param_filter_func filter)
 			break;
 
 		case PARAM_TYPE_FLOAT: {
-				const double f = (double)s->val.f;
-				PX4_DEBUG("exporting: %s (%d) size: %lu val: %.3f", name, s->param, (long unsigned int)size, (double)f);
+				const double f = (double)s->f;
+				PX4_DEBUG("exporting: %s (%d) size: %lu val: %.3f", name, param, (long unsigned int)size, (double)f);
 
 				if (bson_encoder_append_double(&encoder, name, f) != 0) {
 					PX4_ERR("BSON append failed for '%s'", name);
@@ -1442,7 +1657,7 @@ static int param_export_internal(int fd, param_filter_func filter)
 			break;
 
 		default:
-			PX4_ERR("%s unrecognized parameter type %d, skipping export", name, param_type(s->param));
+			PX4_ERR("%s unrecognized parameter type %d, skipping export", name, param_type(param));
 		}
 	}
 
@@ -1611,6 +1826,10 @@ param_import(int fd)
 		return flash_param_import();
 	}
 
+	// imported values are marked as saved, they only get to the default file with a full rewrite.
+	// This is cleared again by param_load_default_journal() if fd was the default file.
+	param_journal_compact_required.store(true);
+
 	return param_import_internal(fd);
 }
 
@@ -1621,10 +1840,103 @@ param_load(int fd)
 		return flash_param_load();
 	}
 
+	param_journal_compact_required.store(true);
+
 	param_reset_all_internal(false);
 	return param_import_internal(fd);
 }
 
+static void
+param_journal_replay_callback(void *arg, const char *name, param_journal_record_t type, const param_value_u &value)
+{
+	bson_node_s node{};
+	strncpy(node.name, name, sizeof(node.name) - 1);
+
+	switch (type) {
+	case PARAM_JOURNAL_RECORD_INT32:
+		node.type = BSON_INT32;
+		node.i32 = value.i;
+		break;
+
+	case PARAM_JOURNAL_RECORD_FLOAT:
+		node.type = BSON_DOUBLE;
+		node.d = value.f;
+		break;
+
+	case PARAM_JOURNAL_RECORD_RESET: {
+			param_t param = param_find_no_notification(name);
+
+			if (param != PARAM_INVALID) {
+				param_lock_writer();
+				param_values_write_begin();
+				params_changed.set(param, false);
+				param_values_write_end();
+				param_unlock_writer();
+			}
+		}
+
+		return;
+	}
+
+	// same handling (including translation of renamed parameters) as for the default file
+	param_import_callback(nullptr, &node);
+}
+
+int
+param_load_default_journal()
+{
+	if (param_journal_file == nullptr) {
+		return 0;
+	}
+
+	do {} while (px4_sem_wait(&param_sem_save) != 0);
+
+	int ret = 0;
+	int fd = ::open(param_journal_file, O_RDWR);
+
+	if (fd < 0) {
+		// no journal, the default file holds all values
+		param_journal_size = 0;
+		param_journal_compact_required.store(errno != ENOENT);
+
+	} else {
+		const hrt_abstime start = hrt_absolute_time();
+		int num_records = 0;
+		const off_t valid_end = param_journal_replay(fd, &param_journal_replay_callback, nullptr, &num_records);
+		const off_t file_size = lseek(fd, 0, SEEK_END);
+
+		if (valid_end < 0) {
+			PX4_ERR("param journal %s invalid, ignoring", param_journal_file);
+			param_journal_compact_required.store(true);
+			ret = -1;
+
+		} else {
+			bool truncated = true;
+
+			if (valid_end < file_size) {
+				// a save was interrupted, drop the incomplete records
+				PX4_WARN("param journal: dropping %d bytes of incomplete records", (int)(file_size - valid_end));
+				truncated = (ftruncate(fd, valid_end) == 0);
+			}
+
+			param_journal_size = valid_end;
+			param_journal_compact_required.store(!truncated);
+
+			PX4_INFO("param journal: %d records replayed in %.3f ms", num_records, hrt_elapsed_time(&start) * 1e-3);
+		}
+
+		::close(fd);
+
+		if (num_records > 0) {
+			param_notify_changes();
+		}
+	}
+
+	px4_sem_post(&param_sem_save);
+
+	return ret;
+}
+
 int
 param_dump(int fd)
 {
@@ -1669,7 +1981,7 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 	for (param = 0; handle_in_range(param); param++) {
 
 		/* if requested, skip unchanged values */
-		if (only_changed && (param_find_changed(param) == nullptr)) {
+		if (only_changed && !params_changed[param]) {
 			continue;
 		}
 
@@ -1704,6 +2016,258 @@ uint32_t param_hash_check()
 	return param_hash;
 }
 
+#if defined(__PX4_POSIX)
+#include <sys/mman.h>
+
+/* snapshot file (see param_snapshot_save()): header, flags[count], values[count], custom_defaults[count] */
+static constexpr uint32_t PARAM_SNAPSHOT_MAGIC = 0x53503450; // "P4PS"
+static constexpr uint32_t PARAM_SNAPSHOT_VERSION = 1;
+
+enum param_snapshot_flags_t : uint8_t {
+	PARAM_SNAPSHOT_CHANGED        = (1 << 0),
+	PARAM_SNAPSHOT_CUSTOM_DEFAULT = (1 << 1),
+	PARAM_SNAPSHOT_ACTIVE         = (1 << 2),
+	PARAM_SNAPSHOT_UNSAVED        = (1 << 3),
+};
+
+struct param_snapshot_header_s {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t build_id;
+	uint32_t key;
+	uint32_t param_count;
+	uint32_t metadata_crc;		///< parameter names, types and static defaults of the build
+	uint32_t file_crc;		///< default file and journal at the time of the snapshot
+	uint32_t data_crc;		///< everything after the header
+	uint32_t setup_time_us;		///< boot time until the snapshot was taken
+};
+
+static constexpr size_t PARAM_SNAPSHOT_SIZE = sizeof(param_snapshot_header_s) + param_info_count *
+		(sizeof(uint8_t) + 2 * sizeof(uint32_t));
+
+/** boot time until the end of the parameter setup without snapshot, 0 if not restored from a snapshot */
+static uint32_t param_snapshot_restored_setup_time = 0;
+
+static uint32_t param_metadata_crc()
+{
+	uint32_t crc = 0;
+
+	for (param_t param = 0; handle_in_range(param); param++) {
+		const char *name = param_name(param);
+		const uint8_t type = param_type(param);
+		crc = crc32part((const uint8_t *)name, strlen(name) + 1, crc);
+		crc = crc32part(&type, sizeof(type), crc);
+		crc = crc32part((const uint8_t *)&px4::parameters[param].val, param_size(param), crc);
+	}
+
+	return crc;
+}
+
+static uint32_t param_file_crc(const char *filename, uint32_t crc)
+{
+	int fd = (filename != nullptr) ? ::open(filename, O_RDONLY) : -1;
+
+	if (fd < 0) {
+		// a missing file is a valid state as well
+		static constexpr uint8_t missing = 0xff;
+		return crc32part(&missing, sizeof(missing), crc);
+	}
+
+	uint8_t buffer[512];
+	ssize_t n;
+
+	while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+		crc = crc32part(buffer, n, crc);
+	}
+
+	::close(fd);
+	return crc;
+}
+
+int param_snapshot_save(const char *filename, uint64_t build_id, uint32_t key)
+{
+	const uint32_t setup_time = px4_boot_profile_time();
+
+	if (param_snapshot_restored_setup_time > 0) {
+		const int32_t saved = (int32_t)param_snapshot_restored_setup_time - (int32_t)setup_time;
+		PX4_INFO("param setup took %.1f ms, %.1f ms without snapshot (%.1f ms saved)", setup_time * 1e-3,
+			 param_snapshot_restored_setup_time * 1e-3, saved * 1e-3);
+		return PX4_OK;
+	}
+
+	uint8_t *data = (uint8_t *)malloc(PARAM_SNAPSHOT_SIZE);
+
+	if (data == nullptr) {
+		return -ENOMEM;
+	}
+
+	param_snapshot_header_s &header = *(param_snapshot_header_s *)data;
+	uint8_t *flags = data + sizeof(param_snapshot_header_s);
+	uint32_t *values = (uint32_t *)(flags + param_info_count);
+	uint32_t *custom_defaults = values + param_info_count;
+
+	param_lock_reader();
+
+	for (param_t param = 0; handle_in_range(param); param++) {
+		flags[param] = (params_changed[param] ? PARAM_SNAPSHOT_CHANGED : 0)
+			       | (params_custom_default[param] ? PARAM_SNAPSHOT_CUSTOM_DEFAULT : 0)
+			       | (params_active[param] ? PARAM_SNAPSHOT_ACTIVE : 0)
+			       | (params_unsaved[param] ? PARAM_SNAPSHOT_UNSAVED : 0);
+		values[param] = 0;
+		custom_defaults[param] = 0;
+
+		if (params_changed[param]) {
+			memcpy(&values[param], &param_changed_values[param], param_size(param));
+		}
+
+		if (params_custom_default[param]) {
+			param_get_default_value_internal(param, &custom_defaults[param]);
+		}
+	}
+
+	param_unlock_reader();
+
+	header.magic = PARAM_SNAPSHOT_MAGIC;
+	header.version = PARAM_SNAPSHOT_VERSION;
+	header.build_id = build_id;
+	header.key = key;
+	header.param_count = param_info_count;
+	header.metadata_crc = param_metadata_crc();
+	header.file_crc = param_file_crc(param_journal_file, param_file_crc(param_get_default_file(), 0));
+	header.data_crc = crc32part(flags, PARAM_SNAPSHOT_SIZE - sizeof(param_snapshot_header_s), 0);
+	header.setup_time_us = setup_time;
+
+	int ret = PX4_OK;
+	int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, PX4_O_MODE_666);
+
+	if (fd < 0) {
+		PX4_ERR("open '%s' for writing failed", filename);
+		ret = -1;
+
+	} else {
+		if (::write(fd, data, PARAM_SNAPSHOT_SIZE) != (ssize_t)PARAM_SNAPSHOT_SIZE) {
+			PX4_ERR("writing snapshot '%s' failed", filename);
+			ret = -1;
+		}
+
+		::close(fd);
+	}
+
+	if (ret != PX4_OK) {
+		::unlink(filename);
+	}
+
+	free(data);
+	return ret;
+}
+
+int param_snapshot_load(const char *filename, uint64_t build_id, uint32_t key)
+{
+	// wall clock, the lockstep time might not be running yet
+	const uint64_t start = px4_boot_profile_time();
+
+	int fd = ::open(filename, O_RDONLY);
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	struct stat st {};
+
+	if ((fstat(fd, &st) != 0) || (st.st_size != (off_t)PARAM_SNAPSHOT_SIZE)) {
+		PX4_INFO("snapshot '%s' outdated (size)", filename);
+		::close(fd);
+		return -1;
+	}
+
+	uint8_t *data = (uint8_t *)mmap(nullptr, PARAM_SNAPSHOT_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (data == MAP_FAILED) {
+		PX4_ERR("mmap '%s' failed", filename);
+		return -1;
+	}
+
+	const param_snapshot_header_s &header = *(const param_snapshot_header_s *)data;
+	const uint8_t *flags = data + sizeof(param_snapshot_header_s);
+	const uint32_t *values = (const uint32_t *)(flags + param_info_count);
+	const uint32_t *custom_defaults = values + param_info_count;
+
+	const char *outdated = nullptr;
+
+	if ((header.magic != PARAM_SNAPSHOT_MAGIC) || (header.version != PARAM_SNAPSHOT_VERSION)
+	    || (header.param_count != param_info_count)
+	    || (header.data_crc != crc32part(flags, PARAM_SNAPSHOT_SIZE - sizeof(param_snapshot_header_s), 0))) {
+		outdated = "invalid";
+
+	} else if ((header.build_id != build_id) || (header.metadata_crc != param_metadata_crc())) {
+		outdated = "build changed";
+
+	} else if (header.key != key) {
+		outdated = "configuration changed";
+
+	} else if (header.file_crc != param_file_crc(param_journal_file, param_file_crc(param_get_default_file(), 0))) {
+		outdated = "parameter file changed";
+	}
+
+	if (outdated != nullptr) {
+		PX4_INFO("snapshot '%s' outdated (%s)", filename, outdated);
+		munmap(data, PARAM_SNAPSHOT_SIZE);
+		return -1;
+	}
+
+	param_lock_writer();
+
+	if (param_custom_default_values == nullptr) {
+		utarray_new(param_custom_default_values, &param_icd);
+
+	} else {
+		utarray_clear(param_custom_default_values);
+	}
+
+	param_values_write_begin();
+
+	for (param_t param = 0; handle_in_range(param); param++) {
+		params_changed.set(param, flags[param] & PARAM_SNAPSHOT_CHANGED);
+		params_custom_default.set(param, flags[param] & PARAM_SNAPSHOT_CUSTOM_DEFAULT);
+		params_active.set(param, flags[param] & PARAM_SNAPSHOT_ACTIVE);
+		params_unsaved.set(param, flags[param] & PARAM_SNAPSHOT_UNSAVED);
+
+		if (flags[param] & PARAM_SNAPSHOT_CHANGED) {
+			memcpy(&param_changed_values[param], &values[param], param_size(param));
+		}
+
+		if (flags[param] & PARAM_SNAPSHOT_CUSTOM_DEFAULT) {
+			// in param order, the array stays sorted
+			param_wbuf_s buf{};
+			buf.param = param;
+			memcpy(&buf.val, &custom_defaults[param], param_size(param));
+			utarray_push_back(param_custom_default_values, &buf);
+		}
+	}
+
+	param_values_write_end();
+
+	param_unlock_writer();
+
+	param_snapshot_restored_setup_time = header.setup_time_us;
+	munmap(data, PARAM_SNAPSHOT_SIZE);
+
+	PX4_INFO("restored %zu changed params from snapshot in %.3f ms", params_changed.count(),
+		 (px4_boot_profile_time() - start) * 1e-3);
+
+	param_notify_changes();
+
+	return PX4_OK;
+}
+
+#else
+
+int param_snapshot_save(const char *filename, uint64_t build_id, uint32_t key) { return -1; }
+int param_snapshot_load(const char *filename, uint64_t build_id, uint32_t key) { return -1; }
+
+#endif /* defined(__PX4_POSIX) */
+
 void param_print_status()
 {
 	PX4_INFO("summary: %d/%d (used/total)", param_count_used(), param_count());
@@ -1719,12 +2283,15 @@ void param_print_status()
 		PX4_INFO("backup file: %s", param_backup_file);
 	}
 
+	if (param_journal_file) {
+		PX4_INFO("journal: %s (%d bytes%s)", param_journal_file, (int)param_journal_size,
+			 param_journal_compact_required.load() ? ", full save pending" : "");
+	}
+
 #endif /* FLASH_BASED_PARAMS */
 
-	if (param_values != nullptr) {
-		PX4_INFO("storage array: %d/%d elements (%zu bytes total)",
-			 utarray_len(param_values), param_values->n, param_values->n * sizeof(UT_icd));
-	}
+	PX4_INFO("changed values: %zu/%d (%zu bytes total)",
+		 params_changed.count(), (int)param_info_count, sizeof(param_changed_values));
 
 	if (param_custom_default_values != nullptr) {
 		PX4_INFO("storage array (custom defaults): %d/%d elements (%zu bytes total)",
@@ -1739,6 +2306,7 @@ void param_print_status()
 	}
 
 	perf_print_counter(param_export_perf);
+	perf_print_counter(param_journal_perf);
 	perf_print_counter(param_find_perf);
 	perf_print_counter(param_get_perf);
 	perf_print_counter(param_set_perf);
@@ -20,6 +20,61 @@ except ImportError as e:
 
 import os
 
+def name_hash(name, seed):
+    """
+    FNV-1a with a seeded offset basis and a murmur3 finalizer.
+    Must match param_name_hash() in parameters.cpp.
+    """
+    h = (2166136261 ^ seed) & 0xffffffff
+    for c in name.encode('ascii'):
+        h ^= c
+        h = (h * 16777619) & 0xffffffff
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    h ^= h >> 16
+    return h
+
+def generate_perfect_hash(names):
+    """
+    Build a perfect hash (hash and displace) for the parameter names.
+
+    The first level hash assigns each name to a bucket, every bucket gets a
+    displacement seed such that the second level hash maps all its names to
+    distinct free slots.
+
+    @return (displacements, slots): slots contain the parameter index or 0xffff
+    """
+    num_buckets = max(1, (len(names) + 3) // 4)
+    num_slots = max(1, len(names) + len(names) // 4)
+
+    buckets = [[] for _ in range(num_buckets)]
+    for index, name in enumerate(names):
+        buckets[name_hash(name, 0) % num_buckets].append(index)
+
+    displacements = [0] * num_buckets
+    slots = [0xffff] * num_slots
+
+    # place the largest buckets first, they are the hardest to fit
+    for bucket_index in sorted(range(num_buckets), key=lambda b: -len(buckets[b])):
+        bucket = buckets[bucket_index]
+        if not bucket:
+            continue
+
+        for seed in range(1, 0xffff):
+            positions = [name_hash(names[i], seed) % num_slots for i in bucket]
+            if len(set(positions)) == len(positions) and all(slots[p] == 0xffff for p in positions):
+                break
+        else:
+            raise Exception("failed to generate perfect hash for parameter names")
+
+        displacements[bucket_index] = seed
+        for i, p in zip(bucket, positions):
+            slots[p] = i
+
+    return displacements, slots
+
 def generate(xml_file, dest='.'):
     """
     Generate px4 param source from xml.
@@ -40,6 +95,8 @@ def generate(xml_file, dest='.'):
 
     params = sorted(params, key=lambda name: name.attrib["name"])
 
+    hash_displacements, hash_slots = generate_perfect_hash([p.attrib["name"] for p in params])
+
     script_path = os.path.dirname(os.path.realpath(__file__))
 
     # for jinja docs see: http://jinja.pocoo.org/docs/2.9/api/
@@ -56,7 +113,8 @@ def generate(xml_file, dest='.'):
         template = env.get_template(template_file)
         with open(os.path.join(
                 dest, template_file.replace('.jinja','')), 'w') as fid:
-            fid.write(template.render(params=params))
+            fid.write(template.render(params=params,
+                hash_displacements=hash_displacements, hash_slots=hash_slots))
 
 if __name__ == "__main__":
     arg_parser = argparse.ArgumentParser()
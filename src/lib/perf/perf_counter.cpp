@@ -620,6 +620,10 @@ perf_print_latency(int fd)
 	// print the overflow bucket value
 	latency = get_latency(get_latency_bucket_count() - 1, get_latency_bucket_count());
 	dprintf(fd, " >%4" PRIu16 " : %" PRIu32 "\n", latency.bucket, latency.counter);
+
+#if defined(__PX4_POSIX)
+	hrt_print_callout_jitter(fd);
+#endif
 }
 
 void
@@ -636,4 +640,8 @@ perf_reset_all(void)
 	pthread_mutex_unlock(&perf_counters_mutex);
 
 	reset_latency_counters();
+
+#if defined(__PX4_POSIX)
+	hrt_reset_callout_jitter();
+#endif
 }
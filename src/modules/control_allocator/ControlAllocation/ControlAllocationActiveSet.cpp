@@ -0,0 +1,334 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocationActiveSet.cpp
+ *
+ * Weighted least-squares control allocation with an active set solver
+ */
+
+#include "ControlAllocationActiveSet.hpp"
+
+#include <mathlib/mathlib.h>
+
+namespace
+{
+// gamma, weight of the control error relative to the deviation from the unconstrained solution
+static constexpr float CONTROL_ERROR_WEIGHT = 1000.f;
+
+// Wv, priority of the axes when the control setpoint cannot be allocated: roll/pitch over thrust over yaw
+static constexpr float AXIS_WEIGHTS[ControlAllocation::NUM_AXES] {1.f, 1.f, 0.3f, 0.5f, 0.5f, 0.5f};
+
+// stop when no saturated actuator can reduce the cost by more than this
+static constexpr float MULTIPLIER_TOLERANCE = 1e-5f;
+} // namespace
+
+void
+ControlAllocationActiveSet::setEffectivenessMatrix(
+	const matrix::Matrix<float, ControlAllocation::NUM_AXES, ControlAllocation::NUM_ACTUATORS> &effectiveness,
+	const ActuatorVector &actuator_trim, const ActuatorVector &linearization_point, int num_actuators,
+	bool update_normalization_scale)
+{
+	ControlAllocationPseudoInverse::setEffectivenessMatrix(effectiveness, actuator_trim, linearization_point,
+			num_actuators, update_normalization_scale);
+	_hessian_update_needed = true;
+}
+
+void
+ControlAllocationActiveSet::updateHessian()
+{
+	if (!_hessian_update_needed) {
+		return;
+	}
+
+	// effectiveness in the normalized control space of the mix, same scaling as normalizeControlAllocationMatrix()
+	float scale[NUM_AXES];
+
+	for (int axis = 0; axis < NUM_AXES; axis++) {
+		scale[axis] = 1.f;
+	}
+
+	if (_control_allocation_scale(0) > FLT_EPSILON) {
+		scale[0] = _control_allocation_scale(0);
+		scale[1] = _control_allocation_scale(1);
+	}
+
+	if (_control_allocation_scale(2) > FLT_EPSILON) {
+		scale[2] = _control_allocation_scale(2);
+	}
+
+	if (_control_allocation_scale(3) > FLT_EPSILON) {
+		scale[3] = _control_allocation_scale(3);
+		scale[4] = _control_allocation_scale(4);
+		scale[5] = _control_allocation_scale(5);
+	}
+
+	matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> effectiveness_normalized;
+
+	for (int axis = 0; axis < NUM_AXES; axis++) {
+		const float weight = CONTROL_ERROR_WEIGHT * AXIS_WEIGHTS[axis] * AXIS_WEIGHTS[axis];
+
+		for (int i = 0; i < _num_actuators; i++) {
+			effectiveness_normalized(axis, i) = scale[axis] * _effectiveness(axis, i);
+			_effectiveness_weighted(axis, i) = weight * effectiveness_normalized(axis, i);
+		}
+	}
+
+	for (int i = 0; i < _num_actuators; i++) {
+		for (int j = i; j < _num_actuators; j++) {
+			float sum = (i == j) ? 1.f : 0.f;
+
+			for (int axis = 0; axis < NUM_AXES; axis++) {
+				sum += effectiveness_normalized(axis, i) * _effectiveness_weighted(axis, j);
+			}
+
+			_hessian[i][j] = sum;
+			_hessian[j][i] = sum;
+		}
+	}
+
+	_hessian_update_needed = false;
+}
+
+void
+ControlAllocationActiveSet::updateGradient(const ActuatorVector &linear_term, const ActuatorVector &delta)
+{
+	for (int i = 0; i < _num_actuators; i++) {
+		float sum = linear_term(i);
+
+		for (int j = 0; j < _num_actuators; j++) {
+			sum -= _hessian[i][j] * delta(j);
+		}
+
+		_gradient[i] = sum;
+	}
+}
+
+bool
+ControlAllocationActiveSet::solveFree(int num_free)
+{
+	// Cholesky decomposition, the lower triangle of _hessian_free is replaced by L
+	for (int j = 0; j < num_free; j++) {
+		float diag = _hessian_free[j][j];
+
+		for (int k = 0; k < j; k++) {
+			diag -= _hessian_free[j][k] * _hessian_free[j][k];
+		}
+
+		if (diag <= FLT_EPSILON) {
+			return false;
+		}
+
+		diag = sqrtf(diag);
+		_hessian_free[j][j] = diag;
+
+		for (int i = j + 1; i < num_free; i++) {
+			float sum = _hessian_free[i][j];
+
+			for (int k = 0; k < j; k++) {
+				sum -= _hessian_free[i][k] * _hessian_free[j][k];
+			}
+
+			_hessian_free[i][j] = sum / diag;
+		}
+	}
+
+	// forward substitution L y = b
+	for (int i = 0; i < num_free; i++) {
+		float sum = _rhs_free[i];
+
+		for (int k = 0; k < i; k++) {
+			sum -= _hessian_free[i][k] * _rhs_free[k];
+		}
+
+		_rhs_free[i] = sum / _hessian_free[i][i];
+	}
+
+	// back substitution L^T x = y
+	for (int i = num_free - 1; i >= 0; i--) {
+		float sum = _rhs_free[i];
+
+		for (int k = i + 1; k < num_free; k++) {
+			sum -= _hessian_free[k][i] * _rhs_free[k];
+		}
+
+		_rhs_free[i] = sum / _hessian_free[i][i];
+	}
+
+	return true;
+}
+
+void
+ControlAllocationActiveSet::allocate()
+{
+	//Compute new gains if needed
+	updatePseudoInverse();
+	updateHessian();
+
+	_prev_actuator_sp = _actuator_sp;
+
+	// The problem is solved for the deviation from trim
+	const matrix::Vector<float, NUM_AXES> control = _control_sp - _control_trim;
+	const ActuatorVector unconstrained = _mix * control;
+	const ActuatorVector linear_term = _effectiveness_weighted.transpose() * control + unconstrained;
+
+	ActuatorVector lower;
+	ActuatorVector upper;
+	ActuatorVector delta;
+
+	// warm start from the previous solution and active set, which is feasible after clipping
+	for (int i = 0; i < _num_actuators; i++) {
+		lower(i) = _actuator_min(i) - _actuator_trim(i);
+		upper(i) = _actuator_max(i) - _actuator_trim(i);
+
+		if (upper(i) < lower(i)) {
+			_bound[i] = Bound::FIXED;
+			delta(i) = 0.f;
+
+		} else {
+			if (_bound[i] == Bound::FIXED) {
+				_bound[i] = Bound::FREE;
+			}
+
+			delta(i) = math::constrain(_actuator_sp(i) - _actuator_trim(i), lower(i), upper(i));
+
+			if (_bound[i] == Bound::LOWER) {
+				delta(i) = lower(i);
+
+			} else if (_bound[i] == Bound::UPPER) {
+				delta(i) = upper(i);
+			}
+		}
+	}
+
+	int iteration = 0;
+
+	for (; iteration < MAX_ITERATIONS; iteration++) {
+		updateGradient(linear_term, delta);
+
+		// optimal step for the free actuators with the saturated ones held at their limits
+		int num_free = 0;
+
+		for (int i = 0; i < _num_actuators; i++) {
+			if (_bound[i] == Bound::FREE) {
+				_free_index[num_free++] = i;
+			}
+		}
+
+		for (int k = 0; k < num_free; k++) {
+			for (int l = 0; l <= k; l++) {
+				_hessian_free[k][l] = _hessian[_free_index[k]][_free_index[l]];
+			}
+
+			_rhs_free[k] = _gradient[_free_index[k]];
+		}
+
+		if (num_free > 0 && !solveFree(num_free)) {
+			break;
+		}
+
+		// shorten the step at the first actuator limit it hits
+		float step = 1.f;
+		int blocking = -1;
+		Bound blocking_bound = Bound::FREE;
+
+		for (int k = 0; k < num_free; k++) {
+			const int i = _free_index[k];
+			const float target = delta(i) + _rhs_free[k];
+
+			if (target < lower(i)) {
+				const float max_step = (lower(i) - delta(i)) / _rhs_free[k];
+
+				if (max_step < step) {
+					step = max_step;
+					blocking = i;
+					blocking_bound = Bound::LOWER;
+				}
+
+			} else if (target > upper(i)) {
+				const float max_step = (upper(i) - delta(i)) / _rhs_free[k];
+
+				if (max_step < step) {
+					step = max_step;
+					blocking = i;
+					blocking_bound = Bound::UPPER;
+				}
+			}
+		}
+
+		for (int k = 0; k < num_free; k++) {
+			delta(_free_index[k]) += step * _rhs_free[k];
+		}
+
+		if (blocking >= 0) {
+			_bound[blocking] = blocking_bound;
+			delta(blocking) = (blocking_bound == Bound::LOWER) ? lower(blocking) : upper(blocking);
+			continue;
+		}
+
+		// full step taken: optimal if no saturated actuator wants to move back into its range
+		updateGradient(linear_term, delta);
+
+		float min_multiplier = -MULTIPLIER_TOLERANCE;
+		int release = -1;
+
+		for (int i = 0; i < _num_actuators; i++) {
+			float multiplier = 0.f;
+
+			if (_bound[i] == Bound::LOWER) {
+				multiplier = -_gradient[i];
+
+			} else if (_bound[i] == Bound::UPPER) {
+				multiplier = _gradient[i];
+			}
+
+			if (multiplier < min_multiplier) {
+				min_multiplier = multiplier;
+				release = i;
+			}
+		}
+
+		if (release < 0) {
+			break;
+		}
+
+		_bound[release] = Bound::FREE;
+	}
+
+	_last_iterations = math::min(iteration + 1, (int)MAX_ITERATIONS);
+
+	for (int i = 0; i < _num_actuators; i++) {
+		_actuator_sp(i) = _actuator_trim(i) + delta(i);
+	}
+}
@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocationActiveSet.hpp
+ *
+ * Weighted least-squares control allocation with actuator limits, solved with an active set method.
+ *
+ * It minimizes
+ *   gamma * |Wv (B u - v)|^2 + |Wu (u - u_d)|^2    subject to u_min <= u <= u_max
+ * where u_d is the unconstrained pseudo-inverse solution. Without saturation the result is identical
+ * to ControlAllocationPseudoInverse, with saturation the control error is distributed according to
+ * the axis weights instead of clipping or desaturating along fixed directions.
+ *
+ * The solver is warm started with the previous solution and set of saturated actuators, so usually
+ * it converges within one or two iterations. All workspaces are fixed size members.
+ *
+ * Reference: O. Härkegård, "Efficient active set algorithms for solving constrained least squares
+ * problems in aircraft control allocation", CDC 2002.
+ */
+
+#pragma once
+
+#include "ControlAllocationPseudoInverse.hpp"
+
+class ControlAllocationActiveSet: public ControlAllocationPseudoInverse
+{
+public:
+	ControlAllocationActiveSet() = default;
+	virtual ~ControlAllocationActiveSet() = default;
+
+	void allocate() override;
+	void setEffectivenessMatrix(const matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> &effectiveness,
+				    const ActuatorVector &actuator_trim, const ActuatorVector &linearization_point, int num_actuators,
+				    bool update_normalization_scale) override;
+
+	/**
+	 * Number of active set iterations used by the last call to allocate()
+	 */
+	int getLastIterations() const { return _last_iterations; }
+
+	static constexpr int MAX_ITERATIONS = 2 * NUM_ACTUATORS;
+
+protected:
+	/**
+	 * Recalculate the Hessian of the least-squares problem if the effectiveness or the scale changed.
+	 */
+	void updateHessian();
+
+private:
+	enum class Bound : int8_t {
+		LOWER = -1,
+		FREE = 0,
+		UPPER = 1,
+		FIXED = 2, ///< actuator range is empty, held at trim
+	};
+
+	/**
+	 * Update _gradient with the negative gradient of the cost for the actuator deviation from trim
+	 */
+	void updateGradient(const ActuatorVector &linear_term, const ActuatorVector &delta);
+
+	/**
+	 * Solve _hessian_free * x = _rhs_free for the free actuators with a Cholesky decomposition.
+	 *
+	 * @return false if the reduced Hessian is not positive definite
+	 */
+	bool solveFree(int num_free);
+
+	bool _hessian_update_needed{true};
+	int _last_iterations{0};
+
+	matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> _effectiveness_weighted; ///< gamma * Wv^2 * B_normalized
+	float _hessian[NUM_ACTUATORS][NUM_ACTUATORS] {};	///< gamma * B^T Wv^2 B + I (Wu = I)
+
+	// workspaces
+	Bound _bound[NUM_ACTUATORS] {};				///< active set, kept between calls for warm starting
+	int8_t _free_index[NUM_ACTUATORS] {};
+	float _hessian_free[NUM_ACTUATORS][NUM_ACTUATORS] {};	///< reduced Hessian, overwritten by its Cholesky factor
+	float _rhs_free[NUM_ACTUATORS] {};			///< reduced gradient, overwritten by the step
+	float _gradient[NUM_ACTUATORS] {};			///< negative gradient of the cost at the current solution
+};
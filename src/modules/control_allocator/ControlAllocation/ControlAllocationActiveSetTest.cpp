@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file ControlAllocationActiveSetTest.cpp
+ *
+ * Tests for the weighted least-squares active set allocation, compared to the existing methods
+ */
+
+#include <gtest/gtest.h>
+#include <ControlAllocationActiveSet.hpp>
+#include <ControlAllocationSequentialDesaturation.hpp>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+
+using namespace matrix;
+
+namespace
+{
+static constexpr int NUM_ACTUATORS = ControlAllocation::NUM_ACTUATORS;
+static constexpr int NUM_AXES = ControlAllocation::NUM_AXES;
+
+typedef Matrix<float, NUM_AXES, NUM_ACTUATORS> EffectivenessMatrix;
+typedef ControlAllocation::ActuatorVector ActuatorVector;
+
+uint64_t now_us()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+float randf(float min, float max)
+{
+	return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+// quadrotor in X configuration, same convention as ActuatorEffectivenessRotors
+EffectivenessMatrix quadEffectiveness()
+{
+	const float position[4][2] {{0.15f, 0.25f}, {-0.15f, -0.25f}, {0.15f, -0.25f}, {-0.15f, 0.25f}};
+	const float direction[4] {1.f, 1.f, -1.f, -1.f};
+	EffectivenessMatrix effectiveness;
+
+	for (int i = 0; i < 4; i++) {
+		effectiveness(0, i) = -position[i][1];
+		effectiveness(1, i) = position[i][0];
+		effectiveness(2, i) = -0.05f * direction[i];
+		effectiveness(5, i) = -1.f;
+	}
+
+	return effectiveness;
+}
+
+void setup(ControlAllocation &method, const EffectivenessMatrix &effectiveness, int num_actuators,
+	   const ActuatorVector &actuator_min, const ActuatorVector &actuator_max, const ActuatorVector &actuator_trim = {})
+{
+	method.setActuatorMin(actuator_min);
+	method.setActuatorMax(actuator_max);
+	method.setNormalizeRPY(true);
+	method.setEffectivenessMatrix(effectiveness, actuator_trim, ActuatorVector{}, num_actuators, true);
+}
+
+bool withinLimits(const ControlAllocation &method)
+{
+	for (int i = 0; i < method.numConfiguredActuators(); i++) {
+		if (method.getActuatorSetpoint()(i) < method.getActuatorMin()(i) - 1e-4f
+		    || method.getActuatorSetpoint()(i) > method.getActuatorMax()(i) + 1e-4f) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// error of the allocated control, weighted like the active set allocation (roll/pitch over thrust over yaw)
+float weightedError(const ControlAllocation &method)
+{
+	const float weights[NUM_AXES] {1.f, 1.f, 0.3f, 0.5f, 0.5f, 0.5f};
+	const Vector<float, NUM_AXES> error = method.getAllocatedControl() - method.getControlSetpoint();
+	float sum = 0.f;
+
+	for (int axis = 0; axis < NUM_AXES; axis++) {
+		sum += weights[axis] * weights[axis] * error(axis) * error(axis);
+	}
+
+	return sqrtf(sum);
+}
+} // namespace
+
+TEST(ControlAllocationActiveSetTest, UnsaturatedMatchesPseudoInverse)
+{
+	ControlAllocationPseudoInverse pseudo_inverse;
+	ControlAllocationActiveSet active_set;
+	ActuatorVector actuator_min;
+	ActuatorVector actuator_max;
+	actuator_max.setAll(1.f);
+	setup(pseudo_inverse, quadEffectiveness(), 4, actuator_min, actuator_max);
+	setup(active_set, quadEffectiveness(), 4, actuator_min, actuator_max);
+
+	// GIVEN: a control setpoint that can be allocated without saturation
+	const float control[NUM_AXES] {0.1f, -0.05f, 0.02f, 0.f, 0.f, -0.5f};
+	pseudo_inverse.setControlSetpoint(Vector<float, NUM_AXES>(control));
+	active_set.setControlSetpoint(Vector<float, NUM_AXES>(control));
+
+	// WHEN: we allocate
+	pseudo_inverse.allocate();
+	active_set.allocate();
+
+	// THEN: both methods give the same actuator setpoint
+	for (int i = 0; i < 4; i++) {
+		EXPECT_NEAR(active_set.getActuatorSetpoint()(i), pseudo_inverse.getActuatorSetpoint()(i), 1e-4f);
+	}
+
+	EXPECT_TRUE(withinLimits(active_set));
+}
+
+TEST(ControlAllocationActiveSetTest, SaturationPrioritizesRollPitch)
+{
+	ControlAllocationPseudoInverse pseudo_inverse;
+	ControlAllocationActiveSet active_set;
+	ActuatorVector actuator_min;
+	ActuatorVector actuator_max;
+	actuator_max.setAll(1.f);
+	setup(pseudo_inverse, quadEffectiveness(), 4, actuator_min, actuator_max);
+	setup(active_set, quadEffectiveness(), 4, actuator_min, actuator_max);
+
+	// GIVEN: a roll demand at almost full thrust
+	const float control[NUM_AXES] {0.6f, 0.f, 0.f, 0.f, 0.f, -0.9f};
+	pseudo_inverse.setControlSetpoint(Vector<float, NUM_AXES>(control));
+	active_set.setControlSetpoint(Vector<float, NUM_AXES>(control));
+
+	// WHEN: we allocate
+	pseudo_inverse.allocate();
+	pseudo_inverse.clipActuatorSetpoint();
+	active_set.allocate();
+
+	// THEN: the active set solution is within the limits without clipping
+	EXPECT_TRUE(withinLimits(active_set));
+
+	// THEN: roll is tracked better than with clipping, by giving up thrust
+	const Vector<float, NUM_AXES> allocated_clipped = pseudo_inverse.getAllocatedControl();
+	const Vector<float, NUM_AXES> allocated = active_set.getAllocatedControl();
+	EXPECT_LT(fabsf(allocated(0) - control[0]), fabsf(allocated_clipped(0) - control[0]));
+	EXPECT_NEAR(allocated(1), 0.f, 1e-3f);
+	EXPECT_GT(allocated(5), control[5]);
+	EXPECT_LT(weightedError(active_set), weightedError(pseudo_inverse));
+
+	// WHEN: we allocate the same setpoint again
+	active_set.allocate();
+
+	// THEN: the warm started solver converges immediately
+	EXPECT_EQ(active_set.getLastIterations(), 1);
+}
+
+TEST(ControlAllocationActiveSetTest, FixedActuator)
+{
+	ControlAllocationActiveSet active_set;
+	ActuatorVector actuator_min;
+	ActuatorVector actuator_max;
+	ActuatorVector actuator_trim;
+	actuator_max.setAll(1.f);
+
+	// GIVEN: an actuator with an empty range, which has to stay at trim
+	actuator_min(2) = 1.f;
+	actuator_max(2) = 0.f;
+	actuator_trim(2) = 0.5f;
+	setup(active_set, quadEffectiveness(), 4, actuator_min, actuator_max, actuator_trim);
+
+	// WHEN: we allocate
+	const float control[NUM_AXES] {0.2f, 0.2f, 0.f, 0.f, 0.f, -0.5f};
+	active_set.setControlSetpoint(Vector<float, NUM_AXES>(control));
+	active_set.allocate();
+
+	// THEN: the actuator is held at trim and the others are within their limits
+	EXPECT_FLOAT_EQ(active_set.getActuatorSetpoint()(2), 0.5f);
+
+	for (int i : {0, 1, 3}) {
+		EXPECT_GE(active_set.getActuatorSetpoint()(i), -1e-4f);
+		EXPECT_LE(active_set.getActuatorSetpoint()(i), 1.f + 1e-4f);
+	}
+}
+
+TEST(ControlAllocationActiveSetTest, Benchmark)
+{
+	// 8 rotors and 8 tilting surfaces with random effectiveness, cycling through random setpoints
+	srand(42);
+	EffectivenessMatrix effectiveness;
+	ActuatorVector actuator_min;
+	ActuatorVector actuator_max;
+
+	for (int i = 0; i < NUM_ACTUATORS; i++) {
+		const bool motor = i < 8;
+		actuator_min(i) = motor ? 0.f : -1.f;
+		actuator_max(i) = 1.f;
+
+		for (int axis = 0; axis < NUM_AXES; axis++) {
+			effectiveness(axis, i) = randf(-0.3f, 0.3f);
+		}
+
+		if (motor) {
+			effectiveness(5, i) = -randf(0.8f, 1.2f);
+		}
+	}
+
+	ControlAllocationPseudoInverse pseudo_inverse;
+	ControlAllocationSequentialDesaturation sequential_desaturation;
+	ControlAllocationActiveSet active_set;
+	ControlAllocation *methods[] {&pseudo_inverse, &sequential_desaturation, &active_set};
+	const char *names[] {"pseudo-inverse", "sequential desaturation", "active set"};
+
+	static constexpr int NUM_SETPOINTS = 64;
+	static constexpr int NUM_ALLOCATIONS = 20000;
+	Vector<float, NUM_AXES> setpoints[NUM_SETPOINTS];
+
+	for (int k = 0; k < NUM_SETPOINTS; k++) {
+		for (int axis = 0; axis < 5; axis++) {
+			setpoints[k](axis) = randf(-0.8f, 0.8f);
+		}
+
+		setpoints[k](5) = randf(-1.f, -0.1f);
+	}
+
+	float error[3] {};
+	int violations[3] {};
+
+	for (int m = 0; m < 3; m++) {
+		setup(*methods[m], effectiveness, NUM_ACTUATORS, actuator_min, actuator_max);
+		const uint64_t start = now_us();
+
+		for (int n = 0; n < NUM_ALLOCATIONS; n++) {
+			// setpoints change slowly compared to the rate controller, repeat each one a few times
+			methods[m]->setControlSetpoint(setpoints[(n / 8) % NUM_SETPOINTS]);
+			methods[m]->allocate();
+		}
+
+		const uint64_t duration = now_us() - start;
+
+		for (int k = 0; k < NUM_SETPOINTS; k++) {
+			methods[m]->setControlSetpoint(setpoints[k]);
+			methods[m]->allocate();
+			violations[m] += withinLimits(*methods[m]) ? 0 : 1;
+			methods[m]->clipActuatorSetpoint();
+			error[m] += weightedError(*methods[m]) / NUM_SETPOINTS;
+		}
+
+		printf("%-24s %7.3f us per allocation, mean weighted control error %.4f, %d/%d outside limits before clipping\n",
+		       names[m], (double)duration / NUM_ALLOCATIONS, (double)error[m], violations[m], NUM_SETPOINTS);
+	}
+
+	// the active set solution never needs clipping and has the smallest control error
+	EXPECT_EQ(violations[2], 0);
+	EXPECT_LE(error[2], error[0]);
+	EXPECT_LE(error[2], error[1]);
+}
@@ -41,6 +41,8 @@
 
 #include "ControlAllocationPseudoInverse.hpp"
 
+#include <string.h>
+
 void
 ControlAllocationPseudoInverse::setEffectivenessMatrix(
 	const matrix::Matrix<float, ControlAllocation::NUM_AXES, ControlAllocation::NUM_ACTUATORS> &effectiveness,
@@ -57,7 +59,9 @@ void
 ControlAllocationPseudoInverse::updatePseudoInverse()
 {
 	if (_mix_update_needed) {
-		matrix::geninv(_effectiveness, _mix);
+		if (!updatePseudoInverseIncremental()) {
+			updatePseudoInverseFull();
+		}
 
 		if (_normalization_needs_update && !_had_actuator_failure) {
 			updateControlAllocationMatrixScale();
@@ -69,6 +73,143 @@ ControlAllocationPseudoInverse::updatePseudoInverse()
 	}
 }
 
+namespace
+{
+// minimum denominator of a rank-one downdate, below it the Gram matrix is close to singular
+static constexpr float GRAM_DOWNDATE_MIN = 1e-3f;
+
+// maximum deviation of B * B^+ from identity accepted for an incremental update
+static constexpr float RESIDUAL_MAX = 1e-4f;
+
+uint8_t nonZeroRows(const matrix::Matrix<float, ControlAllocation::NUM_AXES, ControlAllocation::NUM_ACTUATORS> &B)
+{
+	uint8_t rows = 0;
+
+	for (int axis = 0; axis < ControlAllocation::NUM_AXES; axis++) {
+		for (int i = 0; i < ControlAllocation::NUM_ACTUATORS; i++) {
+			if (fabsf(B(axis, i)) > FLT_EPSILON) {
+				rows |= 1 << axis;
+				break;
+			}
+		}
+	}
+
+	return rows;
+}
+} // namespace
+
+void
+ControlAllocationPseudoInverse::updatePseudoInverseFull()
+{
+	matrix::geninv(_effectiveness, _mix);
+
+	_mix_effectiveness = _effectiveness;
+	_mix_num_actuators = _num_actuators;
+	_incremental_updates = 0;
+
+	// Gram matrix of the non-zero rows, padded with identity so it stays invertible
+	_gram_rows = nonZeroRows(_effectiveness);
+	matrix::SquareMatrix<float, NUM_AXES> gram = _effectiveness * _effectiveness.transpose();
+
+	for (int axis = 0; axis < NUM_AXES; axis++) {
+		if (!(_gram_rows & (1 << axis))) {
+			gram(axis, axis) = 1.f;
+		}
+	}
+
+	_gram_inverse_valid = matrix::inv(gram, _gram_inverse);
+
+	if (_gram_inverse_valid) {
+		// B^T (B B^T)^-1 is only the pseudo-inverse if the non-zero rows are linearly independent
+		const matrix::Matrix<float, NUM_ACTUATORS, NUM_AXES> mix = _effectiveness.transpose() * _gram_inverse;
+		const float tolerance = 1e-3f * fmaxf(_mix.abs().max(), 1.f);
+		_gram_inverse_valid = (mix - _mix).abs().max() < tolerance;
+	}
+}
+
+bool
+ControlAllocationPseudoInverse::updatePseudoInverseIncremental()
+{
+	if (!_gram_inverse_valid || _num_actuators != _mix_num_actuators || _incremental_updates >= MAX_INCREMENTAL_UPDATES
+	    || nonZeroRows(_effectiveness) != _gram_rows) {
+		return false;
+	}
+
+	bool column_changed[NUM_ACTUATORS] {};
+	int num_changed = 0;
+
+	// bitwise, any change has to go into the Gram matrix for it to match _mix_effectiveness
+	for (int i = 0; i < NUM_ACTUATORS; i++) {
+		for (int axis = 0; axis < NUM_AXES; axis++) {
+			if (memcmp(&_effectiveness(axis, i), &_mix_effectiveness(axis, i), sizeof(float)) != 0) {
+				column_changed[i] = true;
+				num_changed++;
+				break;
+			}
+		}
+	}
+
+	// two rank-one updates per column, a full recomputation is cheaper when many columns changed
+	if (num_changed > NUM_AXES) {
+		return false;
+	}
+
+	for (int i = 0; i < NUM_ACTUATORS; i++) {
+		if (!column_changed[i]) {
+			continue;
+		}
+
+		// add the new column: (G + u u^T)^-1 = G^-1 - G^-1 u u^T G^-1 / (1 + u^T G^-1 u)
+		const matrix::Vector<float, NUM_AXES> u = _effectiveness.col(i);
+		const matrix::Vector<float, NUM_AXES> gram_u = _gram_inverse * u;
+		const float scale_u = 1.f / (1.f + u.dot(gram_u));
+
+		for (int row = 0; row < NUM_AXES; row++) {
+			for (int col = 0; col < NUM_AXES; col++) {
+				_gram_inverse(row, col) -= gram_u(row) * gram_u(col) * scale_u;
+			}
+		}
+
+		// remove the old column: (G - w w^T)^-1 = G^-1 + G^-1 w w^T G^-1 / (1 - w^T G^-1 w)
+		const matrix::Vector<float, NUM_AXES> w = _mix_effectiveness.col(i);
+		const matrix::Vector<float, NUM_AXES> gram_w = _gram_inverse * w;
+		const float denominator = 1.f - w.dot(gram_w);
+
+		if (denominator < GRAM_DOWNDATE_MIN) {
+			_gram_inverse_valid = false;
+			return false;
+		}
+
+		const float scale_w = 1.f / denominator;
+
+		for (int row = 0; row < NUM_AXES; row++) {
+			for (int col = 0; col < NUM_AXES; col++) {
+				_gram_inverse(row, col) += gram_w(row) * gram_w(col) * scale_w;
+			}
+		}
+	}
+
+	_mix = _effectiveness.transpose() * _gram_inverse;
+
+	// the updates lose accuracy if the Gram matrix is badly conditioned, check B * B^+ = I on the non-zero rows
+	const matrix::SquareMatrix<float, NUM_AXES> identity = _effectiveness * _mix;
+
+	for (int row = 0; row < NUM_AXES; row++) {
+		for (int col = 0; col < NUM_AXES; col++) {
+			const float expected = (row == col && (_gram_rows & (1 << row))) ? 1.f : 0.f;
+
+			if (fabsf(identity(row, col) - expected) > RESIDUAL_MAX) {
+				_gram_inverse_valid = false;
+				return false;
+			}
+		}
+	}
+
+	_mix_effectiveness = _effectiveness;
+	++_incremental_updates;
+	return true;
+}
+
 void
 ControlAllocationPseudoInverse::updateControlAllocationMatrixScale()
 {
@@ -72,5 +72,29 @@ protected:
 private:
 	void normalizeControlAllocationMatrix();
 	void updateControlAllocationMatrixScale();
+
+	/**
+	 * Recompute the pseudo-inverse and the inverse Gram matrix from scratch.
+	 */
+	void updatePseudoInverseFull();
+
+	/**
+	 * Update the pseudo-inverse with rank-one updates of the inverse Gram matrix (B B^T)^-1
+	 * for the columns of the effectiveness matrix that changed since the last update.
+	 * This keeps the cost low when only a few actuators change, e.g. rotors during a tilt transition.
+	 *
+	 * @return false if a full recomputation is required
+	 */
+	bool updatePseudoInverseIncremental();
+
+	static constexpr int MAX_INCREMENTAL_UPDATES = 32; ///< bound numerical drift by recomputing periodically
+
 	bool _normalization_needs_update{false};
+
+	matrix::Matrix<float, NUM_AXES, NUM_ACTUATORS> _mix_effectiveness; ///< effectiveness _mix was computed for
+	matrix::SquareMatrix<float, NUM_AXES> _gram_inverse; ///< (B B^T)^-1 for the non-zero rows of B, identity otherwise
+	uint8_t _gram_rows{0};		///< bitmask of the non-zero rows of _mix_effectiveness
+	int _mix_num_actuators{0};
+	int _incremental_updates{0};
+	bool _gram_inverse_valid{false};
 };
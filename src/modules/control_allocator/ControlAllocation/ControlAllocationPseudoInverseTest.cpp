@@ -42,8 +42,56 @@
 #include <gtest/gtest.h>
 #include <ControlAllocationPseudoInverse.hpp>
 
+#include <chrono>
+
 using namespace matrix;
 
+namespace
+{
+uint64_t now_us()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// quad tiltrotor with two control surfaces and rotors tilted forward by tilt [rad], like
+// ActuatorEffectivenessRotors with three dimensional thrust disabled (collective thrust on the z axis)
+matrix::Matrix<float, 6, 16> tiltrotorEffectiveness(float tilt)
+{
+	const float position[4][2] {{0.3f, 0.4f}, {-0.3f, -0.4f}, {0.3f, -0.4f}, {-0.3f, 0.4f}};
+	const float direction[4] {1.f, 1.f, -1.f, -1.f};
+	const float ct = 6.5f;
+	const float km = 0.05f;
+	const Vector3f axis(sinf(tilt), 0.f, -cosf(tilt));
+	matrix::Matrix<float, 6, 16> effectiveness;
+
+	for (int i = 0; i < 4; i++) {
+		const Vector3f moment = ct * Vector3f(position[i][0], position[i][1], 0.f).cross(axis) - ct * km * direction[i] * axis;
+
+		for (int j = 0; j < 3; j++) {
+			effectiveness(j, i) = moment(j);
+		}
+
+		effectiveness(5, i) = ct;
+	}
+
+	// ailerons
+	effectiveness(0, 4) = 0.5f;
+	effectiveness(0, 5) = -0.5f;
+	effectiveness(1, 4) = 0.1f;
+	effectiveness(1, 5) = 0.1f;
+
+	return effectiveness;
+}
+// exposes the pseudo-inverse update and its result
+class TestPseudoInverse : public ControlAllocationPseudoInverse
+{
+public:
+	using ControlAllocationPseudoInverse::updatePseudoInverse;
+	const matrix::Matrix<float, NUM_ACTUATORS, NUM_AXES> &mix() const { return _mix; }
+};
+} // namespace
+
 TEST(ControlAllocationTest, AllZeroCase)
 {
 	ControlAllocationPseudoInverse method;
@@ -67,3 +115,67 @@ TEST(ControlAllocationTest, AllZeroCase)
 	EXPECT_EQ(actuator_sp, actuator_sp_expected);
 	EXPECT_EQ(control_allocated, control_allocated_expected);
 }
+
+TEST(ControlAllocationTest, TiltTransitionIncrementalUpdate)
+{
+	ControlAllocationPseudoInverse method;
+	matrix::Vector<float, 16> actuator_trim;
+	matrix::Vector<float, 16> linearization_point;
+	const float control[6] {0.3f, -0.2f, 0.1f, 0.f, 0.f, 4.f};
+
+	// WHEN: the rotors are tilted forward and back again in small steps
+	for (int step = 0; step <= 180; step++) {
+		const float tilt = (float)(step <= 90 ? step : 180 - step) * (float)M_PI / 180.f;
+		method.setEffectivenessMatrix(tiltrotorEffectiveness(tilt), actuator_trim, linearization_point, 6, false);
+		method.setControlSetpoint(matrix::Vector<float, 6>(control));
+		method.allocate();
+
+		ControlAllocationPseudoInverse reference;
+		reference.setEffectivenessMatrix(tiltrotorEffectiveness(tilt), actuator_trim, linearization_point, 6, false);
+		reference.setControlSetpoint(matrix::Vector<float, 6>(control));
+		reference.allocate();
+
+		// THEN: the incrementally updated pseudo-inverse gives the same allocation as a full recomputation
+		for (int i = 0; i < 6; i++) {
+			EXPECT_NEAR(method.getActuatorSetpoint()(i), reference.getActuatorSetpoint()(i), 1e-3f) << "tilt step " << step;
+		}
+	}
+}
+
+TEST(ControlAllocationTest, TiltTransitionBenchmark)
+{
+	static constexpr int NUM_STEPS = 1000;
+	matrix::Vector<float, 16> actuator_trim;
+	matrix::Vector<float, 16> linearization_point;
+	TestPseudoInverse method;
+	uint64_t full_time = 0;
+	uint64_t incremental_time = 0;
+
+	for (int step = 0; step < NUM_STEPS; step++) {
+		const float tilt = 0.5f * (float)M_PI * step / (NUM_STEPS - 1);
+		const matrix::Matrix<float, 6, 16> effectiveness = tiltrotorEffectiveness(tilt);
+
+		// full recomputation, a new object has no inverse Gram matrix to update
+		TestPseudoInverse reference;
+		reference.setEffectivenessMatrix(effectiveness, actuator_trim, linearization_point, 6, false);
+		uint64_t start = now_us();
+		reference.updatePseudoInverse();
+		full_time += now_us() - start;
+
+		// incremental update of the changed rotor columns
+		method.setEffectivenessMatrix(effectiveness, actuator_trim, linearization_point, 6, false);
+		start = now_us();
+		method.updatePseudoInverse();
+		incremental_time += now_us() - start;
+
+		// THEN: both give the same mix matrix
+		for (int i = 0; i < 6; i++) {
+			for (int axis = 0; axis < 6; axis++) {
+				ASSERT_NEAR(method.mix()(i, axis), reference.mix()(i, axis), 1e-3f) << "step " << step;
+			}
+		}
+	}
+
+	printf("transition sweep, %d matrices: full %.3f us, incremental %.3f us per update\n", NUM_STEPS,
+	       (double)full_time / NUM_STEPS, (double)incremental_time / NUM_STEPS);
+}
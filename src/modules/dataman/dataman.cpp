@@ -49,23 +49,44 @@
 #include <px4_platform_common/getopt.h>
 #include <drivers/drv_hrt.h>
 #include <lib/parameters/param.h>
+#include <lib/mathlib/mathlib.h>
 #include <lib/perf/perf_counter.h>
 #include <stdlib.h>
 
+#if defined(__PX4_LINUX)
+#include <sys/mman.h>
+#define DATAMAN_FILE_MMAP // the file backend is memory mapped and written back by the kernel
+#endif // __PX4_LINUX
+
 #include "dataman.h"
 
+using namespace time_literals;
+
 __BEGIN_DECLS
 __EXPORT int dataman_main(int argc, char *argv[]);
 __END_DECLS
 
 static constexpr int TASK_STACK_SIZE = 1220;
 
+/* Writes are made persistent at the latest this long after they were done (see _flush_wait) */
+static constexpr hrt_abstime DM_FLUSH_DELAY = 500_ms;
+
+#if defined(DATAMAN_FILE_MMAP)
+/* Private mmap based File Operations */
+static ssize_t _mmap_write(dm_item_t item, unsigned index, const void *buf, size_t count);
+static int  _mmap_clear(dm_item_t item);
+static int _mmap_initialize(unsigned max_offset);
+static void _mmap_shutdown();
+static void _mmap_flush();
+#else
 /* Private File based Operations */
 static ssize_t _file_write(dm_item_t item, unsigned index, const void *buf, size_t count);
 static ssize_t _file_read(dm_item_t item, unsigned index, void *buf, size_t count);
 static int  _file_clear(dm_item_t item);
 static int _file_initialize(unsigned max_offset);
 static void _file_shutdown();
+static void _file_flush();
+#endif // DATAMAN_FILE_MMAP
 
 /* Private Ram based Operations */
 static ssize_t _ram_write(dm_item_t item, unsigned index, const void *buf, size_t count);
@@ -74,6 +95,8 @@ static int  _ram_clear(dm_item_t item);
 static int _ram_initialize(unsigned max_offset);
 static void _ram_shutdown();
 
+static int _flush_wait(px4_sem_t *sem);
+
 typedef struct dm_operations_t {
 	ssize_t (*write)(dm_item_t item, unsigned index, const void *buf, size_t count);
 	ssize_t (*read)(dm_item_t item, unsigned index, void *buf, size_t count);
@@ -81,16 +104,30 @@ typedef struct dm_operations_t {
 	int (*initialize)(unsigned max_offset);
 	void (*shutdown)();
 	int (*wait)(px4_sem_t *sem);
+	void (*flush)();
 } dm_operations_t;
 
+#if defined(DATAMAN_FILE_MMAP)
+static constexpr dm_operations_t dm_file_operations = {
+	.write   = _mmap_write,
+	.read    = _ram_read,
+	.clear   = _mmap_clear,
+	.initialize = _mmap_initialize,
+	.shutdown = _mmap_shutdown,
+	.wait = _flush_wait,
+	.flush = _mmap_flush,
+};
+#else
 static constexpr dm_operations_t dm_file_operations = {
 	.write   = _file_write,
 	.read    = _file_read,
 	.clear   = _file_clear,
 	.initialize = _file_initialize,
 	.shutdown = _file_shutdown,
-	.wait = px4_sem_wait,
+	.wait = _flush_wait,
+	.flush = _file_flush,
 };
+#endif // DATAMAN_FILE_MMAP
 
 static constexpr dm_operations_t dm_ram_operations = {
 	.write   = _ram_write,
@@ -99,20 +136,47 @@ static constexpr dm_operations_t dm_ram_operations = {
 	.initialize = _ram_initialize,
 	.shutdown = _ram_shutdown,
 	.wait = px4_sem_wait,
+	.flush = nullptr,
 };
 
 static const dm_operations_t *g_dm_ops;
 
+#if !defined(DATAMAN_FILE_MMAP)
+/* Write-back page cache of the file backend. Reads load whole pages, writes only modify the cache and
+ * the dirty pages are written back together (and fsync'ed once) by _file_flush() */
+#if defined(CONSTRAINED_MEMORY)
+static constexpr unsigned DM_CACHE_NUM_PAGES = 2;
+static constexpr unsigned DM_CACHE_PAGE_SIZE = 512;
+#else
+static constexpr unsigned DM_CACHE_NUM_PAGES = 8;
+static constexpr unsigned DM_CACHE_PAGE_SIZE = 1024;
+#endif
+
+typedef struct {
+	int offset;		/**< file offset of the page, -1 if unused */
+	unsigned last_used;	/**< for LRU replacement */
+	bool dirty;
+	uint8_t data[DM_CACHE_PAGE_SIZE];
+} dm_cache_page_t;
+#endif // !DATAMAN_FILE_MMAP
+
 static struct {
 	union {
 		struct {
 			int fd;
+#if !defined(DATAMAN_FILE_MMAP)
+			unsigned size;
+			dm_cache_page_t *pages;
+			unsigned use_counter;
+#endif // !DATAMAN_FILE_MMAP
 		} file;
 		struct {
 			uint8_t *data;
 			uint8_t *data_end;
+			int fd; /* backing file of the mmap file backend */
 		} ram;
 	};
+	hrt_abstime dirty_since; /* time of the first write not flushed yet, 0 if everything is persistent */
 	bool running;
 	bool silence = false;
 } dm_operations_data;
@@ -122,6 +186,8 @@ typedef enum {
 	dm_write_func = 0,
 	dm_read_func,
 	dm_clear_func,
+	dm_write_bulk_func,
+	dm_read_bulk_func,
 	dm_number_of_funcs
 } dm_function_t;
 
@@ -138,12 +204,14 @@ typedef struct {
 			unsigned index;
 			const void *buf;
 			size_t count;
+			unsigned num_items; /* bulk writes only */
 		} write_params;
 		struct {
 			dm_item_t item;
 			unsigned index;
 			void *buf;
 			size_t count;
+			unsigned num_items; /* bulk reads only */
 		} read_params;
 		struct {
 			dm_item_t item;
@@ -155,6 +223,9 @@ const size_t k_work_item_allocation_chunk_size = 8;
 
 /* Usage statistics */
 static unsigned g_func_counts[dm_number_of_funcs];
+static unsigned g_flush_count;
+static unsigned g_cache_hits;
+static unsigned g_cache_misses;
 
 /* table of maximum number of instances for each item type */
 static const unsigned g_per_item_max_index[DM_KEY_NUM_KEYS] = {
@@ -378,6 +449,144 @@ calculate_offset(dm_item_t item, unsigned index)
 	return g_key_offsets[item] + (index * g_per_item_size[item]);
 }
 
+/* Items which other modules commit to after writing the data they refer to (mission state, fence/safe point stats) */
+static bool
+_is_commit_record(dm_item_t item, unsigned index)
+{
+	return (item == DM_KEY_MISSION_STATE) || (item == DM_KEY_COMPAT)
+	       || ((item == DM_KEY_FENCE_POINTS || item == DM_KEY_SAFE_POINTS) && index == 0);
+}
+
+/* Called by the file backends before an item is written. The data a commit record refers to is made persistent
+ * first, so a power loss can't leave a record pointing at items which never reached the media. */
+static void
+_write_begin(dm_item_t item, unsigned index)
+{
+	if (_is_commit_record(item, index) && dm_operations_data.dirty_since != 0) {
+		g_dm_ops->flush();
+	}
+}
+
+/* Called by the file backends after an item was written. Commit records are made persistent right away,
+ * everything else with the next flush, at the latest DM_FLUSH_DELAY later. */
+static void
+_write_done(dm_item_t item, unsigned index)
+{
+	if (_is_commit_record(item, index)) {
+		g_dm_ops->flush();
+
+	} else if (dm_operations_data.dirty_since == 0) {
+		dm_operations_data.dirty_since = hrt_absolute_time();
+	}
+}
+
+#if !defined(DATAMAN_FILE_MMAP)
+static int
+_cache_write_back(dm_cache_page_t *page)
+{
+	const unsigned len = math::min(DM_CACHE_PAGE_SIZE, dm_operations_data.file.size - page->offset);
+
+	if (lseek(dm_operations_data.file.fd, page->offset, SEEK_SET) != page->offset) {
+		return -1;
+	}
+
+	if (write(dm_operations_data.file.fd, page->data, len) != (ssize_t)len) {
+		return -1;
+	}
+
+	page->dirty = false;
+	return 0;
+}
+
+/* Get the cache page containing the file offset (aligned to DM_CACHE_PAGE_SIZE), loading it if needed */
+static dm_cache_page_t *
+_cache_get_page(int offset)
+{
+	dm_cache_page_t *pages = dm_operations_data.file.pages;
+	dm_cache_page_t *victim = &pages[0];
+
+	for (unsigned i = 0; i < DM_CACHE_NUM_PAGES; i++) {
+		if (pages[i].offset == offset) {
+			pages[i].last_used = ++dm_operations_data.file.use_counter;
+			g_cache_hits++;
+			return &pages[i];
+		}
+
+		if (victim->offset >= 0 && (pages[i].offset < 0 || pages[i].last_used < victim->last_used)) {
+			victim = &pages[i];
+		}
+	}
+
+	g_cache_misses++;
+
+	if (victim->dirty && _cache_write_back(victim) != 0) {
+		return nullptr;
+	}
+
+	victim->offset = -1;
+
+	if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
+		return nullptr;
+	}
+
+	/* Parts of the page past the end of the file are empty items */
+	ssize_t len = read(dm_operations_data.file.fd, victim->data, DM_CACHE_PAGE_SIZE);
+
+	if (len < 0) {
+		return nullptr;
+	}
+
+	memset(victim->data + len, 0, DM_CACHE_PAGE_SIZE - len);
+
+	victim->offset = offset;
+	victim->dirty = false;
+	victim->last_used = ++dm_operations_data.file.use_counter;
+	return victim;
+}
+
+/* Copy between the caller's buffer and the file through the cache */
+static int
+_cache_copy(int offset, void *buf, size_t count, bool write)
+{
+	uint8_t *data = (uint8_t *)buf;
+
+	while (count > 0) {
+		const int page_offset = offset - (offset % DM_CACHE_PAGE_SIZE);
+		const size_t start = offset - page_offset;
+		const size_t len = math::min(count, DM_CACHE_PAGE_SIZE - start);
+
+		dm_cache_page_t *page = _cache_get_page(page_offset);
+
+		if (page == nullptr) {
+			return -1;
+		}
+
+		if (write) {
+			memcpy(page->data + start, data, len);
+			page->dirty = true;
+
+		} else {
+			memcpy(data, page->data + start, len);
+		}
+
+		offset += len;
+		data += len;
+		count -= len;
+	}
+
+	return 0;
+}
+
+static void
+_cache_invalidate()
+{
+	for (unsigned i = 0; i < DM_CACHE_NUM_PAGES; i++) {
+		dm_operations_data.file.pages[i].offset = -1;
+		dm_operations_data.file.pages[i].dirty = false;
+	}
+}
+#endif // !DATAMAN_FILE_MMAP
+
 /* Each data item is stored as follows
  *
  * byte 0: Length of user data item
@@ -425,6 +634,7 @@ static ssize_t _ram_write(dm_item_t item, unsigned index, const void *buf, size_
 	return count;
 }
 
+#if !defined(DATAMAN_FILE_MMAP)
 /* write to the data manager file */
 static ssize_t
 _file_write(dm_item_t item, unsigned index, const void *buf, size_t count)
@@ -454,50 +664,20 @@ _file_write(dm_item_t item, unsigned index, const void *buf, size_t count)
 		memcpy(buffer + DM_SECTOR_HDR_SIZE, buf, count);
 	}
 
-	count += DM_SECTOR_HDR_SIZE;
-
-	bool write_success = false;
-
-	for (int i = 0; i < 2; i++) {
-		int ret_seek = lseek(dm_operations_data.file.fd, offset, SEEK_SET);
-
-		if (ret_seek < 0) {
-			PX4_ERR("file write lseek failed %d", errno);
-			continue;
-		}
-
-		if (ret_seek != offset) {
-			PX4_ERR("file write lseek failed, incorrect offset %d vs %d", ret_seek, offset);
-			continue;
-		}
-
-		int ret_write = write(dm_operations_data.file.fd, buffer, count);
-
-		if (ret_write < 0) {
-			PX4_ERR("file write failed %d", errno);
-			continue;
-		}
-
-		if (ret_write != (ssize_t)count) {
-			PX4_ERR("file write failed, wrote %d bytes, expected %zu", ret_write, count);
-			continue;
-
-		} else {
-			write_success = true;
-			break;
-		}
-	}
+	_write_begin(item, index);
 
-	if (!write_success) {
+	/* The data only goes to the cache, it's written to the file by the next flush */
+	if (_cache_copy(offset, buffer, count + DM_SECTOR_HDR_SIZE, true) != 0) {
+		PX4_ERR("file write failed %d", errno);
 		return -1;
 	}
 
-	/* Make sure data is written to physical media */
-	fsync(dm_operations_data.file.fd);
+	_write_done(item, index);
 
 	/* All is well... return the number of user data written */
-	return count - DM_SECTOR_HDR_SIZE;
+	return count;
 }
+#endif // !DATAMAN_FILE_MMAP
 
 /* Retrieve from the data manager RAM buffer*/
 static ssize_t _ram_read(dm_item_t item, unsigned index, void *buf, size_t count)
@@ -538,6 +718,7 @@ static ssize_t _ram_read(dm_item_t item, unsigned index, void *buf, size_t count
 	return buffer[0];
 }
 
+#if !defined(DATAMAN_FILE_MMAP)
 /* Retrieve from the data manager file */
 static ssize_t
 _file_read(dm_item_t item, unsigned index, void *buf, size_t count)
@@ -561,46 +742,15 @@ _file_read(dm_item_t item, unsigned index, void *buf, size_t count)
 		return -E2BIG;
 	}
 
-	int len = -1;
-	bool read_success = false;
-
-	for (int i = 0; i < 2; i++) {
-		int ret_seek = lseek(dm_operations_data.file.fd, offset, SEEK_SET);
-
-		if ((ret_seek < 0) && !dm_operations_data.silence) {
-			PX4_ERR("file read lseek failed %d", errno);
-			continue;
-		}
-
-		if ((ret_seek != offset) && !dm_operations_data.silence) {
-			PX4_ERR("file read lseek failed, incorrect offset %d vs %d", ret_seek, offset);
-			continue;
+	/* Read the prefix and data, parts past the end of the file read as empty */
+	if (_cache_copy(offset, buffer, count + DM_SECTOR_HDR_SIZE, false) != 0) {
+		if (!dm_operations_data.silence) {
+			PX4_ERR("file read failed %d", errno);
 		}
 
-		/* Read the prefix and data */
-		len = read(dm_operations_data.file.fd, buffer, count + DM_SECTOR_HDR_SIZE);
-
-		/* Check for read error */
-		if (len >= 0) {
-			read_success = true;
-			break;
-
-		} else {
-			if (!dm_operations_data.silence) {
-				PX4_ERR("file read failed %d", errno);
-			}
-		}
-	}
-
-	if (!read_success) {
 		return -1;
 	}
 
-	/* A zero length entry is a empty entry */
-	if (len == 0) {
-		buffer[0] = 0;
-	}
-
 	/* See if we got data */
 	if (buffer[0] > 0) {
 		/* We got more than requested!!! */
@@ -615,6 +765,7 @@ _file_read(dm_item_t item, unsigned index, void *buf, size_t count)
 	/* Return the number of bytes of caller data read */
 	return buffer[0];
 }
+#endif // !DATAMAN_FILE_MMAP
 
 static int  _ram_clear(dm_item_t item)
 {
@@ -645,6 +796,7 @@ static int  _ram_clear(dm_item_t item)
 	return result;
 }
 
+#if !defined(DATAMAN_FILE_MMAP)
 static int
 _file_clear(dm_item_t item)
 {
@@ -660,28 +812,18 @@ _file_clear(dm_item_t item)
 
 	/* Clear all items of this type */
 	for (i = 0; (unsigned)i < g_per_item_max_index[item]; i++) {
-		char buf[1];
+		uint8_t len;
 
-		if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
+		if (_cache_copy(offset, &len, 1, false) != 0) {
 			result = -1;
 			break;
 		}
 
 		/* Avoid SD flash wear by only doing writes where necessary */
-		if (read(dm_operations_data.file.fd, buf, 1) < 1) {
-			break;
-		}
+		if (len) {
+			len = 0;
 
-		/* If item has length greater than 0 it needs to be overwritten */
-		if (buf[0]) {
-			if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
-				result = -1;
-				break;
-			}
-
-			buf[0] = 0;
-
-			if (write(dm_operations_data.file.fd, buf, 1) != 1) {
+			if (_cache_copy(offset, &len, 1, true) != 0) {
 				result = -1;
 				break;
 			}
@@ -691,13 +833,24 @@ _file_clear(dm_item_t item)
 	}
 
 	/* Make sure data is actually written to physical media */
-	fsync(dm_operations_data.file.fd);
+	_file_flush();
 	return result;
 }
 
 static int
 _file_initialize(unsigned max_offset)
 {
+	dm_operations_data.file.size = max_offset;
+	dm_operations_data.file.pages = (dm_cache_page_t *)malloc(DM_CACHE_NUM_PAGES * sizeof(dm_cache_page_t));
+
+	if (dm_operations_data.file.pages == nullptr) {
+		PX4_WARN("Could not allocate data manager cache");
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	_cache_invalidate();
+
 	/* See if the data manage file exists and is a multiple of the sector size */
 	dm_operations_data.file.fd = open(k_data_manager_device_path, O_RDONLY | O_BINARY);
 
@@ -717,6 +870,7 @@ _file_initialize(unsigned max_offset)
 		}
 
 		close(dm_operations_data.file.fd);
+		_cache_invalidate();
 
 		if (incompat) {
 			unlink(k_data_manager_device_path);
@@ -728,12 +882,14 @@ _file_initialize(unsigned max_offset)
 
 	if (dm_operations_data.file.fd < 0) {
 		PX4_WARN("Could not open data manager file %s", k_data_manager_device_path);
+		free(dm_operations_data.file.pages);
 		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
 		return -1;
 	}
 
 	if ((unsigned)lseek(dm_operations_data.file.fd, max_offset, SEEK_SET) != max_offset) {
 		close(dm_operations_data.file.fd);
+		free(dm_operations_data.file.pages);
 		PX4_WARN("Could not seek data manager file %s", k_data_manager_device_path);
 		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
 		return -1;
@@ -748,11 +904,11 @@ _file_initialize(unsigned max_offset)
 		PX4_ERR("Failed writing compat: %d", ret);
 	}
 
-	fsync(dm_operations_data.file.fd);
 	dm_operations_data.running = true;
 
 	return 0;
 }
+#endif // !DATAMAN_FILE_MMAP
 
 static int
 _ram_initialize(unsigned max_offset)
@@ -773,12 +929,16 @@ _ram_initialize(unsigned max_offset)
 	return 0;
 }
 
+#if !defined(DATAMAN_FILE_MMAP)
 static void
 _file_shutdown()
 {
+	_file_flush();
 	close(dm_operations_data.file.fd);
+	free(dm_operations_data.file.pages);
 	dm_operations_data.running = false;
 }
+#endif // !DATAMAN_FILE_MMAP
 
 static void
 _ram_shutdown()
@@ -787,6 +947,174 @@ _ram_shutdown()
 	dm_operations_data.running = false;
 }
 
+#if defined(DATAMAN_FILE_MMAP)
+/* The mmap file backend reads and writes the mapping like the RAM backend, the kernel writes the pages back */
+static ssize_t
+_mmap_write(dm_item_t item, unsigned index, const void *buf, size_t count)
+{
+	_write_begin(item, index);
+
+	ssize_t ret = _ram_write(item, index, buf, count);
+
+	if (ret >= 0) {
+		_write_done(item, index);
+	}
+
+	return ret;
+}
+
+static int
+_mmap_clear(dm_item_t item)
+{
+	int ret = _ram_clear(item);
+	_mmap_flush();
+	return ret;
+}
+
+static void
+_mmap_flush()
+{
+	if (msync(dm_operations_data.ram.data, dm_operations_data.ram.data_end - dm_operations_data.ram.data + 1, MS_SYNC) != 0) {
+		PX4_ERR("msync failed %d", errno);
+	}
+
+	dm_operations_data.dirty_since = 0;
+	g_flush_count++;
+}
+
+static int
+_mmap_initialize(unsigned max_offset)
+{
+	dm_operations_data.ram.fd = open(k_data_manager_device_path, O_RDWR | O_CREAT | O_BINARY, PX4_O_MODE_666);
+
+	if (dm_operations_data.ram.fd < 0) {
+		PX4_WARN("Could not open data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	if (ftruncate(dm_operations_data.ram.fd, max_offset) != 0) {
+		close(dm_operations_data.ram.fd);
+		PX4_WARN("Could not resize data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	void *data = mmap(nullptr, max_offset, PROT_READ | PROT_WRITE, MAP_SHARED, dm_operations_data.ram.fd, 0);
+
+	if (data == MAP_FAILED) {
+		close(dm_operations_data.ram.fd);
+		PX4_WARN("Could not map data manager file %s", k_data_manager_device_path);
+		px4_sem_post(&g_init_sema); /* Don't want to hang startup */
+		return -1;
+	}
+
+	dm_operations_data.ram.data = (uint8_t *)data;
+	dm_operations_data.ram.data_end = &dm_operations_data.ram.data[max_offset - 1];
+
+	// Read the mission state and check the hash
+	struct dataman_compat_s compat_state;
+	int ret = _ram_read(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
+
+	if (ret != sizeof(compat_state) || compat_state.key != DM_COMPAT_KEY) {
+		memset(dm_operations_data.ram.data, 0, max_offset);
+
+		/* Write current compat info */
+		compat_state.key = DM_COMPAT_KEY;
+		ret = g_dm_ops->write(DM_KEY_COMPAT, 0, &compat_state, sizeof(compat_state));
+
+		if (ret != sizeof(compat_state)) {
+			PX4_ERR("Failed writing compat: %d", ret);
+		}
+	}
+
+	dm_operations_data.running = true;
+
+	return 0;
+}
+
+static void
+_mmap_shutdown()
+{
+	_mmap_flush();
+	munmap(dm_operations_data.ram.data, dm_operations_data.ram.data_end - dm_operations_data.ram.data + 1);
+	close(dm_operations_data.ram.fd);
+	dm_operations_data.running = false;
+}
+
+#else
+
+/* Write all dirty cache pages back to the file and make sure they are on the physical media */
+static void
+_file_flush()
+{
+	bool clean = true;
+	int last_offset = -1;
+
+	/* Write in ascending file order to keep the access sequential */
+	for (;;) {
+		dm_cache_page_t *next = nullptr;
+
+		for (unsigned i = 0; i < DM_CACHE_NUM_PAGES; i++) {
+			dm_cache_page_t *page = &dm_operations_data.file.pages[i];
+
+			if (page->dirty && page->offset > last_offset && (next == nullptr || page->offset < next->offset)) {
+				next = page;
+			}
+		}
+
+		if (next == nullptr) {
+			break;
+		}
+
+		last_offset = next->offset;
+
+		if (_cache_write_back(next) != 0) {
+			PX4_ERR("file write failed %d", errno);
+			clean = false;
+			break;
+		}
+	}
+
+	fsync(dm_operations_data.file.fd);
+
+	/* Retry with the next flush if something failed */
+	dm_operations_data.dirty_since = clean ? 0 : hrt_absolute_time();
+	g_flush_count++;
+}
+#endif // DATAMAN_FILE_MMAP
+
+/* Wait for a work item, flushing outstanding writes of the file backends once they are DM_FLUSH_DELAY old */
+static int
+_flush_wait(px4_sem_t *sem)
+{
+	while (dm_operations_data.dirty_since != 0) {
+		const hrt_abstime elapsed = hrt_elapsed_time(&dm_operations_data.dirty_since);
+
+		if (elapsed >= DM_FLUSH_DELAY) {
+			g_dm_ops->flush();
+			break;
+		}
+
+		struct timespec ts;
+#if defined(__PX4_NUTTX)
+		px4_clock_gettime(CLOCK_REALTIME, &ts);
+#else
+		px4_clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif // __PX4_NUTTX
+
+		const uint64_t nsecs = ts.tv_nsec + (DM_FLUSH_DELAY - elapsed) * 1000;
+		ts.tv_sec += nsecs / 1000000000;
+		ts.tv_nsec = nsecs % 1000000000;
+
+		if (px4_sem_timedwait(sem, &ts) == 0) {
+			return 0;
+		}
+	}
+
+	return px4_sem_wait(sem);
+}
+
 /** Write to the data manager file */
 __EXPORT ssize_t
 dm_write(dm_item_t item, unsigned index, const void *buf, size_t count)
@@ -851,6 +1179,72 @@ dm_read(dm_item_t item, unsigned index, void *buf, size_t count)
 	return ret;
 }
 
+/** Write consecutive items to the data manager file */
+__EXPORT ssize_t
+dm_write_bulk(dm_item_t item, unsigned index, const void *buf, size_t item_len, unsigned num_items)
+{
+	work_q_item_t *work;
+
+	/* Make sure data manager has been started and is not shutting down */
+	if (!is_running() || g_task_should_exit) {
+		return -1;
+	}
+
+	perf_begin(_dm_write_perf);
+
+	/* get a work item and queue up a bulk write request */
+	if ((work = create_work_item()) == nullptr) {
+		PX4_ERR("dm_write_bulk create_work_item failed");
+		perf_end(_dm_write_perf);
+		return -1;
+	}
+
+	work->func = dm_write_bulk_func;
+	work->write_params.item = item;
+	work->write_params.index = index;
+	work->write_params.buf = buf;
+	work->write_params.count = item_len;
+	work->write_params.num_items = num_items;
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	ssize_t ret = (ssize_t)enqueue_work_item_and_wait_for_result(work);
+	perf_end(_dm_write_perf);
+	return ret;
+}
+
+/** Retrieve consecutive items from the data manager file */
+__EXPORT ssize_t
+dm_read_bulk(dm_item_t item, unsigned index, void *buf, size_t item_len, unsigned num_items)
+{
+	work_q_item_t *work;
+
+	/* Make sure data manager has been started and is not shutting down */
+	if (!is_running() || g_task_should_exit) {
+		return -1;
+	}
+
+	perf_begin(_dm_read_perf);
+
+	/* get a work item and queue up a bulk read request */
+	if ((work = create_work_item()) == nullptr) {
+		PX4_ERR("dm_read_bulk create_work_item failed");
+		perf_end(_dm_read_perf);
+		return -1;
+	}
+
+	work->func = dm_read_bulk_func;
+	work->read_params.item = item;
+	work->read_params.index = index;
+	work->read_params.buf = buf;
+	work->read_params.count = item_len;
+	work->read_params.num_items = num_items;
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	ssize_t ret = (ssize_t)enqueue_work_item_and_wait_for_result(work);
+	perf_end(_dm_read_perf);
+	return ret;
+}
+
 /** Clear a data Item */
 __EXPORT int
 dm_clear(dm_item_t item)
@@ -971,6 +1365,11 @@ task_main(int argc, char *argv[])
 		g_func_counts[i] = 0;
 	}
 
+	g_flush_count = 0;
+	g_cache_hits = 0;
+	g_cache_misses = 0;
+	dm_operations_data.dirty_since = 0;
+
 	/* Initialize the item type locks, for now only DM_KEY_MISSION_STATE & DM_KEY_FENCE_POINTS supports locking */
 	px4_sem_init(&g_sys_state_mutex_mission, 1, 1); /* Initially unlocked */
 	px4_sem_init(&g_sys_state_mutex_fence, 1, 1); /* Initially unlocked */
@@ -1046,6 +1445,43 @@ task_main(int argc, char *argv[])
 					g_dm_ops->read(work->read_params.item, work->read_params.index, work->read_params.buf, work->read_params.count);
 				break;
 
+			case dm_write_bulk_func: {
+					g_func_counts[dm_write_bulk_func]++;
+					const uint8_t *buf = (const uint8_t *)work->write_params.buf;
+					unsigned i = 0;
+
+					for (; i < work->write_params.num_items; i++) {
+						if (g_dm_ops->write(work->write_params.item, work->write_params.index + i, buf, work->write_params.count)
+						    != (ssize_t)work->write_params.count) {
+							break;
+						}
+
+						buf += work->write_params.count;
+					}
+
+					work->result = (i > 0) ? (int)i : -1;
+				}
+				break;
+
+			case dm_read_bulk_func: {
+					g_func_counts[dm_read_bulk_func]++;
+					uint8_t *buf = (uint8_t *)work->read_params.buf;
+					unsigned i = 0;
+
+					/* Stop at the first item which is empty or has a different size */
+					for (; i < work->read_params.num_items; i++) {
+						if (g_dm_ops->read(work->read_params.item, work->read_params.index + i, buf, work->read_params.count)
+						    != (ssize_t)work->read_params.count) {
+							break;
+						}
+
+						buf += work->read_params.count;
+					}
+
+					work->result = (i > 0) ? (int)i : -1;
+				}
+				break;
+
 			case dm_clear_func:
 				g_func_counts[dm_clear_func]++;
 				work->result = g_dm_ops->clear(work->clear_params.item);
@@ -1130,6 +1566,14 @@ status()
 	PX4_INFO("Writes   %u", g_func_counts[dm_write_func]);
 	PX4_INFO("Reads    %u", g_func_counts[dm_read_func]);
 	PX4_INFO("Clears   %u", g_func_counts[dm_clear_func]);
+	PX4_INFO("Bulk writes %u, bulk reads %u", g_func_counts[dm_write_bulk_func], g_func_counts[dm_read_bulk_func]);
+
+	if (backend == BACKEND_FILE) {
+		PX4_INFO("Flushes  %u", g_flush_count);
+#if !defined(DATAMAN_FILE_MMAP)
+		PX4_INFO("Cache hits %u, misses %u", g_cache_hits, g_cache_misses);
+#endif // !DATAMAN_FILE_MMAP
+	}
 	PX4_INFO("Max Q lengths work %u, free %u", g_work_q.max_size, g_free_q.max_size);
 	perf_print_counter(_dm_read_perf);
 	perf_print_counter(_dm_write_perf);
@@ -1166,6 +1610,12 @@ which stores the number of items for these types. These items are always updated
 the mavlink mission manager). During that time, navigator will try to acquire the geofence item lock, fail, and will not
 check for geofence violations.
 
+The file backend does not write every item to the file immediately: writes go to a small write-back page cache (on
+Linux the file is memory mapped instead), and dirty data is written back and synced at most 500 ms after the write,
+when the dataman is idle. Writes of the mission state and of the fence/safe point stats entry are written through,
+so that a completed transaction is always persistent. `dm_read_bulk`/`dm_write_bulk` transfer a range of consecutive
+items with a single request to the worker thread.
+
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("dataman", "system");
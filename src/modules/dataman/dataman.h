@@ -108,6 +108,34 @@ dm_write(
 	size_t buflen			/* Length in bytes of data to retrieve */
 );
 
+/**
+ * Retrieve consecutive items from the data manager store in a single request.
+ * The items are stored back to back in the caller buffer.
+ * @return number of items read (stops at the first item that fails or doesn't have item_len bytes), -1 on error
+ */
+__EXPORT ssize_t
+dm_read_bulk(
+	dm_item_t item,			/* The item type to retrieve */
+	unsigned index,			/* The index of the first item */
+	void *buffer,			/* Pointer to caller data buffer, num_items * item_len bytes */
+	size_t item_len,		/* Length in bytes of each item */
+	unsigned num_items		/* Number of items to retrieve */
+);
+
+/**
+ * Write consecutive items to the data manager store in a single request.
+ * The items are taken back to back from the caller buffer.
+ * @return number of items written (stops at the first item that fails), -1 on error
+ */
+__EXPORT ssize_t
+dm_write_bulk(
+	dm_item_t item,			/* The item type to store */
+	unsigned index,			/* The index of the first item */
+	const void *buffer,		/* Pointer to caller data buffer, num_items * item_len bytes */
+	size_t item_len,		/* Length in bytes of each item */
+	unsigned num_items		/* Number of items to store */
+);
+
 /**
  * Lock all items of a type. Can be used for atomic updates of multiple items (single items are always updated
  * atomically).
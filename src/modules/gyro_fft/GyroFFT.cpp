@@ -57,6 +57,7 @@ GyroFFT::~GyroFFT()
 	perf_free(_cycle_perf);
 	perf_free(_cycle_interval_perf);
 	perf_free(_fft_perf);
+	perf_free(_sliding_dft_perf);
 	perf_free(_gyro_generation_gap_perf);
 	perf_free(_gyro_fifo_generation_gap_perf);
 
@@ -67,66 +68,64 @@ GyroFFT::~GyroFFT()
 	delete[] _fft_input_buffer;
 	delete[] _fft_outupt_buffer;
 	delete[] _peak_magnitudes_all;
+	delete[] _sliding_dft_spectrum;
 }
 
 bool GyroFFT::init()
 {
 	bool buffers_allocated = false;
 
-	// arm_rfft_init_q15(&_rfft_q15, _imu_gyro_fft_len, 0, 1) manually inlined to save flash
-	_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
-	_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
-	_rfft_q15.ifftFlagR = 0;
-	_rfft_q15.bitReverseFlagR = 1;
+	if (_param_imu_gyro_fft_mth.get() == (int32_t)Method::SLIDING_DFT) {
+		switch (_param_imu_gyro_fft_len.get()) {
+		case 256:
+		case 512:
+		case 1024:
+			break;
+
+		default:
+			PX4_ERR("Invalid IMU_GYRO_FFT_LEN=%" PRId32 ", resetting", _param_imu_gyro_fft_len.get());
+			_param_imu_gyro_fft_len.set(256);
+			_param_imu_gyro_fft_len.commit();
+			break;
+		}
+
+		if (AllocateSlidingDFT(_param_imu_gyro_fft_len.get())) {
+			_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
+			_method = Method::SLIDING_DFT;
+			_sliding_dft_perf = perf_alloc(PC_ELAPSED, MODULE_NAME": sliding DFT");
+
+			if (!SensorSelectionUpdate(true)) {
+				ScheduleDelayed(500_ms);
+			}
+
+			return true;
+		}
+
+		PX4_ERR("failed to allocate buffers");
+		delete[] _sliding_dft_spectrum;
+		_sliding_dft_spectrum = nullptr;
+		return false;
+	}
 
 	switch (_param_imu_gyro_fft_len.get()) {
 	// case 128:
 	// 	buffers_allocated = AllocateBuffers<128>();
-	// 	_rfft_q15.fftLenReal = 128;
-	// 	_rfft_q15.twidCoefRModifier = 64U;
-	// 	_rfft_q15.pCfft = &arm_cfft_sR_q15_len64;
 	// 	break;
 
 	case 256:
 		buffers_allocated = AllocateBuffers<256>();
-		_rfft_q15.fftLenReal = 256;
-		_rfft_q15.twidCoefRModifier = 32U;
-		_rfft_q15.pCfft = &arm_cfft_sR_q15_len128;
 		break;
 
 	case 512:
 		buffers_allocated = AllocateBuffers<512>();
-		_rfft_q15.fftLenReal = 512;
-		_rfft_q15.twidCoefRModifier = 16U;
-		_rfft_q15.pCfft = &arm_cfft_sR_q15_len256;
 		break;
 
 	case 1024:
 		buffers_allocated = AllocateBuffers<1024>();
-		_rfft_q15.fftLenReal = 1024;
-		_rfft_q15.twidCoefRModifier = 8U;
-		_rfft_q15.pCfft = &arm_cfft_sR_q15_len512;
 		break;
 
 	// case 2048:
 	// 	buffers_allocated = AllocateBuffers<2048>();
-	// 	_rfft_q15.fftLenReal = 2048;
-	// 	_rfft_q15.twidCoefRModifier = 4U;
-	// 	_rfft_q15.pCfft = &arm_cfft_sR_q15_len1024;
-	// 	break;
-
-//	case 4096:
-//		buffers_allocated = AllocateBuffers<4096>();
-//		_rfft_q15.fftLenReal = 4096;
-//		_rfft_q15.twidCoefRModifier = 2U;
-//		_rfft_q15.pCfft = &arm_cfft_sR_q15_len2048;
-//		break;
-
-	// case 8192:
-	// 	buffers_allocated = AllocateBuffers<8192>();
-	// 	_rfft_q15.fftLenReal = 8192;
-	// 	_rfft_q15.twidCoefRModifier = 1U;
-	// 	_rfft_q15.pCfft = &arm_cfft_sR_q15_len4096;
 	// 	break;
 
 	default:
@@ -138,13 +137,15 @@ bool GyroFFT::init()
 		break;
 	}
 
+	buffers_allocated = buffers_allocated && _rfft.init(_param_imu_gyro_fft_len.get());
+
 	if (buffers_allocated) {
 		_imu_gyro_fft_len = _param_imu_gyro_fft_len.get();
 
 		// init Hanning window
 		for (int n = 0; n < _imu_gyro_fft_len; n++) {
 			const float hanning_value = 0.5f * (1.f - cosf(2.f * M_PI_F * n / (_imu_gyro_fft_len - 1)));
-			arm_float_to_q15(&hanning_value, &_hanning_window[n], 1);
+			_hanning_window[n] = RealFFT::floatToQ15(hanning_value);
 		}
 
 		if (!SensorSelectionUpdate(true)) {
@@ -266,7 +267,8 @@ static inline float tau(float x)
 	return (0.25f * p1 - sqrtf(6.f) / 24.f * p2);
 }
 
-float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
+template<typename T>
+float GyroFFT::EstimatePeakFrequencyBin(const T fft[], int peak_index)
 {
 	if (peak_index >= 2) {
 		// find peak location using Quinn's Second Estimator (2020-06-14: http://dspguru.com/dsp/howtos/how-to-interpolate-fft-peak/)
@@ -299,6 +301,42 @@ float GyroFFT::EstimatePeakFrequencyBin(q15_t fft[], int peak_index)
 	return NAN;
 }
 
+void GyroFFT::ConfigureSlidingDFT()
+{
+	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
+	// peaks are searched in [bin_first, bin_last], the Hann window and the peak
+	// interpolation need two more bins tracked on each side
+	int bin_last = math::constrain((int)ceilf(_param_imu_gyro_fft_max.get() / resolution_hz), 3, _imu_gyro_fft_len / 2 - 3);
+	int bin_first = math::constrain((int)floorf(_param_imu_gyro_fft_min.get() / resolution_hz), 3, bin_last);
+
+	const bool limited = (bin_last - bin_first + 5 > SlidingDFT::MAX_BINS);
+
+	if (limited) {
+		bin_last = bin_first + SlidingDFT::MAX_BINS - 5;
+	}
+
+	_sliding_dft_resolution_hz = resolution_hz;
+
+	// reconfiguring drops the tracked window (e.g. on any parameter update), so only do it if the bins changed
+	if ((bin_first == _sliding_dft_bin_first) && (bin_last == _sliding_dft_bin_last)) {
+		return;
+	}
+
+	if (limited) {
+		PX4_WARN("sliding DFT limited to %.1f - %.1f Hz", (double)(bin_first * resolution_hz),
+			 (double)(bin_last * resolution_hz));
+	}
+
+	for (int axis = 0; axis < 3; axis++) {
+		_sliding_dft[axis].configure(bin_first - 2, bin_last + 2);
+		_fft_buffer_index[axis] = 0;
+	}
+
+	_sliding_dft_bin_first = bin_first;
+	_sliding_dft_bin_last = bin_last;
+}
+
 void GyroFFT::Run()
 {
 	if (should_exit()) {
@@ -314,6 +352,8 @@ void GyroFFT::Run()
 	perf_begin(_cycle_perf);
 	perf_count(_cycle_interval_perf);
 
+	bool params_updated = false;
+
 	// Check if parameters have changed
 	if (_parameter_update_sub.updated()) {
 		// clear update
@@ -321,11 +361,21 @@ void GyroFFT::Run()
 		_parameter_update_sub.copy(&param_update);
 
 		updateParams();
+		params_updated = true;
 	}
 
 	const bool selection_updated = SensorSelectionUpdate();
 	VehicleIMUStatusUpdate(selection_updated);
 
+	if ((_method == Method::SLIDING_DFT) && (_gyro_sample_rate_hz > 0.f)) {
+		const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
+
+		// the tracked bins depend on the resolution and on IMU_GYRO_FFT_MIN/MAX, unchanged bins are kept
+		if (params_updated || (fabsf(resolution_hz - _sliding_dft_resolution_hz) > FLT_EPSILON)) {
+			ConfigureSlidingDFT();
+		}
+	}
+
 	// reset
 	_fft_updated = false;
 
@@ -394,6 +444,11 @@ void GyroFFT::Run()
 
 void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
 {
+	if (_method == Method::SLIDING_DFT) {
+		UpdateSlidingDFT(timestamp_sample, input, N);
+		return;
+	}
+
 	q15_t *gyro_data_buffer[] {_gyro_data_buffer_x, _gyro_data_buffer_y, _gyro_data_buffer_z};
 
 	for (int axis = 0; axis < 3; axis++) {
@@ -410,12 +465,12 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 			if ((buffer_index >= _imu_gyro_fft_len) && !_fft_updated) {
 				perf_begin(_fft_perf);
 
-				arm_mult_q15(gyro_data_buffer[axis], _hanning_window, _fft_input_buffer, _imu_gyro_fft_len);
-				arm_rfft_q15(&_rfft_q15, _fft_input_buffer, _fft_outupt_buffer);
+				RealFFT::multiply(gyro_data_buffer[axis], _hanning_window, _fft_input_buffer, _imu_gyro_fft_len);
+				_rfft.transform(_fft_input_buffer, _fft_outupt_buffer);
 
 				_fft_updated = true;
 
-				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer);
+				FindPeaks(timestamp_sample, axis, _fft_outupt_buffer, 1, _imu_gyro_fft_len / 2 - 1);
 
 				// reset
 				// shift buffer (3/4 overlap)
@@ -429,27 +484,66 @@ void GyroFFT::Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint
 	}
 }
 
-void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer)
+void GyroFFT::UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N)
+{
+	perf_begin(_sliding_dft_perf);
+
+	// search the tracked bins for peaks every 1/16 of the window
+	const int peak_interval = _imu_gyro_fft_len / 16;
+
+	for (int axis = 0; axis < 3; axis++) {
+		int &buffer_index = _fft_buffer_index[axis];
+		SlidingDFT &sliding_dft = _sliding_dft[axis];
+
+		if (buffer_index == 0) {
+			// gap in the data or scale change, restart with an empty window
+			sliding_dft.reset();
+		}
+
+		for (int n = 0; n < N; n++) {
+			sliding_dft.update(input[axis][n]);
+		}
+
+		buffer_index += N;
+
+		if (buffer_index >= _imu_gyro_fft_len) {
+			// spectrum buffer is ordered [real[0], imag[0], real[1], imag[1] ...] like the RFFT output
+			for (int bin = _sliding_dft_bin_first - 1; bin <= _sliding_dft_bin_last + 1; bin++) {
+				sliding_dft.windowed(bin, _sliding_dft_spectrum[2 * bin], _sliding_dft_spectrum[2 * bin + 1]);
+			}
+
+			FindPeaks(timestamp_sample, axis, _sliding_dft_spectrum, _sliding_dft_bin_first, _sliding_dft_bin_last);
+
+			buffer_index = _imu_gyro_fft_len - peak_interval;
+		}
+	}
+
+	perf_end(_sliding_dft_perf);
+}
+
+template<typename T>
+void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, const T *spectrum, int bin_first, int bin_last)
 {
 	const float resolution_hz = _gyro_sample_rate_hz / _imu_gyro_fft_len;
 
 	// sum total energy across all used buckets for SNR
 	float bin_mag_sum = 0;
 
-	// FFT output buffer is ordered [real[0], imag[0], real[1], imag[1], real[2], imag[2] ... real[(N/2)-1], imag[(N/2)-1]
-	for (uint16_t fft_index = 2; fft_index < _imu_gyro_fft_len; fft_index += 2) {
+	// spectrum is ordered [real[0], imag[0], real[1], imag[1], real[2], imag[2] ... real[(N/2)-1], imag[(N/2)-1]
+	for (int bin_index = bin_first; bin_index <= bin_last; bin_index++) {
 
-		const float real = fft_outupt_buffer[fft_index];
-		const float imag = fft_outupt_buffer[fft_index + 1];
+		const float real = spectrum[2 * bin_index];
+		const float imag = spectrum[2 * bin_index + 1];
 
 		const float fft_magnitude = sqrtf(real * real + imag * imag);
 
-		int bin_index = fft_index / 2;
-
 		_peak_magnitudes_all[bin_index] = fft_magnitude;
 		bin_mag_sum += fft_magnitude;
 	}
 
+	// bins the noise is averaged over, IMU_GYRO_FFT_LEN - 1 for the full RFFT spectrum
+	const float snr_bins = 2 * (bin_last - bin_first + 1) + 1;
+
 
 	// find raw peaks
 	uint16_t raw_peak_index[MAX_NUM_PEAKS] {};
@@ -460,7 +554,7 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 		float largest_peak = 0;
 		int largest_peak_index = 0;
 
-		for (int bin_index = 1; bin_index < _imu_gyro_fft_len; bin_index++) {
+		for (int bin_index = bin_first; bin_index <= bin_last; bin_index++) {
 
 			const float freq_hz = bin_index * resolution_hz;
 
@@ -504,12 +598,12 @@ void GyroFFT::FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *ff
 	for (int peak_new = 0; peak_new < MAX_NUM_PEAKS; peak_new++) {
 		if (raw_peak_index[peak_new] > 0) {
 
-			const float adjusted_bin = 0.5f * EstimatePeakFrequencyBin(fft_outupt_buffer, 2 * raw_peak_index[peak_new]);
+			const float adjusted_bin = 0.5f * EstimatePeakFrequencyBin(spectrum, 2 * raw_peak_index[peak_new]);
 
 			if (PX4_ISFINITE(adjusted_bin)) {
 				const float freq_adjusted = resolution_hz * adjusted_bin;
 
-				const float snr = 10.f * log10f((_imu_gyro_fft_len - 1) * peak_magnitude[peak_new] /
+				const float snr = 10.f * log10f(snr_bins * peak_magnitude[peak_new] /
 								(bin_mag_sum - peak_magnitude[peak_new]));
 
 				if (PX4_ISFINITE(freq_adjusted)
@@ -706,6 +800,13 @@ int GyroFFT::print_status()
 	perf_print_counter(_cycle_perf);
 	perf_print_counter(_cycle_interval_perf);
 	perf_print_counter(_fft_perf);
+
+	if (_sliding_dft_perf) {
+		PX4_INFO("sliding DFT: %.1f - %.1f Hz", (double)(_sliding_dft_bin_first * _sliding_dft_resolution_hz),
+			 (double)(_sliding_dft_bin_last * _sliding_dft_resolution_hz));
+		perf_print_counter(_sliding_dft_perf);
+	}
+
 	perf_print_counter(_gyro_generation_gap_perf);
 	perf_print_counter(_gyro_fifo_generation_gap_perf);
 	return 0;
@@ -53,8 +53,15 @@
 #include <uORB/topics/sensor_selection.h>
 #include <uORB/topics/vehicle_imu_status.h>
 
-#include "arm_math.h"
-#include "arm_const_structs.h"
+#if defined(GYRO_FFT_PORTABLE)
+#include "RealFFTPortable.hpp"
+using RealFFT = RealFFTPortable;
+#else
+#include "RealFFTCMSIS.hpp"
+using RealFFT = RealFFTCMSIS;
+#endif
+
+#include "SlidingDFT.hpp"
 
 using namespace time_literals;
 
@@ -84,12 +91,29 @@ private:
 	static constexpr int MAX_NUM_PEAKS = sizeof(sensor_gyro_fft_s::peak_frequencies_x) / sizeof(
 			sensor_gyro_fft_s::peak_frequencies_x[0]);
 
+	enum class Method : int32_t {
+		RFFT = 0,
+		SLIDING_DFT = 1,
+	};
+
 	void Run() override;
-	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, q15_t *fft_outupt_buffer);
-	inline float EstimatePeakFrequencyBin(q15_t fft[], int peak_index);
+	void ConfigureSlidingDFT();
+
+	/**
+	 * @param spectrum interleaved [real, imag] per bin, indexed by absolute bin
+	 * @param bin_first first bin searched for peaks, bin_first - 1 must be valid
+	 * @param bin_last last bin searched for peaks, bin_last + 1 must be valid
+	 */
+	template<typename T>
+	inline void FindPeaks(const hrt_abstime &timestamp_sample, int axis, const T *spectrum, int bin_first, int bin_last);
+
+	template<typename T>
+	inline float EstimatePeakFrequencyBin(const T fft[], int peak_index);
+
 	inline void Publish();
 	bool SensorSelectionUpdate(bool force = false);
 	void Update(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
+	void UpdateSlidingDFT(const hrt_abstime &timestamp_sample, int16_t *input[], uint8_t N);
 	inline void UpdateOutput(const hrt_abstime &timestamp_sample, int axis, float peak_frequencies[MAX_NUM_PEAKS],
 				 float peak_snr[MAX_NUM_PEAKS], int num_peaks_found);
 	void VehicleIMUStatusUpdate(bool force = false);
@@ -112,6 +136,16 @@ private:
 			&& _fft_outupt_buffer);
 	}
 
+	bool AllocateSlidingDFT(int N)
+	{
+		_sliding_dft_spectrum = new float[N];
+		_peak_magnitudes_all = new float[N];
+
+		return _sliding_dft[0].allocate(N) && _sliding_dft[1].allocate(N) && _sliding_dft[2].allocate(N)
+		       && _sliding_dft_spectrum
+		       && _peak_magnitudes_all;
+	}
+
 	uORB::Publication<sensor_gyro_fft_s> _sensor_gyro_fft_pub{ORB_ID(sensor_gyro_fft)};
 
 	uORB::SubscriptionInterval _parameter_update_sub{ORB_ID(parameter_update), 1_s};
@@ -125,6 +159,7 @@ private:
 	perf_counter_t _cycle_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": cycle")};
 	perf_counter_t _cycle_interval_perf{perf_alloc(PC_INTERVAL, MODULE_NAME": cycle interval")};
 	perf_counter_t _fft_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": FFT")};
+	perf_counter_t _sliding_dft_perf{nullptr};
 	perf_counter_t _gyro_generation_gap_perf{nullptr};
 	perf_counter_t _gyro_fifo_generation_gap_perf{nullptr};
 
@@ -132,7 +167,7 @@ private:
 
 	bool _gyro_fifo{false};
 
-	arm_rfft_instance_q15 _rfft_q15;
+	RealFFT _rfft;
 
 	q15_t *_gyro_data_buffer_x{nullptr};
 	q15_t *_gyro_data_buffer_y{nullptr};
@@ -143,6 +178,12 @@ private:
 
 	float *_peak_magnitudes_all{nullptr};
 
+	SlidingDFT _sliding_dft[3] {};
+	float *_sliding_dft_spectrum{nullptr};
+	float _sliding_dft_resolution_hz{0.f};
+	int _sliding_dft_bin_first{0};
+	int _sliding_dft_bin_last{0};
+
 	float _gyro_sample_rate_hz{8000}; // 8 kHz default
 
 	float _fifo_last_scale{0};
@@ -159,11 +200,14 @@ private:
 
 	int32_t _imu_gyro_fft_len{256};
 
+	Method _method{Method::RFFT};
+
 	bool _fft_updated{false};
 	bool _publish{false};
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::IMU_GYRO_FFT_LEN>) _param_imu_gyro_fft_len,
+		(ParamInt<px4::params::IMU_GYRO_FFT_MTH>) _param_imu_gyro_fft_mth,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MIN>) _param_imu_gyro_fft_min,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_MAX>) _param_imu_gyro_fft_max,
 		(ParamFloat<px4::params::IMU_GYRO_FFT_SNR>) _param_imu_gyro_fft_snr
@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file RealFFTCMSIS.hpp
+ *
+ * q15 real FFT using the vendored CMSIS-DSP kernels.
+ */
+
+#pragma once
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+class RealFFTCMSIS
+{
+public:
+	RealFFTCMSIS() = default;
+	~RealFFTCMSIS() = default;
+
+	/**
+	 * @param length FFT length (256, 512 or 1024)
+	 * @return false if the length isn't supported
+	 */
+	bool init(int length)
+	{
+		// arm_rfft_init_q15(&_rfft_q15, length, 0, 1) manually inlined to save flash
+		_rfft_q15.pTwiddleAReal = (q15_t *) realCoefAQ15;
+		_rfft_q15.pTwiddleBReal = (q15_t *) realCoefBQ15;
+		_rfft_q15.ifftFlagR = 0;
+		_rfft_q15.bitReverseFlagR = 1;
+
+		switch (length) {
+		// case 128:
+		// 	_rfft_q15.fftLenReal = 128;
+		// 	_rfft_q15.twidCoefRModifier = 64U;
+		// 	_rfft_q15.pCfft = &arm_cfft_sR_q15_len64;
+		// 	return true;
+
+		case 256:
+			_rfft_q15.fftLenReal = 256;
+			_rfft_q15.twidCoefRModifier = 32U;
+			_rfft_q15.pCfft = &arm_cfft_sR_q15_len128;
+			return true;
+
+		case 512:
+			_rfft_q15.fftLenReal = 512;
+			_rfft_q15.twidCoefRModifier = 16U;
+			_rfft_q15.pCfft = &arm_cfft_sR_q15_len256;
+			return true;
+
+		case 1024:
+			_rfft_q15.fftLenReal = 1024;
+			_rfft_q15.twidCoefRModifier = 8U;
+			_rfft_q15.pCfft = &arm_cfft_sR_q15_len512;
+			return true;
+
+		// case 2048:
+		// 	_rfft_q15.fftLenReal = 2048;
+		// 	_rfft_q15.twidCoefRModifier = 4U;
+		// 	_rfft_q15.pCfft = &arm_cfft_sR_q15_len1024;
+		// 	return true;
+
+		// case 4096:
+		// 	_rfft_q15.fftLenReal = 4096;
+		// 	_rfft_q15.twidCoefRModifier = 2U;
+		// 	_rfft_q15.pCfft = &arm_cfft_sR_q15_len2048;
+		// 	return true;
+
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * Real FFT, output ordered [real[0], imag[0], real[1], imag[1] ... ] (2 * length values).
+	 * The input buffer is used as scratch space.
+	 */
+	void transform(q15_t *input, q15_t *output) { arm_rfft_q15(&_rfft_q15, input, output); }
+
+	static void multiply(const q15_t *a, const q15_t *b, q15_t *output, int length) { arm_mult_q15(a, b, output, length); }
+
+	static q15_t floatToQ15(float value)
+	{
+		q15_t output;
+		arm_float_to_q15(&value, &output, 1);
+		return output;
+	}
+
+private:
+	arm_rfft_instance_q15 _rfft_q15{};
+};
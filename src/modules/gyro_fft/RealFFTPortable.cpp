@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "RealFFTPortable.hpp"
+
+#include <math.h>
+
+static inline q15_t saturate_q15(float value)
+{
+	if (value >= 32767.f) {
+		return INT16_MAX;
+
+	} else if (value <= -32768.f) {
+		return INT16_MIN;
+	}
+
+	return (q15_t)lrintf(value);
+}
+
+RealFFTPortable::~RealFFTPortable()
+{
+	free();
+}
+
+void RealFFTPortable::free()
+{
+	delete[] _real;
+	delete[] _imag;
+	delete[] _twiddle_real;
+	delete[] _twiddle_imag;
+	delete[] _split_real;
+	delete[] _split_imag;
+	delete[] _bit_reverse;
+
+	_real = nullptr;
+	_imag = nullptr;
+	_twiddle_real = nullptr;
+	_twiddle_imag = nullptr;
+	_split_real = nullptr;
+	_split_imag = nullptr;
+	_bit_reverse = nullptr;
+
+	_length = 0;
+}
+
+bool RealFFTPortable::init(int length)
+{
+	if ((length < 16) || (length > 8192) || ((length & (length - 1)) != 0)) {
+		return false;
+	}
+
+	free();
+
+	const int half = length / 2;
+
+	_real = new float[half];
+	_imag = new float[half];
+	_twiddle_real = new float[half];
+	_twiddle_imag = new float[half];
+	_split_real = new float[half];
+	_split_imag = new float[half];
+	_bit_reverse = new uint16_t[half];
+
+	if (!_real || !_imag || !_twiddle_real || !_twiddle_imag || !_split_real || !_split_imag || !_bit_reverse) {
+		free();
+		return false;
+	}
+
+	_length = length;
+
+	int bits = 0;
+
+	while ((1 << bits) < half) {
+		bits++;
+	}
+
+	for (int n = 0; n < half; n++) {
+		int reversed = 0;
+
+		for (int b = 0; b < bits; b++) {
+			reversed |= ((n >> b) & 1) << (bits - 1 - b);
+		}
+
+		_bit_reverse[n] = reversed;
+	}
+
+	_twiddle_real[0] = 1.f;
+	_twiddle_imag[0] = 0.f;
+
+	for (int h = 1; h < half; h *= 2) {
+		for (int k = 0; k < h; k++) {
+			const double angle = -M_PI * k / h;
+			_twiddle_real[h + k] = (float)cos(angle);
+			_twiddle_imag[h + k] = (float)sin(angle);
+		}
+	}
+
+	for (int k = 0; k < half; k++) {
+		const double angle = -2.0 * M_PI * k / length;
+		_split_real[k] = (float)cos(angle);
+		_split_imag[k] = (float)sin(angle);
+	}
+
+	return true;
+}
+
+void RealFFTPortable::transform(q15_t *input, q15_t *output)
+{
+	const int half = _length / 2;
+
+	// pack even and odd samples as one complex sequence, bit reversed for the in-place FFT
+	for (int n = 0; n < half; n++) {
+		const int r = _bit_reverse[n];
+		_real[r] = input[2 * n];
+		_imag[r] = input[2 * n + 1];
+	}
+
+	// radix-2 decimation in time butterflies, inner loop is contiguous to allow vectorization
+	for (int h = 1; h < half; h *= 2) {
+		const float *w_real = &_twiddle_real[h];
+		const float *w_imag = &_twiddle_imag[h];
+
+		for (int start = 0; start < half; start += 2 * h) {
+			float *a_real = &_real[start];
+			float *a_imag = &_imag[start];
+			float *b_real = &_real[start + h];
+			float *b_imag = &_imag[start + h];
+
+			for (int k = 0; k < h; k++) {
+				const float t_real = b_real[k] * w_real[k] - b_imag[k] * w_imag[k];
+				const float t_imag = b_real[k] * w_imag[k] + b_imag[k] * w_real[k];
+				b_real[k] = a_real[k] - t_real;
+				b_imag[k] = a_imag[k] - t_imag;
+				a_real[k] += t_real;
+				a_imag[k] += t_imag;
+			}
+		}
+	}
+
+	const float scale = 1.f / _length;
+
+	// X[0] and X[N/2] are real
+	output[0] = saturate_q15((_real[0] + _imag[0]) * scale);
+	output[1] = 0;
+	output[_length] = saturate_q15((_real[0] - _imag[0]) * scale);
+	output[_length + 1] = 0;
+
+	// X[k] = (Z[k] + Z*[N/2-k]) / 2 - j/2 e^(-j 2 pi k / N) (Z[k] - Z*[N/2-k])
+	for (int k = 1; k < half; k++) {
+		const float z_real = _real[k];
+		const float z_imag = _imag[k];
+		const float c_real = _real[half - k];
+		const float c_imag = -_imag[half - k];
+
+		const float d_real = z_real - c_real;
+		const float d_imag = z_imag - c_imag;
+		const float p_real = _split_real[k] * d_real - _split_imag[k] * d_imag;
+		const float p_imag = _split_real[k] * d_imag + _split_imag[k] * d_real;
+
+		const float x_real = 0.5f * (z_real + c_real + p_imag) * scale;
+		const float x_imag = 0.5f * (z_imag + c_imag - p_real) * scale;
+
+		output[2 * k] = saturate_q15(x_real);
+		output[2 * k + 1] = saturate_q15(x_imag);
+
+		// conjugate symmetric upper half
+		output[2 * (_length - k)] = output[2 * k];
+		output[2 * (_length - k) + 1] = saturate_q15(-x_imag);
+	}
+}
+
+void RealFFTPortable::multiply(const q15_t *a, const q15_t *b, q15_t *output, int length)
+{
+	for (int n = 0; n < length; n++) {
+		const int32_t product = ((int32_t)a[n] * b[n]) >> 15;
+		output[n] = (product > INT16_MAX) ? INT16_MAX : (q15_t)product;
+	}
+}
+
+q15_t RealFFTPortable::floatToQ15(float value)
+{
+	// truncating like arm_float_to_q15
+	const float scaled = value * 32768.f;
+
+	if (scaled >= 32767.f) {
+		return INT16_MAX;
+
+	} else if (scaled <= -32768.f) {
+		return INT16_MIN;
+	}
+
+	return (q15_t)scaled;
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file RealFFTPortable.hpp
+ *
+ * Portable q15 real FFT with the same interface and output layout as RealFFTCMSIS.
+ * Computed in floating point (radix-2 complex FFT of half length and a split step),
+ * with the output scaled by 1/length like the CMSIS q15 RFFT.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int16_t q15_t;
+
+class RealFFTPortable
+{
+public:
+	RealFFTPortable() = default;
+	~RealFFTPortable();
+
+	RealFFTPortable(const RealFFTPortable &) = delete;
+	RealFFTPortable &operator=(const RealFFTPortable &) = delete;
+
+	/**
+	 * @param length FFT length, power of 2 from 16 to 8192
+	 * @return false if the length isn't supported or allocation failed
+	 */
+	bool init(int length);
+
+	/**
+	 * Real FFT, output ordered [real[0], imag[0], real[1], imag[1] ... ] (2 * length values).
+	 * The input buffer is left unchanged.
+	 */
+	void transform(q15_t *input, q15_t *output);
+
+	static void multiply(const q15_t *a, const q15_t *b, q15_t *output, int length);
+
+	static q15_t floatToQ15(float value);
+
+private:
+	void free();
+
+	int _length{0};
+
+	// complex FFT of length / 2 in split real and imaginary arrays
+	float *_real{nullptr};
+	float *_imag{nullptr};
+
+	// butterfly twiddles of all stages, stage with half size h at [h, 2h)
+	float *_twiddle_real{nullptr};
+	float *_twiddle_imag{nullptr};
+
+	// e^(-j 2 pi k / length) for the real split
+	float *_split_real{nullptr};
+	float *_split_imag{nullptr};
+
+	uint16_t *_bit_reverse{nullptr};
+};
@@ -0,0 +1,354 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file RealFFTTest.cpp
+ * Checks the portable real FFT against a direct DFT (and CMSIS-DSP if available) and runs
+ * gyro FIFO data through the backends at realistic rates for offline tuning.
+ *
+ * Recorded data: export sensor_gyro_fifo with `ulog2csv -m sensor_gyro_fifo log.ulg` and run
+ * `GYRO_FFT_REPLAY=log_sensor_gyro_fifo_0.csv ./unit-RealFFT`. The searched frequency range
+ * defaults to IMU_GYRO_FFT_MIN/MAX and can be set with GYRO_FFT_MIN_HZ and GYRO_FFT_MAX_HZ.
+ */
+
+#include <gtest/gtest.h>
+#include "RealFFTPortable.hpp"
+
+#if defined(GYRO_FFT_TEST_CMSIS)
+#include "RealFFTCMSIS.hpp"
+#endif
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static uint64_t timeNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t _lcg_state = 1;
+
+// deterministic noise in [-1, 1]
+static float noise()
+{
+	_lcg_state = _lcg_state * 1664525u + 1013904223u;
+	return (float)(_lcg_state >> 8) / (float)(1u << 23) - 1.f;
+}
+
+struct GyroFifo {
+	float sample_rate_hz{0.f};
+	std::vector<int16_t> axis[3];
+};
+
+// 8 kHz FIFO with a motor ramp 60 -> 140 Hz plus second harmonic and noise
+static GyroFifo synthesizeFifo()
+{
+	GyroFifo fifo;
+	fifo.sample_rate_hz = 8000.f;
+	const int samples = 4 * 8000;
+
+	float phase = 0.f;
+
+	for (int n = 0; n < samples; n++) {
+		const float freq_hz = 60.f + 80.f * n / samples;
+		phase += 2.f * (float)M_PI * freq_hz / fifo.sample_rate_hz;
+
+		for (int axis = 0; axis < 3; axis++) {
+			const float value = (1500.f - 400.f * axis) * sinf(phase + axis) + 400.f * sinf(2.f * phase) + 300.f * noise();
+			fifo.axis[axis].push_back((int16_t)value);
+		}
+	}
+
+	return fifo;
+}
+
+// ulog2csv output of sensor_gyro_fifo
+static bool loadFifoCsv(const char *path, GyroFifo &fifo)
+{
+	FILE *file = fopen(path, "r");
+
+	if (file == nullptr) {
+		return false;
+	}
+
+	static char line[8192];
+	int column_dt = -1;
+	int column_samples = -1;
+	int column_first[3] {-1, -1, -1};
+
+	if (fgets(line, sizeof(line), file)) {
+		int column = 0;
+
+		for (char *token = strtok(line, ",\r\n"); token != nullptr; token = strtok(nullptr, ",\r\n"), column++) {
+			if (strcmp(token, "dt") == 0) { column_dt = column; }
+
+			if (strcmp(token, "samples") == 0) { column_samples = column; }
+
+			if (strcmp(token, "x[0]") == 0) { column_first[0] = column; }
+
+			if (strcmp(token, "y[0]") == 0) { column_first[1] = column; }
+
+			if (strcmp(token, "z[0]") == 0) { column_first[2] = column; }
+		}
+	}
+
+	if ((column_dt < 0) || (column_samples < 0) || (column_first[0] < 0) || (column_first[1] < 0) || (column_first[2] < 0)) {
+		fclose(file);
+		return false;
+	}
+
+	double dt_sum = 0.0;
+	int messages = 0;
+	std::vector<double> values;
+
+	while (fgets(line, sizeof(line), file)) {
+		values.clear();
+
+		for (char *token = strtok(line, ",\r\n"); token != nullptr; token = strtok(nullptr, ",\r\n")) {
+			values.push_back(atof(token));
+		}
+
+		if ((int)values.size() <= column_first[2]) {
+			continue;
+		}
+
+		const int samples = (int)values[column_samples];
+
+		for (int axis = 0; axis < 3; axis++) {
+			for (int n = 0; (n < samples) && (column_first[axis] + n < (int)values.size()); n++) {
+				fifo.axis[axis].push_back((int16_t)values[column_first[axis] + n]);
+			}
+		}
+
+		dt_sum += values[column_dt];
+		messages++;
+	}
+
+	fclose(file);
+
+	if ((messages == 0) || (dt_sum <= 0.0)) {
+		return false;
+	}
+
+	// dt is the sample interval in microseconds
+	fifo.sample_rate_hz = (float)(1e6 * messages / dt_sum);
+	return true;
+}
+
+template<typename Backend>
+struct ReplayResult {
+	int ffts{0};
+	uint64_t elapsed_ns{0};
+	std::vector<int> peak_bins;
+};
+
+// same buffering as GyroFFT::Update(): Hanning window, 3/4 overlap, strongest bin in the searched range
+template<typename Backend>
+static ReplayResult<Backend> replay(const GyroFifo &fifo, int length, float min_hz, float max_hz)
+{
+	ReplayResult<Backend> result;
+	Backend fft;
+
+	if (!fft.init(length)) {
+		return result;
+	}
+
+	std::vector<q15_t> window(length);
+	std::vector<q15_t> buffer(length);
+	std::vector<q15_t> input(length);
+	std::vector<q15_t> output(2 * length);
+
+	for (int n = 0; n < length; n++) {
+		window[n] = Backend::floatToQ15(0.5f * (1.f - cosf(2.f * (float)M_PI * n / (length - 1))));
+	}
+
+	const float resolution_hz = fifo.sample_rate_hz / length;
+	const int bin_min = (int)ceilf(min_hz / resolution_hz);
+	const int bin_max = (int)fminf(max_hz / resolution_hz, length / 2 - 1);
+
+	for (int axis = 0; axis < 3; axis++) {
+		int buffer_index = 0;
+
+		for (size_t n = 0; n < fifo.axis[axis].size(); n++) {
+			buffer[buffer_index++] = fifo.axis[axis][n] / 2;
+
+			if (buffer_index >= length) {
+				const uint64_t start = timeNs();
+				Backend::multiply(buffer.data(), window.data(), input.data(), length);
+				fft.transform(input.data(), output.data());
+				result.elapsed_ns += timeNs() - start;
+				result.ffts++;
+
+				float peak_magnitude = 0.f;
+				int peak_bin = 0;
+
+				for (int bin = bin_min; bin <= bin_max; bin++) {
+					const float real = output[2 * bin];
+					const float imag = output[2 * bin + 1];
+
+					if (real * real + imag * imag > peak_magnitude) {
+						peak_magnitude = real * real + imag * imag;
+						peak_bin = bin;
+					}
+				}
+
+				result.peak_bins.push_back(peak_bin);
+
+				const int overlap_start = length / 4;
+				memmove(&buffer[0], &buffer[overlap_start], sizeof(q15_t) * overlap_start * 3);
+				buffer_index = overlap_start * 3;
+			}
+		}
+	}
+
+	return result;
+}
+
+TEST(RealFFTTest, MatchesDirectDFT)
+{
+	for (int length : {256, 512, 1024}) {
+		RealFFTPortable fft;
+		ASSERT_TRUE(fft.init(length));
+
+		std::vector<q15_t> input(length);
+
+		for (int n = 0; n < length; n++) {
+			input[n] = (q15_t)(12000.f * sinf(2.f * (float)M_PI * 17.3f * n / length)
+					   + 6000.f * cosf(2.f * (float)M_PI * 61.f * n / length) + 2000.f * noise());
+		}
+
+		std::vector<q15_t> input_copy(input);
+		std::vector<q15_t> output(2 * length);
+		fft.transform(input.data(), output.data());
+
+		EXPECT_EQ(input, input_copy);
+
+		for (int k = 0; k < length; k++) {
+			double real = 0.0;
+			double imag = 0.0;
+
+			for (int n = 0; n < length; n++) {
+				real += input[n] * cos(2.0 * M_PI * k * n / length);
+				imag -= input[n] * sin(2.0 * M_PI * k * n / length);
+			}
+
+			// scaled by 1 / length like the CMSIS q15 RFFT
+			EXPECT_NEAR(output[2 * k], real / length, 1.0) << "length " << length << " bin " << k;
+			EXPECT_NEAR(output[2 * k + 1], imag / length, 1.0) << "length " << length << " bin " << k;
+		}
+	}
+}
+
+TEST(RealFFTTest, Q15Helpers)
+{
+	EXPECT_EQ(RealFFTPortable::floatToQ15(0.5f), 16384);
+	EXPECT_EQ(RealFFTPortable::floatToQ15(-1.f), INT16_MIN);
+	EXPECT_EQ(RealFFTPortable::floatToQ15(1.f), INT16_MAX);
+
+	const q15_t a[3] {16384, INT16_MIN, -200};
+	const q15_t b[3] {16384, INT16_MIN, 16384};
+	q15_t out[3] {};
+	RealFFTPortable::multiply(a, b, out, 3);
+	EXPECT_EQ(out[0], 8192);
+	EXPECT_EQ(out[1], INT16_MAX);
+	EXPECT_EQ(out[2], -100);
+
+	EXPECT_FALSE(RealFFTPortable().init(100));
+}
+
+TEST(RealFFTTest, Replay)
+{
+	GyroFifo fifo;
+	const char *path = getenv("GYRO_FFT_REPLAY");
+
+	if (path) {
+		ASSERT_TRUE(loadFifoCsv(path, fifo)) << "unable to read sensor_gyro_fifo csv " << path;
+
+	} else {
+		fifo = synthesizeFifo();
+	}
+
+	const float min_hz = getenv("GYRO_FFT_MIN_HZ") ? strtof(getenv("GYRO_FFT_MIN_HZ"), nullptr) : 30.f;
+	const float max_hz = getenv("GYRO_FFT_MAX_HZ") ? strtof(getenv("GYRO_FFT_MAX_HZ"), nullptr) : 150.f;
+
+	printf("%s: %zu samples per axis at %.1f Hz, %.0f - %.0f Hz\n", path ? path : "synthetic",
+	       fifo.axis[0].size(), (double)fifo.sample_rate_hz, (double)min_hz, (double)max_hz);
+
+	for (int length : {256, 512, 1024}) {
+		const auto portable = replay<RealFFTPortable>(fifo, length, min_hz, max_hz);
+		ASSERT_GT(portable.ffts, 0);
+
+		const float resolution_hz = fifo.sample_rate_hz / length;
+		float peak_mean_hz = 0.f;
+
+		for (int bin : portable.peak_bins) {
+			peak_mean_hz += bin * resolution_hz / portable.ffts;
+		}
+
+		printf("  %4d portable: %d FFTs, %.2f us per FFT, mean peak %.1f Hz\n", length, portable.ffts,
+		       1e-3 * portable.elapsed_ns / portable.ffts, (double)peak_mean_hz);
+
+#if defined(GYRO_FFT_TEST_CMSIS)
+		const auto cmsis = replay<RealFFTCMSIS>(fifo, length, min_hz, max_hz);
+		ASSERT_EQ(cmsis.ffts, portable.ffts);
+
+		int matching = 0;
+
+		for (int i = 0; i < cmsis.ffts; i++) {
+			if (abs(cmsis.peak_bins[i] - portable.peak_bins[i]) <= 1) {
+				matching++;
+			}
+		}
+
+		printf("  %4d CMSIS:    %d FFTs, %.2f us per FFT, peak bin within 1 of portable %.1f%%\n", length, cmsis.ffts,
+		       1e-3 * cmsis.elapsed_ns / cmsis.ffts, 100.0 * matching / cmsis.ffts);
+
+		if (!path) {
+			// the synthetic tone dominates, the q15 rounding of CMSIS must not move the peak
+			EXPECT_GE(matching, cmsis.ffts * 95 / 100);
+		}
+
+#endif // GYRO_FFT_TEST_CMSIS
+
+		if (!path) {
+			// the ramp averages to 100 Hz
+			EXPECT_NEAR(peak_mean_hz, 100.f, 2.f * resolution_hz);
+		}
+	}
+}
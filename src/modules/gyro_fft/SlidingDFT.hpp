@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file SlidingDFT.hpp
+ *
+ * Damped sliding DFT of a contiguous range of bins. Every new sample updates all
+ * tracked bins at a constant cost, so the spectrum of the latest window is always
+ * available instead of once per (overlapping) block.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+class SlidingDFT
+{
+public:
+	static constexpr int MAX_BINS = 64;
+
+	SlidingDFT() = default;
+	~SlidingDFT() { delete[] _buffer; }
+
+	SlidingDFT(const SlidingDFT &) = delete;
+	SlidingDFT &operator=(const SlidingDFT &) = delete;
+
+	/**
+	 * Allocate the input history for a window length.
+	 * @param length window length in samples
+	 * @return true on success
+	 */
+	bool allocate(int length)
+	{
+		delete[] _buffer;
+		_buffer = new float[length];
+		_length = (_buffer != nullptr) ? length : 0;
+		_damping_length = powf(DAMPING, (float)_length);
+		reset();
+		return (_buffer != nullptr);
+	}
+
+	/**
+	 * Select the tracked bins and reset the state.
+	 * @param bin_first first tracked bin (>= 1)
+	 * @param bin_last last tracked bin (< length / 2), at most MAX_BINS bins in total
+	 */
+	void configure(int bin_first, int bin_last)
+	{
+		_bin_first = bin_first;
+		_num_bins = bin_last - bin_first + 1;
+
+		if (_num_bins > MAX_BINS) {
+			_num_bins = MAX_BINS;
+		}
+
+		for (int b = 0; b < _num_bins; b++) {
+			const float omega = 2.f * (float)M_PI * (_bin_first + b) / _length;
+			_twiddle_real[b] = DAMPING * cosf(omega);
+			_twiddle_imag[b] = DAMPING * sinf(omega);
+		}
+
+		reset();
+	}
+
+	void reset()
+	{
+		if (_buffer) {
+			memset(_buffer, 0, sizeof(float) * _length);
+		}
+
+		memset(_real, 0, sizeof(_real));
+		memset(_imag, 0, sizeof(_imag));
+		_index = 0;
+	}
+
+	/**
+	 * Push a new sample, dropping the oldest one out of the window.
+	 */
+	inline void update(float sample)
+	{
+		// X_k(n) = r e^(j 2 pi k / N) * (X_k(n-1) + x(n) - r^N x(n-N))
+		const float delta = sample - _damping_length * _buffer[_index];
+		_buffer[_index] = sample;
+
+		if (++_index >= _length) {
+			_index = 0;
+		}
+
+		for (int b = 0; b < _num_bins; b++) {
+			const float real = _real[b] + delta;
+			const float imag = _imag[b];
+			_real[b] = real * _twiddle_real[b] - imag * _twiddle_imag[b];
+			_imag[b] = real * _twiddle_imag[b] + imag * _twiddle_real[b];
+		}
+	}
+
+	/**
+	 * Hann windowed spectrum of a tracked bin, applied in the frequency domain
+	 * (-1/4, 1/2, -1/4), so both neighbouring bins must be tracked as well.
+	 * @param bin absolute bin index in (bin_first, bin_last)
+	 */
+	inline void windowed(int bin, float &real, float &imag) const
+	{
+		const int b = bin - _bin_first;
+		real = 0.5f * _real[b] - 0.25f * (_real[b - 1] + _real[b + 1]);
+		imag = 0.5f * _imag[b] - 0.25f * (_imag[b - 1] + _imag[b + 1]);
+	}
+
+	int length() const { return _length; }
+	int bin_first() const { return _bin_first; }
+	int bin_last() const { return _bin_first + _num_bins - 1; }
+
+private:
+	// slightly below 1 so that rounding errors of the recursion decay instead of accumulating
+	static constexpr float DAMPING = 0.9999f;
+
+	float *_buffer{nullptr};
+	int _length{0};
+	int _index{0};
+
+	int _bin_first{1};
+	int _num_bins{0};
+
+	float _damping_length{1.f};
+
+	float _twiddle_real[MAX_BINS] {};
+	float _twiddle_imag[MAX_BINS] {};
+	float _real[MAX_BINS] {};
+	float _imag[MAX_BINS] {};
+};
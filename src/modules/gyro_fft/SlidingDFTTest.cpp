@@ -0,0 +1,221 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file SlidingDFTTest.cpp
+ * Compares the sliding DFT with a directly computed Hann windowed DFT and the peak
+ * tracking latency with the block wise (3/4 overlap) evaluation of the RFFT path.
+ */
+
+#include <gtest/gtest.h>
+#include "SlidingDFT.hpp"
+
+#include <chrono>
+#include <math.h>
+
+static constexpr float SAMPLE_RATE_HZ = 1000.f;
+static constexpr int LENGTH = 256;
+static constexpr float RESOLUTION_HZ = SAMPLE_RATE_HZ / LENGTH;
+
+static uint64_t timeUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// two tones and a bit of deterministic broadband noise
+static float signal(int n, float freq_hz)
+{
+	const float t = n / SAMPLE_RATE_HZ;
+	return 1000.f * sinf(2.f * (float)M_PI * freq_hz * t) + 300.f * sinf(2.f * (float)M_PI * 210.f * t + 0.3f)
+	       + 50.f * sinf(n * 1.7f) * cosf(n * 0.31f);
+}
+
+// Hann windowed DFT of the last LENGTH samples, weighted like the damped recursion
+static void directDFT(const float *history, int newest, int bin, float damping, float &real, float &imag)
+{
+	real = 0.f;
+	imag = 0.f;
+
+	for (int m = 0; m < LENGTH; m++) {
+		const float x = history[(newest + 1 + m) % LENGTH];
+		const float window = 0.5f - 0.5f * cosf(2.f * (float)M_PI * m / LENGTH);
+		const float weight = window * powf(damping, (float)(LENGTH - m));
+		const float omega = 2.f * (float)M_PI * bin * m / LENGTH;
+		real += weight * x * cosf(omega);
+		imag -= weight * x * sinf(omega);
+	}
+}
+
+// largest windowed magnitude in (bin_first, bin_last)
+static int peakBin(const SlidingDFT &sliding_dft)
+{
+	int peak = -1;
+	float peak_magnitude = 0.f;
+
+	for (int bin = sliding_dft.bin_first() + 1; bin < sliding_dft.bin_last(); bin++) {
+		float real, imag;
+		sliding_dft.windowed(bin, real, imag);
+		const float magnitude = real * real + imag * imag;
+
+		if (magnitude > peak_magnitude) {
+			peak_magnitude = magnitude;
+			peak = bin;
+		}
+	}
+
+	return peak;
+}
+
+TEST(SlidingDFTTest, MatchesDirectDFT)
+{
+	SlidingDFT sliding_dft;
+	ASSERT_TRUE(sliding_dft.allocate(LENGTH));
+	sliding_dft.configure(5, 60);
+
+	float history[LENGTH] {};
+
+	// long enough for rounding errors to show up if the recursion were unstable
+	for (int n = 0; n < 200 * LENGTH; n++) {
+		const float x = signal(n, 80.f);
+		history[n % LENGTH] = x;
+		sliding_dft.update(x);
+
+		if ((n > LENGTH) && (n % 4099 == 0)) {
+			for (int bin = 6; bin < 60; bin++) {
+				float real, imag, real_ref, imag_ref;
+				sliding_dft.windowed(bin, real, imag);
+				directDFT(history, n % LENGTH, bin, 0.9999f, real_ref, imag_ref);
+
+				// relative to the largest bin (~LENGTH * 1000 / 4)
+				EXPECT_NEAR(real, real_ref, 0.5f) << "bin " << bin << " sample " << n;
+				EXPECT_NEAR(imag, imag_ref, 0.5f) << "bin " << bin << " sample " << n;
+			}
+		}
+	}
+
+	EXPECT_EQ(peakBin(sliding_dft), (int)roundf(80.f / RESOLUTION_HZ));
+}
+
+TEST(SlidingDFTTest, TrackingLatency)
+{
+	// tone steps from 80 to 120 Hz after the window is full
+	const float freq_before = 80.f;
+	const float freq_after = 120.f;
+	const int bin_after = (int)roundf(freq_after / RESOLUTION_HZ);
+	const int step = 3 * LENGTH + 37;
+
+	SlidingDFT sliding_dft;
+	ASSERT_TRUE(sliding_dft.allocate(LENGTH));
+	sliding_dft.configure(5, 60);
+
+	float history[LENGTH] {};
+
+	int latency_sliding = -1;
+	int latency_block = -1;
+
+	for (int n = 0; n < step + 2 * LENGTH; n++) {
+		const float x = signal(n, (n < step) ? freq_before : freq_after);
+		history[n % LENGTH] = x;
+		sliding_dft.update(x);
+
+		if (n < step) {
+			continue;
+		}
+
+		// sliding DFT peaks are searched every 1/16 window
+		if ((latency_sliding < 0) && (n % (LENGTH / 16) == 0) && (peakBin(sliding_dft) == bin_after)) {
+			latency_sliding = n - step;
+		}
+
+		// RFFT of the whole window every 1/4 window
+		if ((latency_block < 0) && (n % (LENGTH / 4) == 0)) {
+			float peak_magnitude = 0.f;
+			int peak = -1;
+
+			for (int bin = 6; bin < 60; bin++) {
+				float real, imag;
+				directDFT(history, n % LENGTH, bin, 1.f, real, imag);
+
+				if (real * real + imag * imag > peak_magnitude) {
+					peak_magnitude = real * real + imag * imag;
+					peak = bin;
+				}
+			}
+
+			if (peak == bin_after) {
+				latency_block = n - step;
+			}
+		}
+	}
+
+	printf("peak tracking latency after a step: sliding DFT %d samples, RFFT blocks %d samples\n",
+	       latency_sliding, latency_block);
+
+	ASSERT_GT(latency_sliding, 0);
+	ASSERT_GT(latency_block, 0);
+	EXPECT_LE(latency_sliding, latency_block);
+	EXPECT_LT(latency_sliding, LENGTH);
+}
+
+TEST(SlidingDFTTest, Benchmark)
+{
+	// IMU_GYRO_FFT_LEN 512 at 8 kHz, 30 - 150 Hz tracked (16 bins)
+	static constexpr int length = 512;
+	static constexpr int samples = 8000;
+
+	SlidingDFT sliding_dft;
+	ASSERT_TRUE(sliding_dft.allocate(length));
+	sliding_dft.configure(1, 16);
+
+	static float input[samples];
+
+	for (int n = 0; n < samples; n++) {
+		input[n] = signal(n, 100.f);
+	}
+
+	const uint64_t start = timeUs();
+
+	for (int n = 0; n < samples; n++) {
+		sliding_dft.update(input[n]);
+	}
+
+	const uint64_t elapsed = timeUs() - start;
+
+	float real, imag;
+	sliding_dft.windowed(8, real, imag);
+	EXPECT_TRUE(isfinite(real) && isfinite(imag));
+
+	printf("sliding DFT, %d bins: %.1f ns per sample and axis\n", 16, 1000.0 * elapsed / samples);
+}
@@ -83,3 +83,19 @@ PARAM_DEFINE_INT32(IMU_GYRO_FFT_LEN, 512);
 * @group Sensors
 */
 PARAM_DEFINE_FLOAT(IMU_GYRO_FFT_SNR, 10.f);
+
+/**
+* IMU gyro FFT method.
+*
+* RFFT computes a fixed point FFT of the whole window every 1/4 window per axis.
+* Sliding DFT updates only the bins between IMU_GYRO_FFT_MIN and IMU_GYRO_FFT_MAX
+* with every gyro sample and searches them for peaks every 1/16 window, reducing
+* the peak tracking latency at a constant per sample cost. The SNR is computed
+* relative to the tracked bins only.
+*
+* @value 0 RFFT
+* @value 1 Sliding DFT
+* @reboot_required true
+* @group Sensors
+*/
+PARAM_DEFINE_INT32(IMU_GYRO_FFT_MTH, 0);
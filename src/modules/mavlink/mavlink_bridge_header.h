@@ -55,6 +55,11 @@
 #define MAVLINK_GET_CHANNEL_BUFFER mavlink_get_channel_buffer
 #define MAVLINK_GET_CHANNEL_STATUS mavlink_get_channel_status
 
+/* UDP transport with sendmmsg()/recvmmsg(), defined here as it changes the layout of the receiver */
+#if defined(__PX4_LINUX)
+# define MAVLINK_UDP_MMSG ///< coalesce messages into MTU sized datagrams and use sendmmsg()/recvmmsg()
+#endif // __PX4_LINUX
+
 #if !defined(CONSTRAINED_MEMORY)
 # define MAVLINK_COMM_NUM_BUFFERS 6
 # define MAVLINK_COMM_4 static_cast<mavlink_channel_t>(4)
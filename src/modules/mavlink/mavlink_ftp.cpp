@@ -66,6 +66,7 @@ MavlinkFTP::~MavlinkFTP()
 {
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
+	delete[] _burst_buffer;
 }
 
 unsigned
@@ -543,6 +544,7 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 	_session_info.fd = fd;
 	_session_info.file_size = fileSize;
 	_session_info.stream_download = false;
+	_invalidateBurstBuffer();
 
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
@@ -630,6 +632,8 @@ MavlinkFTP::_workWrite(PayloadHeader *payload)
 	}
 
 	PX4_DEBUG("write %d bytes", payload->size);
+	_invalidateBurstBuffer();
+
 	int bytes_written = ::write(_session_info.fd, &payload->data[0], payload->size);
 
 	if (bytes_written < 0) {
@@ -1029,10 +1033,70 @@ MavlinkFTP::_copy_file(const char *src_path, const char *dst_path, size_t length
 	return (length > 0) ? -1 : 0;
 }
 
+int MavlinkFTP::_burstRead(uint32_t offset, uint8_t *dst, uint8_t len)
+{
+	// a stream download in progress is activity, only a stalled one gets closed by send()
+	_last_work_buffer_access = hrt_absolute_time();
+
+	if (_burst_buffer == nullptr) {
+		_burst_buffer = new uint8_t[_burst_buffer_len];
+		_invalidateBurstBuffer();
+	}
+
+	if (_burst_buffer == nullptr) {
+		// no memory for read-ahead, read directly
+		if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+			return -1;
+		}
+
+		return ::read(_session_info.fd, dst, len);
+	}
+
+	// refill the read-ahead buffer if the requested range is not (completely) buffered
+	if ((offset < _burst_buffer_offset) || (offset + len > _burst_buffer_offset + _burst_buffer_fill)) {
+		_invalidateBurstBuffer();
+
+		if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+			return -1;
+		}
+
+		const int bytes_read = ::read(_session_info.fd, _burst_buffer, _burst_buffer_len);
+
+		if (bytes_read < 0) {
+			return -1;
+		}
+
+		_burst_buffer_offset = offset;
+		_burst_buffer_fill = bytes_read;
+	}
+
+	const int available = _burst_buffer_offset + _burst_buffer_fill - offset;
+	const int bytes = (len < available) ? len : available;
+
+	memcpy(dst, &_burst_buffer[offset - _burst_buffer_offset], bytes);
+
+	return bytes;
+}
+
+unsigned MavlinkFTP::_burstWindowSize()
+{
+#if !defined(MAVLINK_FTP_UNIT_TEST) && defined(MAVLINK_UDP)
+
+	// network links are fast enough to make the round trip for the next burst request the limiting factor
+	if (_mavlink->get_protocol() == Protocol::UDP) {
+		return 512 * 1024;
+	}
+
+#endif
+
+	/* perform transfers in 35K chunks - this is determined empirical */
+	return 35000;
+}
+
 void MavlinkFTP::send()
 {
 
-	if (_work_buffer1 || _work_buffer2) {
+	if (_work_buffer1 || _work_buffer2 || _burst_buffer) {
 		// free the work buffers if they are not used for a while
 		if (hrt_elapsed_time(&_last_work_buffer_access) > 2_s) {
 			if (_work_buffer1) {
@@ -1044,16 +1108,25 @@ void MavlinkFTP::send()
 				delete[] _work_buffer2;
 				_work_buffer2 = nullptr;
 			}
+
+			if (_burst_buffer && !_session_info.stream_download) {
+				delete[] _burst_buffer;
+				_burst_buffer = nullptr;
+			}
 		}
+	}
 
-	} else if (_session_info.fd != -1) {
-		// close session without activity
+	if (_session_info.fd != -1) {
+		// close session without activity, also a stalled stream download which still holds the burst buffer
 		if (hrt_elapsed_time(&_last_work_buffer_access) > 10_s) {
 			::close(_session_info.fd);
 			_session_info.fd = -1;
 			_session_info.stream_download = false;
 			_last_reply_valid = false;
 			PX4_WARN("Session was closed without activity");
+
+			delete[] _burst_buffer;
+			_burst_buffer = nullptr;
 		}
 	}
 
@@ -1101,17 +1174,11 @@ void MavlinkFTP::send()
 		}
 
 		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-				PX4_WARN("stream download: seek fail");
-			}
-		}
-
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _burstRead(payload->offset, &payload->data[0], kMaxDataLength);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
+				_our_errno = errno;
 				error_code = kErrFailErrno;
 				PX4_WARN("stream download: read fail");
 
@@ -1141,8 +1208,7 @@ void MavlinkFTP::send()
 			if (max_bytes_to_send < (get_size() * 2)) {
 				more_data = false;
 
-				/* perform transfers in 35K chunks - this is determined empirical */
-				if (_session_info.stream_chunk_transmitted > 35000) {
+				if (_session_info.stream_chunk_transmitted > _burstWindowSize()) {
 					payload->burst_complete = true;
 					_session_info.stream_download = false;
 					_session_info.stream_chunk_transmitted = 0;
@@ -151,6 +151,17 @@ private:
 	ErrorCode	_workRename(PayloadHeader *payload);
 	ErrorCode	_workCalcFileCRC32(PayloadHeader *payload);
 
+	/**
+	 * Read burst data of the current session through the read-ahead buffer.
+	 * @return number of bytes read, or -1 on error (errno is set)
+	 */
+	int		_burstRead(uint32_t offset, uint8_t *dst, uint8_t len);
+
+	/**
+	 * Number of bytes sent in one burst before the client has to request the next one.
+	 */
+	unsigned	_burstWindowSize();
+
 	uint8_t _getServerSystemId(void);
 	uint8_t _getServerComponentId(void);
 	uint8_t _getServerChannel(void);
@@ -198,6 +209,18 @@ private:
 	static constexpr int _work_buffer2_len = 256;
 	hrt_abstime _last_work_buffer_access{0}; ///< timestamp when the buffers were last accessed
 
+	/* burst read-ahead buffer: allocated on the first burst and freed together with the work buffers */
+	uint8_t *_burst_buffer{nullptr};
+#if defined(__PX4_POSIX)
+	static constexpr int _burst_buffer_len = 64 * 1024;
+#else
+	static constexpr int _burst_buffer_len = 4 * kMaxDataLength;
+#endif
+	uint32_t _burst_buffer_offset{0};	///< file offset of the first byte in _burst_buffer
+	int _burst_buffer_fill{0};		///< number of valid bytes in _burst_buffer
+
+	void _invalidateBurstBuffer() { _burst_buffer_fill = 0; }
+
 	// prepend a root directory to each file/dir access to avoid enumerating the full FS tree (e.g. on Linux).
 	// Note that requests can still fall outside of the root dir by using ../..
 #ifdef MAVLINK_FTP_UNIT_TEST
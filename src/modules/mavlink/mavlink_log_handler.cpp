@@ -388,6 +388,11 @@ MavlinkLogHandler::_open_for_transmit()
 		return false;
 	}
 
+#if defined(__PX4_POSIX)
+	// LOG_DATA only carries 90 bytes, read ahead in large blocks to keep the number of read() calls low
+	setvbuf(_current_log_filep, nullptr, _IOFBF, 64 * 1024);
+#endif // __PX4_POSIX
+
 	return true;
 }
 
@@ -765,11 +765,47 @@ void Mavlink::send_finish()
 
 	else if (get_protocol() == Protocol::UDP) {
 
+# if defined(MAVLINK_UDP_MMSG)
+
+		if (_param_mav_udp_batch.get()) {
+			// append to the current datagram, start a new one if the message doesn't fit anymore
+			if ((_udp_tx_count == 0) || (_udp_tx_len[_udp_tx_count - 1] + _buf_fill > UDP_TX_DATAGRAM_SIZE)) {
+				if (_udp_tx_count == UDP_TX_DATAGRAMS_MAX) {
+					udp_send_pending();
+				}
+
+				_udp_tx_len[_udp_tx_count] = 0;
+				_udp_tx_msgs[_udp_tx_count] = 0;
+				_udp_tx_count++;
+			}
+
+			const int i = _udp_tx_count - 1;
+			memcpy(&_udp_tx_buf[i][_udp_tx_len[i]], _buf, _buf_fill);
+			_udp_tx_len[i] += _buf_fill;
+			_udp_tx_msgs[i]++;
+
+			// accounting is done once the datagram is actually sent
+			_buf_fill = 0;
+			pthread_mutex_unlock(&_send_mutex);
+			return;
+		}
+
+# endif // MAVLINK_UDP_MMSG
+
 # if defined(CONFIG_NET)
 
 		if (_src_addr_initialized) {
 # endif // CONFIG_NET
 			ret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+# if defined(MAVLINK_UDP_MMSG)
+			_udp_tx_syscalls++;
+
+			if (ret == (int)_buf_fill) {
+				_udp_tx_datagrams++;
+				_udp_tx_datagram_bytes += _buf_fill;
+			}
+
+# endif // MAVLINK_UDP_MMSG
 # if defined(CONFIG_NET)
 		}
 
@@ -785,6 +821,9 @@ void Mavlink::send_finish()
 			if (_broadcast_address_found && _buf_fill > 0) {
 
 				int bret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+# if defined(MAVLINK_UDP_MMSG)
+				_udp_tx_syscalls++;
+# endif // MAVLINK_UDP_MMSG
 
 				if (bret <= 0) {
 					if (!_broadcast_failed_warned) {
@@ -815,6 +854,92 @@ void Mavlink::send_finish()
 	pthread_mutex_unlock(&_send_mutex);
 }
 
+#if defined(MAVLINK_UDP_MMSG)
+int Mavlink::udp_sendmmsg(const sockaddr_in &addr)
+{
+	iovec iov[UDP_TX_DATAGRAMS_MAX] {};
+	mmsghdr msgs[UDP_TX_DATAGRAMS_MAX] {};
+
+	for (int i = 0; i < _udp_tx_count; i++) {
+		iov[i].iov_base = _udp_tx_buf[i];
+		iov[i].iov_len = _udp_tx_len[i];
+		msgs[i].msg_hdr.msg_name = (void *)&addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	int sent = 0;
+
+	while (sent < _udp_tx_count) {
+		const int ret = sendmmsg(_socket_fd, &msgs[sent], _udp_tx_count - sent, 0);
+		_udp_tx_syscalls++;
+
+		if (ret <= 0) {
+			break;
+		}
+
+		sent += ret;
+	}
+
+	return sent;
+}
+
+void Mavlink::udp_send_pending()
+{
+	if (_udp_tx_count == 0) {
+		return;
+	}
+
+	const int sent = udp_sendmmsg(_src_addr);
+
+	if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+	    (!get_client_source_initialized() || !is_gcs_connected())) {
+
+		if (!_broadcast_address_found) {
+			find_broadcast_address();
+		}
+
+		if (_broadcast_address_found) {
+			if (udp_sendmmsg(_bcast_addr) < _udp_tx_count) {
+				if (!_broadcast_failed_warned) {
+					PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
+					_broadcast_failed_warned = true;
+				}
+
+			} else {
+				_broadcast_failed_warned = false;
+			}
+		}
+	}
+
+	for (int i = 0; i < _udp_tx_count; i++) {
+		if (i < sent) {
+			_tstatus.tx_message_count += _udp_tx_msgs[i];
+			count_txbytes(_udp_tx_len[i]);
+			_udp_tx_datagrams++;
+			_udp_tx_datagram_bytes += _udp_tx_len[i];
+
+		} else {
+			count_txerrbytes(_udp_tx_len[i]);
+		}
+	}
+
+	if (sent > 0) {
+		_last_write_success_time = _last_write_try_time;
+	}
+
+	_udp_tx_count = 0;
+}
+
+void Mavlink::flush_udp_tx()
+{
+	pthread_mutex_lock(&_send_mutex);
+	udp_send_pending();
+	pthread_mutex_unlock(&_send_mutex);
+}
+#endif // MAVLINK_UDP_MMSG
+
 void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 {
 	if (!_tx_buffer_low) {
@@ -2258,6 +2383,13 @@ Mavlink::task_main(int argc, char *argv[])
 
 		if (!should_transmit()) {
 			check_requested_subscriptions();
+#if defined(MAVLINK_UDP_MMSG)
+
+			if (get_protocol() == Protocol::UDP) {
+				flush_udp_tx();
+			}
+
+#endif // MAVLINK_UDP_MMSG
 			continue;
 		}
 
@@ -2574,6 +2706,16 @@ Mavlink::task_main(int argc, char *argv[])
 				_bytes_tx = 0;
 				_bytes_txerr = 0;
 				_bytes_rx = 0;
+
+#if defined(MAVLINK_UDP_MMSG)
+				pthread_mutex_lock(&_send_mutex);
+				_udp_tx_syscall_rate = _udp_tx_syscalls / dt;
+				_udp_tx_bytes_per_datagram = (_udp_tx_datagrams > 0) ? (float)_udp_tx_datagram_bytes / _udp_tx_datagrams : 0.f;
+				_udp_tx_syscalls = 0;
+				_udp_tx_datagrams = 0;
+				_udp_tx_datagram_bytes = 0;
+				pthread_mutex_unlock(&_send_mutex);
+#endif // MAVLINK_UDP_MMSG
 			}
 
 			_bytes_timestamp = t;
@@ -2584,6 +2726,15 @@ Mavlink::task_main(int argc, char *argv[])
 			publish_telemetry_status();
 		}
 
+#if defined(MAVLINK_UDP_MMSG)
+
+		// send everything queued during this iteration (including by the receiver thread)
+		if (get_protocol() == Protocol::UDP) {
+			flush_udp_tx();
+		}
+
+#endif // MAVLINK_UDP_MMSG
+
 		perf_end(_loop_perf);
 	}
 
@@ -2948,6 +3099,12 @@ Mavlink::display_status()
 		}
 
 #endif
+#if defined(MAVLINK_UDP_MMSG)
+		printf("\tUDP batching: %s\n", _param_mav_udp_batch.get() ? "YES" : "NO");
+		printf("\t  tx: %.1f syscalls/s, %.1f B/datagram\n",
+		       (double)_udp_tx_syscall_rate, (double)_udp_tx_bytes_per_datagram);
+		_receiver.print_udp_rx_stats();
+#endif // MAVLINK_UDP_MMSG
 		break;
 #endif // MAVLINK_UDP
 
@@ -338,6 +338,14 @@ public:
 	 */
 	void             	send_finish();
 
+#if defined(MAVLINK_UDP_MMSG)
+	/**
+	 * Send all coalesced UDP datagrams with a single sendmmsg() per destination.
+	 * Called once per main loop iteration and by the receiver threads after queueing their replies.
+	 */
+	void			flush_udp_tx();
+#endif // MAVLINK_UDP_MMSG
+
 	/**
 	 * Resend message as is, don't change sequence number and CRC.
 	 */
@@ -632,6 +640,34 @@ private:
 	unsigned short		_remote_port{DEFAULT_REMOTE_PORT_UDP};
 #endif // MAVLINK_UDP
 
+#if defined(MAVLINK_UDP_MMSG)
+	static constexpr int		UDP_TX_DATAGRAMS_MAX{16};
+	static constexpr unsigned	UDP_TX_DATAGRAM_SIZE{1472}; ///< 1500 byte Ethernet MTU - IPv4 and UDP headers
+
+	uint8_t			_udp_tx_buf[UDP_TX_DATAGRAMS_MAX][UDP_TX_DATAGRAM_SIZE] {};
+	unsigned		_udp_tx_len[UDP_TX_DATAGRAMS_MAX] {};
+	uint16_t		_udp_tx_msgs[UDP_TX_DATAGRAMS_MAX] {};
+	int			_udp_tx_count{0};		///< number of datagrams currently in use
+
+	// counters since the last rate update and the resulting averages for 'mavlink status'
+	unsigned		_udp_tx_syscalls{0};
+	unsigned		_udp_tx_datagrams{0};
+	unsigned		_udp_tx_datagram_bytes{0};
+	float			_udp_tx_syscall_rate{0.f};
+	float			_udp_tx_bytes_per_datagram{0.f};
+
+	/**
+	 * Send all pending datagrams to one destination.
+	 * @return number of datagrams sent
+	 */
+	int			udp_sendmmsg(const sockaddr_in &addr);
+
+	/**
+	 * Send all pending datagrams to the partner (and broadcast) address, _send_mutex must be held.
+	 */
+	void			udp_send_pending();
+#endif // MAVLINK_UDP_MMSG
+
 	uint8_t			_buf[MAVLINK_MAX_PACKET_LEN] {};
 	unsigned		_buf_fill{0};
 
@@ -673,6 +709,7 @@ private:
 		(ParamBool<px4::params::MAV_HB_FORW_EN>) _param_mav_hb_forw_en,
 		(ParamBool<px4::params::MAV_ODOM_LP>) _param_mav_odom_lp,
 		(ParamInt<px4::params::MAV_RADIO_TOUT>)      _param_mav_radio_timeout,
+		(ParamBool<px4::params::MAV_UDP_BATCH>) _param_mav_udp_batch,
 		(ParamInt<px4::params::SYS_HITL>) _param_sys_hitl,
 		(ParamBool<px4::params::SYS_FAILURE_EN>) _param_sys_failure_injection_enabled
 	)
@@ -166,3 +166,15 @@ PARAM_DEFINE_INT32(MAV_ODOM_LP, 0);
  * @max 250
  */
 PARAM_DEFINE_INT32(MAV_RADIO_TOUT, 5);
+
+/**
+ * Coalesce UDP transmissions.
+ *
+ * If enabled, multiple MAVLink messages are packed into one UDP datagram (up to the Ethernet MTU)
+ * and all pending datagrams are sent with a single sendmmsg() call once per main loop iteration.
+ * Incoming datagrams are read in batches with recvmmsg(). Only available on Linux.
+ *
+ * @boolean
+ * @group MAVLink
+ */
+PARAM_DEFINE_INT32(MAV_UDP_BATCH, 1);
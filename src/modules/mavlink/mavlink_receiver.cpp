@@ -78,6 +78,13 @@ MavlinkReceiver::~MavlinkReceiver()
 #if !defined(CONSTRAINED_FLASH)
 	delete[] _received_msg_stats;
 #endif // !CONSTRAINED_FLASH
+
+	perf_free(_rt_lane_latency_perf);
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+	perf_free(_bulk_lane_latency_perf);
+	perf_free(_bulk_lane_dropped_perf);
+	px4_sem_destroy(&_bulk_lane_sem);
+#endif // MAVLINK_RECEIVER_BULK_LANE
 }
 
 static constexpr vehicle_odometry_s vehicle_odometry_empty {
@@ -105,6 +112,11 @@ MavlinkReceiver::MavlinkReceiver(Mavlink *parent) :
 	_parameters_manager(parent),
 	_mavlink_timesync(parent)
 {
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+	px4_sem_init(&_bulk_lane_sem, 0, 0);
+	// _bulk_lane_sem use case is a signal
+	px4_sem_setprotocol(&_bulk_lane_sem, SEM_PRIO_NONE);
+#endif // MAVLINK_RECEIVER_BULK_LANE
 }
 
 void
@@ -3252,7 +3264,26 @@ MavlinkReceiver::run()
 
 			else if (_mavlink->get_protocol() == Protocol::UDP) {
 				if (fds[0].revents & POLLIN) {
+#if defined(MAVLINK_UDP_MMSG)
+
+					// batch only once the partner is known, the partner detection below
+					// needs the sender of every datagram
+					if (_param_mav_udp_batch.get() && _mavlink->get_client_source_initialized()) {
+						nread = udp_recvmmsg(buf, sizeof(buf), srcaddr);
+
+					} else {
+						nread = recvfrom(_mavlink->get_socket_fd(), buf, sizeof(buf), 0, (struct sockaddr *)&srcaddr, &addrlen);
+						_udp_rx_syscalls++;
+
+						if (nread > 0) {
+							_udp_rx_datagrams++;
+							_udp_rx_bytes += nread;
+						}
+					}
+
+#else
 					nread = recvfrom(_mavlink->get_socket_fd(), buf, sizeof(buf), 0, (struct sockaddr *)&srcaddr, &addrlen);
+#endif // MAVLINK_UDP_MMSG
 				}
 
 				struct sockaddr_in &srcaddr_last = _mavlink->get_client_source_address();
@@ -3283,6 +3314,11 @@ MavlinkReceiver::run()
 			if (_mavlink->get_protocol() != Protocol::UDP || _mavlink->get_client_source_initialized()) {
 #endif // MAVLINK_UDP
 
+				const hrt_abstime time_received = hrt_absolute_time();
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+				bool bulk_lane_pushed = false;
+#endif // MAVLINK_RECEIVER_BULK_LANE
+
 				/* if read failed, this loop won't execute */
 				for (ssize_t i = 0; i < nread; i++) {
 					if (mavlink_parse_char(_mavlink->get_channel(), buf[i], &msg, &_status)) {
@@ -3296,29 +3332,6 @@ MavlinkReceiver::run()
 						/* handle generic messages and commands */
 						handle_message(&msg);
 
-						/* handle packet with mission manager */
-						_mission_manager.handle_message(&msg);
-
-						/* handle packet with parameter component */
-						if (_mavlink->boot_complete()) {
-							// make sure mavlink app has booted before we start processing parameter sync
-							_parameters_manager.handle_message(&msg);
-
-						} else {
-							if (hrt_elapsed_time(&_mavlink->get_first_start_time()) > 20_s) {
-								PX4_ERR("system boot did not complete in 20 seconds");
-								_mavlink->set_boot_complete();
-							}
-						}
-
-						if (_mavlink->ftp_enabled()) {
-							/* handle packet with ftp component */
-							_mavlink_ftp.handle_message(&msg);
-						}
-
-						/* handle packet with log component */
-						_mavlink_log_handler.handle_message(&msg);
-
 						/* handle packet with timesync component */
 						_mavlink_timesync.handle_message(&msg);
 
@@ -3330,9 +3343,42 @@ MavlinkReceiver::run()
 						if (_message_statistics_enabled) {
 							update_message_statistics(msg);
 						}
+
+						// parameter sync waits for the boot to complete, don't block it forever
+						if (!_mavlink->boot_complete()
+						    && hrt_elapsed_time(&_mavlink->get_first_start_time()) > 20_s) {
+							PX4_ERR("system boot did not complete in 20 seconds");
+							_mavlink->set_boot_complete();
+						}
+
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+
+						/* hand mission, parameter, FTP and log messages over to the bulk lane */
+						if (is_bulk_message(msg.msgid)) {
+							if (_bulk_lane_queue.push(BulkLaneItem{time_received, msg})) {
+								bulk_lane_pushed = true;
+
+							} else {
+								perf_count(_bulk_lane_dropped_perf);
+							}
+						}
+
+#else
+						handle_bulk_message(msg);
+#endif // MAVLINK_RECEIVER_BULK_LANE
+
+						perf_set_elapsed(_rt_lane_latency_perf, hrt_elapsed_time(&time_received));
 					}
 				}
 
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+
+				if (bulk_lane_pushed) {
+					px4_sem_post(&_bulk_lane_sem);
+				}
+
+#endif // MAVLINK_RECEIVER_BULK_LANE
+
 				/* count received bytes (nread will be -1 on read error) */
 				if (nread > 0) {
 					_mavlink->count_rxbytes(nread);
@@ -3371,26 +3417,210 @@ MavlinkReceiver::run()
 
 		CheckHeartbeats(t);
 
-		if (t - last_send_update > timeout * 1000) {
-			_mission_manager.check_active_mission();
-			_mission_manager.send();
-
-			_parameters_manager.send();
+#if defined(MAVLINK_UDP_MMSG)
+		update_udp_rx_stats(t);
+#endif // MAVLINK_UDP_MMSG
 
-			if (_mavlink->ftp_enabled()) {
-				_mavlink_ftp.send();
-			}
-
-			_mavlink_log_handler.send();
+		if (t - last_send_update > timeout * 1000) {
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+			// wake up the bulk lane to run the periodic mission, parameter, FTP and log transfers
+			px4_sem_post(&_bulk_lane_sem);
+#else
+			update_bulk_handlers();
+#endif // MAVLINK_RECEIVER_BULK_LANE
 			last_send_update = t;
 		}
 
 		if (_tune_publisher != nullptr) {
 			_tune_publisher->publish_next_tune(t);
 		}
+
+#if defined(MAVLINK_UDP_MMSG)
+
+		// send the replies (command acks, timesync, ...) now instead of with the next main loop iteration
+		if (_mavlink->get_protocol() == Protocol::UDP) {
+			_mavlink->flush_udp_tx();
+		}
+
+#endif // MAVLINK_UDP_MMSG
+	}
+}
+
+#if defined(MAVLINK_UDP_MMSG)
+ssize_t MavlinkReceiver::udp_recvmmsg(uint8_t *buf, size_t len, sockaddr_in &srcaddr)
+{
+	// one slot per datagram, sized to fit a full Wifi/Ethernet MTU packet
+	static constexpr int DATAGRAMS_MAX{5};
+	const size_t slot_size = len / DATAGRAMS_MAX;
+
+	iovec iov[DATAGRAMS_MAX] {};
+	mmsghdr msgs[DATAGRAMS_MAX] {};
+	sockaddr_in addrs[DATAGRAMS_MAX] {};
+
+	for (int i = 0; i < DATAGRAMS_MAX; i++) {
+		iov[i].iov_base = &buf[i * slot_size];
+		iov[i].iov_len = slot_size;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	const int ret = recvmmsg(_mavlink->get_socket_fd(), msgs, DATAGRAMS_MAX, MSG_DONTWAIT, nullptr);
+	_udp_rx_syscalls++;
+
+	if (ret <= 0) {
+		return -1;
+	}
+
+	// the parser treats the link as a byte stream, so the datagrams can simply be concatenated
+	size_t total = 0;
+
+	for (int i = 0; i < ret; i++) {
+		if (total != i * slot_size) {
+			memmove(&buf[total], iov[i].iov_base, msgs[i].msg_len);
+		}
+
+		total += msgs[i].msg_len;
 	}
+
+	// the datagrams might come from different senders, report the first one as a single recvfrom() would
+	srcaddr = addrs[0];
+
+	_udp_rx_datagrams += ret;
+	_udp_rx_bytes += total;
+
+	return total;
 }
 
+void MavlinkReceiver::update_udp_rx_stats(const hrt_abstime &now)
+{
+	if (now > _udp_rx_stats_timestamp + 1_s) {
+		if (_udp_rx_stats_timestamp != 0) {
+			const float dt = (now - _udp_rx_stats_timestamp) * 1e-6f;
+
+			_udp_rx_syscall_rate = _udp_rx_syscalls / dt;
+			_udp_rx_bytes_per_datagram = (_udp_rx_datagrams > 0) ? (float)_udp_rx_bytes / _udp_rx_datagrams : 0.f;
+
+			_udp_rx_syscalls = 0;
+			_udp_rx_datagrams = 0;
+			_udp_rx_bytes = 0;
+		}
+
+		_udp_rx_stats_timestamp = now;
+	}
+}
+
+void MavlinkReceiver::print_udp_rx_stats() const
+{
+	printf("\t  rx: %.1f syscalls/s, %.1f B/datagram\n",
+	       (double)_udp_rx_syscall_rate, (double)_udp_rx_bytes_per_datagram);
+}
+#endif // MAVLINK_UDP_MMSG
+
+void MavlinkReceiver::handle_bulk_message(const mavlink_message_t &msg)
+{
+	/* handle packet with mission manager */
+	_mission_manager.handle_message(&msg);
+
+	/* handle packet with parameter component */
+	if (_mavlink->boot_complete()) {
+		// make sure mavlink app has booted before we start processing parameter sync
+		_parameters_manager.handle_message(&msg);
+	}
+
+	if (_mavlink->ftp_enabled()) {
+		/* handle packet with ftp component */
+		_mavlink_ftp.handle_message(&msg);
+	}
+
+	/* handle packet with log component */
+	_mavlink_log_handler.handle_message(&msg);
+}
+
+void MavlinkReceiver::update_bulk_handlers()
+{
+	_mission_manager.check_active_mission();
+	_mission_manager.send();
+
+	_parameters_manager.send();
+
+	if (_mavlink->ftp_enabled()) {
+		_mavlink_ftp.send();
+	}
+
+	_mavlink_log_handler.send();
+}
+
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+bool MavlinkReceiver::is_bulk_message(uint32_t msgid)
+{
+	switch (msgid) {
+	case MAVLINK_MSG_ID_MISSION_ACK:
+	case MAVLINK_MSG_ID_MISSION_SET_CURRENT:
+	case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+	case MAVLINK_MSG_ID_MISSION_REQUEST:
+	case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+	case MAVLINK_MSG_ID_MISSION_COUNT:
+	case MAVLINK_MSG_ID_MISSION_ITEM:
+	case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+	case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+	case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+	case MAVLINK_MSG_ID_PARAM_SET:
+	case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+	case MAVLINK_MSG_ID_PARAM_MAP_RC:
+	case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+	case MAVLINK_MSG_ID_LOG_REQUEST_LIST:
+	case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+	case MAVLINK_MSG_ID_LOG_ERASE:
+	case MAVLINK_MSG_ID_LOG_REQUEST_END:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+void MavlinkReceiver::run_bulk_lane()
+{
+	/* set thread name */
+	{
+		char thread_name[17];
+		snprintf(thread_name, sizeof(thread_name), "mavlink_blk_if%d", _mavlink->get_instance_id());
+		px4_prctl(PR_SET_NAME, thread_name, px4_getpid());
+	}
+
+	while (!_should_exit.load() && !_mavlink->should_exit()) {
+		// woken up by the receive thread for new messages and at the periodic send interval
+		px4_sem_wait(&_bulk_lane_sem);
+
+		BulkLaneItem item;
+
+		while (_bulk_lane_queue.pop(item)) {
+			handle_bulk_message(item.msg);
+			perf_set_elapsed(_bulk_lane_latency_perf, hrt_elapsed_time(&item.time_received));
+		}
+
+		update_bulk_handlers();
+
+#if defined(MAVLINK_UDP_MMSG)
+
+		if (_mavlink->get_protocol() == Protocol::UDP) {
+			_mavlink->flush_udp_tx();
+		}
+
+#endif // MAVLINK_UDP_MMSG
+	}
+}
+
+void *MavlinkReceiver::start_bulk_lane_trampoline(void *context)
+{
+	MavlinkReceiver *self = reinterpret_cast<MavlinkReceiver *>(context);
+	self->run_bulk_lane();
+	return nullptr;
+}
+#endif // MAVLINK_RECEIVER_BULK_LANE
+
 bool MavlinkReceiver::component_was_seen(int system_id, int component_id)
 {
 	// For system broadcast messages return true if at least one component was seen before
@@ -3587,6 +3817,14 @@ void MavlinkReceiver::start()
 
 	pthread_create(&_thread, &receiveloop_attr, MavlinkReceiver::start_trampoline, (void *)this);
 
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+	// the bulk lane runs at a lower priority, so that large transfers can't delay time-critical messages
+	param.sched_priority = SCHED_PRIORITY_MAX - 90;
+	(void)pthread_attr_setschedparam(&receiveloop_attr, &param);
+
+	pthread_create(&_bulk_lane_thread, &receiveloop_attr, MavlinkReceiver::start_bulk_lane_trampoline, (void *)this);
+#endif // MAVLINK_RECEIVER_BULK_LANE
+
 	pthread_attr_destroy(&receiveloop_attr);
 }
 
@@ -3608,4 +3846,9 @@ void MavlinkReceiver::stop()
 {
 	_should_exit.store(true);
 	pthread_join(_thread, nullptr);
+
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+	px4_sem_post(&_bulk_lane_sem);
+	pthread_join(_bulk_lane_thread, nullptr);
+#endif // MAVLINK_RECEIVER_BULK_LANE
 }
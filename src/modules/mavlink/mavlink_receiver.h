@@ -41,6 +41,7 @@
 
 #pragma once
 
+#include "mavlink_bridge_header.h"
 #include "mavlink_ftp.h"
 #include "mavlink_log_handler.h"
 #include "mavlink_mission.h"
@@ -49,12 +50,19 @@
 #include "mavlink_timesync.h"
 #include "tune_publisher.h"
 
+#if defined(MAVLINK_UDP_MMSG)
+#include <netinet/in.h>
+#endif // MAVLINK_UDP_MMSG
+
+#include <containers/SpscQueue.hpp>
 #include <geo/geo.h>
 #include <lib/drivers/accelerometer/PX4Accelerometer.hpp>
 #include <lib/drivers/gyroscope/PX4Gyroscope.hpp>
 #include <lib/drivers/magnetometer/PX4Magnetometer.hpp>
 #include <lib/systemlib/mavlink_log.h>
+#include <perf/perf_counter.h>
 #include <px4_platform_common/module_params.h>
+#include <px4_platform_common/sem.h>
 #include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/SubscriptionInterval.hpp>
@@ -118,6 +126,10 @@
 # include <uORB/topics/debug_vect.h>
 #endif // !CONSTRAINED_FLASH
 
+#if !defined(CONSTRAINED_MEMORY)
+# define MAVLINK_RECEIVER_BULK_LANE ///< handle mission, parameter, FTP and log messages in a separate thread
+#endif // !CONSTRAINED_MEMORY
+
 using namespace time_literals;
 
 class Mavlink;
@@ -134,6 +146,9 @@ public:
 	bool component_was_seen(int system_id, int component_id);
 	void enable_message_statistics() { _message_statistics_enabled = true; }
 	void print_detailed_rx_stats() const;
+#if defined(MAVLINK_UDP_MMSG)
+	void print_udp_rx_stats() const;
+#endif // MAVLINK_UDP_MMSG
 
 	void request_stop() { _should_exit.store(true); }
 
@@ -141,6 +156,28 @@ private:
 	static void *start_trampoline(void *context);
 	void run();
 
+	/**
+	 * Handle mission, parameter, FTP and log messages (bulk lane).
+	 */
+	void handle_bulk_message(const mavlink_message_t &msg);
+
+	/**
+	 * Run the periodic transfers of the bulk lane handlers.
+	 */
+	void update_bulk_handlers();
+
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+	struct BulkLaneItem {
+		hrt_abstime time_received;
+		mavlink_message_t msg;
+	};
+
+	static bool is_bulk_message(uint32_t msgid);
+
+	static void *start_bulk_lane_trampoline(void *context);
+	void run_bulk_lane();
+#endif // MAVLINK_RECEIVER_BULK_LANE
+
 	void acknowledge(uint8_t sysid, uint8_t compid, uint16_t command, uint8_t result, uint8_t progress = 0);
 
 	/**
@@ -237,6 +274,19 @@ private:
 
 	px4::atomic_bool 	_should_exit{false};
 	pthread_t		_thread {};
+
+#if defined(MAVLINK_RECEIVER_BULK_LANE)
+	static constexpr size_t BULK_LANE_QUEUE_SIZE{32};
+
+	SpscQueue<BulkLaneItem, BULK_LANE_QUEUE_SIZE> _bulk_lane_queue;	///< receive thread -> bulk lane handoff
+	px4_sem_t		_bulk_lane_sem;
+	pthread_t		_bulk_lane_thread {};
+
+	perf_counter_t _bulk_lane_latency_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": rx bulk lane latency")};
+	perf_counter_t _bulk_lane_dropped_perf{perf_alloc(PC_COUNT, MODULE_NAME": rx bulk lane dropped")};
+#endif // MAVLINK_RECEIVER_BULK_LANE
+
+	perf_counter_t _rt_lane_latency_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": rx rt lane latency")};
 	/**
 	 * @brief Updates optical flow parameters.
 	 */
@@ -283,6 +333,23 @@ private:
 	uint64_t _total_received_counter{0};                            ///< The total number of successfully received messages
 	uint64_t _total_lost_counter{0};                                ///< Total messages lost during transmission.
 
+#if defined(MAVLINK_UDP_MMSG)
+	/**
+	 * Read all pending datagrams with a single recvmmsg() and pack them back to back into buf.
+	 * @return number of bytes received or -1 on error
+	 */
+	ssize_t udp_recvmmsg(uint8_t *buf, size_t len, sockaddr_in &srcaddr);
+
+	void update_udp_rx_stats(const hrt_abstime &now);
+
+	unsigned _udp_rx_syscalls{0};
+	unsigned _udp_rx_datagrams{0};
+	unsigned _udp_rx_bytes{0};
+	hrt_abstime _udp_rx_stats_timestamp{0};
+	float _udp_rx_syscall_rate{0.f};
+	float _udp_rx_bytes_per_datagram{0.f};
+#endif // MAVLINK_UDP_MMSG
+
 	uint8_t _mavlink_status_last_buffer_overrun{0};
 	uint8_t _mavlink_status_last_parse_error{0};
 	uint16_t _mavlink_status_last_packet_rx_drop_count{0};
@@ -398,7 +465,8 @@ private:
 	DEFINE_PARAMETERS(
 		(ParamFloat<px4::params::BAT_CRIT_THR>)     _param_bat_crit_thr,
 		(ParamFloat<px4::params::BAT_EMERGEN_THR>)  _param_bat_emergen_thr,
-		(ParamFloat<px4::params::BAT_LOW_THR>)      _param_bat_low_thr
+		(ParamFloat<px4::params::BAT_LOW_THR>)      _param_bat_low_thr,
+		(ParamBool<px4::params::MAV_UDP_BATCH>)     _param_mav_udp_batch
 	);
 
 	// Disallow copy construction and move assignment.
@@ -644,6 +644,85 @@ bool MavlinkFtpTest::_burst_test()
 	return true;
 }
 
+/// @brief Measures the burst download throughput of a large file (read-ahead path).
+bool MavlinkFtpTest::_burst_throughput_test()
+{
+#ifdef __PX4_NUTTX
+	static constexpr uint32_t file_size = 64 * 1024;
+#else
+	static constexpr uint32_t file_size = 4 * 1024 * 1024;
+#endif
+	static const char file[] = PX4_MAVLINK_TEST_DATA_DIR "/test_throughput.data";
+
+	// file content is the low byte of the offset, so every chunk can be verified
+	int fd = ::open(file, O_CREAT | O_TRUNC | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO);
+	ut_assert("open failed", fd != -1);
+
+	uint8_t block[256];
+
+	for (unsigned i = 0; i < sizeof(block); i++) {
+		block[i] = i;
+	}
+
+	for (uint32_t written = 0; written < file_size; written += sizeof(block)) {
+		if (::write(fd, block, sizeof(block)) != sizeof(block)) {
+			::close(fd);
+			::unlink(file);
+			ut_assert("write failed", false);
+		}
+	}
+
+	::close(fd);
+
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+
+	payload.opcode = MavlinkFTP::kCmdOpenFileRO;
+	payload.offset = 0;
+	payload.size = strlen(file) + 1;
+
+	bool success = _send_receive_msg(&payload, (const uint8_t *)file, payload.size, &reply);
+
+	if (!success) {
+		::unlink(file);
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	BurstThroughputInfo info{this, 0, false, true};
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_burst_throughput, &info);
+
+	payload.opcode = MavlinkFTP::kCmdBurstReadFile;
+	payload.session = reply->session;
+	payload.offset = 0;
+	payload.size = MAX_DATA_LEN;
+
+	const hrt_abstime start = hrt_absolute_time();
+
+	mavlink_message_t msg;
+	_setup_ftp_msg(&payload, nullptr, 0, &msg);
+	_ftp_server->handle_message(&msg);
+
+	while (!info.eof && _ftp_server->get_size() > 0) {
+		_ftp_server->send();
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+	_ftp_server->set_unittest_worker(MavlinkFtpTest::receive_message_handler_generic, this);
+	::unlink(file);
+
+	ut_assert("File contents differ", info.data_valid);
+	ut_assert("Missing EOF", info.eof);
+	ut_compare("Incorrect number of bytes", info.expected_offset, file_size);
+
+	PX4_INFO("burst download: %" PRIu32 " bytes in %.1f ms (%.1f MB/s)", file_size, elapsed / 1e3,
+		 (double)file_size / (elapsed > 0 ? elapsed : 1));
+
+	return true;
+}
+
 /// @brief Tests for correct reponse to a Read command on an invalid session.
 bool MavlinkFtpTest::_read_badsession_test()
 {
@@ -929,6 +1008,34 @@ bool MavlinkFtpTest::_receive_message_handler_burst(const mavlink_file_transfer_
 	return true;
 }
 
+void MavlinkFtpTest::receive_message_handler_burst_throughput(const mavlink_file_transfer_protocol_t *ftp_req,
+		void *worker_data)
+{
+	BurstThroughputInfo *info = (BurstThroughputInfo *)worker_data;
+	const MavlinkFTP::PayloadHeader *reply = reinterpret_cast<const MavlinkFTP::PayloadHeader *>(ftp_req->payload);
+
+	info->ftp_test_class->_expected_seq_number++;
+
+	if (reply->opcode == MavlinkFTP::kRspNak) {
+		info->eof = (reply->data[0] == MavlinkFTP::kErrEOF);
+		info->data_valid = info->data_valid && info->eof;
+		return;
+	}
+
+	if (reply->opcode != MavlinkFTP::kRspAck || reply->offset != info->expected_offset) {
+		info->data_valid = false;
+		return;
+	}
+
+	for (unsigned i = 0; i < reply->size; i++) {
+		if (reply->data[i] != (uint8_t)(reply->offset + i)) {
+			info->data_valid = false;
+		}
+	}
+
+	info->expected_offset += reply->size;
+}
+
 /// @brief Decode and validate the incoming message
 bool MavlinkFtpTest::_decode_message(const mavlink_file_transfer_protocol_t	*ftp_msg,	///< Incoming FTP message
 				     const MavlinkFTP::PayloadHeader		**payload)	///< Payload inside FTP message response
@@ -1017,6 +1124,7 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_read_test);
 	ut_run_test(_read_badsession_test);
 	ut_run_test(_burst_test);
+	ut_run_test(_burst_throughput_test);
 	ut_run_test(_removedirectory_test);
 	ut_run_test(_createdirectory_test);
 	ut_run_test(_removefile_test);
@@ -65,6 +65,17 @@ public:
 
 	static void receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
 
+	/// Worker data for burst throughput handler
+	struct BurstThroughputInfo {
+		MavlinkFtpTest		*ftp_test_class;
+		uint32_t		expected_offset;
+		bool			eof;
+		bool			data_valid;
+	};
+
+	static void receive_message_handler_burst_throughput(const mavlink_file_transfer_protocol_t *ftp_req,
+			void *worker_data);
+
 	static const uint8_t serverSystemId = 50;	///< System ID for server
 	static const uint8_t serverComponentId = 1;	///< Component ID for server
 	static const uint8_t serverChannel = 0;		///< Channel to send to
@@ -93,6 +104,7 @@ private:
 	bool _read_test(void);
 	bool _read_badsession_test(void);
 	bool _burst_test(void);
+	bool _burst_throughput_test(void);
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
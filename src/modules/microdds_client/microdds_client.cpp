@@ -33,7 +33,6 @@
 
 #include <px4_platform_common/getopt.h>
 #include <px4_platform_common/cli.h>
-#include <uORB/topics/vehicle_imu.h>
 
 #include "microdds_client.h"
 
@@ -52,8 +51,9 @@
 using namespace time_literals;
 
 MicroddsClient::MicroddsClient(Transport transport, const char *device, int baudrate, const char *host,
-			       const char *port, bool localhost_only)
-	: _localhost_only(localhost_only)
+			       const char *port, bool localhost_only, uint32_t flush_interval_us)
+	: _localhost_only(localhost_only),
+	  _flush_interval_us(flush_interval_us)
 {
 	if (transport == Transport::Serial) {
 
@@ -127,8 +127,6 @@ void MicroddsClient::run()
 		return;
 	}
 
-	int polling_topic_sub = orb_subscribe(ORB_ID(vehicle_imu));
-
 	while (!should_exit()) {
 		bool got_response = false;
 
@@ -220,36 +218,26 @@ void MicroddsClient::run()
 		bool had_ping_reply = false;
 		uint32_t last_num_payload_sent{};
 		uint32_t last_num_payload_received{};
-		bool error_printed = false;
+		uint32_t last_num_samples_sent{};
+		uint32_t last_num_packets_sent{};
 		hrt_abstime last_read = hrt_absolute_time();
+		uint32_t wait_us = 0;
 
 		while (!should_exit() && _connected) {
-			px4_pollfd_struct_t fds[1];
-			fds[0].fd = polling_topic_sub;
-			fds[0].events = POLLIN;
+			// wake up on new samples of the sent topics (or to read and to send out pending samples)
 			// we could poll on the uart/udp fd as well (on nuttx)
-			int pret = px4_poll(fds, 1, 20);
-
-			if (pret < 0) {
-				if (!error_printed) {
-					PX4_ERR("poll failed (%i)", pret);
-					error_printed = true;
-				}
-
-			} else if (pret != 0) {
-				if (fds[0].revents & POLLIN) {
-					vehicle_imu_s data;
-					orb_copy(ORB_ID(vehicle_imu), polling_topic_sub, &data);
-				}
-			}
+			_subs->wait(wait_us);
 
-			_subs->update(data_out);
+			const uint32_t flush_in_us = _subs->update(data_out, _flush_interval_us);
 
 			hrt_abstime read_start = hrt_absolute_time();
 
-			if (read_start - last_read > 5_ms) {
+			if (read_start - last_read >= READ_INTERVAL) {
 				last_read = read_start;
 
+				// running the session sends out the output streams as well
+				_subs->flush();
+
 				// Read as long as there's data or until a timeout
 				pollfd fd_read;
 				fd_read.fd = _fd;
@@ -266,12 +254,24 @@ void MicroddsClient::run()
 
 			hrt_abstime now = hrt_absolute_time();
 
+			// next wakeup at the latest for the next read or to send out the pending samples
+			const hrt_abstime next_read = last_read + READ_INTERVAL;
+			wait_us = (next_read > now) ? (next_read - now) : 0;
+
+			if (flush_in_us > 0 && flush_in_us < wait_us) {
+				wait_us = flush_in_us;
+			}
+
 			if (now - last_status_update > 1_s) {
 				float dt = (now - last_status_update) / 1e6f;
 				_last_payload_tx_rate = (_subs->num_payload_sent - last_num_payload_sent) / dt;
 				_last_payload_rx_rate = (_pubs->num_payload_received - last_num_payload_received) / dt;
+				_last_samples_tx_rate = (_subs->num_samples_sent - last_num_samples_sent) / dt;
+				_last_packets_tx_rate = (_subs->num_packets_sent - last_num_packets_sent) / dt;
 				last_num_payload_sent = _subs->num_payload_sent;
 				last_num_payload_received = _pubs->num_payload_received;
+				last_num_samples_sent = _subs->num_samples_sent;
+				last_num_packets_sent = _subs->num_packets_sent;
 				last_status_update = now;
 			}
 
@@ -298,10 +298,10 @@ void MicroddsClient::run()
 
 		uxr_delete_session_retries(&session, _connected ? 1 : 0);
 		_last_payload_tx_rate = 0;
-		_last_payload_tx_rate = 0;
+		_last_payload_rx_rate = 0;
+		_last_samples_tx_rate = 0;
+		_last_packets_tx_rate = 0;
 	}
-
-	orb_unsubscribe(polling_topic_sub);
 }
 
 int MicroddsClient::setBaudrate(int fd, unsigned baud)
@@ -432,6 +432,7 @@ int MicroddsClient::print_status()
 	PX4_INFO("Running, %s", _connected ? "connected" : "disconnected");
 	PX4_INFO("Payload tx: %i B/s", _last_payload_tx_rate);
 	PX4_INFO("Payload rx: %i B/s", _last_payload_rx_rate);
+	PX4_INFO("Samples tx: %i /s in %i packets/s", _last_samples_tx_rate, _last_packets_tx_rate);
 	return 0;
 }
 
@@ -448,8 +449,9 @@ MicroddsClient *MicroddsClient::instantiate(int argc, char *argv[])
 	int baudrate = 921600;
 	const char *port = "15555";
 	bool localhost_only = false;
+	int flush_interval_us = 0;
 
-	while ((ch = px4_getopt(argc, argv, "t:d:b:h:p:l", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "t:d:b:h:p:lf:", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 't':
 			if (!strcmp(myoptarg, "serial")) {
@@ -489,6 +491,16 @@ MicroddsClient *MicroddsClient::instantiate(int argc, char *argv[])
 			localhost_only = true;
 			break;
 
+		case 'f':
+			flush_interval_us = strtol(myoptarg, nullptr, 10);
+
+			if (flush_interval_us < 0 || flush_interval_us > (int)READ_INTERVAL) {
+				PX4_ERR("flush interval out of range: %s", myoptarg);
+				error_flag = true;
+			}
+
+			break;
+
 		case '?':
 			error_flag = true;
 			break;
@@ -511,7 +523,7 @@ MicroddsClient *MicroddsClient::instantiate(int argc, char *argv[])
 		}
 	}
 
-	return new MicroddsClient(transport, device, baudrate, ip, port, localhost_only);
+	return new MicroddsClient(transport, device, baudrate, ip, port, localhost_only, flush_interval_us);
 }
 
 int MicroddsClient::print_usage(const char *reason)
@@ -525,9 +537,14 @@ int MicroddsClient::print_usage(const char *reason)
 ### Description
 MicroDDS Client used to communicate uORB topics with an Agent over serial or UDP.
 
+The client sends new samples as soon as they are published. All samples that are available at that time
+are batched into the same packet. With -f the samples are held back for up to the given interval
+to fill up the packets further, which reduces the packet rate and overhead for high rate topics.
+
 ### Examples
 $ microdds_client start -t serial -d /dev/ttyS3 -b 921600
 $ microdds_client start -t udp -h 127.0.0.1 -p 15555
+$ microdds_client start -t udp -h 127.0.0.1 -p 15555 -f 2000
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("microdds_client", "system");
@@ -538,6 +555,7 @@ $ microdds_client start -t udp -h 127.0.0.1 -p 15555
 	PRINT_MODULE_USAGE_PARAM_STRING('h', "127.0.0.1", "<IP>", "Host IP", true);
 	PRINT_MODULE_USAGE_PARAM_INT('p', 15555, 0, 3000000, "Remote Port", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('l', "Restrict to localhost (use in combination with ROS_LOCALHOST_ONLY=1)", true);
+	PRINT_MODULE_USAGE_PARAM_INT('f', 0, 0, 5000, "Max. time in us to hold back samples for batching", true);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 
 	return 0;
@@ -49,7 +49,7 @@ public:
 	};
 
 	MicroddsClient(Transport transport, const char *device, int baudrate, const char *host, const char *port,
-		       bool localhost_only);
+		       bool localhost_only, uint32_t flush_interval_us);
 
 	~MicroddsClient();
 
@@ -72,9 +72,12 @@ public:
 	int print_status() override;
 
 private:
+	static constexpr hrt_abstime READ_INTERVAL{5000}; ///< interval in us to read from the agent
+
 	int setBaudrate(int fd, unsigned baud);
 
 	const bool _localhost_only;
+	const uint32_t _flush_interval_us; ///< max. time to hold back samples for batching
 
 	SendTopicsSubs *_subs{nullptr};
 	RcvTopicsPubs *_pubs{nullptr};
@@ -86,6 +89,8 @@ private:
 
 	int _last_payload_tx_rate{}; ///< in B/s
 	int _last_payload_rx_rate{}; ///< in B/s
+	int _last_samples_tx_rate{}; ///< in 1/s
+	int _last_packets_tx_rate{}; ///< in 1/s
 	bool _connected{false};
 };
 
@@ -81,6 +81,31 @@ TEST_F(GeofenceBreachAvoidanceTest, waypointFromBearingAndDistance)
 	EXPECT_LT(Vector2d(home_global - same_as_home_global).norm(), 1e-4);
 }
 
+TEST_F(GeofenceBreachAvoidanceTest, isPathToTestPointInsideFence)
+{
+	GeofenceBreachAvoidance gf_avoidance(nullptr);
+	FakeGeofence geo;
+	Vector2d home_global(42.1, 8.2);
+
+	geo.setProbeFunctionBehavior(FakeGeofence::ProbeFunction::GF_STRIP_10M_AHEAD);
+	gf_avoidance.setTestPointBearing(0.0f);
+	gf_avoidance.setCurrentPosition(home_global(0), home_global(1), 0);
+
+	// the test point is before the exclusion strip
+	gf_avoidance.setHorizontalTestPointDistance(5.0f);
+	EXPECT_TRUE(gf_avoidance.isPathToTestPointInsideFence(&geo));
+
+	// the test point is beyond the strip: the point itself is inside, but the path to it is not
+	gf_avoidance.setHorizontalTestPointDistance(20.0f);
+	Vector2d test_point = gf_avoidance.getFenceViolationTestPoint();
+	EXPECT_TRUE(geo.isInsidePolygonOrCircle(test_point(0), test_point(1), 0));
+	EXPECT_FALSE(gf_avoidance.isPathToTestPointInsideFence(&geo));
+
+	// flying away from the strip
+	gf_avoidance.setTestPointBearing(M_PI_F);
+	EXPECT_TRUE(gf_avoidance.isPathToTestPointInsideFence(&geo));
+}
+
 TEST_F(GeofenceBreachAvoidanceTest, generateLoiterPointForFixedWing)
 {
 	GeofenceBreachAvoidance gf_avoidance(nullptr);
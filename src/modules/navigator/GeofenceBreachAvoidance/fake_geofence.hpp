@@ -70,16 +70,34 @@ public:
 				return _gf_boundary_is_20m_north(lat, lon, altitude);
 			}
 
+		case ProbeFunction::GF_STRIP_10M_AHEAD: {
+				return _gf_strip_is_10m_north(lat, lon, altitude);
+			}
+
 		default:
 			return _allPointsOutside(lat, lon, altitude);
 		}
 	}
 
+	bool isSegmentInsidePolygonOrCircle(double lat_start, double lon_start, double lat_end, double lon_end,
+					    float altitude) override
+	{
+		if (_probe_function_behavior == ProbeFunction::GF_STRIP_10M_AHEAD) {
+			// the strip is crossed if the segment starts and ends on different sides, or ends inside
+			const matrix::Vector2f start_local = _projection.project(lat_start, lon_start);
+			const matrix::Vector2f end_local = _projection.project(lat_end, lon_end);
+			return (start_local(0) < 10.0f) == (end_local(0) < 10.0f) && (start_local(0) > 15.0f) == (end_local(0) > 15.0f);
+		}
+
+		return isInsidePolygonOrCircle(lat_start, lon_start, altitude) && isInsidePolygonOrCircle(lat_end, lon_end, altitude);
+	}
+
 	enum class ProbeFunction {
 		ALL_POINTS_OUTSIDE = 0,
 		LEFT_INSIDE_RIGHT_OUTSIDE,
 		RIGHT_INSIDE_LEFT_OUTSIDE,
-		GF_BOUNDARY_20M_AHEAD
+		GF_BOUNDARY_20M_AHEAD,
+		GF_STRIP_10M_AHEAD
 	};
 
 	void setProbeFunctionBehavior(ProbeFunction func) {_probe_function_behavior = func;}
@@ -92,6 +110,8 @@ private:
 	bool _flag_on_left = true;
 	bool _flag_on_right = false;
 
+	MapProjection _projection{42.1, 8.2};
+
 	bool _allPointsOutside(double lat, double lon, float alt)
 	{
 		return false;
@@ -133,4 +153,11 @@ private:
 
 		return true;
 	}
+
+	bool _gf_strip_is_10m_north(double lat, double lon, float alt)
+	{
+		// exclusion strip from 10m to 15m north of home
+		matrix::Vector2f waypoint_local = _projection.project(lat, lon);
+		return waypoint_local(0) < 10.0f || waypoint_local(0) > 15.0f;
+	}
 };
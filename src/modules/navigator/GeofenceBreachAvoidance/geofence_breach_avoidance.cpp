@@ -100,6 +100,14 @@ GeofenceBreachAvoidance::getFenceViolationTestPoint()
 	return waypointFromBearingAndDistance(_current_pos_lat_lon, _test_point_bearing, _test_point_distance);
 }
 
+bool
+GeofenceBreachAvoidance::isPathToTestPointInsideFence(Geofence *geofence)
+{
+	const Vector2d test_point = getFenceViolationTestPoint();
+	return geofence->isSegmentInsidePolygonOrCircle(_current_pos_lat_lon(0), _current_pos_lat_lon(1), test_point(0),
+			test_point(1), _current_alt_amsl);
+}
+
 Vector2d
 GeofenceBreachAvoidance::generateLoiterPointForFixedWing(geofence_violation_type_u violation_type, Geofence *geofence)
 {
@@ -59,6 +59,13 @@ public:
 
 	matrix::Vector2<double> getFenceViolationTestPoint();
 
+	/**
+	 * Check if the straight path from the current position to the fence violation test point stays inside the
+	 * polygons & circles of the geofence. Unlike a check of the test point only, this also catches fence areas
+	 * that are crossed on the way.
+	 */
+	bool isPathToTestPointInsideFence(Geofence *geofence);
+
 	matrix::Vector2<double> waypointFromBearingAndDistance(matrix::Vector2<double> current_pos_lat_lon,
 			float test_point_bearing, float test_point_distance);
 
@@ -0,0 +1,413 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file GeofenceIndexTest.cpp
+ * Compares the indexed point-in-polygon and segment intersection tests with plain loops over all edges,
+ * and benchmarks them on large fences.
+ */
+
+#include <gtest/gtest.h>
+#include "geofence_index.h"
+
+#include <chrono>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+using Vertex = GeofenceIndex::Vertex;
+
+static uint64_t timeUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// reference: ray cast over all edges, like Geofence::insidePolygon() did before
+static bool insidePolygonNaive(const Vertex *v, int n, float x, float y)
+{
+	bool c = false;
+
+	for (int i = 0, j = n - 1; i < n; j = i++) {
+		if ((v[i].y >= y) != (v[j].y >= y) && (x <= (v[j].x - v[i].x) * (y - v[i].y) / (v[j].y - v[i].y) + v[i].x)) {
+			c = !c;
+		}
+	}
+
+	return c;
+}
+
+// reference: intersect the segment with all edges
+static int intersectSegmentNaive(const Vertex *v, int n, float x_start, float y_start, float x_end, float y_end, float *t,
+				 int max_crossings)
+{
+	const float dx = x_end - x_start;
+	const float dy = y_end - y_start;
+	int num_crossings = 0;
+
+	for (int i = 0, j = n - 1; i < n; j = i++) {
+		const float ex = v[i].x - v[j].x;
+		const float ey = v[i].y - v[j].y;
+		const float denom = dx * ey - dy * ex;
+
+		if (fabsf(denom) < FLT_EPSILON) {
+			continue;
+		}
+
+		const float wx = v[j].x - x_start;
+		const float wy = v[j].y - y_start;
+		const float ts = (wx * ey - wy * ex) / denom;
+		const float u = (wx * dy - wy * dx) / denom;
+
+		if (u >= 0.f && u <= 1.f && ts >= 0.f && ts <= 1.f) {
+			if (num_crossings < max_crossings) {
+				t[num_crossings] = ts;
+			}
+
+			num_crossings++;
+		}
+	}
+
+	return num_crossings;
+}
+
+// sort the crossings and merge the ones reported twice
+static int uniqueCrossings(float *t, int num_crossings)
+{
+	for (int i = 1; i < num_crossings; i++) {
+		for (int k = i; k > 0 && t[k - 1] > t[k]; k--) {
+			const float tmp = t[k];
+			t[k] = t[k - 1];
+			t[k - 1] = tmp;
+		}
+	}
+
+	int num_unique = 0;
+
+	for (int i = 0; i < num_crossings; i++) {
+		if (num_unique == 0 || t[i] - t[num_unique - 1] > 1e-4f) {
+			t[num_unique++] = t[i];
+		}
+	}
+
+	return num_unique;
+}
+
+// star shaped polygon with a noisy radius, every second vertex is moved inwards by inner_ratio (concave if < 1)
+static void makeStar(Vertex *v, int n, float center_x, float center_y, float radius, float inner_ratio = 0.6f)
+{
+	for (int i = 0; i < n; i++) {
+		const float angle = 2.f * (float)M_PI * i / n;
+		const float r = radius * ((i % 2) ? inner_ratio : 1.f) * (0.9f + 0.2f * (rand() / (float)RAND_MAX));
+		v[i].x = center_x + r * cosf(angle);
+		v[i].y = center_y + r * sinf(angle);
+	}
+}
+
+static float clampFloat(float value, float min, float max)
+{
+	return (value < min) ? min : ((value > max) ? max : value);
+}
+
+static float randomFloat(float min, float max)
+{
+	return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+TEST(GeofenceIndexTest, Empty)
+{
+	GeofenceIndex index;
+	EXPECT_TRUE(index.build(nullptr, nullptr, 0));
+	EXPECT_EQ(index.numPolygons(), 0);
+	EXPECT_FALSE(index.insidePolygon(0, 0.f, 0.f));
+
+	const uint16_t vertex_counts[] = {0};
+	EXPECT_FALSE(index.build(nullptr, vertex_counts, 1));
+}
+
+TEST(GeofenceIndexTest, Square)
+{
+	const Vertex square[] = {{0.f, 0.f}, {10.f, 0.f}, {10.f, 10.f}, {0.f, 10.f}};
+	const uint16_t vertex_counts[] = {4};
+	GeofenceIndex index;
+	ASSERT_TRUE(index.build(square, vertex_counts, 1));
+
+	EXPECT_TRUE(index.insidePolygon(0, 5.f, 5.f));
+	EXPECT_TRUE(index.insidePolygon(0, 0.1f, 9.9f));
+	EXPECT_FALSE(index.insidePolygon(0, -1.f, 5.f));
+	EXPECT_FALSE(index.insidePolygon(0, 11.f, 5.f));
+	EXPECT_FALSE(index.insidePolygon(0, 5.f, 11.f));
+	EXPECT_FALSE(index.insidePolygon(0, 5.f, -11.f));
+	EXPECT_FALSE(index.insidePolygon(1, 5.f, 5.f));
+}
+
+TEST(GeofenceIndexTest, MatchesRayCast)
+{
+	srand(1);
+
+	// several polygons of very different sizes, including a vertical line of vertices (equal y coordinates)
+	static constexpr int num_polygons = 5;
+	const uint16_t vertex_counts[num_polygons] = {3, 17, 64, 250, 1000};
+	Vertex vertices[3 + 17 + 64 + 250 + 1000];
+	Vertex *v = vertices;
+
+	for (int i = 0; i < num_polygons; i++) {
+		makeStar(v, vertex_counts[i], 100.f * i, -50.f * i, 20.f + 30.f * i);
+		v += vertex_counts[i];
+	}
+
+	vertices[1].y = vertices[0].y;
+
+	GeofenceIndex index;
+	ASSERT_TRUE(index.build(vertices, vertex_counts, num_polygons));
+	EXPECT_EQ(index.numVertices(), 3 + 17 + 64 + 250 + 1000);
+
+	v = vertices;
+
+	for (int i = 0; i < num_polygons; i++) {
+		const float extent = 30.f + 30.f * i;
+		int num_inside = 0;
+
+		for (int k = 0; k < 20000; k++) {
+			const float x = randomFloat(100.f * i - extent, 100.f * i + extent);
+			const float y = randomFloat(-50.f * i - extent, -50.f * i + extent);
+			const bool inside = insidePolygonNaive(v, vertex_counts[i], x, y);
+			ASSERT_EQ(index.insidePolygon(i, x, y), inside) << "polygon " << i << " point " << x << ", " << y;
+			num_inside += inside;
+		}
+
+		// the test points need to cover both cases
+		EXPECT_GT(num_inside, 1000);
+		EXPECT_LT(num_inside, 19000);
+
+		// points exactly on vertex coordinates
+		for (int k = 0; k < vertex_counts[i]; k++) {
+			ASSERT_EQ(index.insidePolygon(i, v[k].x, v[k].y), insidePolygonNaive(v, vertex_counts[i], v[k].x, v[k].y));
+			ASSERT_EQ(index.insidePolygon(i, v[k].x - 0.1f, v[k].y), insidePolygonNaive(v, vertex_counts[i], v[k].x - 0.1f,
+				  v[k].y));
+		}
+
+		v += vertex_counts[i];
+	}
+}
+
+TEST(GeofenceIndexTest, Benchmark)
+{
+	srand(2);
+
+	// a noisy circle is closer to real fences than a star, where each ray crosses a large fraction of all edges
+	for (int n : {10, 100, 500, 2000}) {
+		Vertex *vertices = new Vertex[n];
+		makeStar(vertices, n, 0.f, 0.f, 1000.f, 0.98f);
+		const uint16_t vertex_count = n;
+
+		uint64_t start = timeUs();
+		GeofenceIndex index;
+		ASSERT_TRUE(index.build(vertices, &vertex_count, 1));
+		const uint64_t build_time = timeUs() - start;
+
+		static constexpr int num_queries = 20000;
+		float *points = new float[2 * num_queries];
+
+		for (int k = 0; k < 2 * num_queries; k++) {
+			points[k] = randomFloat(-1100.f, 1100.f);
+		}
+
+		int num_inside_naive = 0;
+		start = timeUs();
+
+		for (int k = 0; k < num_queries; k++) {
+			num_inside_naive += insidePolygonNaive(vertices, n, points[2 * k], points[2 * k + 1]);
+		}
+
+		const uint64_t naive_time = timeUs() - start;
+
+		int num_inside_index = 0;
+		start = timeUs();
+
+		for (int k = 0; k < num_queries; k++) {
+			num_inside_index += index.insidePolygon(0, points[2 * k], points[2 * k + 1]);
+		}
+
+		const uint64_t index_time = timeUs() - start;
+
+		EXPECT_EQ(num_inside_naive, num_inside_index);
+
+		printf("%4d vertices: build %5" PRIu64 " us, %u bytes, query: ray cast %7.3f us, index %7.3f us\n", n, build_time,
+		       index.memoryUsage(), (double)naive_time / num_queries, (double)index_time / num_queries);
+
+		delete[] points;
+		delete[] vertices;
+	}
+}
+
+TEST(GeofenceIndexTest, SegmentSquare)
+{
+	const Vertex square[] = {{0.f, 0.f}, {10.f, 0.f}, {10.f, 10.f}, {0.f, 10.f}};
+	const uint16_t vertex_counts[] = {4};
+	GeofenceIndex index;
+	ASSERT_TRUE(index.build(square, vertex_counts, 1));
+
+	float t[4];
+
+	// through the square
+	ASSERT_EQ(uniqueCrossings(t, index.intersectSegment(0, -5.f, 5.f, 15.f, 5.f, t, 4)), 2);
+	EXPECT_FLOAT_EQ(t[0], 0.25f);
+	EXPECT_FLOAT_EQ(t[1], 0.75f);
+
+	ASSERT_EQ(uniqueCrossings(t, index.intersectSegment(0, 5.f, 15.f, 5.f, -5.f, t, 4)), 2);
+	EXPECT_FLOAT_EQ(t[0], 0.25f);
+	EXPECT_FLOAT_EQ(t[1], 0.75f);
+
+	// leaving the square
+	ASSERT_EQ(index.intersectSegment(0, 2.f, 2.f, 12.f, 7.f, t, 4), 1);
+	EXPECT_FLOAT_EQ(t[0], 0.8f);
+
+	// inside, outside, and a zero length segment
+	EXPECT_EQ(index.intersectSegment(0, 2.f, 2.f, 8.f, 9.f, t, 4), 0);
+	EXPECT_EQ(index.intersectSegment(0, -5.f, -5.f, -1.f, 20.f, t, 4), 0);
+	EXPECT_EQ(index.intersectSegment(0, 5.f, 5.f, 5.f, 5.f, t, 4), 0);
+	EXPECT_EQ(index.intersectSegment(1, -5.f, 5.f, 15.f, 5.f, t, 4), 0);
+}
+
+TEST(GeofenceIndexTest, SegmentMatchesAllEdges)
+{
+	srand(3);
+
+	static constexpr int num_polygons = 4;
+	const uint16_t vertex_counts[num_polygons] = {3, 40, 300, 1000};
+	Vertex vertices[3 + 40 + 300 + 1000];
+	Vertex *v = vertices;
+
+	for (int i = 0; i < num_polygons; i++) {
+		makeStar(v, vertex_counts[i], 100.f * i, -50.f * i, 20.f + 30.f * i);
+		v += vertex_counts[i];
+	}
+
+	GeofenceIndex index;
+	ASSERT_TRUE(index.build(vertices, vertex_counts, num_polygons));
+
+	static constexpr int max_crossings = 1024;
+	float t_index[max_crossings];
+	float t_naive[max_crossings];
+	v = vertices;
+
+	for (int i = 0; i < num_polygons; i++) {
+		const float extent = 40.f + 30.f * i;
+		int num_crossing_segments = 0;
+
+		for (int k = 0; k < 5000; k++) {
+			// short and long segments
+			const float length = (k % 2) ? 5.f : 2.f * extent;
+			const float x_start = randomFloat(100.f * i - extent, 100.f * i + extent);
+			const float y_start = randomFloat(-50.f * i - extent, -50.f * i + extent);
+			const float x_end = x_start + randomFloat(-length, length);
+			const float y_end = y_start + randomFloat(-length, length);
+
+			const int num_index = uniqueCrossings(t_index, index.intersectSegment(i, x_start, y_start, x_end, y_end, t_index,
+							      max_crossings));
+			const int num_naive = uniqueCrossings(t_naive, intersectSegmentNaive(v, vertex_counts[i], x_start, y_start, x_end,
+							      y_end, t_naive, max_crossings));
+			ASSERT_EQ(num_index, num_naive) << "polygon " << i << " segment " << k;
+
+			for (int c = 0; c < num_index; c++) {
+				ASSERT_NEAR(t_index[c], t_naive[c], 1e-4f);
+			}
+
+			num_crossing_segments += num_index > 0;
+		}
+
+		EXPECT_GT(num_crossing_segments, 100);
+
+		v += vertex_counts[i];
+	}
+}
+
+TEST(GeofenceIndexTest, SegmentBenchmark)
+{
+	srand(4);
+
+	// legs of a survey-like mission, in the area of a noisy circular fence
+	static constexpr int num_legs = 5000;
+	float *legs = new float[2 * (num_legs + 1)];
+
+	for (int k = 0; k < 2 * (num_legs + 1); k++) {
+		legs[k] = randomFloat(-1100.f, 1100.f);
+	}
+
+	for (int k = 1; k <= num_legs; k++) {
+		// short legs, close to the previous waypoint and within the fence area
+		legs[2 * k] = clampFloat(legs[2 * k - 2] + 0.05f * legs[2 * k], -1100.f, 1100.f);
+		legs[2 * k + 1] = clampFloat(legs[2 * k - 1] + 0.05f * legs[2 * k + 1], -1100.f, 1100.f);
+	}
+
+	for (int n : {100, 500, 2000}) {
+		Vertex *vertices = new Vertex[n];
+		makeStar(vertices, n, 0.f, 0.f, 1000.f, 0.98f);
+		const uint16_t vertex_count = n;
+
+		GeofenceIndex index;
+		ASSERT_TRUE(index.build(vertices, &vertex_count, 1));
+
+		float t[64];
+		int num_crossings_naive = 0;
+		uint64_t start = timeUs();
+
+		for (int k = 0; k < num_legs; k++) {
+			num_crossings_naive += uniqueCrossings(t, intersectSegmentNaive(vertices, n, legs[2 * k], legs[2 * k + 1],
+							       legs[2 * k + 2], legs[2 * k + 3], t, 64));
+		}
+
+		const uint64_t naive_time = timeUs() - start;
+
+		int num_crossings_index = 0;
+		start = timeUs();
+
+		for (int k = 0; k < num_legs; k++) {
+			num_crossings_index += uniqueCrossings(t, index.intersectSegment(0, legs[2 * k], legs[2 * k + 1],
+							       legs[2 * k + 2], legs[2 * k + 3], t, 64));
+		}
+
+		const uint64_t index_time = timeUs() - start;
+
+		EXPECT_EQ(num_crossings_naive, num_crossings_index);
+
+		printf("%4d vertices, %d legs (%d crossings): %u bytes, all edges %7.3f ms, grid %7.3f ms\n", n, num_legs,
+		       num_crossings_index, index.memoryUsage(), naive_time / 1e3, index_time / 1e3);
+
+		delete[] vertices;
+	}
+
+	delete[] legs;
+}
@@ -0,0 +1,537 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "geofence_index.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int compare_float(const void *a, const void *b)
+{
+	const float fa = *(const float *)a;
+	const float fb = *(const float *)b;
+	return (fa > fb) - (fa < fb);
+}
+
+GeofenceIndex::~GeofenceIndex()
+{
+	clear();
+}
+
+void GeofenceIndex::clear()
+{
+	delete[] _polygons;
+	delete[] _vertices;
+	delete[] _slab_bounds;
+	delete[] _slab_edges_start;
+	delete[] _slab_edges;
+	delete[] _cell_edges_start;
+	delete[] _cell_edges;
+
+	_polygons = nullptr;
+	_vertices = nullptr;
+	_slab_bounds = nullptr;
+	_slab_edges_start = nullptr;
+	_slab_edges = nullptr;
+	_cell_edges_start = nullptr;
+	_cell_edges = nullptr;
+
+	_num_polygons = 0;
+	_num_vertices = 0;
+	_num_slabs = 0;
+	_num_slab_edges = 0;
+	_num_cells = 0;
+	_num_cell_edges = 0;
+}
+
+unsigned GeofenceIndex::memoryUsage() const
+{
+	return _num_polygons * sizeof(Polygon) + _num_vertices * sizeof(Vertex) + _num_slabs * sizeof(float)
+	       + (_num_slabs + 1) * sizeof(uint32_t) + _num_slab_edges * sizeof(uint16_t)
+	       + (_num_cells + 1) * sizeof(uint32_t) + _num_cell_edges * sizeof(uint16_t);
+}
+
+int GeofenceIndex::gridSize(int num_vertices)
+{
+	// about one edge per cell for a polygon with evenly distributed vertices
+	const int grid_size = (int)ceilf(sqrtf((float)num_vertices));
+	return (grid_size < MAX_GRID_SIZE) ? grid_size : MAX_GRID_SIZE;
+}
+
+int GeofenceIndex::cellX(const Polygon &polygon, float x) const
+{
+	if (polygon.cell_size_x <= 0.f) {
+		return 0;
+	}
+
+	const int cell = (int)((x - polygon.x_min) / polygon.cell_size_x);
+	return (cell < 0) ? 0 : ((cell >= polygon.grid_size) ? polygon.grid_size - 1 : cell);
+}
+
+int GeofenceIndex::cellY(const Polygon &polygon, float y) const
+{
+	if (polygon.cell_size_y <= 0.f) {
+		return 0;
+	}
+
+	const int cell = (int)((y - polygon.y_min) / polygon.cell_size_y);
+	return (cell < 0) ? 0 : ((cell >= polygon.grid_size) ? polygon.grid_size - 1 : cell);
+}
+
+/* index of the last slab with a lower bound <= y */
+static int find_slab(const float *bounds, int num_slabs, float y)
+{
+	int low = 0;
+	int high = num_slabs - 1;
+
+	while (low < high) {
+		const int mid = (low + high + 1) / 2;
+
+		if (bounds[mid] <= y) {
+			low = mid;
+
+		} else {
+			high = mid - 1;
+		}
+	}
+
+	return low;
+}
+
+bool GeofenceIndex::build(const Vertex *vertices, const uint16_t *vertex_counts, int num_polygons)
+{
+	clear();
+
+	int num_vertices = 0;
+	unsigned num_slabs = 0;
+	unsigned num_cells = 0;
+	int max_vertex_count = 0;
+
+	for (int i = 0; i < num_polygons; i++) {
+		if (vertex_counts[i] == 0) {
+			return false;
+		}
+
+		const int grid_size = gridSize(vertex_counts[i]);
+		num_vertices += vertex_counts[i];
+		num_slabs += (vertex_counts[i] < MAX_SLABS) ? vertex_counts[i] : MAX_SLABS;
+		num_cells += grid_size * grid_size;
+
+		if (vertex_counts[i] > max_vertex_count) {
+			max_vertex_count = vertex_counts[i];
+		}
+	}
+
+	if (num_polygons == 0) {
+		return true;
+	}
+
+	_polygons = new Polygon[num_polygons];
+	_vertices = new Vertex[num_vertices];
+	_slab_bounds = new float[num_slabs];
+	_slab_edges_start = new uint32_t[num_slabs + 1];
+	_cell_edges_start = new uint32_t[num_cells + 1];
+	float *sorted_y = new float[max_vertex_count];
+
+	if (!_polygons || !_vertices || !_slab_bounds || !_slab_edges_start || !_cell_edges_start || !sorted_y) {
+		delete[] sorted_y;
+		clear();
+		return false;
+	}
+
+	memcpy(_vertices, vertices, num_vertices * sizeof(Vertex));
+	memset(_slab_edges_start, 0, (num_slabs + 1) * sizeof(uint32_t));
+	memset(_cell_edges_start, 0, (num_cells + 1) * sizeof(uint32_t));
+	_num_polygons = num_polygons;
+	_num_vertices = num_vertices;
+	_num_slabs = num_slabs;
+	_num_cells = num_cells;
+
+	// first pass: slab bounds at the quantiles of the vertex y coordinates, and the number of edges per slab
+	// (the count of slab s is stored at _slab_edges_start[s + 1])
+	uint32_t first_vertex = 0;
+	uint32_t first_slab = 0;
+
+	for (int i = 0; i < num_polygons; i++) {
+		Polygon &polygon = _polygons[i];
+		const Vertex *v = &_vertices[first_vertex];
+		const int n = vertex_counts[i];
+
+		polygon.first_vertex = first_vertex;
+		polygon.num_vertices = n;
+		polygon.num_slabs = (n < MAX_SLABS) ? n : MAX_SLABS;
+		polygon.first_slab = first_slab;
+		polygon.x_min = v[0].x;
+		polygon.x_max = v[0].x;
+
+		for (int k = 0; k < n; k++) {
+			sorted_y[k] = v[k].y;
+
+			if (v[k].x < polygon.x_min) {
+				polygon.x_min = v[k].x;
+			}
+
+			if (v[k].x > polygon.x_max) {
+				polygon.x_max = v[k].x;
+			}
+		}
+
+		qsort(sorted_y, n, sizeof(float), compare_float);
+		polygon.y_min = sorted_y[0];
+		polygon.y_max = sorted_y[n - 1];
+
+		float *bounds = &_slab_bounds[first_slab];
+
+		for (int s = 0; s < polygon.num_slabs; s++) {
+			bounds[s] = sorted_y[s * n / polygon.num_slabs];
+		}
+
+		// an edge is crossed by the ray cast of a point with y in (y_low, y_high], so it is needed in all slabs in between
+		for (int k = 0; k < n; k++) {
+			const Vertex &vi = v[k];
+			const Vertex &vj = v[(k == 0) ? n - 1 : k - 1];
+
+			const float y_low = fminf(vi.y, vj.y);
+			const float y_high = fmaxf(vi.y, vj.y);
+
+			// horizontal edges are never crossed by the ray
+			if (y_high <= y_low) {
+				continue;
+			}
+
+			const int slab_low = find_slab(bounds, polygon.num_slabs, y_low);
+			const int slab_high = find_slab(bounds, polygon.num_slabs, y_high);
+
+			for (int s = slab_low; s <= slab_high; s++) {
+				_slab_edges_start[first_slab + s + 1]++;
+			}
+		}
+
+		first_vertex += n;
+		first_slab += polygon.num_slabs;
+	}
+
+	delete[] sorted_y;
+
+	if (!buildGrid()) {
+		clear();
+		return false;
+	}
+
+	// convert the counts into start indexes, shifted by one slab: the second pass moves them to their final place
+	uint32_t num_slab_edges = 0;
+
+	for (unsigned s = 0; s < num_slabs; s++) {
+		const uint32_t count = _slab_edges_start[s + 1];
+		_slab_edges_start[s + 1] = num_slab_edges;
+		num_slab_edges += count;
+	}
+
+	_slab_edges = new uint16_t[num_slab_edges > 0 ? num_slab_edges : 1];
+
+	if (!_slab_edges) {
+		clear();
+		return false;
+	}
+
+	_num_slab_edges = num_slab_edges;
+
+	// second pass: fill in the edges, _slab_edges_start[s + 1] is the insertion cursor of slab s and ends up
+	// at the end of slab s, which is the start of slab s + 1
+	for (int i = 0; i < num_polygons; i++) {
+		const Polygon &polygon = _polygons[i];
+		const Vertex *v = &_vertices[polygon.first_vertex];
+		const int n = polygon.num_vertices;
+		const float *bounds = &_slab_bounds[polygon.first_slab];
+
+		for (int k = 0; k < n; k++) {
+			const Vertex &vi = v[k];
+			const Vertex &vj = v[(k == 0) ? n - 1 : k - 1];
+
+			const float y_low = fminf(vi.y, vj.y);
+			const float y_high = fmaxf(vi.y, vj.y);
+
+			// horizontal edges are never crossed by the ray
+			if (y_high <= y_low) {
+				continue;
+			}
+
+			const int slab_low = find_slab(bounds, polygon.num_slabs, y_low);
+			const int slab_high = find_slab(bounds, polygon.num_slabs, y_high);
+
+			for (int s = slab_low; s <= slab_high; s++) {
+				_slab_edges[_slab_edges_start[polygon.first_slab + s + 1]++] = k;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool GeofenceIndex::insidePolygon(int polygon_index, float x, float y) const
+{
+	if (polygon_index < 0 || polygon_index >= _num_polygons) {
+		return false;
+	}
+
+	const Polygon &polygon = _polygons[polygon_index];
+
+	// no edge can be crossed outside of the bounding box
+	if (y <= polygon.y_min || y > polygon.y_max || x > polygon.x_max) {
+		return false;
+	}
+
+	const Vertex *v = &_vertices[polygon.first_vertex];
+	const int n = polygon.num_vertices;
+	const unsigned slab = polygon.first_slab + find_slab(&_slab_bounds[polygon.first_slab], polygon.num_slabs, y);
+	bool c = false;
+
+	for (uint32_t e = _slab_edges_start[slab]; e < _slab_edges_start[slab + 1]; e++) {
+		const int k = _slab_edges[e];
+		const Vertex &vi = v[k];
+		const Vertex &vj = v[(k == 0) ? n - 1 : k - 1];
+
+		if ((vi.y >= y) != (vj.y >= y) && (x <= (vj.x - vi.x) * (y - vi.y) / (vj.y - vi.y) + vi.x)) {
+			c = !c;
+		}
+	}
+
+	return c;
+}
+
+bool GeofenceIndex::buildGrid()
+{
+	uint32_t first_cell = 0;
+
+	for (int i = 0; i < _num_polygons; i++) {
+		Polygon &polygon = _polygons[i];
+		polygon.grid_size = gridSize(polygon.num_vertices);
+		polygon.first_cell = first_cell;
+		polygon.cell_size_x = (polygon.x_max - polygon.x_min) / polygon.grid_size;
+		polygon.cell_size_y = (polygon.y_max - polygon.y_min) / polygon.grid_size;
+		first_cell += polygon.grid_size * polygon.grid_size;
+	}
+
+	// same two passes as for the slabs: count the edges per cell (stored at _cell_edges_start[cell + 1]), then fill them in.
+	// An edge is added to all cells overlapped by its bounding box.
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = 0; i < _num_polygons; i++) {
+			const Polygon &polygon = _polygons[i];
+			const Vertex *v = &_vertices[polygon.first_vertex];
+			const int n = polygon.num_vertices;
+
+			for (int k = 0; k < n; k++) {
+				const Vertex &vi = v[k];
+				const Vertex &vj = v[(k == 0) ? n - 1 : k - 1];
+				const int cell_x_low = cellX(polygon, (vi.x < vj.x) ? vi.x : vj.x);
+				const int cell_x_high = cellX(polygon, (vi.x < vj.x) ? vj.x : vi.x);
+				const int cell_y_low = cellY(polygon, (vi.y < vj.y) ? vi.y : vj.y);
+				const int cell_y_high = cellY(polygon, (vi.y < vj.y) ? vj.y : vi.y);
+
+				for (int cell_x = cell_x_low; cell_x <= cell_x_high; cell_x++) {
+					for (int cell_y = cell_y_low; cell_y <= cell_y_high; cell_y++) {
+						const unsigned cell = polygon.first_cell + cell_x * polygon.grid_size + cell_y;
+
+						if (pass == 0) {
+							_cell_edges_start[cell + 1]++;
+
+						} else {
+							_cell_edges[_cell_edges_start[cell + 1]++] = k;
+						}
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			uint32_t num_cell_edges = 0;
+
+			for (unsigned cell = 0; cell < _num_cells; cell++) {
+				const uint32_t count = _cell_edges_start[cell + 1];
+				_cell_edges_start[cell + 1] = num_cell_edges;
+				num_cell_edges += count;
+			}
+
+			_cell_edges = new uint16_t[num_cell_edges > 0 ? num_cell_edges : 1];
+
+			if (!_cell_edges) {
+				return false;
+			}
+
+			_num_cell_edges = num_cell_edges;
+		}
+	}
+
+	return true;
+}
+
+/* Liang-Barsky clipping of the segment parameter range [t_min, t_max] against one side of a box */
+static bool clip(float p, float q, float &t_min, float &t_max)
+{
+	if (fabsf(p) < FLT_EPSILON) {
+		// parallel to the side
+		return q >= 0.f;
+	}
+
+	const float r = q / p;
+
+	if (p < 0.f) {
+		if (r > t_max) {
+			return false;
+		}
+
+		if (r > t_min) {
+			t_min = r;
+		}
+
+	} else {
+		if (r < t_min) {
+			return false;
+		}
+
+		if (r < t_max) {
+			t_max = r;
+		}
+	}
+
+	return true;
+}
+
+int GeofenceIndex::intersectSegment(int polygon_index, float x_start, float y_start, float x_end, float y_end,
+				    float *t, int max_crossings) const
+{
+	if (polygon_index < 0 || polygon_index >= _num_polygons) {
+		return 0;
+	}
+
+	const Polygon &polygon = _polygons[polygon_index];
+	const float dx = x_end - x_start;
+	const float dy = y_end - y_start;
+
+	// part of the segment within the bounding box
+	float t_min = 0.f;
+	float t_max = 1.f;
+
+	if (!clip(-dx, x_start - polygon.x_min, t_min, t_max) || !clip(dx, polygon.x_max - x_start, t_min, t_max)
+	    || !clip(-dy, y_start - polygon.y_min, t_min, t_max) || !clip(dy, polygon.y_max - y_start, t_min, t_max)) {
+		return 0;
+	}
+
+	// walk along the grid cells crossed by the segment (Amanatides & Woo)
+	const int grid_size = polygon.grid_size;
+	int cell_x = cellX(polygon, x_start + t_min * dx);
+	int cell_y = cellY(polygon, y_start + t_min * dy);
+	const int step_x = (dx > 0.f) ? 1 : -1;
+	const int step_y = (dy > 0.f) ? 1 : -1;
+
+	// segment parameter at the next cell border, and between two cell borders
+	float t_next_x = INFINITY;
+	float t_delta_x = INFINITY;
+	float t_next_y = INFINITY;
+	float t_delta_y = INFINITY;
+
+	if (fabsf(dx) > FLT_EPSILON && polygon.cell_size_x > 0.f) {
+		t_next_x = (polygon.x_min + (cell_x + (dx > 0.f)) * polygon.cell_size_x - x_start) / dx;
+		t_delta_x = polygon.cell_size_x / fabsf(dx);
+	}
+
+	if (fabsf(dy) > FLT_EPSILON && polygon.cell_size_y > 0.f) {
+		t_next_y = (polygon.y_min + (cell_y + (dy > 0.f)) * polygon.cell_size_y - y_start) / dy;
+		t_delta_y = polygon.cell_size_y / fabsf(dy);
+	}
+
+	const Vertex *v = &_vertices[polygon.first_vertex];
+	const int n = polygon.num_vertices;
+	float t_cell_start = t_min;
+	int num_crossings = 0;
+
+	for (;;) {
+		const float t_cell_end = fminf(fminf(t_next_x, t_next_y), t_max);
+		const unsigned cell = polygon.first_cell + cell_x * grid_size + cell_y;
+
+		for (uint32_t e = _cell_edges_start[cell]; e < _cell_edges_start[cell + 1]; e++) {
+			const int k = _cell_edges[e];
+			const Vertex &vi = v[k];
+			const Vertex &vj = v[(k == 0) ? n - 1 : k - 1];
+
+			// solve start + ts * d = vj + u * (vi - vj)
+			const float ex = vi.x - vj.x;
+			const float ey = vi.y - vj.y;
+			const float denom = dx * ey - dy * ex;
+
+			// parallel
+			if (fabsf(denom) < FLT_EPSILON) {
+				continue;
+			}
+
+			const float wx = vj.x - x_start;
+			const float wy = vj.y - y_start;
+			const float ts = (wx * ey - wy * ex) / denom;
+			const float u = (wx * dy - wy * dx) / denom;
+
+			// an edge can be in several cells: only count the crossing in the cell where it happens
+			if (u < 0.f || u > 1.f || ts < 0.f || ts > 1.f || ts < t_cell_start - 1e-6f || ts > t_cell_end + 1e-6f) {
+				continue;
+			}
+
+			if (num_crossings < max_crossings) {
+				t[num_crossings] = ts;
+			}
+
+			num_crossings++;
+		}
+
+		if (t_cell_end >= t_max) {
+			break;
+		}
+
+		if (t_next_x < t_next_y) {
+			cell_x += step_x;
+			t_cell_start = t_next_x;
+			t_next_x += t_delta_x;
+
+		} else {
+			cell_y += step_y;
+			t_cell_start = t_next_y;
+			t_next_y += t_delta_y;
+		}
+
+		if (cell_x < 0 || cell_x >= grid_size || cell_y < 0 || cell_y >= grid_size) {
+			break;
+		}
+	}
+
+	return num_crossings;
+}
@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file geofence_index.h
+ *
+ * In-memory copy of the geofence polygons in a local frame, with a slab index per polygon for fast
+ * point-in-polygon tests, and a uniform grid over the edges of each polygon for segment intersection tests.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class GeofenceIndex
+{
+public:
+	/** Polygon vertex in the local frame [m] (x: north, y: east) */
+	struct Vertex {
+		float x;
+		float y;
+	};
+
+	GeofenceIndex() = default;
+	~GeofenceIndex();
+	GeofenceIndex(const GeofenceIndex &) = delete;
+	GeofenceIndex &operator=(const GeofenceIndex &) = delete;
+
+	/**
+	 * Build the index for a set of polygons, replacing the existing ones.
+	 * The polygons are stored back to back in vertices, polygon i has vertex_counts[i] > 0 vertices.
+	 * @return false if the memory could not be allocated or a polygon is empty (the index is empty then)
+	 */
+	bool build(const Vertex *vertices, const uint16_t *vertex_counts, int num_polygons);
+
+	void clear();
+
+	int numPolygons() const { return _num_polygons; }
+	int numVertices() const { return _num_vertices; }
+
+	/** @return memory used by the index [bytes] */
+	unsigned memoryUsage() const;
+
+	/**
+	 * Check if a point is inside a polygon. The result is the same as for a ray cast over all edges
+	 * (PNPOLY), but only the edges within the slab containing the point are tested.
+	 * Only supports non-complex polygons (not self intersecting).
+	 */
+	bool insidePolygon(int polygon, float x, float y) const;
+
+	/**
+	 * Find the crossings of the segment (x_start, y_start) -> (x_end, y_end) with the edges of a polygon.
+	 * Only the edges in the grid cells along the segment are tested. Edges parallel to the segment are ignored.
+	 * A crossing exactly on a grid cell border might be reported twice.
+	 *
+	 * @param t output: position of each crossing along the segment, in [0, 1]
+	 * @param max_crossings size of t
+	 * @return number of crossings found, can be larger than max_crossings (only max_crossings are stored then)
+	 */
+	int intersectSegment(int polygon, float x_start, float y_start, float x_end, float y_end, float *t,
+			     int max_crossings) const;
+
+private:
+#if defined(CONSTRAINED_MEMORY)
+	static constexpr int MAX_SLABS = 16; ///< maximum number of slabs per polygon
+	static constexpr int MAX_GRID_SIZE = 8; ///< maximum number of grid cells per polygon along each axis
+#else
+	static constexpr int MAX_SLABS = 64;
+	static constexpr int MAX_GRID_SIZE = 16;
+#endif
+
+	struct Polygon {
+		uint32_t first_vertex;
+		uint16_t num_vertices;
+		uint16_t num_slabs;
+		uint32_t first_slab; ///< index into _slab_bounds and _slab_edges_start
+		uint32_t first_cell; ///< index into _cell_edges_start, cells are stored row by row (x major)
+		uint16_t grid_size;  ///< number of grid cells along each axis
+		float x_min;         ///< bounding box
+		float x_max;
+		float y_min;
+		float y_max;
+		float cell_size_x;   ///< grid cell size, 0 if the bounding box has no extent along the axis
+		float cell_size_y;
+	};
+
+	static int gridSize(int num_vertices);
+
+	/** build the edge grid of all polygons, the bounding boxes need to be set already */
+	bool buildGrid();
+
+	int cellX(const Polygon &polygon, float x) const;
+	int cellY(const Polygon &polygon, float y) const;
+
+	Polygon *_polygons{nullptr};
+	Vertex *_vertices{nullptr};
+	float *_slab_bounds{nullptr};       ///< lower y bound of each slab, ascending per polygon
+	uint32_t *_slab_edges_start{nullptr}; ///< per slab: first index into _slab_edges, one more entry per polygon
+	uint16_t *_slab_edges{nullptr};     ///< edge k goes from vertex k-1 (wrapping) to vertex k
+	uint32_t *_cell_edges_start{nullptr}; ///< per grid cell: first index into _cell_edges, one more entry at the end
+	uint16_t *_cell_edges{nullptr};     ///< edges overlapping each cell (with their bounding box)
+
+	int _num_polygons{0};
+	int _num_vertices{0};
+	unsigned _num_slabs{0};
+	unsigned _num_slab_edges{0};
+	unsigned _num_cells{0};
+	unsigned _num_cell_edges{0};
+};
@@ -175,6 +175,122 @@ void Geofence::_updateFence()
 
 	}
 
+	_loadFenceData();
+}
+
+static bool is_supported_frame(const mission_fence_point_s &fence_point)
+{
+	return fence_point.frame == NAV_FRAME_GLOBAL || fence_point.frame == NAV_FRAME_GLOBAL_INT
+	       || fence_point.frame == NAV_FRAME_GLOBAL_RELATIVE_ALT
+	       || fence_point.frame == NAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+}
+
+void Geofence::_loadFenceData()
+{
+	_polygon_index.clear();
+
+	int num_index_polygons = 0;
+	int num_vertices = 0;
+
+	for (int i = 0; i < _num_polygons; ++i) {
+		_polygons[i].loaded = false;
+
+		if (_polygons[i].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION
+		    || _polygons[i].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_EXCLUSION) {
+			++num_index_polygons;
+			num_vertices += _polygons[i].vertex_count;
+		}
+	}
+
+	if (_num_polygons == 0) {
+		return;
+	}
+
+	GeofenceIndex::Vertex *vertices = new GeofenceIndex::Vertex[math::max(num_vertices, 1)];
+	uint16_t *vertex_counts = new uint16_t[math::max(num_index_polygons, 1)];
+
+	if (!vertices || !vertex_counts) {
+		PX4_ERR("alloc failed");
+		delete[] vertices;
+		delete[] vertex_counts;
+		return;
+	}
+
+	// all cached coordinates are relative to the first fence point
+	_projection_reference = MapProjection{};
+
+	static constexpr unsigned VERTEX_CHUNK_SIZE = 8;
+	mission_fence_point_s fence_points[VERTEX_CHUNK_SIZE];
+	int num_loaded_polygons = 0;
+	int num_loaded_vertices = 0;
+
+	for (int i = 0; i < _num_polygons; ++i) {
+		PolygonInfo &polygon = _polygons[i];
+		const bool is_circle = polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION
+				       || polygon.fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION;
+		const unsigned count = is_circle ? 1 : polygon.vertex_count;
+		GeofenceIndex::Vertex *polygon_vertices = &vertices[num_loaded_vertices];
+		bool success = true;
+
+		for (unsigned chunk_start = 0; success && chunk_start < count; chunk_start += VERTEX_CHUNK_SIZE) {
+			const unsigned chunk_size = math::min(VERTEX_CHUNK_SIZE, count - chunk_start);
+
+			if (dm_read_bulk(DM_KEY_FENCE_POINTS, polygon.dataman_index + chunk_start, fence_points,
+					 sizeof(mission_fence_point_s), chunk_size) != (ssize_t)chunk_size) {
+				PX4_ERR("dm_read failed");
+				success = false;
+				break;
+			}
+
+			for (unsigned k = 0; k < chunk_size; k++) {
+				if (!is_supported_frame(fence_points[k])) {
+					// TODO: handle different frames
+					PX4_ERR("Frame type %i not supported", (int)fence_points[k].frame);
+					success = false;
+					break;
+				}
+
+				if (!_projection_reference.isInitialized()) {
+					_projection_reference.initReference(fence_points[k].lat, fence_points[k].lon);
+				}
+
+				float x, y;
+				_projection_reference.project(fence_points[k].lat, fence_points[k].lon, x, y);
+
+				if (is_circle) {
+					polygon.circle_center_x = x;
+					polygon.circle_center_y = y;
+
+				} else {
+					polygon_vertices[chunk_start + k] = {x, y};
+				}
+			}
+		}
+
+		if (success) {
+			polygon.loaded = true;
+
+			if (!is_circle) {
+				polygon.index_id = num_loaded_polygons;
+				vertex_counts[num_loaded_polygons++] = polygon.vertex_count;
+				num_loaded_vertices += polygon.vertex_count;
+			}
+		}
+	}
+
+	if (!_polygon_index.build(vertices, vertex_counts, num_loaded_polygons)) {
+		PX4_ERR("alloc failed");
+
+		for (int i = 0; i < _num_polygons; ++i) {
+			if (_polygons[i].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION
+			    || _polygons[i].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_EXCLUSION) {
+				_polygons[i].loaded = false;
+			}
+		}
+	}
+
+	delete[] vertices;
+	delete[] vertex_counts;
 }
 
 bool Geofence::checkAll(const struct vehicle_global_position_s &global_position)
@@ -304,12 +420,47 @@ bool Geofence::isBelowMaxAltitude(float altitude)
 	return inside_fence;
 }
 
-bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
+int Geofence::checkMissionItems(const mission_item_s *items, const mission_item_s *leg_starts, int num_items,
+				bool &leg_violation)
+{
+	leg_violation = false;
+
+	if (!updateFenceIfChanged()) {
+		return -1;
+	}
+
+	for (int i = 0; i < num_items; ++i) {
+		const mission_item_s &item = items[i];
+
+		if (!isCloserThanMaxDistToHome(item.lat, item.lon, item.altitude)
+		    || !isBelowMaxAltitude(item.altitude)
+		    || !_insidePolygonOrCircle(item.lat, item.lon, item.altitude)) {
+			return i;
+		}
+
+		// the altitude changes linearly along the leg and the distance to home is convex, so only the
+		// polygons & circles need to be checked between the items
+		if (leg_starts && _num_polygons > 0 && _projection_reference.isInitialized()) {
+			float x_start, y_start, x_end, y_end;
+			_projection_reference.project(leg_starts[i].lat, leg_starts[i].lon, x_start, y_start);
+			_projection_reference.project(item.lat, item.lon, x_end, y_end);
+
+			if (!_segmentInsidePolygonOrCircleLocal(x_start, y_start, x_end, y_end)) {
+				leg_violation = true;
+				return i;
+			}
+		}
+	}
+
+	return -1;
+}
+
+bool Geofence::updateFenceIfChanged()
 {
-	// the following uses dm_read, so first we try to lock all items. If that fails, it (most likely) means
-	// the data is currently being updated (via a mavlink geofence transfer), and we do not check for a violation now
+	// the fence data is updated when the dataman stats entry changed, so first we try to lock all items. If that fails,
+	// it (most likely) means the data is currently being updated (via a mavlink geofence transfer)
 	if (dm_trylock(DM_KEY_FENCE_POINTS) != 0) {
-		return true;
+		return false;
 	}
 
 	// we got the lock, now check if the fence data got updated
@@ -320,8 +471,46 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 		_updateFence();
 	}
 
-	if (isEmpty()) {
-		dm_unlock(DM_KEY_FENCE_POINTS);
+	dm_unlock(DM_KEY_FENCE_POINTS);
+	return true;
+}
+
+bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
+{
+	// do not check for a violation while the fence data is being updated
+	if (!updateFenceIfChanged()) {
+		return true;
+	}
+
+	return _insidePolygonOrCircle(lat, lon, altitude);
+}
+
+bool Geofence::isSegmentInsidePolygonOrCircle(double lat_start, double lon_start, double lat_end, double lon_end,
+		float altitude)
+{
+	// do not check for a violation while the fence data is being updated
+	if (!updateFenceIfChanged()) {
+		return true;
+	}
+
+	if (!_insidePolygonOrCircle(lat_end, lon_end, altitude)) {
+		return false;
+	}
+
+	if (_num_polygons == 0 || !_projection_reference.isInitialized()) {
+		return true;
+	}
+
+	float x_start, y_start, x_end, y_end;
+	_projection_reference.project(lat_start, lon_start, x_start, y_start);
+	_projection_reference.project(lat_end, lon_end, x_end, y_end);
+
+	return _segmentInsidePolygonOrCircleLocal(x_start, y_start, x_end, y_end);
+}
+
+bool Geofence::_insidePolygonOrCircle(double lat, double lon, float altitude) const
+{
+	if (_num_polygons == 0) {
 		/* Empty fence -> accept all points */
 		return true;
 	}
@@ -329,20 +518,30 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 	/* Vertical check */
 	if (_altitude_max > _altitude_min) { // only enable vertical check if configured properly
 		if (altitude > _altitude_max || altitude < _altitude_min) {
-			dm_unlock(DM_KEY_FENCE_POINTS);
 			return false;
 		}
 	}
 
+	/* Horizontal check: iterate all polygons & circles, using the data cached in RAM */
+	float x = 0.f;
+	float y = 0.f;
+
+	if (_projection_reference.isInitialized()) {
+		_projection_reference.project(lat, lon, x, y);
+	}
+
+	return _insidePolygonOrCircleLocal(x, y);
+}
 
-	/* Horizontal check: iterate all polygons & circles */
+bool Geofence::_insidePolygonOrCircleLocal(float x, float y) const
+{
 	bool outside_exclusion = true;
 	bool inside_inclusion = false;
 	bool had_inclusion_areas = false;
 
 	for (int polygon_index = 0; polygon_index < _num_polygons; ++polygon_index) {
 		if (_polygons[polygon_index].fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_index], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_index], x, y);
 
 			if (inside) {
 				inside_inclusion = true;
@@ -351,14 +550,14 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 			had_inclusion_areas = true;
 
 		} else if (_polygons[polygon_index].fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
-			bool inside = insideCircle(_polygons[polygon_index], lat, lon, altitude);
+			bool inside = insideCircle(_polygons[polygon_index], x, y);
 
 			if (inside) {
 				outside_exclusion = false;
 			}
 
 		} else { // it's a polygon
-			bool inside = insidePolygon(_polygons[polygon_index], lat, lon, altitude);
+			bool inside = insidePolygon(_polygons[polygon_index], x, y);
 
 			if (_polygons[polygon_index].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION) {
 				if (inside) {
@@ -375,81 +574,104 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 		}
 	}
 
-	dm_unlock(DM_KEY_FENCE_POINTS);
-
 	return (!had_inclusion_areas || inside_inclusion) && outside_exclusion;
 }
 
-bool Geofence::insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude)
+bool Geofence::_segmentInsidePolygonOrCircleLocal(float x_start, float y_start, float x_end, float y_end) const
 {
-	/**
-	 * Adaptation of algorithm originally presented as
-	 * PNPOLY - Point Inclusion in Polygon Test
-	 * W. Randolph Franklin (WRF)
-	 * Only supports non-complex polygons (not self intersecting)
-	 */
-
-	mission_fence_point_s temp_vertex_i{};
-	mission_fence_point_s temp_vertex_j{};
-	bool c = false;
-
-	for (unsigned i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + i, &temp_vertex_i,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
+	const float dx = x_end - x_start;
+	const float dy = y_end - y_start;
+
+	// positions of the crossings along the segment, in [0, 1], including both ends
+	float t[MAX_SEGMENT_CROSSINGS + 2];
+	int num_t = 0;
+	t[num_t++] = 0.f;
+
+	for (int polygon_index = 0; polygon_index < _num_polygons; ++polygon_index) {
+		const PolygonInfo &polygon = _polygons[polygon_index];
+
+		if (!polygon.loaded) {
+			continue;
 		}
 
-		if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index + j, &temp_vertex_j,
-			    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-			break;
+		if (polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION || polygon.fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
+			// solve |start + t * d - center| = radius
+			const float cx = x_start - polygon.circle_center_x;
+			const float cy = y_start - polygon.circle_center_y;
+			const float a = dx * dx + dy * dy;
+			const float b = 2.f * (dx * cx + dy * cy);
+			const float c = cx * cx + cy * cy - polygon.circle_radius * polygon.circle_radius;
+			const float discriminant = b * b - 4.f * a * c;
+
+			if (a < FLT_EPSILON || discriminant < 0.f) {
+				continue;
+			}
+
+			const float root = sqrtf(discriminant);
+
+			for (const float crossing : {(-b - root) / (2.f * a), (-b + root) / (2.f * a)}) {
+				if (crossing >= 0.f && crossing <= 1.f) {
+					if (num_t > MAX_SEGMENT_CROSSINGS) {
+						return false;
+					}
+
+					t[num_t++] = crossing;
+				}
+			}
+
+		} else {
+			const int max_crossings = MAX_SEGMENT_CROSSINGS + 1 - num_t;
+			const int num_crossings = _polygon_index.intersectSegment(polygon.index_id, x_start, y_start, x_end, y_end,
+						  &t[num_t], max_crossings);
+
+			if (num_crossings > max_crossings) {
+				return false;
+			}
+
+			num_t += num_crossings;
+		}
+	}
+
+	t[num_t++] = 1.f;
+
+	// insertion sort, there are only a few crossings (usually none)
+	for (int i = 2; i < num_t - 1; i++) {
+		for (int k = i; k > 1 && t[k - 1] > t[k]; k--) {
+			const float tmp = t[k];
+			t[k] = t[k - 1];
+			t[k - 1] = tmp;
 		}
+	}
 
-		if (temp_vertex_i.frame != NAV_FRAME_GLOBAL && temp_vertex_i.frame != NAV_FRAME_GLOBAL_INT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-			// TODO: handle different frames
-			PX4_ERR("Frame type %i not supported", (int)temp_vertex_i.frame);
-			break;
+	for (int i = 0; i < num_t - 1; i++) {
+		if (t[i + 1] - t[i] < 1e-6f) {
+			continue;
 		}
 
-		if (((double)temp_vertex_i.lon >= lon) != ((double)temp_vertex_j.lon >= lon) &&
-		    (lat <= (double)(temp_vertex_j.lat - temp_vertex_i.lat) * (lon - (double)temp_vertex_i.lon) /
-		     (double)(temp_vertex_j.lon - temp_vertex_i.lon) + (double)temp_vertex_i.lat)) {
-			c = !c;
+		const float t_mid = 0.5f * (t[i] + t[i + 1]);
+
+		if (!_insidePolygonOrCircleLocal(x_start + t_mid * dx, y_start + t_mid * dy)) {
+			return false;
 		}
 	}
 
-	return c;
+	return true;
 }
 
-bool Geofence::insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude)
+bool Geofence::insidePolygon(const PolygonInfo &polygon, float x, float y) const
 {
+	return polygon.loaded && _polygon_index.insidePolygon(polygon.index_id, x, y);
+}
 
-	mission_fence_point_s circle_point{};
-
-	if (dm_read(DM_KEY_FENCE_POINTS, polygon.dataman_index, &circle_point,
-		    sizeof(mission_fence_point_s)) != sizeof(mission_fence_point_s)) {
-		PX4_ERR("dm_read failed");
-		return false;
-	}
-
-	if (circle_point.frame != NAV_FRAME_GLOBAL && circle_point.frame != NAV_FRAME_GLOBAL_INT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-		// TODO: handle different frames
-		PX4_ERR("Frame type %i not supported", (int)circle_point.frame);
+bool Geofence::insideCircle(const PolygonInfo &polygon, float x, float y) const
+{
+	if (!polygon.loaded) {
 		return false;
 	}
 
-	if (!_projection_reference.isInitialized()) {
-		_projection_reference.initReference(lat, lon);
-	}
-
-	float x1, y1, x2, y2;
-	_projection_reference.project(lat, lon, x1, y1);
-	_projection_reference.project(circle_point.lat, circle_point.lon, x2, y2);
-	float dx = x1 - x2, dy = y1 - y2;
-	return dx * dx + dy * dy < circle_point.circle_radius * circle_point.circle_radius;
+	const float dx = x - polygon.circle_center_x;
+	const float dy = y - polygon.circle_center_y;
+	return dx * dx + dy * dy < polygon.circle_radius * polygon.circle_radius;
 }
 
 bool
@@ -628,4 +850,5 @@ void Geofence::printStatus()
 	PX4_INFO("Geofence: %i inclusion, %i exclusion polygons, %i inclusion, %i exclusion circles, %i total vertices",
 		 num_inclusion_polygons, num_exclusion_polygons, num_inclusion_circles, num_exclusion_circles,
 		 total_num_vertices);
+	PX4_INFO("Geofence: %i polygons cached, %u bytes", _polygon_index.numPolygons(), _polygon_index.memoryUsage());
 }
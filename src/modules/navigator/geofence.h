@@ -53,6 +53,8 @@
 #include <uORB/topics/sensor_gps.h>
 #include <uORB/topics/vehicle_air_data.h>
 
+#include "GeofenceIndex/geofence_index.h"
+
 #define GEOFENCE_FILENAME PX4_STORAGEDIR"/etc/geofence.txt"
 
 class Navigator;
@@ -111,6 +113,36 @@ public:
 
 	virtual bool isInsidePolygonOrCircle(double lat, double lon, float altitude);
 
+	/**
+	 * Check if the straight path between two points is inside the polygons & circles for its whole length.
+	 */
+	virtual bool isSegmentInsidePolygonOrCircle(double lat_start, double lon_start, double lat_end, double lon_end,
+			float altitude);
+
+	/**
+	 * Check a batch of mission items (altitude in AMSL) against the geofence.
+	 * This applies the same checks as check(mission_item), but the fence data is checked for updates only once for
+	 * the whole batch, and the violation counter (GF_COUNT) is not applied as it is meant for position estimates.
+	 *
+	 * @param leg_starts if not null, the legs from leg_starts[i] to items[i] are checked against the polygons & circles
+	 *                   as well (set leg_starts[i] to items[i] for an item without a leg)
+	 * @param leg_violation set to true if the returned item is inside the fence, but the leg to it is not
+	 * @return index of the first item violating the fence, -1 if all items obey the fence
+	 */
+	int checkMissionItems(const mission_item_s *items, const mission_item_s *leg_starts, int num_items,
+			      bool &leg_violation);
+
+	/**
+	 * Reload the fence data if it got changed in dataman.
+	 * @return false if the fence data is currently locked (being written) and could not be checked for updates
+	 */
+	bool updateFenceIfChanged();
+
+	/**
+	 * @return dataman update counter of the fence data in RAM
+	 */
+	uint16_t getUpdateCounter() const { return _update_counter; }
+
 	int clearDm();
 
 	bool valid();
@@ -161,6 +193,10 @@ private:
 			uint16_t vertex_count;
 			float circle_radius;
 		};
+		bool loaded;           ///< vertices/center are cached below (false if they could not be read or the frame is not supported)
+		uint16_t index_id;     ///< polygon id in _polygon_index (polygons only)
+		float circle_center_x; ///< circle center in the local frame of _projection_reference (circles only)
+		float circle_center_y;
 	};
 
 	Navigator   *_navigator{nullptr};
@@ -174,7 +210,11 @@ private:
 
 	int _num_polygons{0};
 
-	MapProjection _projection_reference{}; ///< class to convert (lon, lat) to local [m]
+	static constexpr int MAX_SEGMENT_CROSSINGS = 32; ///< a segment crossing more fence borders is treated as a violation
+
+	MapProjection _projection_reference{}; ///< class to convert (lon, lat) to local [m], reference is the first fence point
+
+	GeofenceIndex _polygon_index; ///< vertices of all polygons in the local frame
 
 	uORB::SubscriptionData<vehicle_air_data_s> _sub_airdata;
 
@@ -186,6 +226,12 @@ private:
 	 */
 	void _updateFence();
 
+	/**
+	 * Read the vertices of all polygons and the circle centers from dataman into RAM (in the local frame)
+	 * and build the polygon index.
+	 */
+	void _loadFenceData();
+
 	/**
 	 * Check if a point passes the Geofence test.
 	 * This takes all polygons and minimum & maximum altitude into account
@@ -198,23 +244,40 @@ private:
 	 */
 	bool checkPolygons(double lat, double lon, float altitude);
 
+	/**
+	 * isInsidePolygonOrCircle() for the fence data in RAM, without checking for updates
+	 */
+	bool _insidePolygonOrCircle(double lat, double lon, float altitude) const;
+
+	/**
+	 * Horizontal part of _insidePolygonOrCircle(), for a point in the local frame
+	 */
+	bool _insidePolygonOrCircleLocal(float x, float y) const;
+
+	/**
+	 * Check if the segment (in the local frame) is inside the polygons & circles for its whole length.
+	 * The inside state can only change where the segment crosses a polygon edge or a circle, so one point between
+	 * each pair of consecutive crossings is checked.
+	 */
+	bool _segmentInsidePolygonOrCircleLocal(float x_start, float y_start, float x_end, float y_end) const;
+
 
 
 	bool checkAll(const vehicle_global_position_s &global_position);
 	bool checkAll(const vehicle_global_position_s &global_position, float baro_altitude_amsl);
 
 	/**
-	 * Check if a single point is within a polygon
+	 * Check if a single point (in the local frame) is within a polygon
 	 * @return true if within polygon
 	 */
-	bool insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insidePolygon(const PolygonInfo &polygon, float x, float y) const;
 
 	/**
-	 * Check if a single point is within a circle
+	 * Check if a single point (in the local frame) is within a circle
 	 * @param polygon must be a circle!
 	 * @return true if within polygon the circle
 	 */
-	bool insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	bool insideCircle(const PolygonInfo &polygon, float x, float y) const;
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::GF_ACTION>)         _param_gf_action,
@@ -1735,14 +1735,16 @@ Mission::check_mission_valid(bool force)
 {
 	if ((!_home_inited && _navigator->home_global_position_valid()) || force) {
 
-		MissionFeasibilityChecker _missionFeasibilityChecker(_navigator);
+		const hrt_abstime check_start = hrt_absolute_time();
 
 		_navigator->get_mission_result()->valid =
-			_missionFeasibilityChecker.checkMissionFeasible(_mission,
+			_feasibility_checker.checkMissionFeasible(_mission,
 					_param_mis_dist_1wp.get(),
 					_param_mis_dist_wps.get(),
 					_navigator->mission_landing_required());
 
+		_navigator->get_mission_result()->feasibility_check_duration = hrt_elapsed_time(&check_start);
+		_navigator->get_mission_result()->feasibility_items_cached = _feasibility_checker.itemsCached();
 		_navigator->get_mission_result()->seq_total = _mission.count;
 		_navigator->increment_mission_instance_count();
 		_navigator->set_mission_result_updated();
@@ -245,6 +245,8 @@ private:
 	uORB::Subscription	_mission_sub{ORB_ID(mission)};		/**< mission subscription */
 	mission_s		_mission {};
 
+	MissionFeasibilityChecker _feasibility_checker{_navigator};	/**< persistent, keeps the results of unchanged items */
+
 	int32_t _current_mission_index{-1};
 
 	// track location of planned mission landing
@@ -45,6 +45,8 @@
 #include "mission_block.h"
 #include "navigator.h"
 
+#include <crc32.h>
+#include <drivers/drv_hrt.h>
 #include <drivers/drv_pwm_output.h>
 #include <lib/geo/geo.h>
 #include <lib/mathlib/mathlib.h>
@@ -52,6 +54,8 @@
 #include <uORB/Subscription.hpp>
 #include <px4_platform_common/events.h>
 
+#include <new>
+
 bool
 MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission,
 		float max_distance_to_1st_waypoint, float max_distance_between_waypoints,
@@ -59,6 +63,10 @@ MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission,
 {
 	// Reset warning flag
 	_navigator->get_mission_result()->warning = false;
+	_items_cached = 0;
+
+	// the items might have changed since the last run
+	_item_chunk_count = 0;
 
 	// trivial case: A mission with length zero cannot be valid
 	if ((int)mission.count <= 0) {
@@ -82,10 +90,25 @@ MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission,
 
 	const float home_alt = _navigator->get_home_position()->alt;
 
+	// results of the per-item checks of previous runs can only be reused if nothing else changed. While the fence
+	// is being written we cannot tell, and the geofence results are not cached
+	const bool geofence_current = _navigator->get_geofence().updateFenceIfChanged();
+	const uint32_t context_hash = contextHash(home_alt, home_valid, home_alt_valid);
+
+	if (context_hash != _context_hash) {
+		_context_hash = context_hash;
+
+		for (size_t i = 0; i < _item_cache_size; i++) {
+			_item_cache[i].passed = 0;
+		}
+	}
+
+	resizeItemCache(mission.count);
+
 	// check if all mission item commands are supported
 	failed = failed || !checkMissionItemValidity(mission);
 	failed = failed || !checkDistancesBetweenWaypoints(mission, max_distance_between_waypoints);
-	failed = failed || !checkGeofence(mission, home_alt, home_valid);
+	failed = failed || !checkGeofence(mission, home_alt, home_valid, geofence_current);
 	failed = failed || !checkHomePositionAltitude(mission, home_alt, home_alt_valid);
 
 	if (_navigator->get_vstatus()->is_vtol) {
@@ -101,6 +124,122 @@ MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission,
 	return !failed;
 }
 
+bool
+MissionFeasibilityChecker::readItem(const mission_s &mission, size_t index, mission_item_s &mission_item)
+{
+	if (index >= mission.count) {
+		return false;
+	}
+
+	if (_item_chunk_count == 0 || _item_chunk_dataman_id != mission.dataman_id
+	    || index < _item_chunk_start || index >= _item_chunk_start + _item_chunk_count) {
+
+		const unsigned num_items = math::min((size_t)ITEM_CHUNK_SIZE, mission.count - index);
+		const ssize_t ret = dm_read_bulk((dm_item_t)mission.dataman_id, index, _item_chunk, sizeof(mission_item_s), num_items);
+
+		if (ret <= 0) {
+			_item_chunk_count = 0;
+			return false;
+		}
+
+		_item_chunk_start = index;
+		_item_chunk_count = ret;
+		_item_chunk_dataman_id = mission.dataman_id;
+	}
+
+	mission_item = _item_chunk[index - _item_chunk_start];
+	return true;
+}
+
+static uint32_t item_hash(const mission_item_s &mission_item)
+{
+	return crc32part((const uint8_t *)&mission_item, sizeof(mission_item_s), 0);
+}
+
+uint32_t
+MissionFeasibilityChecker::contextHash(float home_alt, bool home_valid, bool home_alt_valid)
+{
+	Geofence &geofence = _navigator->get_geofence();
+
+	struct {
+		double home_lat;
+		double home_lon;
+		float home_alt;
+		float geofence_max_hor_dist;
+		float geofence_max_ver_dist;
+		uint16_t geofence_update_counter;
+		bool home_valid;
+		bool home_alt_valid;
+		bool geofence_valid;
+		bool geofence_home_required;
+		bool landed;
+	} context;
+
+	memset(&context, 0, sizeof(context)); // clear the padding
+	context.home_lat = _navigator->get_home_position()->lat;
+	context.home_lon = _navigator->get_home_position()->lon;
+	context.home_alt = home_alt;
+	context.geofence_max_hor_dist = geofence.getMaxHorDistanceHome();
+	context.geofence_max_ver_dist = geofence.getMaxVerDistanceHome();
+	context.geofence_update_counter = geofence.getUpdateCounter();
+	context.home_valid = home_valid;
+	context.home_alt_valid = home_alt_valid;
+	context.geofence_valid = geofence.valid();
+	context.geofence_home_required = geofence.isHomeRequired();
+	context.landed = _navigator->get_land_detected()->landed;
+
+	return crc32part((const uint8_t *)&context, sizeof(context), 0);
+}
+
+void
+MissionFeasibilityChecker::resizeItemCache(size_t count)
+{
+	if (count <= _item_cache_size) {
+		return;
+	}
+
+	ItemCacheEntry *item_cache = new (std::nothrow) ItemCacheEntry[count] {};
+
+	if (item_cache == nullptr) {
+		// keep the current cache, the items beyond it are always checked
+		return;
+	}
+
+	for (size_t i = 0; i < _item_cache_size; i++) {
+		item_cache[i] = _item_cache[i];
+	}
+
+	delete[] _item_cache;
+	_item_cache = item_cache;
+	_item_cache_size = count;
+}
+
+bool
+MissionFeasibilityChecker::itemCheckCached(size_t index, uint32_t hash, ItemCheck check, uint32_t leg_hash) const
+{
+	return index < _item_cache_size && _item_cache[index].hash == hash && (_item_cache[index].passed & check)
+	       && (check != ITEM_CHECK_GEOFENCE || _item_cache[index].leg_hash == leg_hash);
+}
+
+void
+MissionFeasibilityChecker::setItemCheckPassed(size_t index, uint32_t hash, ItemCheck check, uint32_t leg_hash)
+{
+	if (index >= _item_cache_size) {
+		return;
+	}
+
+	if (_item_cache[index].hash != hash) {
+		_item_cache[index].hash = hash;
+		_item_cache[index].passed = 0;
+	}
+
+	if (check == ITEM_CHECK_GEOFENCE) {
+		_item_cache[index].leg_hash = leg_hash;
+	}
+
+	_item_cache[index].passed |= check;
+}
+
 bool
 MissionFeasibilityChecker::checkRotarywing(const mission_s &mission, float home_alt)
 {
@@ -134,7 +273,7 @@ MissionFeasibilityChecker::checkVTOL(const mission_s &mission, float home_alt, b
 }
 
 bool
-MissionFeasibilityChecker::checkGeofence(const mission_s &mission, float home_alt, bool home_valid)
+MissionFeasibilityChecker::checkGeofence(const mission_s &mission, float home_alt, bool home_valid, bool cache_results)
 {
 	if (_navigator->get_geofence().isHomeRequired() && !home_valid) {
 		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence requires valid home position\t");
@@ -143,35 +282,101 @@ MissionFeasibilityChecker::checkGeofence(const mission_s &mission, float home_al
 		return false;
 	}
 
-	/* Check if all mission items are inside the geofence (if we have a valid geofence) */
+	/* Check if all mission items and the legs between them are inside the geofence (if we have a valid geofence) */
 	if (_navigator->get_geofence().valid()) {
+		_geofence_batch_count = 0;
+
+		// previous item with a position, the start of the leg to the next one
+		mission_item_s leg_start{};
+		uint32_t leg_hash = 0;
+
 		for (size_t i = 0; i < mission.count; i++) {
 			struct mission_item_s missionitem = {};
-			const ssize_t len = sizeof(missionitem);
 
-			if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+			if (!readItem(mission, i, missionitem)) {
 				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 				return false;
 			}
 
-			if (missionitem.altitude_is_relative && !home_valid) {
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence requires valid home position\t");
-				events::send(events::ID("navigator_mis_geofence_no_home2"), {events::Log::Error, events::LogInternal::Info},
-					     "Geofence requires a valid home position");
-				return false;
-			}
+			const uint32_t hash = item_hash(missionitem);
+			const bool has_position = MissionBlock::item_contains_position(missionitem);
 
 			// Geofence function checks against home altitude amsl
 			missionitem.altitude = missionitem.altitude_is_relative ? missionitem.altitude + home_alt : missionitem.altitude;
 
-			if (MissionBlock::item_contains_position(missionitem) && !_navigator->get_geofence().check(missionitem)) {
+			if (!itemCheckCached(i, hash, ITEM_CHECK_GEOFENCE, has_position ? leg_hash : 0)) {
+				if (missionitem.altitude_is_relative && !home_valid) {
+					mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence requires valid home position\t");
+					events::send(events::ID("navigator_mis_geofence_no_home2"), {events::Log::Error, events::LogInternal::Info},
+						     "Geofence requires a valid home position");
+					return false;
+				}
 
-				mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence violation for waypoint %zu\t", i + 1);
-				events::send<int16_t>(events::ID("navigator_mis_geofence_violation"), {events::Log::Error, events::LogInternal::Info},
-						      "Geofence violation for waypoint {1}",
-						      i + 1);
-				return false;
+				if (has_position) {
+					_geofence_batch[_geofence_batch_count] = missionitem;
+					_geofence_batch_leg_start[_geofence_batch_count] = (leg_hash != 0) ? leg_start : missionitem;
+					_geofence_batch_index[_geofence_batch_count] = i;
+					_geofence_batch_hash[_geofence_batch_count] = hash;
+					_geofence_batch_leg_hash[_geofence_batch_count] = leg_hash;
+
+					if (++_geofence_batch_count == ITEM_CHUNK_SIZE && !checkGeofenceBatch(cache_results)) {
+						return false;
+					}
+
+				} else if (cache_results) {
+					setItemCheckPassed(i, hash, ITEM_CHECK_GEOFENCE);
+				}
 			}
+
+			if (has_position) {
+				leg_start = missionitem;
+				leg_hash = hash;
+			}
+		}
+
+		return checkGeofenceBatch(cache_results);
+	}
+
+	return true;
+}
+
+bool
+MissionFeasibilityChecker::checkGeofenceBatch(bool cache_results)
+{
+	const unsigned batch_count = _geofence_batch_count;
+	_geofence_batch_count = 0;
+
+	if (batch_count == 0) {
+		return true;
+	}
+
+	bool leg_violation = false;
+	const int violation = _navigator->get_geofence().checkMissionItems(_geofence_batch, _geofence_batch_leg_start,
+			      batch_count, leg_violation);
+
+	if (violation >= 0 && leg_violation) {
+		const size_t i = _geofence_batch_index[violation];
+
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence violation on the way to waypoint %zu\t", i + 1);
+		events::send<int16_t>(events::ID("navigator_mis_geofence_leg_violation"), {events::Log::Error, events::LogInternal::Info},
+				      "Geofence violation on the way to waypoint {1}",
+				      i + 1);
+		return false;
+
+	} else if (violation >= 0) {
+		const size_t i = _geofence_batch_index[violation];
+
+		mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Geofence violation for waypoint %zu\t", i + 1);
+		events::send<int16_t>(events::ID("navigator_mis_geofence_violation"), {events::Log::Error, events::LogInternal::Info},
+				      "Geofence violation for waypoint {1}",
+				      i + 1);
+		return false;
+	}
+
+	if (cache_results) {
+		for (unsigned k = 0; k < batch_count; k++) {
+			setItemCheckPassed(_geofence_batch_index[k], _geofence_batch_hash[k], ITEM_CHECK_GEOFENCE,
+					   _geofence_batch_leg_hash[k]);
 		}
 	}
 
@@ -184,9 +389,8 @@ MissionFeasibilityChecker::checkHomePositionAltitude(const mission_s &mission, f
 	/* Check if all waypoints are above the home altitude */
 	for (size_t i = 0; i < mission.count; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (!readItem(mission, i, missionitem)) {
 			_navigator->get_mission_result()->warning = true;
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
@@ -227,9 +431,8 @@ MissionFeasibilityChecker::checkMissionItemValidity(const mission_s &mission)
 	// do not allow mission if we find unsupported item
 	for (size_t i = 0; i < mission.count; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (!readItem(mission, i, missionitem)) {
 			// not supposed to happen unless the datamanager can't access the SD card, etc.
 			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Cannot access SD card\t");
 			events::send(events::ID("navigator_mis_sd_failure"), events::Log::Error,
@@ -237,6 +440,13 @@ MissionFeasibilityChecker::checkMissionItemValidity(const mission_s &mission)
 			return false;
 		}
 
+		const uint32_t hash = item_hash(missionitem);
+
+		if (itemCheckCached(i, hash, ITEM_CHECK_VALIDITY)) {
+			_items_cached++;
+			continue;
+		}
+
 		// check if we find unsupported items and reject mission if so
 		if (missionitem.nav_cmd != NAV_CMD_IDLE &&
 		    missionitem.nav_cmd != NAV_CMD_WAYPOINT &&
@@ -316,6 +526,8 @@ MissionFeasibilityChecker::checkMissionItemValidity(const mission_s &mission)
 				     "Mission rejected: starts with landing");
 			return false;
 		}
+
+		setItemCheckPassed(i, hash, ITEM_CHECK_VALIDITY);
 	}
 
 	return true;
@@ -330,9 +542,8 @@ MissionFeasibilityChecker::checkTakeoff(const mission_s &mission, float home_alt
 
 	for (size_t i = 0; i < mission.count; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (!readItem(mission, i, missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -385,9 +596,8 @@ MissionFeasibilityChecker::checkTakeoff(const mission_s &mission, float home_alt
 		// one of the bellow mission items
 		for (size_t i = 0; i < (size_t)takeoff_index; i++) {
 			struct mission_item_s missionitem = {};
-			const ssize_t len = sizeof(struct mission_item_s);
 
-			if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+			if (!readItem(mission, i, missionitem)) {
 				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 				return false;
 			}
@@ -463,9 +673,8 @@ MissionFeasibilityChecker::checkFixedWingLanding(const mission_s &mission, bool
 
 	for (size_t i = 0; i < mission.count; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (!readItem(mission, i, missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -503,7 +712,7 @@ MissionFeasibilityChecker::checkFixedWingLanding(const mission_s &mission, bool
 			if (i > 0) {
 				landing_approach_index = i - 1;
 
-				if (dm_read((dm_item_t)mission.dataman_id, landing_approach_index, &missionitem_previous, len) != len) {
+				if (!readItem(mission, landing_approach_index, missionitem_previous)) {
 					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 					return false;
 				}
@@ -652,9 +861,8 @@ MissionFeasibilityChecker::checkVTOLLanding(const mission_s &mission, bool land_
 
 	for (size_t i = 0; i < mission.count; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read((dm_item_t)mission.dataman_id, i, &missionitem, len) != len) {
+		if (!readItem(mission, i, missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -679,7 +887,7 @@ MissionFeasibilityChecker::checkVTOLLanding(const mission_s &mission, bool land_
 			if (i > 0) {
 				landing_approach_index = i - 1;
 
-				if (dm_read((dm_item_t)mission.dataman_id, landing_approach_index, &missionitem_previous, len) != len) {
+				if (!readItem(mission, landing_approach_index, missionitem_previous)) {
 					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 					return false;
 				}
@@ -734,7 +942,7 @@ MissionFeasibilityChecker::checkDistanceToFirstWaypoint(const mission_s &mission
 
 		struct mission_item_s mission_item {};
 
-		if (!(dm_read((dm_item_t)mission.dataman_id, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s))) {
+		if (!readItem(mission, i, mission_item)) {
 			/* error reading, mission is invalid */
 			mavlink_log_info(_navigator->get_mavlink_log_pub(), "Error reading offboard mission.\t");
 			events::send(events::ID("navigator_mis_storage_failure"), events::Log::Error,
@@ -790,7 +998,7 @@ MissionFeasibilityChecker::checkDistancesBetweenWaypoints(const mission_s &missi
 
 		struct mission_item_s mission_item {};
 
-		if (!(dm_read((dm_item_t)mission.dataman_id, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s))) {
+		if (!readItem(mission, i, mission_item)) {
 			/* error reading, mission is invalid */
 			mavlink_log_info(_navigator->get_mavlink_log_pub(), "Error reading offboard mission.\t");
 			events::send(events::ID("navigator_mis_storage_failure2"), events::Log::Error,
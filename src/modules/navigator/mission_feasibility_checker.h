@@ -54,8 +54,53 @@ class MissionFeasibilityChecker: public ModuleParams
 private:
 	Navigator *_navigator{nullptr};
 
+	static constexpr unsigned ITEM_CHUNK_SIZE = 8; ///< number of mission items read from dataman in one request
+
+	/* Mission items are read from dataman in chunks, all checks read them through readItem() */
+	mission_item_s _item_chunk[ITEM_CHUNK_SIZE] {};
+	size_t _item_chunk_start{0};
+	unsigned _item_chunk_count{0};
+	uint8_t _item_chunk_dataman_id{0};
+
+	bool readItem(const mission_s &mission, size_t index, mission_item_s &mission_item);
+
+	/*
+	 * Results of the per-item checks (item validity, geofence) of the previous runs, keyed by a hash of the item.
+	 * They are only valid for the same context (home position, geofence, parameters, landed state), see contextHash().
+	 */
+	enum ItemCheck : uint8_t {
+		ITEM_CHECK_VALIDITY = (1 << 0),
+		ITEM_CHECK_GEOFENCE = (1 << 1)
+	};
+
+	struct ItemCacheEntry {
+		uint32_t hash;
+		uint32_t leg_hash; ///< hash of the previous item with a position, the geofence check includes the leg from it
+		uint8_t passed;    ///< bitmask of ItemCheck
+	};
+
+	ItemCacheEntry *_item_cache{nullptr};
+	size_t _item_cache_size{0};
+	uint32_t _context_hash{0};
+	unsigned _items_cached{0}; ///< number of items of the current run whose checks were taken from the cache
+
+	uint32_t contextHash(float home_alt, bool home_valid, bool home_alt_valid);
+	void resizeItemCache(size_t count);
+	bool itemCheckCached(size_t index, uint32_t hash, ItemCheck check, uint32_t leg_hash = 0) const;
+	void setItemCheckPassed(size_t index, uint32_t hash, ItemCheck check, uint32_t leg_hash = 0);
+
+	/* Items to check against the geofence in one batch, together with the legs leading to them */
+	mission_item_s _geofence_batch[ITEM_CHUNK_SIZE] {};
+	mission_item_s _geofence_batch_leg_start[ITEM_CHUNK_SIZE] {};
+	size_t _geofence_batch_index[ITEM_CHUNK_SIZE] {};
+	uint32_t _geofence_batch_hash[ITEM_CHUNK_SIZE] {};
+	uint32_t _geofence_batch_leg_hash[ITEM_CHUNK_SIZE] {};
+	unsigned _geofence_batch_count{0};
+
+	bool checkGeofenceBatch(bool cache_results);
+
 	/* Checks for all airframes */
-	bool checkGeofence(const mission_s &mission, float home_alt, bool home_valid);
+	bool checkGeofence(const mission_s &mission, float home_alt, bool home_valid, bool cache_results);
 
 	bool checkHomePositionAltitude(const mission_s &mission, float home_alt, bool home_alt_valid);
 
@@ -79,15 +124,22 @@ private:
 
 public:
 	MissionFeasibilityChecker(Navigator *navigator) : ModuleParams(nullptr), _navigator(navigator) {}
-	~MissionFeasibilityChecker() = default;
+	~MissionFeasibilityChecker() { delete[] _item_cache; }
 
 	MissionFeasibilityChecker(const MissionFeasibilityChecker &) = delete;
 	MissionFeasibilityChecker &operator=(const MissionFeasibilityChecker &) = delete;
 
 	/*
-	 * Returns true if mission is feasible and false otherwise
+	 * Returns true if mission is feasible and false otherwise.
+	 * Items that did not change since the previous call (in the same context) are not checked again
+	 * by the per-item checks.
 	 */
 	bool checkMissionFeasible(const mission_s &mission,
 				  float max_distance_to_1st_waypoint, float max_distance_between_waypoints,
 				  bool land_start_req);
+
+	/*
+	 * Returns the number of items whose per-item checks were skipped in the last call to checkMissionFeasible()
+	 */
+	unsigned itemsCached() const { return _items_cached; }
 };
@@ -850,9 +850,15 @@ void Navigator::geofence_breach_check(bool &have_geofence_position_data)
 		gf_violation_type.flags.max_altitude_exceeded = !_geofence.isBelowMaxAltitude(_global_pos.alt +
 				vertical_test_point_distance);
 
-		gf_violation_type.flags.fence_violation = !_geofence.isInsidePolygonOrCircle(fence_violation_test_point(0),
-				fence_violation_test_point(1),
-				_global_pos.alt);
+		if (_geofence.getPredict()) {
+			// check the whole path to the predicted position, a fence area might be crossed on the way
+			gf_violation_type.flags.fence_violation = !_gf_breach_avoidance.isPathToTestPointInsideFence(&_geofence);
+
+		} else {
+			gf_violation_type.flags.fence_violation = !_geofence.isInsidePolygonOrCircle(fence_violation_test_point(0),
+					fence_violation_test_point(1),
+					_global_pos.alt);
+		}
 
 		_last_geofence_check = hrt_absolute_time();
 		have_geofence_position_data = false;
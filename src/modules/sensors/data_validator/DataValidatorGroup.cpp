@@ -47,62 +47,25 @@
 
 DataValidatorGroup::DataValidatorGroup(unsigned siblings)
 {
-
-	DataValidator *next = nullptr;
-	DataValidator *prev = nullptr;
-
-	for (unsigned i = 0; i < siblings; i++) {
-		next = new DataValidator();
-
-		if (i == 0) {
-			_first = next;
-
-		} else {
-			prev->setSibling(next);
-		}
-
-		prev = next;
-	}
-
-	_last = next;
-
-	if (_first) {
-		_timeout_interval_us = _first->get_timeout();
-	}
-}
-
-DataValidatorGroup::~DataValidatorGroup()
-{
-	while (_first) {
-		DataValidator *next = _first->sibling();
-		delete (_first);
-		_first = next;
-	}
+	_num_validators = (siblings < MAX_VALIDATORS) ? siblings : MAX_VALIDATORS;
+	_timeout_interval_us = _validators[0].get_timeout();
 }
 
 DataValidator *DataValidatorGroup::add_new_validator()
 {
-
-	DataValidator *validator = new DataValidator();
-
-	if (!validator) {
+	if (_num_validators >= MAX_VALIDATORS) {
 		return nullptr;
 	}
 
-	_last->setSibling(validator);
-	_last = validator;
-	_last->set_timeout(_timeout_interval_us);
-	return _last;
+	DataValidator *validator = &_validators[_num_validators++];
+	validator->set_timeout(_timeout_interval_us);
+	return validator;
 }
 
 void DataValidatorGroup::set_timeout(uint32_t timeout_interval_us)
 {
-
-	DataValidator *next = _first;
-
-	while (next != nullptr) {
-		next->set_timeout(timeout_interval_us);
-		next = next->sibling();
+	for (unsigned i = 0; i < _num_validators; i++) {
+		_validators[i].set_timeout(timeout_interval_us);
 	}
 
 	_timeout_interval_us = timeout_interval_us;
@@ -110,38 +73,32 @@ void DataValidatorGroup::set_timeout(uint32_t timeout_interval_us)
 
 void DataValidatorGroup::set_equal_value_threshold(uint32_t threshold)
 {
-
-	DataValidator *next = _first;
-
-	while (next != nullptr) {
-		next->set_equal_value_threshold(threshold);
-		next = next->sibling();
+	for (unsigned i = 0; i < _num_validators; i++) {
+		_validators[i].set_equal_value_threshold(threshold);
 	}
 }
 
 void DataValidatorGroup::put(unsigned index, uint64_t timestamp, const float val[3], uint32_t error_count,
 			     uint8_t priority)
 {
+	if (index < _num_validators) {
+		_validators[index].put(timestamp, val, error_count, priority);
+	}
+}
 
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (i == index) {
-			next->put(timestamp, val, error_count, priority);
-			break;
+void DataValidatorGroup::put(uint32_t updated, const uint64_t timestamp[], const float val[][DataValidator::dimensions],
+			     const uint32_t error_count[], const uint8_t priority[])
+{
+	for (unsigned i = 0; i < _num_validators; i++) {
+		if (updated & (1u << i)) {
+			_validators[i].put(timestamp[i], val[i], error_count[i], priority[i]);
 		}
-
-		next = next->sibling();
-		i++;
 	}
 }
 
 float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 {
 
-	DataValidator *next = _first;
-
 	// XXX This should eventually also include voting
 	int pre_check_best = _curr_best;
 	float pre_check_confidence = 1.0f;
@@ -151,9 +108,8 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 	int max_index = -1;
 	DataValidator *best = nullptr;
 
-	int i = 0;
-
-	while (next != nullptr) {
+	for (int i = 0; i < (int)_num_validators; i++) {
+		DataValidator *next = &_validators[i];
 		float confidence = next->confidence(timestamp);
 
 		if (i == pre_check_best) {
@@ -175,9 +131,6 @@ float *DataValidatorGroup::get_best(uint64_t timestamp, int *index)
 			max_priority = next->priority();
 			best = next;
 		}
-
-		next = next->sibling();
-		i++;
 	}
 
 	/* the current best sensor is not matching the previous best sensor,
@@ -228,10 +181,9 @@ void DataValidatorGroup::print()
 	PX4_INFO_RAW("validator: best: %d, prev best: %d, failsafe: %s (%u events)\n", _curr_best, _prev_best,
 		     (_toggle_count > 0) ? "YES" : "NO", _toggle_count);
 
-	DataValidator *next = _first;
-	unsigned i = 0;
+	for (unsigned i = 0; i < _num_validators; i++) {
+		DataValidator *next = &_validators[i];
 
-	while (next != nullptr) {
 		if (next->used()) {
 			uint32_t flags = next->state();
 
@@ -245,25 +197,17 @@ void DataValidatorGroup::print()
 
 			next->print();
 		}
-
-		next = next->sibling();
-		i++;
 	}
 }
 
 int DataValidatorGroup::failover_index()
 {
-	DataValidator *next = _first;
-	unsigned i = 0;
+	if ((_prev_best >= 0) && (_prev_best < (int)_num_validators)) {
+		const DataValidator &prev_best = _validators[_prev_best];
 
-	while (next != nullptr) {
-		if (next->used() && (next->state() != DataValidator::ERROR_FLAG_NO_ERROR) &&
-		    (i == (unsigned)_prev_best)) {
-			return i;
+		if (prev_best.used() && (prev_best.state() != DataValidator::ERROR_FLAG_NO_ERROR)) {
+			return _prev_best;
 		}
-
-		next = next->sibling();
-		i++;
 	}
 
 	return -1;
@@ -271,18 +215,12 @@ int DataValidatorGroup::failover_index()
 
 uint32_t DataValidatorGroup::failover_state()
 {
+	if ((_prev_best >= 0) && (_prev_best < (int)_num_validators)) {
+		const DataValidator &prev_best = _validators[_prev_best];
 
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (next->used() && (next->state() != DataValidator::ERROR_FLAG_NO_ERROR) &&
-		    (i == (unsigned)_prev_best)) {
-			return next->state();
+		if (prev_best.used() && (prev_best.state() != DataValidator::ERROR_FLAG_NO_ERROR)) {
+			return prev_best.state();
 		}
-
-		next = next->sibling();
-		i++;
 	}
 
 	return DataValidator::ERROR_FLAG_NO_ERROR;
@@ -290,16 +228,8 @@ uint32_t DataValidatorGroup::failover_state()
 
 uint32_t DataValidatorGroup::get_sensor_state(unsigned index)
 {
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (i == index) {
-			return next->state();
-		}
-
-		next = next->sibling();
-		i++;
+	if (index < _num_validators) {
+		return _validators[index].state();
 	}
 
 	// sensor index not found
@@ -308,16 +238,8 @@ uint32_t DataValidatorGroup::get_sensor_state(unsigned index)
 
 uint8_t DataValidatorGroup::get_sensor_priority(unsigned index)
 {
-	DataValidator *next = _first;
-	unsigned i = 0;
-
-	while (next != nullptr) {
-		if (i == index) {
-			return next->priority();
-		}
-
-		next = next->sibling();
-		i++;
+	if (index < _num_validators) {
+		return _validators[index].priority();
 	}
 
 	// sensor index not found
@@ -46,15 +46,21 @@
 class DataValidatorGroup
 {
 public:
+#if defined(CONSTRAINED_MEMORY)
+	static constexpr unsigned MAX_VALIDATORS = 4;
+#else
+	static constexpr unsigned MAX_VALIDATORS = 8;
+#endif
+
 	/**
-	 * @param siblings initial number of DataValidator's. Must be > 0.
+	 * @param siblings initial number of DataValidator's. Must be > 0 and <= MAX_VALIDATORS.
 	 */
 	DataValidatorGroup(unsigned siblings);
-	~DataValidatorGroup();
+	~DataValidatorGroup() = default;
 
 	/**
-	 * Create a new Validator (with index equal to the number of currently existing validators)
-	 * @return the newly created DataValidator or nullptr on error
+	 * Add a new Validator (with index equal to the number of currently existing validators)
+	 * @return the newly added DataValidator or nullptr if the group is full
 	 */
 	DataValidator *add_new_validator();
 
@@ -69,6 +75,19 @@ public:
 	 */
 	void put(unsigned index, uint64_t timestamp, const float val[3], uint32_t error_count, uint8_t priority);
 
+	/**
+	 * Put items into several validators of the group at once, e.g. all instances
+	 * received in one cycle. All arrays are indexed by the sensor index.
+	 *
+	 * @param updated	Bitmask of the sensors with new data (bit i for sensor index i)
+	 * @param timestamp	The timestamps of the measurements
+	 * @param val		The 3D vectors
+	 * @param error_count	The current error counts of the sensors
+	 * @param priority	The priorities of the sensors
+	 */
+	void put(uint32_t updated, const uint64_t timestamp[], const float val[][DataValidator::dimensions],
+		 const uint32_t error_count[], const uint8_t priority[]);
+
 	/**
 	 * Get the best data triplet of the group
 	 *
@@ -132,8 +151,8 @@ public:
 	void set_equal_value_threshold(uint32_t threshold);
 
 private:
-	DataValidator *_first{nullptr}; /**< first node in the group */
-	DataValidator *_last{nullptr};  /**< last node in the group */
+	DataValidator _validators[MAX_VALIDATORS]; /**< validators of the group, only the first _num_validators are used */
+	unsigned _num_validators{0};
 
 	uint32_t _timeout_interval_us{0}; /**< currently set timeout */
 
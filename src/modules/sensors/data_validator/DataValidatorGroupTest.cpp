@@ -0,0 +1,239 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file DataValidatorGroupTest.cpp
+ * Checks that the batch put selects the same sensors as putting the instances one by one,
+ * and benchmarks a triple redundant IMU update.
+ */
+
+#include <gtest/gtest.h>
+#include "DataValidatorGroup.hpp"
+
+#include <chrono>
+
+static constexpr int NUM_SENSORS = 3;
+
+static uint64_t timeNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t _lcg_state = 1;
+
+static float noise()
+{
+	_lcg_state = _lcg_state * 1664525u + 1013904223u;
+	return (float)(_lcg_state >> 8) / (float)(1u << 23) - 1.f;
+}
+
+struct Sample {
+	uint32_t updated;
+	uint64_t timestamp[NUM_SENSORS];
+	float value[NUM_SENSORS][DataValidator::dimensions];
+	uint32_t error_count[NUM_SENSORS];
+	uint8_t priority[NUM_SENSORS];
+};
+
+// 1 kHz triple IMU with a dropout, a stuck sensor, rising error counts and a priority change
+static Sample makeSample(int cycle)
+{
+	Sample sample{};
+	static uint32_t error_count[NUM_SENSORS] {};
+
+	for (int i = 0; i < NUM_SENSORS; i++) {
+		const bool dropout = (i == 0) && (cycle > 2000) && (cycle < 2600);
+
+		if (dropout) {
+			continue;
+		}
+
+		sample.updated |= 1u << i;
+		sample.timestamp[i] = 1000 + cycle * 1000;
+
+		for (unsigned axis = 0; axis < DataValidator::dimensions; axis++) {
+			const bool stuck = (i == 1) && (cycle > 4000) && (cycle < 4500);
+			sample.value[i][axis] = stuck ? 0.5f : (0.1f * axis + 0.01f * noise());
+		}
+
+		if ((i == 2) && (cycle > 6000) && (cycle < 6300) && (cycle % 2 == 0)) {
+			error_count[i]++;
+		}
+
+		sample.error_count[i] = error_count[i];
+		sample.priority[i] = ((i == 1) && (cycle > 8000)) ? 100 : 75;
+	}
+
+	return sample;
+}
+
+TEST(DataValidatorGroupTest, BatchPutMatchesSinglePut)
+{
+	DataValidatorGroup single{1};
+	DataValidatorGroup batch{1};
+
+	for (int i = 1; i < NUM_SENSORS; i++) {
+		ASSERT_NE(single.add_new_validator(), nullptr);
+		ASSERT_NE(batch.add_new_validator(), nullptr);
+	}
+
+	single.set_timeout(20000);
+	batch.set_timeout(20000);
+
+	int switches = 0;
+	int last_best = -1;
+
+	for (int cycle = 0; cycle < 10000; cycle++) {
+		const Sample sample = makeSample(cycle);
+
+		for (int i = 0; i < NUM_SENSORS; i++) {
+			if (sample.updated & (1u << i)) {
+				single.put(i, sample.timestamp[i], sample.value[i], sample.error_count[i], sample.priority[i]);
+			}
+		}
+
+		batch.put(sample.updated, sample.timestamp, sample.value, sample.error_count, sample.priority);
+
+		const uint64_t now = 1000 + cycle * 1000 + 500;
+		int single_index = -1;
+		int batch_index = -1;
+		const float *single_best = single.get_best(now, &single_index);
+		const float *batch_best = batch.get_best(now, &batch_index);
+
+		ASSERT_EQ(single_index, batch_index) << "cycle " << cycle;
+		ASSERT_EQ(single.failover_count(), batch.failover_count()) << "cycle " << cycle;
+		ASSERT_EQ(single.failover_index(), batch.failover_index()) << "cycle " << cycle;
+		ASSERT_EQ(single.failover_state(), batch.failover_state()) << "cycle " << cycle;
+
+		if (single_best) {
+			ASSERT_NE(batch_best, nullptr);
+
+			for (unsigned axis = 0; axis < DataValidator::dimensions; axis++) {
+				EXPECT_EQ(single_best[axis], batch_best[axis]);
+			}
+		}
+
+		for (int i = 0; i < NUM_SENSORS; i++) {
+			EXPECT_EQ(single.get_sensor_state(i), batch.get_sensor_state(i));
+			EXPECT_EQ(single.get_sensor_priority(i), batch.get_sensor_priority(i));
+		}
+
+		if (batch_index != last_best) {
+			switches++;
+			last_best = batch_index;
+		}
+	}
+
+	// the scenario moves the selection away from sensor 0 and 1 and to 1 on the priority change
+	EXPECT_GE(switches, 3);
+	EXPECT_GE(batch.failover_count(), 1u);
+}
+
+TEST(DataValidatorGroupTest, Capacity)
+{
+	DataValidatorGroup group{1};
+
+	for (unsigned i = 1; i < DataValidatorGroup::MAX_VALIDATORS; i++) {
+		EXPECT_NE(group.add_new_validator(), nullptr);
+	}
+
+	EXPECT_EQ(group.add_new_validator(), nullptr);
+
+	// out of range indices are ignored
+	const float value[DataValidator::dimensions] {1.f, 2.f, 3.f};
+	group.put(DataValidatorGroup::MAX_VALIDATORS, 1000, value, 0, 100);
+	EXPECT_EQ(group.get_sensor_state(DataValidatorGroup::MAX_VALIDATORS), UINT32_MAX);
+	EXPECT_EQ(group.get_sensor_priority(DataValidatorGroup::MAX_VALIDATORS), 0);
+
+	group.put(DataValidatorGroup::MAX_VALIDATORS - 1, 1000, value, 0, 100);
+	int best_index = -1;
+	const float *best = group.get_best(1000, &best_index);
+	ASSERT_NE(best, nullptr);
+	EXPECT_EQ(best_index, (int)DataValidatorGroup::MAX_VALIDATORS - 1);
+	EXPECT_EQ(best[2], 3.f);
+}
+
+TEST(DataValidatorGroupTest, Benchmark)
+{
+	static constexpr int cycles = 100000;
+
+	DataValidatorGroup single{NUM_SENSORS};
+	DataValidatorGroup batch{NUM_SENSORS};
+
+	const Sample sample = makeSample(0);
+	float value[NUM_SENSORS][DataValidator::dimensions];
+	uint64_t timestamp[NUM_SENSORS] {};
+	int index = -1;
+
+	const uint64_t start_single = timeNs();
+
+	for (int cycle = 0; cycle < cycles; cycle++) {
+		for (int i = 0; i < NUM_SENSORS; i++) {
+			for (unsigned axis = 0; axis < DataValidator::dimensions; axis++) {
+				value[i][axis] = sample.value[i][axis] + 1e-3f * (cycle & 0xff);
+			}
+
+			single.put(i, sample.timestamp[i] + cycle, value[i], sample.error_count[i], sample.priority[i]);
+		}
+
+		single.get_best(sample.timestamp[0] + cycle, &index);
+	}
+
+	const uint64_t elapsed_single = timeNs() - start_single;
+
+	EXPECT_EQ(index, 0);
+
+	const uint64_t start_batch = timeNs();
+
+	for (int cycle = 0; cycle < cycles; cycle++) {
+		for (int i = 0; i < NUM_SENSORS; i++) {
+			for (unsigned axis = 0; axis < DataValidator::dimensions; axis++) {
+				value[i][axis] = sample.value[i][axis] + 1e-3f * (cycle & 0xff);
+			}
+
+			timestamp[i] = sample.timestamp[i] + cycle;
+		}
+
+		batch.put(sample.updated, timestamp, value, sample.error_count, sample.priority);
+		batch.get_best(timestamp[0], &index);
+	}
+
+	const uint64_t elapsed_batch = timeNs() - start_batch;
+
+	EXPECT_EQ(index, 0);
+
+	printf("%d sensors put + get_best: %.1f ns single, %.1f ns batch per cycle\n", NUM_SENSORS,
+	       (double)elapsed_single / cycles, (double)elapsed_batch / cycles);
+}
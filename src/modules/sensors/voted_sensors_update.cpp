@@ -140,6 +140,16 @@ void VotedSensorsUpdate::imuPoll(struct sensor_combined_s &raw)
 {
 	const hrt_abstime time_now_us = hrt_absolute_time();
 
+	// new samples of all instances, passed to the voters together
+	uint32_t updated = 0;
+	uint64_t timestamp[MAX_SENSOR_COUNT] {};
+	uint32_t accel_error_count[MAX_SENSOR_COUNT] {};
+	uint32_t gyro_error_count[MAX_SENSOR_COUNT] {};
+	uint8_t accel_priority[MAX_SENSOR_COUNT] {};
+	uint8_t gyro_priority[MAX_SENSOR_COUNT] {};
+	float accel_value[MAX_SENSOR_COUNT][DataValidator::dimensions] {};
+	float gyro_value[MAX_SENSOR_COUNT][DataValidator::dimensions] {};
+
 	for (int uorb_index = 0; uorb_index < MAX_SENSOR_COUNT; uorb_index++) {
 		vehicle_imu_s imu_report;
 
@@ -178,14 +188,22 @@ void VotedSensorsUpdate::imuPoll(struct sensor_combined_s &raw)
 
 			_last_accel_timestamp[uorb_index] = imu_report.timestamp_sample;
 
-			_accel.voter.put(uorb_index, imu_report.timestamp, _last_sensor_data[uorb_index].accelerometer_m_s2,
-					 imu_status.accel_error_count, _accel.priority[uorb_index]);
-
-			_gyro.voter.put(uorb_index, imu_report.timestamp, _last_sensor_data[uorb_index].gyro_rad,
-					imu_status.gyro_error_count, _gyro.priority[uorb_index]);
+			updated |= (1u << uorb_index);
+			timestamp[uorb_index] = imu_report.timestamp;
+			accel_error_count[uorb_index] = imu_status.accel_error_count;
+			gyro_error_count[uorb_index] = imu_status.gyro_error_count;
+			accel_priority[uorb_index] = _accel.priority[uorb_index];
+			gyro_priority[uorb_index] = _gyro.priority[uorb_index];
+			accel_data.copyTo(accel_value[uorb_index]);
+			gyro_rate.copyTo(gyro_value[uorb_index]);
 		}
 	}
 
+	if (updated != 0) {
+		_accel.voter.put(updated, timestamp, accel_value, accel_error_count, accel_priority);
+		_gyro.voter.put(updated, timestamp, gyro_value, gyro_error_count, gyro_priority);
+	}
+
 	// find the best sensor
 	int accel_best_index = _accel.last_best_vote;
 	int gyro_best_index = _gyro.last_best_vote;
@@ -52,6 +52,7 @@
 #include <netinet/tcp.h>
 #include <poll.h>
 #include <pthread.h>
+#include <stdlib.h>
 #include <sys/socket.h>
 #include <termios.h>
 #include <arpa/inet.h>
@@ -71,6 +72,7 @@ using namespace time_literals;
 static px4_task_t g_sim_task = -1;
 
 SimulatorMavlink *SimulatorMavlink::_instance = nullptr;
+unsigned SimulatorMavlink::_shm_port = 0;
 
 static constexpr vehicle_odometry_s vehicle_odometry_empty {
 	.timestamp = 0,
@@ -259,12 +261,20 @@ void SimulatorMavlink::send_controls()
 		mavlink_hil_actuator_controls_t hil_act_control;
 		actuator_controls_from_outputs(&hil_act_control);
 
-		mavlink_message_t message{};
-		mavlink_msg_hil_actuator_controls_encode(_param_mav_sys_id.get(), _param_mav_comp_id.get(), &message, &hil_act_control);
-
 		PX4_DEBUG("sending controls t=%ld (%ld)", _actuator_outputs.timestamp, hil_act_control.time_usec);
 
-		send_mavlink_message(message);
+		if (_shm != nullptr) {
+			// raw struct, no MAVLink packing
+			simulator_mavlink_shm::Frame frame;
+			frame.type = simulator_mavlink_shm::FrameType::HilActuatorControls;
+			frame.hil_actuator_controls = hil_act_control;
+			send_shm_frame(frame);
+
+		} else {
+			mavlink_message_t message{};
+			mavlink_msg_hil_actuator_controls_encode(_param_mav_sys_id.get(), _param_mav_comp_id.get(), &message, &hil_act_control);
+			send_mavlink_message(message);
+		}
 
 		send_esc_telemetry(hil_act_control);
 	}
@@ -477,7 +487,11 @@ void SimulatorMavlink::handle_message_hil_gps(const mavlink_message_t *msg)
 {
 	mavlink_hil_gps_t hil_gps;
 	mavlink_msg_hil_gps_decode(msg, &hil_gps);
+	handle_hil_gps(hil_gps);
+}
 
+void SimulatorMavlink::handle_hil_gps(const mavlink_hil_gps_t &hil_gps)
+{
 	if (!_gps_blocked) {
 		sensor_gps_s gps{};
 
@@ -544,14 +558,18 @@ void SimulatorMavlink::handle_message_hil_gps(const mavlink_message_t *msg)
 }
 
 void SimulatorMavlink::handle_message_hil_sensor(const mavlink_message_t *msg)
+{
+	mavlink_hil_sensor_t imu;
+	mavlink_msg_hil_sensor_decode(msg, &imu);
+	handle_hil_sensor(imu);
+}
+
+void SimulatorMavlink::handle_hil_sensor(const mavlink_hil_sensor_t &imu)
 {
 	if (_lockstep_component == -1) {
 		_lockstep_component = px4_lockstep_register_component();
 	}
 
-	mavlink_hil_sensor_t imu;
-	mavlink_msg_hil_sensor_decode(msg, &imu);
-
 	struct timespec ts;
 	abstime_to_ts(&ts, imu.time_usec);
 	px4_clock_settime(CLOCK_MONOTONIC, &ts);
@@ -1030,6 +1048,14 @@ void SimulatorMavlink::handle_message_vision_position_estimate(const mavlink_mes
 
 void SimulatorMavlink::send_mavlink_message(const mavlink_message_t &aMsg)
 {
+	if (_shm != nullptr) {
+		simulator_mavlink_shm::Frame frame;
+		frame.type = simulator_mavlink_shm::FrameType::Message;
+		frame.message = aMsg;
+		send_shm_frame(frame);
+		return;
+	}
+
 	uint8_t  buf[MAVLINK_MAX_PACKET_LEN];
 	uint16_t bufLen = 0;
 
@@ -1049,6 +1075,19 @@ void SimulatorMavlink::send_mavlink_message(const mavlink_message_t &aMsg)
 	}
 }
 
+void SimulatorMavlink::send_shm_frame(const simulator_mavlink_shm::Frame &frame)
+{
+	// the sender thread is the only regular writer, the lock guards against any other caller
+	pthread_mutex_lock(&_shm_send_mutex);
+
+	if (!_shm->from_px4.push(frame)) {
+		// the simulator is not reading, drop the frame like a full socket buffer would
+		perf_count(_perf_shm_full);
+	}
+
+	pthread_mutex_unlock(&_shm_send_mutex);
+}
+
 void *SimulatorMavlink::sending_trampoline(void * /*unused*/)
 {
 	_instance->send();
@@ -1143,6 +1182,11 @@ void SimulatorMavlink::run()
 	pthread_setname_np(pthread_self(), "sim_rcv");
 #endif
 
+	if (_param_sim_mav_transp.get() == 1) {
+		run_shm();
+		return;
+	}
+
 	struct sockaddr_in _myaddr {};
 	_myaddr.sin_family = AF_INET;
 	_myaddr.sin_addr.s_addr = htonl(INADDR_ANY);
@@ -1226,29 +1270,13 @@ void SimulatorMavlink::run()
 
 	}
 
-	// Create a thread for sending data to the simulator.
-	pthread_t sender_thread;
-
-	pthread_attr_t sender_thread_attr;
-	pthread_attr_init(&sender_thread_attr);
-	pthread_attr_setstacksize(&sender_thread_attr, PX4_STACK_ADJUSTED(8000));
-
-	struct sched_param param;
-	(void)pthread_attr_getschedparam(&sender_thread_attr, &param);
-
-	// sender thread should run immediately after new outputs are available
-	//  to send the lockstep update to the simulation
-	param.sched_priority = SCHED_PRIORITY_ACTUATOR_OUTPUTS + 1;
-	(void)pthread_attr_setschedparam(&sender_thread_attr, &param);
-
 	struct pollfd fds[2] = {};
 	unsigned fd_count = 1;
 	fds[0].fd = _fd;
 	fds[0].events = POLLIN;
 
 	// got data from simulator, now activate the sending thread
-	pthread_create(&sender_thread, &sender_thread_attr, SimulatorMavlink::sending_trampoline, nullptr);
-	pthread_attr_destroy(&sender_thread_attr);
+	start_sender_thread();
 
 	mavlink_status_t mavlink_status = {};
 
@@ -1288,6 +1316,98 @@ void SimulatorMavlink::run()
 	}
 }
 
+void SimulatorMavlink::run_shm()
+{
+	_shm = simulator_mavlink_shm::create(_port);
+
+	if (_shm == nullptr) {
+		PX4_ERR("Creating shared memory for port %u failed: %s", _port, strerror(errno));
+		return;
+	}
+
+	// remove the segment on shutdown, otherwise every run leaves one behind in /dev/shm
+	static bool unlink_registered = false;
+
+	if (!unlink_registered) {
+		atexit(&SimulatorMavlink::unlink_shm);
+		unlink_registered = true;
+	}
+
+	_shm_port = _port;
+
+	PX4_INFO("Waiting for simulator to connect on shared memory (port %u)", _port);
+
+	// Once we receive something, we're most probably good and can carry on.
+	while (!_shm->to_px4.wait(100_ms)) {}
+
+	PX4_INFO("Simulator connected on shared memory (port %u).", _port);
+
+	// Request HIL_STATE_QUATERNION for ground truth, before the sender thread becomes the writer of from_px4.
+	request_hil_state_quaternion();
+
+	start_sender_thread();
+
+	// the receive loop below never sends
+	simulator_mavlink_shm::Frame frame;
+
+	while (true) {
+
+		// wait in wall time, the simulator drives the lockstep clock
+		if (!_shm->to_px4.wait(1_s)) {
+			PX4_ERR("shared memory timeout");
+			continue;
+		}
+
+		while (_shm->to_px4.pop(frame)) {
+			switch (frame.type) {
+			case simulator_mavlink_shm::FrameType::HilSensor:
+				handle_hil_sensor(frame.hil_sensor);
+				break;
+
+			case simulator_mavlink_shm::FrameType::HilGps:
+				handle_hil_gps(frame.hil_gps);
+				break;
+
+			case simulator_mavlink_shm::FrameType::Message:
+				handle_message(&frame.message);
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+}
+
+void SimulatorMavlink::unlink_shm()
+{
+	if (_shm_port != 0) {
+		simulator_mavlink_shm::unlink(_shm_port);
+		_shm_port = 0;
+	}
+}
+
+void SimulatorMavlink::start_sender_thread()
+{
+	// Create a thread for sending data to the simulator.
+	pthread_t sender_thread;
+
+	pthread_attr_t sender_thread_attr;
+	pthread_attr_init(&sender_thread_attr);
+	pthread_attr_setstacksize(&sender_thread_attr, PX4_STACK_ADJUSTED(8000));
+
+	struct sched_param param;
+	(void)pthread_attr_getschedparam(&sender_thread_attr, &param);
+
+	// sender thread should run immediately after new outputs are available
+	//  to send the lockstep update to the simulation
+	param.sched_priority = SCHED_PRIORITY_ACTUATOR_OUTPUTS + 1;
+	(void)pthread_attr_setschedparam(&sender_thread_attr, &param);
+
+	pthread_create(&sender_thread, &sender_thread_attr, SimulatorMavlink::sending_trampoline, nullptr);
+	pthread_attr_destroy(&sender_thread_attr);
+}
+
 void SimulatorMavlink::check_failure_injections()
 {
 	vehicle_command_s vehicle_command;
@@ -1623,6 +1743,7 @@ static void usage()
 	PX4_INFO("Connect using TCP: simulator_mavlink start -c tcp_port");
 	PX4_INFO("Connect to a remote server using TCP: simulator_mavlink start -t ip_addr tcp_port");
 	PX4_INFO("Connect to a remote server via hostname using TCP: simulator_mavlink start -h hostname tcp_port");
+	PX4_INFO("With SIM_MAV_TRANSP set to 1 the port only names the shared memory segment for a local simulator");
 }
 
 __BEGIN_DECLS
@@ -1667,6 +1788,7 @@ int simulator_mavlink_main(int argc, char *argv[])
 		} else {
 			px4_task_delete(g_sim_task);
 			g_sim_task = -1;
+			SimulatorMavlink::unlink_shm();
 		}
 
 	} else if (argc == 2 && strcmp(argv[1], "status") == 0) {
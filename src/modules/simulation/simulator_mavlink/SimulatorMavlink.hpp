@@ -42,6 +42,8 @@
 
 #pragma once
 
+#include "SimulatorMavlinkShm.hpp"
+
 #include <drivers/drv_hrt.h>
 #include <lib/drivers/accelerometer/PX4Accelerometer.hpp>
 #include <lib/drivers/gyroscope/PX4Gyroscope.hpp>
@@ -125,6 +127,11 @@ public:
 
 	static int start(int argc, char *argv[]);
 
+	/**
+	 * Remove the shared memory segment (SIM_MAV_TRANSP 1), called on stop and on exit.
+	 */
+	static void unlink_shm();
+
 	void set_ip(InternetProtocol ip) { _ip = ip; }
 	void set_port(unsigned port) { _port = port; }
 	void set_hostname(const char *hostname) { _hostname = hostname; }
@@ -142,6 +149,13 @@ private:
 		// free perf counters
 		perf_free(_perf_sim_delay);
 		perf_free(_perf_sim_interval);
+		perf_free(_perf_shm_full);
+
+		if (_shm != nullptr) {
+			simulator_mavlink_shm::unmap(_shm);
+		}
+
+		pthread_mutex_destroy(&_shm_send_mutex);
 
 		for (size_t i = 0; i < sizeof(_dist_pubs) / sizeof(_dist_pubs[0]); i++) {
 			delete _dist_pubs[i];
@@ -163,6 +177,8 @@ private:
 
 	static SimulatorMavlink *_instance;
 
+	static unsigned _shm_port;	///< port of the shared memory segment to remove, 0 if none
+
 	// simulated sensor instances
 	static constexpr uint8_t ACCEL_COUNT_MAX = 3;
 	PX4Accelerometer _px4_accel[ACCEL_COUNT_MAX] {
@@ -187,6 +203,7 @@ private:
 
 	perf_counter_t _perf_sim_delay{perf_alloc(PC_ELAPSED, MODULE_NAME": network delay")};
 	perf_counter_t _perf_sim_interval{perf_alloc(PC_INTERVAL, MODULE_NAME": network interval")};
+	perf_counter_t _perf_shm_full{perf_alloc(PC_COUNT, MODULE_NAME": shm ring full")};
 
 	// uORB publisher handlers
 	uORB::Publication<differential_pressure_s>	_differential_pressure_pub{ORB_ID(differential_pressure)};
@@ -211,12 +228,17 @@ private:
 
 	char *_tcp_remote_ipaddr{nullptr};
 
+	simulator_mavlink_shm::Layout *_shm{nullptr};	///< shared memory transport, nullptr when using sockets
+	pthread_mutex_t _shm_send_mutex{PTHREAD_MUTEX_INITIALIZER};	///< the from_px4 ring allows a single writer only
+
 	double _realtime_factor{1.0};		///< How fast the simulation runs in comparison to real system time
 
 	hrt_abstime _last_sim_timestamp{0};
 	hrt_abstime _last_sitl_timestamp{0};
 
 	void run();
+	void run_shm();
+	void start_sender_thread();
 
 	void handle_message(const mavlink_message_t *msg);
 	void handle_message_distance_sensor(const mavlink_message_t *msg);
@@ -229,6 +251,9 @@ private:
 	void handle_message_rc_channels(const mavlink_message_t *msg);
 	void handle_message_vision_position_estimate(const mavlink_message_t *msg);
 
+	void handle_hil_gps(const mavlink_hil_gps_t &hil_gps);
+	void handle_hil_sensor(const mavlink_hil_sensor_t &imu);
+
 	void parameters_update(bool force);
 	void poll_for_MAVLink_messages();
 	void request_hil_state_quaternion();
@@ -237,6 +262,7 @@ private:
 	void send_heartbeat();
 	void send_esc_telemetry(mavlink_hil_actuator_controls_t hil_act_control);
 	void send_mavlink_message(const mavlink_message_t &aMsg);
+	void send_shm_frame(const simulator_mavlink_shm::Frame &frame);
 	void update_sensors(const hrt_abstime &time, const mavlink_hil_sensor_t &sensors);
 
 	static void *sending_trampoline(void *);
@@ -312,6 +338,7 @@ private:
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::MAV_TYPE>) _param_mav_type,
 		(ParamInt<px4::params::MAV_SYS_ID>) _param_mav_sys_id,
-		(ParamInt<px4::params::MAV_COMP_ID>) _param_mav_comp_id
+		(ParamInt<px4::params::MAV_COMP_ID>) _param_mav_comp_id,
+		(ParamInt<px4::params::SIM_MAV_TRANSP>) _param_sim_mav_transp
 	)
 };
@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file SimulatorMavlinkShm.hpp
+ * Shared memory transport between simulator_mavlink and a simulator running on the
+ * same host, used instead of the TCP/UDP socket when SIM_MAV_TRANSP is set to 1.
+ *
+ * PX4 creates the segment, the simulator opens it. Each direction is a single producer,
+ * single consumer ring of frames. HIL_SENSOR, HIL_GPS and HIL_ACTUATOR_CONTROLS are
+ * exchanged as raw MAVLink structs without packing and parsing, any other message is
+ * passed as a complete mavlink_message_t. An empty ring is waited on with a futex on
+ * Linux, other platforms poll.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <mavlink.h>
+
+namespace simulator_mavlink_shm
+{
+
+static constexpr uint32_t MAGIC = 0x314d5353; // "SSM1"
+static constexpr uint32_t RING_SIZE = 64; // frames, power of two
+
+enum class FrameType : uint32_t {
+	Message = 0,            ///< any other message, fully decoded
+	HilSensor,
+	HilGps,
+	HilActuatorControls
+};
+
+struct Frame {
+	FrameType type;
+
+	union {
+		mavlink_message_t message;
+		mavlink_hil_sensor_t hil_sensor;
+		mavlink_hil_gps_t hil_gps;
+		mavlink_hil_actuator_controls_t hil_actuator_controls;
+	};
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain uint32_t");
+
+class Ring
+{
+public:
+	/**
+	 * Append a frame, to be called by the producer only.
+	 * @return false if the ring is full
+	 */
+	bool push(const Frame &frame)
+	{
+		const uint32_t head = _head.load(std::memory_order_relaxed);
+
+		if (head - _tail.load(std::memory_order_acquire) >= RING_SIZE) {
+			return false;
+		}
+
+		_frames[head & (RING_SIZE - 1)] = frame;
+		_head.store(head + 1, std::memory_order_seq_cst);
+
+		// the consumer sets _waiting before checking _head a last time, so either it sees
+		// the new frame or we see it waiting
+		if (_waiting.load(std::memory_order_seq_cst) != 0) {
+			_waiting.store(0, std::memory_order_relaxed);
+			wake();
+		}
+
+		return true;
+	}
+
+	/**
+	 * Take the oldest frame, to be called by the consumer only.
+	 * @return false if the ring is empty
+	 */
+	bool pop(Frame &frame)
+	{
+		const uint32_t tail = _tail.load(std::memory_order_relaxed);
+
+		if (_head.load(std::memory_order_acquire) == tail) {
+			return false;
+		}
+
+		frame = _frames[tail & (RING_SIZE - 1)];
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Block the consumer until the ring is not empty, in wall time.
+	 * @return false on timeout
+	 */
+	bool wait(uint32_t timeout_us)
+	{
+		const uint32_t tail = _tail.load(std::memory_order_relaxed);
+
+		if (_head.load(std::memory_order_acquire) != tail) {
+			return true;
+		}
+
+		_waiting.store(1, std::memory_order_seq_cst);
+		const uint32_t head = _head.load(std::memory_order_seq_cst);
+
+		if (head == tail) {
+#if defined(__linux__)
+			timespec ts{(time_t)(timeout_us / 1000000), (long)(timeout_us % 1000000) * 1000};
+			syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_head), FUTEX_WAIT, head, &ts, nullptr, 0);
+#else
+			timespec ts{0, (long)(timeout_us < 100 ? timeout_us : 100) * 1000};
+			nanosleep(&ts, nullptr);
+#endif
+		}
+
+		_waiting.store(0, std::memory_order_relaxed);
+
+		return _head.load(std::memory_order_acquire) != tail;
+	}
+
+private:
+	void wake()
+	{
+#if defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_head), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+	}
+
+	// producer and consumer indices on separate cache lines
+	alignas(64) std::atomic<uint32_t> _head;
+	std::atomic<uint32_t> _waiting;
+	alignas(64) std::atomic<uint32_t> _tail;
+	alignas(64) Frame _frames[RING_SIZE];
+};
+
+struct Layout {
+	uint32_t magic;
+	Ring to_px4;                            ///< simulator -> PX4 (sensors)
+	Ring from_px4;                          ///< PX4 -> simulator (actuator controls)
+};
+
+/**
+ * Name of the segment of a simulator port, so that multiple instances can run side by side.
+ */
+static inline void name(char *buf, size_t len, unsigned port)
+{
+	snprintf(buf, len, "/px4_sim_mavlink_%u", port);
+}
+
+/**
+ * Create (or replace) the shared memory, to be called by PX4.
+ * @return mapped layout or nullptr on error
+ */
+static inline Layout *create(unsigned port)
+{
+	char shm_name[32];
+	name(shm_name, sizeof(shm_name), port);
+
+	shm_unlink(shm_name);
+	int fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0666);
+
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	if (ftruncate(fd, sizeof(Layout)) != 0) {
+		close(fd);
+		shm_unlink(shm_name);
+		return nullptr;
+	}
+
+	void *ptr = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (ptr == MAP_FAILED) {
+		shm_unlink(shm_name);
+		return nullptr;
+	}
+
+	// the new pages are zero filled, which is the empty state of both rings
+	Layout *layout = static_cast<Layout *>(ptr);
+	std::atomic_thread_fence(std::memory_order_release);
+	layout->magic = MAGIC;
+
+	return layout;
+}
+
+/**
+ * Open the shared memory created by PX4, to be called by the simulator.
+ * @return mapped layout or nullptr if PX4 is not running
+ */
+static inline Layout *open(unsigned port)
+{
+	char shm_name[32];
+	name(shm_name, sizeof(shm_name), port);
+
+	int fd = shm_open(shm_name, O_RDWR, 0);
+
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	void *ptr = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (ptr == MAP_FAILED) {
+		return nullptr;
+	}
+
+	Layout *layout = static_cast<Layout *>(ptr);
+
+	if (layout->magic != MAGIC) {
+		munmap(ptr, sizeof(Layout));
+		return nullptr;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return layout;
+}
+
+static inline void unmap(Layout *layout)
+{
+	munmap(layout, sizeof(Layout));
+}
+
+/**
+ * Remove the segment of a port, to be called by PX4 on exit. Existing mappings stay valid until unmapped.
+ */
+static inline void unlink(unsigned port)
+{
+	char shm_name[32];
+	name(shm_name, sizeof(shm_name), port);
+
+	shm_unlink(shm_name);
+}
+
+} // namespace simulator_mavlink_shm
@@ -0,0 +1,358 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file simulator_standin.cpp
+ * Stand-in simulator (px4_sim_mavlink_standin)
+ *
+ * Minimal local simulator to benchmark the lockstep tick rate of simulator_mavlink
+ * independently of any physics engine. It sends a constant HIL_SENSOR every step
+ * (and HIL_GPS at 10 Hz) and, once PX4 replied for the first time, waits for the
+ * HIL_ACTUATOR_CONTROLS of each step before advancing the time, as Gazebo does
+ * in lockstep. Both transports are supported: the shared memory of SIM_MAV_TRANSP 1
+ * (see SimulatorMavlinkShm.hpp) and MAVLink over UDP (simulator_mavlink start -u).
+ */
+
+#include "SimulatorMavlinkShm.hpp"
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+static volatile sig_atomic_t should_exit = 0;
+
+static void signal_handler(int)
+{
+	should_exit = 1;
+}
+
+// Get current timestamp in microseconds
+static uint64_t micros()
+{
+	struct timeval t;
+	gettimeofday(&t, nullptr);
+	return t.tv_sec * ((uint64_t)1000000) + t.tv_usec;
+}
+
+static void usage(const char *name)
+{
+	printf("Stand-in simulator to benchmark the simulator_mavlink lockstep tick rate\n\n");
+	printf("usage: %s [-t shm|udp] [-p <port>] [-i <interval>] [-d <duration>]\n", name);
+	printf("  -t shm|udp       transport, shm requires SIM_MAV_TRANSP 1 (default shm)\n");
+	printf("  -p <port>        port given to simulator_mavlink start (default 4560)\n");
+	printf("  -i <interval>    simulation time step in us (default 4000)\n");
+	printf("  -d <duration>    benchmark duration in s of wall time, 0 to run until interrupted (default 10)\n");
+}
+
+static mavlink_hil_sensor_t hil_sensor(uint64_t time_us)
+{
+	mavlink_hil_sensor_t imu{};
+	imu.time_usec = time_us;
+	imu.zacc = -9.81f;
+	imu.xmag = 0.21f;
+	imu.zmag = 0.42f;
+	imu.abs_pressure = 1013.25f;
+	imu.pressure_alt = 0.f;
+	imu.temperature = 20.f;
+	imu.fields_updated = 0x1fff; // accel, gyro, mag, baro and diff pressure
+	return imu;
+}
+
+static mavlink_hil_gps_t hil_gps(uint64_t time_us)
+{
+	mavlink_hil_gps_t gps{};
+	gps.time_usec = time_us;
+	gps.fix_type = 3;
+	gps.lat = 473977420;
+	gps.lon = 85455940;
+	gps.alt = 488000;
+	gps.eph = 100;
+	gps.epv = 100;
+	gps.cog = UINT16_MAX;
+	gps.satellites_visible = 10;
+	return gps;
+}
+
+/**
+ * Transport of the stand-in. step() sends the sensors of one step, wait_actuators()
+ * returns once the HIL_ACTUATOR_CONTROLS of that step arrived.
+ */
+class Transport
+{
+public:
+	virtual ~Transport() = default;
+	virtual void step(uint64_t time_us, bool gps) = 0;
+	virtual bool wait_actuators(uint32_t timeout_us) = 0;
+};
+
+class ShmTransport : public Transport
+{
+public:
+	explicit ShmTransport(simulator_mavlink_shm::Layout *shm) : _shm(shm) {}
+	~ShmTransport() override { simulator_mavlink_shm::unmap(_shm); }
+
+	void step(uint64_t time_us, bool gps) override
+	{
+		simulator_mavlink_shm::Frame frame;
+
+		if (gps) {
+			frame.type = simulator_mavlink_shm::FrameType::HilGps;
+			frame.hil_gps = hil_gps(time_us);
+			_shm->to_px4.push(frame);
+		}
+
+		frame.type = simulator_mavlink_shm::FrameType::HilSensor;
+		frame.hil_sensor = hil_sensor(time_us);
+		_shm->to_px4.push(frame);
+	}
+
+	bool wait_actuators(uint32_t timeout_us) override
+	{
+		const uint64_t start = micros();
+
+		while (micros() - start < timeout_us) {
+			while (_shm->from_px4.pop(_frame)) {
+				if (_frame.type == simulator_mavlink_shm::FrameType::HilActuatorControls) {
+					return true;
+				}
+			}
+
+			_shm->from_px4.wait(timeout_us);
+		}
+
+		return false;
+	}
+
+private:
+	simulator_mavlink_shm::Layout *_shm;
+	simulator_mavlink_shm::Frame _frame;
+};
+
+class UdpTransport : public Transport
+{
+public:
+	UdpTransport(int fd, const sockaddr_in &addr) : _fd(fd), _addr(addr) {}
+	~UdpTransport() override { close(_fd); }
+
+	void step(uint64_t time_us, bool gps) override
+	{
+		mavlink_message_t msg;
+
+		if (gps) {
+			const mavlink_hil_gps_t hil_gps_msg = hil_gps(time_us);
+			mavlink_msg_hil_gps_encode(1, 200, &msg, &hil_gps_msg);
+			send(msg);
+		}
+
+		const mavlink_hil_sensor_t hil_sensor_msg = hil_sensor(time_us);
+		mavlink_msg_hil_sensor_encode(1, 200, &msg, &hil_sensor_msg);
+		send(msg);
+	}
+
+	bool wait_actuators(uint32_t timeout_us) override
+	{
+		const uint64_t start = micros();
+		uint64_t elapsed_us = 0;
+
+		while (elapsed_us < timeout_us) {
+			pollfd fds{_fd, POLLIN, 0};
+
+			if (poll(&fds, 1, (timeout_us - elapsed_us) / 1000 + 1) > 0) {
+				const ssize_t len = recv(_fd, _buf, sizeof(_buf), 0);
+
+				for (ssize_t i = 0; i < len; i++) {
+					mavlink_message_t msg;
+
+					if (mavlink_parse_char(MAVLINK_COMM_0, _buf[i], &msg, &_status)
+					    && msg.msgid == MAVLINK_MSG_ID_HIL_ACTUATOR_CONTROLS) {
+						return true;
+					}
+				}
+			}
+
+			elapsed_us = micros() - start;
+		}
+
+		return false;
+	}
+
+private:
+	void send(const mavlink_message_t &msg)
+	{
+		uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+		const uint16_t len = mavlink_msg_to_send_buffer(buf, &msg);
+		sendto(_fd, buf, len, 0, (const sockaddr *)&_addr, sizeof(_addr));
+	}
+
+	int _fd;
+	sockaddr_in _addr;
+	uint8_t _buf[2048];
+	mavlink_status_t _status{};
+};
+
+int main(int argc, char *argv[])
+{
+	bool use_shm = true;
+	unsigned port = 4560;
+	int interval_us = 4000;
+	int duration_s = 10;
+
+	int ch;
+
+	while ((ch = getopt(argc, argv, "t:p:i:d:h")) != -1) {
+		switch (ch) {
+		case 't':
+			use_shm = strcmp(optarg, "udp") != 0;
+			break;
+
+		case 'p':
+			port = atoi(optarg);
+			break;
+
+		case 'i':
+			interval_us = atoi(optarg);
+			break;
+
+		case 'd':
+			duration_s = atoi(optarg);
+			break;
+
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (port == 0 || interval_us <= 0 || duration_s < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	signal(SIGINT, signal_handler);
+	signal(SIGTERM, signal_handler);
+
+	Transport *transport = nullptr;
+
+	if (use_shm) {
+		printf("Waiting for PX4 shared memory of port %u\n", port);
+		simulator_mavlink_shm::Layout *shm = nullptr;
+
+		while (!should_exit && (shm = simulator_mavlink_shm::open(port)) == nullptr) {
+			usleep(100000);
+		}
+
+		if (shm == nullptr) {
+			return 1;
+		}
+
+		transport = new ShmTransport(shm);
+
+	} else {
+		int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+		if (fd < 0) {
+			printf("creating UDP socket failed: %s\n", strerror(errno));
+			return 1;
+		}
+
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(port);
+		transport = new UdpTransport(fd, addr);
+	}
+
+	// PX4 replies with actuator controls once its control loop runs, until then keep sending
+	// sensors in real time so that the boot can proceed
+	uint64_t time_us = 1;
+	uint32_t step = 0;
+	bool lockstep = false;
+
+	const uint64_t start = micros();
+	uint64_t stats_start = start;
+	uint32_t stats_steps = 0;
+	uint32_t lockstep_steps = 0;
+	uint64_t lockstep_start = 0;
+	uint32_t timeouts = 0;
+
+	while (!should_exit) {
+		transport->step(time_us, step % (100000 / interval_us + 1) == 0);
+
+		if (!lockstep) {
+			if (transport->wait_actuators(interval_us)) {
+				printf("PX4 replied, lockstep running\n");
+				lockstep = true;
+				lockstep_start = micros();
+				stats_start = lockstep_start;
+			}
+
+		} else if (transport->wait_actuators(1000000)) {
+			lockstep_steps++;
+			stats_steps++;
+
+		} else {
+			timeouts++;
+		}
+
+		time_us += interval_us;
+		step++;
+
+		const uint64_t now = micros();
+
+		if (lockstep && now - stats_start >= 1000000) {
+			const double elapsed_s = (now - stats_start) * 1e-6;
+			printf("%.0f ticks/s, %.2fx realtime\n", stats_steps / elapsed_s, stats_steps * interval_us * 1e-6 / elapsed_s);
+			stats_start = now;
+			stats_steps = 0;
+		}
+
+		if (lockstep && duration_s > 0 && now - lockstep_start >= (uint64_t)duration_s * 1000000) {
+			break;
+		}
+	}
+
+	if (lockstep) {
+		const double elapsed_s = (micros() - lockstep_start) * 1e-6;
+		printf("%s: %u lockstep ticks in %.2f s, %.0f ticks/s, %.2fx realtime, %u timeouts\n", use_shm ? "shm" : "udp",
+		       lockstep_steps, elapsed_s, lockstep_steps / elapsed_s, lockstep_steps * interval_us * 1e-6 / elapsed_s, timeouts);
+	}
+
+	delete transport;
+	return 0;
+}
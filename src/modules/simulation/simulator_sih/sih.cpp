@@ -53,8 +53,9 @@ using namespace math;
 using namespace matrix;
 using namespace time_literals;
 
-Sih::Sih() :
-	ModuleParams(nullptr)
+Sih::Sih(int shm_index) :
+	ModuleParams(nullptr),
+	_shm_index(shm_index)
 {}
 
 Sih::~Sih()
@@ -70,7 +71,20 @@ void Sih::run()
 	_px4_mag.set_temperature(T1_C);
 
 	parameters_updated();
-	init_variables();
+
+	// the multi-vehicle server only steps single IMU samples
+	_imu_fifo_rate = (_shm_index < 0) ? _sih_imu_rate.get() : 0;
+
+	if (_imu_fifo_rate > 0) {
+		// resolution and range of a typical IMU for the raw FIFO samples
+		_px4_accel.set_range(16.f * CONSTANTS_ONE_G);
+		_px4_accel.set_scale(CONSTANTS_ONE_G / 2048.f);
+		_px4_gyro.set_range(math::radians(2000.f));
+		_px4_gyro.set_scale(math::radians(2000.f / 32768.f));
+	}
+
+	srand(1234);    // initialize the random seed once before calling generate_wgn()
+	_model.reset();
 	gps_no_fix();
 
 	const hrt_abstime task_start = hrt_absolute_time();
@@ -79,18 +93,26 @@ void Sih::run()
 	_airspeed_time = task_start;
 	_gt_time = task_start;
 	_dist_snsr_time = task_start;
-	_vehicle = (VehicleType)constrain(_sih_vtype.get(), static_cast<typeof _sih_vtype.get()>(0),
-					  static_cast<typeof _sih_vtype.get()>(2));
 
 	if (_sys_ctrl_alloc.get()) {
 		_actuator_out_sub = uORB::Subscription{ORB_ID(actuator_outputs_sim)};
 	}
 
+	if (_shm_index >= 0) {
+#if defined(ENABLE_LOCKSTEP_SCHEDULER) && defined(__PX4_LINUX)
+		shm_loop();
+#else
+		PX4_ERR("multi-vehicle server requires lockstep on Linux");
+#endif
+
+	} else {
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
-	lockstep_loop();
+		lockstep_loop();
 #else
-	realtime_loop();
+		realtime_loop();
 #endif
+	}
+
 	exit_and_cleanup();
 }
 
@@ -164,6 +186,89 @@ void Sih::lockstep_loop()
 }
 #endif
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER) && defined(__PX4_LINUX)
+void Sih::shm_loop()
+{
+	// wait for the server to be started
+	while (!should_exit() && (_shm = sih_shm::open()) == nullptr) {
+		system_usleep(100_ms);
+	}
+
+	if (_shm == nullptr) {
+		return;
+	}
+
+	if (_shm_index >= (int)_shm->num_slots) {
+		PX4_ERR("vehicle index %d exceeds the %u vehicles of the server", _shm_index, _shm->num_slots);
+		sih_shm::unmap(_shm);
+		_shm = nullptr;
+		return;
+	}
+
+	sih_shm::Slot &slot = _shm->slots[_shm_index];
+
+	if (slot.state.load() != (uint32_t)sih_shm::SlotState::Free) {
+		PX4_WARN("vehicle index %d already in use, taking over", _shm_index);
+	}
+
+	// the model is reset by the server with our parameters
+	slot.params = _model_params;
+	slot.state.store((uint32_t)sih_shm::SlotState::Connecting);
+
+	PX4_INFO("Connected to the multi-vehicle server as vehicle %d", _shm_index);
+
+	while (!should_exit()) {
+		if (!sih_shm::timed_wait(&slot.sensors_ready, 100000)) {
+			if (slot.state.load() == (uint32_t)sih_shm::SlotState::Free) {
+				// dropped by the server for not responding in time
+				PX4_WARN("dropped by the server, reconnecting as vehicle %d", _shm_index);
+				slot.params = _model_params;
+				slot.state.store((uint32_t)sih_shm::SlotState::Reconnecting);
+			}
+
+			continue;
+		}
+
+		perf_count(_loop_interval_perf);
+
+		// the server steps all vehicles with the same simulation time
+		_current_simulation_time_us = slot.time_us;
+		struct timespec ts;
+		abstime_to_ts(&ts, _current_simulation_time_us);
+		px4_clock_settime(CLOCK_MONOTONIC, &ts);
+
+		perf_begin(_loop_perf);
+
+		// check for parameter updates, they only affect the published sensors after the connection
+		if (_parameter_update_sub.updated()) {
+			parameter_update_s pupdate;
+			_parameter_update_sub.copy(&pupdate);
+			updateParams();
+			parameters_updated();
+		}
+
+		_now = hrt_absolute_time();
+		publish_sensors(slot.sensors);
+
+		perf_end(_loop_perf);
+
+		// Only do lock-step once we received the first actuator output
+		if (_last_actuator_output_time > 0) {
+			px4_lockstep_wait_for_components();
+		}
+
+		slot.actuators_updated = read_motors(slot.actuators);
+		slot.step_ack = slot.step;
+		sem_post(&_shm->actuators_ready);
+		_shm_steps++;
+	}
+
+	slot.state.store((uint32_t)sih_shm::SlotState::Free);
+	sih_shm::unmap(_shm);
+	_shm = nullptr;
+}
+#endif
+
 void Sih::realtime_loop()
 {
 	int rate = _imu_gyro_ratemax.get();
@@ -215,17 +320,36 @@ void Sih::sensor_step()
 	_dt = (_now - _last_run) * 1e-6f;
 	_last_run = _now;
 
-	read_motors();
+	float u_sp[SihModel::NB_MOTORS];
 
-	generate_force_and_torques();
+	if (read_motors(u_sp)) {
+		_model.set_actuator_setpoints(u_sp);
+	}
 
-	equations_of_motion();
+	if (_imu_fifo_rate > 0) {
+		// integrate the sub-steps of all the IMU samples of this step at once
+		const int substeps = math::constrain((int)roundf(_dt * _imu_fifo_rate), 1, SihModel::MAX_SUBSTEPS);
+		_model.step(_dt, substeps, _imu_batch);
+		publish_sensors(_model.sensors(), &_imu_batch);
 
-	reconstruct_sensors_signals();
+	} else {
+		_model.step(_dt);
+		publish_sensors(_model.sensors());
+	}
 
+	perf_end(_loop_perf);
+}
+
+void Sih::publish_sensors(const SihModel::Sensors &sensors, const SihModel::ImuBatch *imu)
+{
 	// update IMU every iteration
-	_px4_accel.update(_now, _acc(0), _acc(1), _acc(2));
-	_px4_gyro.update(_now, _gyro(0), _gyro(1), _gyro(2));
+	if (imu != nullptr) {
+		publish_imu_fifo(*imu);
+
+	} else {
+		_px4_accel.update(_now, sensors.accel[0], sensors.accel[1], sensors.accel[2]);
+		_px4_gyro.update(_now, sensors.gyro[0], sensors.gyro[1], sensors.gyro[2]);
+	}
 
 	// magnetometer published at 50 Hz
 	if (_now - _mag_time >= 20_ms
@@ -233,7 +357,7 @@ void Sih::sensor_step()
 	    && fabs(_mag_offset_y) < 10000
 	    && fabs(_mag_offset_z) < 10000) {
 		_mag_time = _now;
-		_px4_mag.update(_now, _mag(0), _mag(1), _mag(2));
+		_px4_mag.update(_now, sensors.mag[0], sensors.mag[1], sensors.mag[2]);
 	}
 
 	// baro published at 20 Hz
@@ -245,8 +369,8 @@ void Sih::sensor_step()
 		sensor_baro_s sensor_baro{};
 		sensor_baro.timestamp_sample = _now;
 		sensor_baro.device_id = 6620172; // 6620172: DRV_BARO_DEVTYPE_BAROSIM, BUS: 1, ADDR: 4, TYPE: SIMULATION
-		sensor_baro.pressure = _baro_p_mBar * 100.f;
-		sensor_baro.temperature = _baro_temp_c;
+		sensor_baro.pressure = sensors.baro_pressure_mbar * 100.f;
+		sensor_baro.temperature = sensors.baro_temperature_c;
 		sensor_baro.error_count = 0;
 		sensor_baro.timestamp = hrt_absolute_time();
 		_sensor_baro_pub.publish(sensor_baro);
@@ -255,59 +379,98 @@ void Sih::sensor_step()
 	// gps published at 20Hz
 	if (_now - _gps_time >= 50_ms) {
 		_gps_time = _now;
-		send_gps();
+		send_gps(sensors);
 	}
 
-	if ((_vehicle == VehicleType::FW || _vehicle == VehicleType::TS) && _now - _airspeed_time >= 50_ms) {
+	if ((_vehicle == SihModel::VehicleType::FW || _vehicle == SihModel::VehicleType::TS) && _now - _airspeed_time >= 50_ms) {
 		_airspeed_time = _now;
-		send_airspeed();
+		send_airspeed(sensors);
 	}
 
 	// distance sensor published at 50 Hz
 	if (_now - _dist_snsr_time >= 20_ms
 	    && fabs(_distance_snsr_override) < 10000) {
 		_dist_snsr_time = _now;
-		send_dist_snsr();
+		send_dist_snsr(sensors);
 	}
 
 	// send groundtruth message every 40 ms
 	if (_now - _gt_time >= 40_ms) {
 		_gt_time = _now;
 
-		publish_sih();  // publish _sih message for debug purpose
+		publish_sih(sensors);  // publish _sih message for debug purpose
 	}
 
-	perf_end(_loop_perf);
 }
 
-// store the parameters in a more convenient form
-void Sih::parameters_updated()
+static inline int16_t fifo_sample(float value, float inv_scale)
 {
-	_T_MAX = _sih_t_max.get();
-	_Q_MAX = _sih_q_max.get();
-	_L_ROLL = _sih_l_roll.get();
-	_L_PITCH = _sih_l_pitch.get();
-	_KDV = _sih_kdv.get();
-	_KDW = _sih_kdw.get();
-	_H0 = _sih_h0.get();
+	return (int16_t)math::constrain(roundf(value * inv_scale), (float)INT16_MIN, (float)INT16_MAX);
+}
 
-	_LAT0 = (double)_sih_lat0.get() * 1.0e-7;
-	_LON0 = (double)_sih_lon0.get() * 1.0e-7;
-	_COS_LAT0 = cosl((long double)radians(_LAT0));
+// publish the IMU samples of the sub-steps like a FIFO driver, the newest sample is at _now
+void Sih::publish_imu_fifo(const SihModel::ImuBatch &imu)
+{
+	const int N = imu.samples;
+	const float inv_accel_scale = 2048.f / CONSTANTS_ONE_G;
+	const float inv_gyro_scale = 1.f / math::radians(2000.f / 32768.f);
+
+	_accel_fifo.timestamp_sample = _now;
+	_accel_fifo.dt = imu.dt * 1e6f;
+	_accel_fifo.samples = N;
+
+	for (int n = 0; n < N; n++) {
+		_accel_fifo.x[n] = fifo_sample(imu.accel_x[n], inv_accel_scale);
+		_accel_fifo.y[n] = fifo_sample(imu.accel_y[n], inv_accel_scale);
+		_accel_fifo.z[n] = fifo_sample(imu.accel_z[n], inv_accel_scale);
+	}
 
-	_MASS = _sih_mass.get();
+	_px4_accel.updateFIFO(_accel_fifo);
 
-	_W_I = Vector3f(0.0f, 0.0f, _MASS * CONSTANTS_ONE_G);
+	_gyro_fifo.timestamp_sample = _now;
+	_gyro_fifo.dt = imu.dt * 1e6f;
+	_gyro_fifo.samples = N;
 
-	_I = diag(Vector3f(_sih_ixx.get(), _sih_iyy.get(), _sih_izz.get()));
-	_I(0, 1) = _I(1, 0) = _sih_ixy.get();
-	_I(0, 2) = _I(2, 0) = _sih_ixz.get();
-	_I(1, 2) = _I(2, 1) = _sih_iyz.get();
+	for (int n = 0; n < N; n++) {
+		_gyro_fifo.x[n] = fifo_sample(imu.gyro_x[n], inv_gyro_scale);
+		_gyro_fifo.y[n] = fifo_sample(imu.gyro_y[n], inv_gyro_scale);
+		_gyro_fifo.z[n] = fifo_sample(imu.gyro_z[n], inv_gyro_scale);
+	}
 
-	// guards against too small determinants
-	_Im1 = 100.0f * inv(static_cast<typeof _I>(100.0f * _I));
+	_px4_gyro.updateFIFO(_gyro_fifo);
+}
 
-	_mu_I = Vector3f(_sih_mu_x.get(), _sih_mu_y.get(), _sih_mu_z.get());
+// store the parameters in a more convenient form
+void Sih::parameters_updated()
+{
+	_model_params.vehicle_type = _sih_vtype.get();
+	_model_params.mass = _sih_mass.get();
+	_model_params.ixx = _sih_ixx.get();
+	_model_params.iyy = _sih_iyy.get();
+	_model_params.izz = _sih_izz.get();
+	_model_params.ixy = _sih_ixy.get();
+	_model_params.ixz = _sih_ixz.get();
+	_model_params.iyz = _sih_iyz.get();
+	_model_params.t_max = _sih_t_max.get();
+	_model_params.q_max = _sih_q_max.get();
+	_model_params.l_roll = _sih_l_roll.get();
+	_model_params.l_pitch = _sih_l_pitch.get();
+	_model_params.kdv = _sih_kdv.get();
+	_model_params.kdw = _sih_kdw.get();
+	_model_params.lat0 = _sih_lat0.get();
+	_model_params.lon0 = _sih_lon0.get();
+	_model_params.h0 = _sih_h0.get();
+	_model_params.mu_x = _sih_mu_x.get();
+	_model_params.mu_y = _sih_mu_y.get();
+	_model_params.mu_z = _sih_mu_z.get();
+	_model_params.baro_offset = _sih_baro_offset.get();
+	_model_params.mag_offset_x = _sih_mag_offset_x.get();
+	_model_params.mag_offset_y = _sih_mag_offset_y.get();
+	_model_params.mag_offset_z = _sih_mag_offset_z.get();
+	_model_params.t_tau = _sih_thrust_tau.get();
+
+	_model.set_params(_model_params);
+	_vehicle = _model.vehicle();
 
 	_gps_used = _sih_gps_used.get();
 	_baro_offset_m = _sih_baro_offset.get();
@@ -318,21 +481,6 @@ void Sih::parameters_updated()
 	_distance_snsr_min = _sih_distance_snsr_min.get();
 	_distance_snsr_max = _sih_distance_snsr_max.get();
 	_distance_snsr_override = _sih_distance_snsr_override.get();
-
-	_T_TAU = _sih_thrust_tau.get();
-}
-
-// initialization of the variables for the simulator
-void Sih::init_variables()
-{
-	srand(1234);    // initialize the random seed once before calling generate_wgn()
-
-	_p_I = Vector3f(0.0f, 0.0f, 0.0f);
-	_v_I = Vector3f(0.0f, 0.0f, 0.0f);
-	_q = Quatf(1.0f, 0.0f, 0.0f, 0.0f);
-	_w_B = Vector3f(0.0f, 0.0f, 0.0f);
-
-	_u[0] = _u[1] = _u[2] = _u[3] = 0.0f;
 }
 
 void Sih::gps_fix()
@@ -365,231 +513,53 @@ void Sih::gps_no_fix()
 
 
 // read the motor signals outputted from the mixer
-void Sih::read_motors()
+bool Sih::read_motors(float u_sp[SihModel::NB_MOTORS])
 {
 	actuator_outputs_s actuators_out;
 
 	float pwm_middle = 0.5f * (PWM_DEFAULT_MIN + PWM_DEFAULT_MAX);
 
-	if (_actuator_out_sub.update(&actuators_out)) {
-		_last_actuator_output_time = actuators_out.timestamp;
-
-		if (_sys_ctrl_alloc.get()) {
-			for (int i = 0; i < NB_MOTORS; i++) { // saturate the motor signals
-				if ((_vehicle == VehicleType::FW && i < 3) || (_vehicle == VehicleType::TS && i > 3)) {
-					_u[i] = actuators_out.output[i];
-
-				} else {
-					float u_sp = actuators_out.output[i];
-					_u[i] = _u[i] + _dt / _T_TAU * (u_sp - _u[i]); // first order transfer function with time constant tau
-				}
-			}
-
-		} else {
-			for (int i = 0; i < NB_MOTORS; i++) { // saturate the motor signals
-				if ((_vehicle == VehicleType::FW && i < 3) || (_vehicle == VehicleType::TS
-						&& i > 3)) { // control surfaces in range [-1,1]
-					_u[i] = constrain(2.0f * (actuators_out.output[i] - pwm_middle) / (PWM_DEFAULT_MAX - PWM_DEFAULT_MIN), -1.0f, 1.0f);
-
-				} else { // throttle signals in range [0,1]
-					float u_sp = constrain((actuators_out.output[i] - PWM_DEFAULT_MIN) / (PWM_DEFAULT_MAX - PWM_DEFAULT_MIN), 0.0f, 1.0f);
-					_u[i] = _u[i] + _dt / _T_TAU * (u_sp - _u[i]); // first order transfer function with time constant tau
-				}
-			}
-		}
+	if (!_actuator_out_sub.update(&actuators_out)) {
+		return false;
 	}
-}
-
-// generate the motors thrust and torque in the body frame
-void Sih::generate_force_and_torques()
-{
-	if (_vehicle == VehicleType::MC) {
-		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (+_u[0] + _u[1] + _u[2] + _u[3]));
-		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (-_u[0] + _u[1] + _u[2] - _u[3]),
-				 _L_PITCH * _T_MAX * (+_u[0] - _u[1] + _u[2] - _u[3]),
-				 _Q_MAX * (+_u[0] + _u[1] - _u[2] - _u[3]));
-		_Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
-		_Ma_B = -_KDW * _w_B;   // first order angular damper
-
-	} else if (_vehicle == VehicleType::FW) {
-		_T_B = Vector3f(_T_MAX * _u[3], 0.0f, 0.0f); 	// forward thruster
-		// _Mt_B = Vector3f(_Q_MAX*_u[3], 0.0f,0.0f); 	// thruster torque
-		_Mt_B = Vector3f();
-		generate_fw_aerodynamics();
-
-	} else if (_vehicle == VehicleType::TS) {
-		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (_u[0] + _u[1]));
-		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (_u[1] - _u[0]), 0.0f, _Q_MAX * (_u[1] - _u[0]));
-		generate_ts_aerodynamics();
 
-		// _Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
-		// _Ma_B = -_KDW * _w_B;   // first order angular damper
-	}
-}
+	_last_actuator_output_time = actuators_out.timestamp;
 
-void Sih::generate_fw_aerodynamics()
-{
-	_v_B = _C_IB.transpose() * _v_I; 	// velocity in body frame [m/s]
-	float altitude = _H0 - _p_I(2);
-	_wing_l.update_aero(_v_B, _w_B, altitude, _u[0]*FLAP_MAX);
-	_wing_r.update_aero(_v_B, _w_B, altitude, -_u[0]*FLAP_MAX);
-	_tailplane.update_aero(_v_B, _w_B, altitude, _u[1]*FLAP_MAX, _T_MAX * _u[3]);
-	_fin.update_aero(_v_B, _w_B, altitude, _u[2]*FLAP_MAX, _T_MAX * _u[3]);
-	_fuselage.update_aero(_v_B, _w_B, altitude);
-	_Fa_I = _C_IB * (_wing_l.get_Fa() + _wing_r.get_Fa() + _tailplane.get_Fa() + _fin.get_Fa() + _fuselage.get_Fa())
-		- _KDV * _v_I; 	// sum of aerodynamic forces
-	_Ma_B = _wing_l.get_Ma() + _wing_r.get_Ma() + _tailplane.get_Ma() + _fin.get_Ma() + _fuselage.get_Ma() - _KDW *
-		_w_B; 	// aerodynamic moments
-}
-
-void Sih::generate_ts_aerodynamics()
-{
-	_v_B = _C_IB.transpose() * _v_I; // velocity in body frame [m/s]
-	Vector3f Fa_ts = Vector3f();
-	Vector3f Ma_ts = Vector3f();
-	Vector3f v_ts = _C_BS.transpose() *
-			_v_B; // the aerodynamic is resolved in a frame like a standard aircraft (nose-right-belly)
-	Vector3f w_ts = _C_BS.transpose() * _w_B;
-	float altitude = _H0 - _p_I(2);
-
-	for (int i = 0; i < NB_TS_SEG; i++) {
-		if (i <= NB_TS_SEG / 2) {
-			_ts[i].update_aero(v_ts, w_ts, altitude, _u[5]*TS_DEF_MAX, _T_MAX * _u[1]);
-
-		} else {
-			_ts[i].update_aero(v_ts, w_ts, altitude, -_u[4]*TS_DEF_MAX, _T_MAX * _u[0]);
+	if (_sys_ctrl_alloc.get()) {
+		for (int i = 0; i < SihModel::NB_MOTORS; i++) {
+			u_sp[i] = actuators_out.output[i];
 		}
 
-		Fa_ts += _ts[i].get_Fa();
-		Ma_ts += _ts[i].get_Ma();
-	}
-
-	_Fa_I = _C_IB * _C_BS * Fa_ts - _KDV * _v_I; 	// sum of aerodynamic forces
-	_Ma_B = _C_BS * Ma_ts - _KDW * _w_B; 	// aerodynamic moments
-}
-
-// apply the equations of motion of a rigid body and integrate one step
-void Sih::equations_of_motion()
-{
-	_C_IB = matrix::Dcm<float>(_q); // body to inertial transformation
-
-	// Equations of motion of a rigid body
-	_p_I_dot = _v_I;                        // position differential
-	_v_I_dot = (_W_I + _Fa_I + _C_IB * _T_B) / _MASS;   // conservation of linear momentum
-	// _q_dot = _q.derivative1(_w_B);              // attitude differential
-	_dq = Quatf::expq(0.5f * _dt * _w_B);
-	_w_B_dot = _Im1 * (_Mt_B + _Ma_B - _w_B.cross(_I * _w_B)); // conservation of angular momentum
-
-	// fake ground, avoid free fall
-	if (_p_I(2) > 0.0f && (_v_I_dot(2) > 0.0f || _v_I(2) > 0.0f)) {
-		if (_vehicle == VehicleType::MC || _vehicle == VehicleType::TS) {
-			if (!_grounded) {    // if we just hit the floor
-				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
-				_v_I_dot = -_v_I / _dt;
-
-			} else {
-				_v_I_dot.setZero();
-			}
-
-			_v_I.setZero();
-			_w_B.setZero();
-			_grounded = true;
-
-		} else if (_vehicle == VehicleType::FW) {
-			if (!_grounded) {    // if we just hit the floor
-				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
-				_v_I_dot(2) = -_v_I(2) / _dt;
+	} else {
+		for (int i = 0; i < SihModel::NB_MOTORS; i++) { // saturate the motor signals
+			if ((_vehicle == SihModel::VehicleType::FW && i < 3) || (_vehicle == SihModel::VehicleType::TS
+					&& i > 3)) { // control surfaces in range [-1,1]
+				u_sp[i] = constrain(2.0f * (actuators_out.output[i] - pwm_middle) / (PWM_DEFAULT_MAX - PWM_DEFAULT_MIN), -1.0f, 1.0f);
 
-			} else {
-				// we only allow negative acceleration in order to takeoff
-				_v_I_dot(2) = fminf(_v_I_dot(2), 0.0f);
+			} else { // throttle signals in range [0,1]
+				u_sp[i] = constrain((actuators_out.output[i] - PWM_DEFAULT_MIN) / (PWM_DEFAULT_MAX - PWM_DEFAULT_MIN), 0.0f, 1.0f);
 			}
-
-			// integration: Euler forward
-			_p_I = _p_I + _p_I_dot * _dt;
-			_v_I = _v_I + _v_I_dot * _dt;
-			Eulerf RPY = Eulerf(_q);
-			RPY(0) = 0.0f;	// no roll
-			RPY(1) = radians(0.0f); // pitch slightly up if needed to get some lift
-			_q = Quatf(RPY);
-			_w_B.setZero();
-			_grounded = true;
 		}
-
-	} else {
-		// integration: Euler forward
-		_p_I = _p_I + _p_I_dot * _dt;
-		_v_I = _v_I + _v_I_dot * _dt;
-		_q = _q * _dq;
-		_q.normalize();
-		// integration Runge-Kutta 4
-		// rk4_update(_p_I, _v_I, _q, _w_B);
-		_w_B = constrain(_w_B + _w_B_dot * _dt, -6.0f * M_PI_F, 6.0f * M_PI_F);
-		_grounded = false;
 	}
-}
-
-// Sih::States Sih::eom_f(States x) 	// equations of motion f: x'=f(x)
-// {
-// 	States x_dot{}; 	// dx/dt
 
-// 	Dcmf C_IB = matrix::Dcm<float>(x.q); // body to inertial transformation
-// 	// Equations of motion of a rigid body
-// 	x_dot.p_I = x.v_I;                        // position differential
-// 	x_dot.v_I = (_W_I + _Fa_I + C_IB * _T_B) / _MASS;   // conservation of linear momentum
-// 	x_dot.q = x.q.derivative1(x.w_B);              // attitude differential
-// 	x_dot.w_B = _Im1 * (_Mt_B + _Ma_B - x.w_B.cross(_I * x.w_B)); // conservation of angular momentum
-
-// 	return x_dot;
-// }
-
-// reconstruct the noisy sensor signals
-void Sih::reconstruct_sensors_signals()
-{
-	// The sensor signals reconstruction and noise levels are from [1]
-	// [1] Bulka, Eitan, and Meyer Nahon. "Autonomous fixed-wing aerobatics: from theory to flight."
-	//     In 2018 IEEE International Conference on Robotics and Automation (ICRA), pp. 6573-6580. IEEE, 2018.
-
-	// IMU
-	_acc = _C_IB.transpose() * (_v_I_dot - Vector3f(0.0f, 0.0f, CONSTANTS_ONE_G)) + noiseGauss3f(0.5f, 1.7f, 1.4f);
-	_gyro = _w_B + noiseGauss3f(0.14f, 0.07f, 0.03f);
-	_mag = _C_IB.transpose() * _mu_I + noiseGauss3f(0.02f, 0.02f, 0.03f);
-	_mag(0) += _mag_offset_x;
-	_mag(1) += _mag_offset_y;
-	_mag(2) += _mag_offset_z;
-
-	// barometer
-	float altitude = (_H0 - _p_I(2)) + _baro_offset_m + generate_wgn() * 0.14f; // altitude with noise
-	_baro_p_mBar = CONSTANTS_STD_PRESSURE_MBAR *        // reconstructed pressure in mBar
-		       powf((1.0f + altitude * TEMP_GRADIENT / T1_K), -CONSTANTS_ONE_G / (TEMP_GRADIENT * CONSTANTS_AIR_GAS_CONST));
-	_baro_temp_c = T1_K + CONSTANTS_ABSOLUTE_NULL_CELSIUS + TEMP_GRADIENT * altitude; // reconstructed temperture in Celsius
-
-	// GPS
-	_gps_lat_noiseless = _LAT0 + degrees((double)_p_I(0) / CONSTANTS_RADIUS_OF_EARTH);
-	_gps_lon_noiseless = _LON0 + degrees((double)_p_I(1) / CONSTANTS_RADIUS_OF_EARTH) / _COS_LAT0;
-	_gps_alt_noiseless = _H0 - _p_I(2);
-
-	_gps_lat = _gps_lat_noiseless + degrees((double)generate_wgn() * 0.2 / CONSTANTS_RADIUS_OF_EARTH);
-	_gps_lon = _gps_lon_noiseless + degrees((double)generate_wgn() * 0.2 / CONSTANTS_RADIUS_OF_EARTH) / _COS_LAT0;
-	_gps_alt = _gps_alt_noiseless + generate_wgn() * 0.5f;
-	_gps_vel = _v_I + noiseGauss3f(0.06f, 0.077f, 0.158f);
+	return true;
 }
 
-void Sih::send_gps()
+void Sih::send_gps(const SihModel::Sensors &sensors)
 {
 	_sensor_gps.timestamp = _now;
-	_sensor_gps.lat = (int32_t)(_gps_lat * 1e7);       // Latitude in 1E-7 degrees
-	_sensor_gps.lon = (int32_t)(_gps_lon * 1e7); // Longitude in 1E-7 degrees
-	_sensor_gps.alt = (int32_t)(_gps_alt * 1000.0f); // Altitude in 1E-3 meters above MSL, (millimetres)
-	_sensor_gps.alt_ellipsoid = (int32_t)(_gps_alt * 1000); // Altitude in 1E-3 meters bove Ellipsoid, (millimetres)
+	_sensor_gps.lat = (int32_t)(sensors.gps_lat * 1e7);       // Latitude in 1E-7 degrees
+	_sensor_gps.lon = (int32_t)(sensors.gps_lon * 1e7); // Longitude in 1E-7 degrees
+	_sensor_gps.alt = (int32_t)(sensors.gps_alt * 1000.0f); // Altitude in 1E-3 meters above MSL, (millimetres)
+	_sensor_gps.alt_ellipsoid = (int32_t)(sensors.gps_alt * 1000); // Altitude in 1E-3 meters bove Ellipsoid, (millimetres)
 	_sensor_gps.vel_ned_valid = true;              // True if NED velocity is valid
-	_sensor_gps.vel_m_s = sqrtf(_gps_vel(0) * _gps_vel(0) + _gps_vel(1) * _gps_vel(
-					    1)); // GPS ground speed, (metres/sec)
-	_sensor_gps.vel_n_m_s = _gps_vel(0);           // GPS North velocity, (metres/sec)
-	_sensor_gps.vel_e_m_s = _gps_vel(1);           // GPS East velocity, (metres/sec)
-	_sensor_gps.vel_d_m_s = _gps_vel(2);           // GPS Down velocity, (metres/sec)
-	_sensor_gps.cog_rad = atan2(_gps_vel(1),
-				    _gps_vel(0)); // Course over ground (NOT heading, but direction of movement), -PI..PI, (radians)
+	_sensor_gps.vel_m_s = sqrtf(sensors.gps_vel[0] * sensors.gps_vel[0] + sensors.gps_vel[1] *
+				    sensors.gps_vel[1]); // GPS ground speed, (metres/sec)
+	_sensor_gps.vel_n_m_s = sensors.gps_vel[0];           // GPS North velocity, (metres/sec)
+	_sensor_gps.vel_e_m_s = sensors.gps_vel[1];           // GPS East velocity, (metres/sec)
+	_sensor_gps.vel_d_m_s = sensors.gps_vel[2];           // GPS Down velocity, (metres/sec)
+	_sensor_gps.cog_rad = atan2(sensors.gps_vel[1],
+				    sensors.gps_vel[0]); // Course over ground (NOT heading, but direction of movement), -PI..PI, (radians)
 
 	if (_gps_used >= 4) {
 		gps_fix();
@@ -609,19 +579,19 @@ void Sih::send_gps()
 	_sensor_gps_pub.publish(_sensor_gps);
 }
 
-void Sih::send_airspeed()
+void Sih::send_airspeed(const SihModel::Sensors &sensors)
 {
 	airspeed_s airspeed{};
 	airspeed.timestamp_sample = _now;
-	airspeed.true_airspeed_m_s	= fmaxf(0.1f, _v_B(0) + generate_wgn() * 0.2f);
-	airspeed.indicated_airspeed_m_s = airspeed.true_airspeed_m_s * sqrtf(_wing_l.get_rho() / RHO);
-	airspeed.air_temperature_celsius = _baro_temp_c;
+	airspeed.true_airspeed_m_s	= sensors.true_airspeed;
+	airspeed.indicated_airspeed_m_s = sensors.indicated_airspeed;
+	airspeed.air_temperature_celsius = sensors.baro_temperature_c;
 	airspeed.confidence = 0.7f;
 	airspeed.timestamp = hrt_absolute_time();
 	_airspeed_pub.publish(airspeed);
 }
 
-void Sih::send_dist_snsr()
+void Sih::send_dist_snsr(const SihModel::Sensors &sensors)
 {
 	_distance_snsr.timestamp = _now;
 	_distance_snsr.type = distance_sensor_s::MAV_DISTANCE_SENSOR_LASER;
@@ -635,7 +605,7 @@ void Sih::send_dist_snsr()
 		_distance_snsr.current_distance = _distance_snsr_override;
 
 	} else {
-		_distance_snsr.current_distance = -_p_I(2) / _C_IB(2, 2);
+		_distance_snsr.current_distance = sensors.distance_bottom;
 
 		if (_distance_snsr.current_distance > _distance_snsr_max) {
 			// this is based on lightware lw20 behaviour
@@ -647,76 +617,37 @@ void Sih::send_dist_snsr()
 	_distance_snsr_pub.publish(_distance_snsr);
 }
 
-void Sih::publish_sih()
+void Sih::publish_sih(const SihModel::Sensors &sensors)
 {
 	// publish angular velocity groundtruth
 	_vehicle_angular_velocity_gt.timestamp = hrt_absolute_time();
-	_vehicle_angular_velocity_gt.xyz[0] = _w_B(0); // rollspeed;
-	_vehicle_angular_velocity_gt.xyz[1] = _w_B(1); // pitchspeed;
-	_vehicle_angular_velocity_gt.xyz[2] = _w_B(2); // yawspeed;
+	_vehicle_angular_velocity_gt.xyz[0] = sensors.w_B[0]; // rollspeed;
+	_vehicle_angular_velocity_gt.xyz[1] = sensors.w_B[1]; // pitchspeed;
+	_vehicle_angular_velocity_gt.xyz[2] = sensors.w_B[2]; // yawspeed;
 
 	_vehicle_angular_velocity_gt_pub.publish(_vehicle_angular_velocity_gt);
 
 	// publish attitude groundtruth
 	_att_gt.timestamp = hrt_absolute_time();
-	_att_gt.q[0] = _q(0);
-	_att_gt.q[1] = _q(1);
-	_att_gt.q[2] = _q(2);
-	_att_gt.q[3] = _q(3);
+	_att_gt.q[0] = sensors.q[0];
+	_att_gt.q[1] = sensors.q[1];
+	_att_gt.q[2] = sensors.q[2];
+	_att_gt.q[3] = sensors.q[3];
 
 	_att_gt_pub.publish(_att_gt);
 
 	// publish position groundtruth
 	_gpos_gt.timestamp = hrt_absolute_time();
-	_gpos_gt.lat = _gps_lat_noiseless;
-	_gpos_gt.lon = _gps_lon_noiseless;
-	_gpos_gt.alt = _gps_alt_noiseless;
+	_gpos_gt.lat = sensors.lat;
+	_gpos_gt.lon = sensors.lon;
+	_gpos_gt.alt = sensors.alt;
 
 	_gpos_gt_pub.publish(_gpos_gt);
 }
 
-float Sih::generate_wgn()   // generate white Gaussian noise sample with std=1
-{
-	// algorithm 1:
-	// float temp=((float)(rand()+1))/(((float)RAND_MAX+1.0f));
-	// return sqrtf(-2.0f*logf(temp))*cosf(2.0f*M_PI_F*rand()/RAND_MAX);
-	// algorithm 2: from BlockRandGauss.hpp
-	static float V1, V2, S;
-	static bool phase = true;
-	float X;
-
-	if (phase) {
-		do {
-			float U1 = (float)rand() / (float)RAND_MAX;
-			float U2 = (float)rand() / (float)RAND_MAX;
-			V1 = 2.0f * U1 - 1.0f;
-			V2 = 2.0f * U2 - 1.0f;
-			S = V1 * V1 + V2 * V2;
-		} while (S >= 1.0f || fabsf(S) < 1e-8f);
-
-		X = V1 * float(sqrtf(-2.0f * float(logf(S)) / S));
-
-	} else {
-		X = V2 * float(sqrtf(-2.0f * float(logf(S)) / S));
-	}
-
-	phase = !phase;
-	return X;
-}
-
-// generate white Gaussian noise sample vector with specified std
-Vector3f Sih::noiseGauss3f(float stdx, float stdy, float stdz)
+// the model has no dependency on the PX4 logging, so it can be used by px4_sih_server
+void SihModel::print_status() const
 {
-	return Vector3f(generate_wgn() * stdx, generate_wgn() * stdy, generate_wgn() * stdz);
-}
-
-int Sih::print_status()
-{
-#if defined(ENABLE_LOCKSTEP_SCHEDULER)
-	PX4_INFO("Running in lockstep mode");
-	PX4_INFO("Achieved speedup: %.2fX", (double)_achieved_speedup);
-#endif
-
 	if (_vehicle == VehicleType::MC) {
 		PX4_INFO("Running MultiCopter");
 
@@ -741,7 +672,7 @@ int Sih::print_status()
 	PX4_INFO("angular acceleration roll-pitch-yaw (deg/s)");
 	(_w_B * 180.0f / M_PI_F).print();
 	PX4_INFO("actuator signals");
-	Vector<float, 8> u = Vector<float, 8>(_u);
+	Vector<float, NB_MOTORS> u = Vector<float, NB_MOTORS>(_u);
 	u.transpose().print();
 	PX4_INFO("Aerodynamic forces NED inertial (N)");
 	_Fa_I.print();
@@ -749,6 +680,28 @@ int Sih::print_status()
 	_Ma_B.print();
 	PX4_INFO("Thruster moments in body frame (Nm)");
 	_Mt_B.print();
+}
+
+int Sih::print_status()
+{
+#if defined(ENABLE_LOCKSTEP_SCHEDULER)
+	PX4_INFO("Running in lockstep mode");
+	PX4_INFO("Achieved speedup: %.2fX", (double)_achieved_speedup);
+#endif
+
+	if (_imu_fifo_rate > 0) {
+		PX4_INFO("IMU FIFO: %d Hz, %d samples per step", (int)_imu_fifo_rate, _imu_batch.samples);
+	}
+
+	if (_shm_index >= 0) {
+#if defined(ENABLE_LOCKSTEP_SCHEDULER) && defined(__PX4_LINUX)
+		PX4_INFO("Running as vehicle %d of the multi-vehicle server (%s)", _shm_index, _shm ? "connected" : "waiting");
+		PX4_INFO("steps: %u", _shm_steps);
+#endif
+		return 0;
+	}
+
+	_model.print_status();
 	return 0;
 }
 
@@ -772,7 +725,24 @@ int Sih::task_spawn(int argc, char *argv[])
 
 Sih *Sih::instantiate(int argc, char *argv[])
 {
-	Sih *instance = new Sih();
+	int shm_index = -1;
+	int myoptind = 1;
+	int ch;
+	const char *myoptarg = nullptr;
+
+	while ((ch = px4_getopt(argc, argv, "s:", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 's':
+			shm_index = strtol(myoptarg, nullptr, 10);
+			break;
+
+		default:
+			print_usage("unrecognized flag");
+			return nullptr;
+		}
+	}
+
+	Sih *instance = new Sih(shm_index);
 
 	if (instance == nullptr) {
 		PX4_ERR("alloc failed");
@@ -810,11 +780,27 @@ Quaternion representation is used for the attitude.
 Forward Euler is used for integration.
 Most of the variables are declared global in the .hpp file to avoid stack overflow.
 
+With `-s <index>` (SITL with lockstep on Linux), the vehicle model is not simulated
+locally, but by a multi-vehicle server process stepping many vehicles at once
+(`px4_sih_server`). This instance connects to it as vehicle <index> through shared
+memory, publishes the sensors of each step and replies with its actuator outputs.
+The SIH_* parameters are sent to the server when connecting.
+
+With SIH_IMU_RATE set, each step is integrated as several sub-steps and the IMU samples
+of all the sub-steps are published at once as sensor_accel_fifo/sensor_gyro_fifo, like a
+FIFO IMU driver. This runs the FIFO filtering of the sensors module at e.g. 8 kHz without
+scheduling every sample.
+
+### Examples
+Start the server for 50 vehicles and connect each PX4 instance:
+$ px4_sih_server -n 50
+$ simulator_sih start -s $px4_instance
 
 )DESCR_STR");
 
     PRINT_MODULE_USAGE_NAME("simulator_sih", "simulation");
     PRINT_MODULE_USAGE_COMMAND("start");
+    PRINT_MODULE_USAGE_PARAM_INT('s', -1, -1, 255, "Vehicle index in the multi-vehicle server (-1: simulate locally)", true);
     PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 
     return 0;
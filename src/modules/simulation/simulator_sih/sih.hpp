@@ -59,9 +59,8 @@
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/posix.h>
 
-#include <matrix/matrix/math.hpp>   // matrix, vectors, dcm, quaterions
-#include <conversion/rotation.h>    // math::radians,
-#include <lib/geo/geo.h>        // to get the physical constants
+#include "sih_model.hpp"
+
 #include <drivers/drv_hrt.h>        // to get the real time
 #include <lib/drivers/accelerometer/PX4Accelerometer.hpp>
 #include <lib/drivers/gyroscope/PX4Gyroscope.hpp>
@@ -84,6 +83,10 @@
 #include <sys/time.h>
 #endif
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER) && defined(__PX4_LINUX)
+#include "sih_shm.hpp"
+#endif
+
 using namespace time_literals;
 
 extern "C" __EXPORT int sih_main(int argc, char *argv[]);
@@ -91,7 +94,7 @@ extern "C" __EXPORT int sih_main(int argc, char *argv[]);
 class Sih : public ModuleBase<Sih>, public ModuleParams
 {
 public:
-	Sih();
+	Sih(int shm_index = -1);
 
 	virtual ~Sih();
 
@@ -113,11 +116,6 @@ public:
 	/** @see ModuleBase::run() */
 	void run() override;
 
-	static float generate_wgn();    // generate white Gaussian noise sample
-
-	// generate white Gaussian noise sample as a 3D vector with specified std
-	static matrix::Vector3f noiseGauss3f(float stdx, float stdy, float stdz);
-
 	// timer called periodically to post the semaphore
 	static void timer_callback(void *sem);
 
@@ -157,31 +155,17 @@ private:
 	uORB::SubscriptionInterval _parameter_update_sub{ORB_ID(parameter_update), 1_s};
 	uORB::Subscription _actuator_out_sub{ORB_ID(actuator_outputs)};
 
-	// hard constants
-	static constexpr uint16_t NB_MOTORS = 6;
 	static constexpr float T1_C = 15.0f;                        // ground temperature in Celsius
-	static constexpr float T1_K = T1_C - CONSTANTS_ABSOLUTE_NULL_CELSIUS;   // ground temperature in Kelvin
-	static constexpr float TEMP_GRADIENT  = -6.5f / 1000.0f;    // temperature gradient in degrees per metre
-	// Aerodynamic coefficients
-	static constexpr float RHO = 1.225f; 		// air density at sea level [kg/m^3]
-	static constexpr float SPAN = 0.86f; 	// wing span [m]
-	static constexpr float MAC = 0.21f; 	// wing mean aerodynamic chord [m]
-	static constexpr float RP = 0.1f; 	// radius of the propeller [m]
-	static constexpr float FLAP_MAX = M_PI_F / 12.0f; // 15 deg, maximum control surface deflection
-
-	void init_variables();
+
 	void gps_fix();
 	void gps_no_fix();
-	void read_motors();
-	void generate_force_and_torques();
-	void equations_of_motion();
-	void reconstruct_sensors_signals();
-	void send_gps();
-	void send_airspeed();
-	void send_dist_snsr();
-	void publish_sih();
-	void generate_fw_aerodynamics();
-	void generate_ts_aerodynamics();
+	bool read_motors(float u_sp[SihModel::NB_MOTORS]);
+	void publish_sensors(const SihModel::Sensors &sensors, const SihModel::ImuBatch *imu = nullptr);
+	void publish_imu_fifo(const SihModel::ImuBatch &imu);
+	void send_gps(const SihModel::Sensors &sensors);
+	void send_airspeed(const SihModel::Sensors &sensors);
+	void send_dist_snsr(const SihModel::Sensors &sensors);
+	void publish_sih(const SihModel::Sensors &sensors);
 	void sensor_step();
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
@@ -190,6 +174,14 @@ private:
 	float _achieved_speedup{0.f};
 #endif
 
+#if defined(ENABLE_LOCKSTEP_SCHEDULER) && defined(__PX4_LINUX)
+	// vehicle stepped by the multi-vehicle server (px4_sih_server) through shared memory
+	void shm_loop();
+	sih_shm::Layout *_shm{nullptr};
+	uint32_t _shm_steps{0};
+#endif
+	const int _shm_index;   // slot in the shared memory of the multi-vehicle server, -1 to run the model locally
+
 	void realtime_loop();
 	px4_sem_t       _data_semaphore;
 	hrt_call 	_timer_call;
@@ -207,90 +199,18 @@ private:
 	hrt_abstime _dist_snsr_time{0};
 	hrt_abstime _now{0};
 	float       _dt{0};         // sampling time [s]
-	bool        _grounded{true};// whether the vehicle is on the ground
-
-	matrix::Vector3f    _T_B;           // thrust force in body frame [N]
-	matrix::Vector3f    _Fa_I;          // aerodynamic force in inertial frame [N]
-	matrix::Vector3f    _Mt_B;          // thruster moments in the body frame [Nm]
-	matrix::Vector3f    _Ma_B;          // aerodynamic moments in the body frame [Nm]
-	matrix::Vector3f    _p_I;           // inertial position [m]
-	matrix::Vector3f    _v_I;           // inertial velocity [m/s]
-	matrix::Vector3f    _v_B;           // body frame velocity [m/s]
-	matrix::Vector3f    _p_I_dot;       // inertial position differential
-	matrix::Vector3f    _v_I_dot;       // inertial velocity differential
-	matrix::Quatf       _q;             // quaternion attitude
-	matrix::Dcmf        _C_IB;          // body to inertial transformation
-	matrix::Vector3f    _w_B;           // body rates in body frame [rad/s]
-	matrix::Quatf       _dq;            // quaternion differential
-	matrix::Vector3f    _w_B_dot;       // body rates differential
-	float       _u[NB_MOTORS];          // thruster signals
-
-	enum class VehicleType {MC, FW, TS};
-	VehicleType _vehicle = VehicleType::MC;
-
-	// aerodynamic segments for the fixedwing
-	AeroSeg _wing_l = AeroSeg(SPAN / 2.0f, MAC, -4.0f, matrix::Vector3f(0.0f, -SPAN / 4.0f, 0.0f), 3.0f,
-				  SPAN / MAC, MAC / 3.0f);
-	AeroSeg _wing_r = AeroSeg(SPAN / 2.0f, MAC, -4.0f, matrix::Vector3f(0.0f, SPAN / 4.0f, 0.0f), -3.0f,
-				  SPAN / MAC, MAC / 3.0f);
-	AeroSeg _tailplane = AeroSeg(0.3f, 0.1f, 0.0f, matrix::Vector3f(-0.4f, 0.0f, 0.0f), 0.0f, -1.0f, 0.05f, RP);
-	AeroSeg _fin = AeroSeg(0.25, 0.18, 0.0f, matrix::Vector3f(-0.45f, 0.0f, -0.1f), -90.0f, -1.0f, 0.12f, RP);
-	AeroSeg _fuselage = AeroSeg(0.2, 0.8, 0.0f, matrix::Vector3f(0.0f, 0.0f, 0.0f), -90.0f);
-
-	// aerodynamic segments for the tailsitter
-	static constexpr const int NB_TS_SEG = 11;
-	static constexpr const float TS_AR = 3.13f;
-	static constexpr const float TS_CM = 0.115f;	// longitudinal position of the CM from trailing edge
-	static constexpr const float TS_RP = 0.0625f;	// propeller radius [m]
-	static constexpr const float TS_DEF_MAX = math::radians(39.0f); 	// max deflection
-	matrix::Dcmf _C_BS = matrix::Dcmf(matrix::Eulerf(0.0f, math::radians(90.0f), 0.0f)); // segment to body 90 deg pitch
-	AeroSeg _ts[NB_TS_SEG] = {
-		AeroSeg(0.0225f, 0.110f, 0.0f, matrix::Vector3f(0.083f - TS_CM, -0.239f, 0.0f), 0.0f, TS_AR),
-		AeroSeg(0.0383f, 0.125f, 0.0f, matrix::Vector3f(0.094f - TS_CM, -0.208f, 0.0f), 0.0f, TS_AR, 0.063f),
-		// AeroSeg(0.0884f, 0.148f, 0.0f, matrix::Vector3f(0.111f-TS_CM, -0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
-		AeroSeg(0.0884f, 0.085f, 0.0f, matrix::Vector3f(0.158f - TS_CM, -0.143f, 0.0f), 0.0f, TS_AR),
-		AeroSeg(0.0884f, 0.063f, 0.0f, matrix::Vector3f(0.047f - TS_CM, -0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
-		AeroSeg(0.0633f, 0.176f, 0.0f, matrix::Vector3f(0.132f - TS_CM, -0.068f, 0.0f), 0.0f, TS_AR, 0.063f),
-		AeroSeg(0.0750f, 0.231f, 0.0f, matrix::Vector3f(0.173f - TS_CM,  0.000f, 0.0f), 0.0f, TS_AR),
-		AeroSeg(0.0633f, 0.176f, 0.0f, matrix::Vector3f(0.132f - TS_CM,  0.068f, 0.0f), 0.0f, TS_AR, 0.063f),
-		// AeroSeg(0.0884f, 0.148f, 0.0f, matrix::Vector3f(0.111f-TS_CM,  0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
-		AeroSeg(0.0884f, 0.085f, 0.0f, matrix::Vector3f(0.158f - TS_CM,  0.143f, 0.0f), 0.0f, TS_AR),
-		AeroSeg(0.0884f, 0.063f, 0.0f, matrix::Vector3f(0.047f - TS_CM,  0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
-		AeroSeg(0.0383f, 0.125f, 0.0f, matrix::Vector3f(0.094f - TS_CM,  0.208f, 0.0f), 0.0f, TS_AR, 0.063f),
-		AeroSeg(0.0225f, 0.110f, 0.0f, matrix::Vector3f(0.083f - TS_CM,  0.239f, 0.0f), 0.0f, TS_AR)
-	};
-
-	// AeroSeg _ts[NB_TS_SEG] = {
-	// 	AeroSeg(0.0225f, 0.110f, -90.0f, matrix::Vector3f(0.0f, -0.239f, TS_CM-0.083f), 0.0f, TS_AR),
-	// 	AeroSeg(0.0383f, 0.125f, -90.0f, matrix::Vector3f(0.0f, -0.208f, TS_CM-0.094f), 0.0f, TS_AR, 0.063f),
-	// 	AeroSeg(0.0884f, 0.148f, -90.0f, matrix::Vector3f(0.0f, -0.143f, TS_CM-0.111f), 0.0f, TS_AR, 0.063f, TS_RP),
-	// 	AeroSeg(0.0633f, 0.176f, -90.0f, matrix::Vector3f(0.0f, -0.068f, TS_CM-0.132f), 0.0f, TS_AR, 0.063f),
-	// 	AeroSeg(0.0750f, 0.231f, -90.0f, matrix::Vector3f(0.0f,  0.000f, TS_CM-0.173f), 0.0f, TS_AR),
-	// 	AeroSeg(0.0633f, 0.176f, -90.0f, matrix::Vector3f(0.0f,  0.068f, TS_CM-0.132f), 0.0f, TS_AR, 0.063f),
-	// 	AeroSeg(0.0884f, 0.148f, -90.0f, matrix::Vector3f(0.0f,  0.143f, TS_CM-0.111f), 0.0f, TS_AR, 0.063f, TS_RP),
-	// 	AeroSeg(0.0383f, 0.125f, -90.0f, matrix::Vector3f(0.0f,  0.208f, TS_CM-0.094f), 0.0f, TS_AR, 0.063f),
-	// 	AeroSeg(0.0225f, 0.110f, -90.0f, matrix::Vector3f(0.0f,  0.239f, TS_CM-0.083f), 0.0f, TS_AR)
-	// 	};
-
-	// sensors reconstruction
-	matrix::Vector3f    _acc;
-	matrix::Vector3f    _mag;
-	matrix::Vector3f    _gyro;
-	matrix::Vector3f    _gps_vel;
-	double      _gps_lat, _gps_lat_noiseless;
-	double      _gps_lon, _gps_lon_noiseless;
-	float       _gps_alt, _gps_alt_noiseless;
-	float       _baro_p_mBar;   // reconstructed (simulated) pressure in mBar
-	float       _baro_temp_c;   // reconstructed (simulated) barometer temperature in degrees Celsius
 
-	// parameters
-	float _MASS, _T_MAX, _Q_MAX, _L_ROLL, _L_PITCH, _KDV, _KDW, _H0, _T_TAU;
-	double _LAT0, _LON0, _COS_LAT0;
-	matrix::Vector3f _W_I;  // weight of the vehicle in inertial frame [N]
-	matrix::Matrix3f _I;    // vehicle inertia matrix
-	matrix::Matrix3f _Im1;  // inverse of the inertia matrix
-	matrix::Vector3f _mu_I; // NED magnetic field in inertial frame [G]
+	SihModel _model;
+	SihModel::Params _model_params{};
+	SihModel::VehicleType _vehicle = SihModel::VehicleType::MC;
 
+	// IMU FIFO simulation, SIH_IMU_RATE > 0
+	int32_t _imu_fifo_rate{0};      // [Hz]
+	SihModel::ImuBatch _imu_batch{};
+	sensor_accel_fifo_s _accel_fifo{};
+	sensor_gyro_fifo_s _gyro_fifo{};
+
+	// parameters
 	int _gps_used;
 	float _baro_offset_m, _mag_offset_x, _mag_offset_y, _mag_offset_z;
 	float _distance_snsr_min, _distance_snsr_max, _distance_snsr_override;
@@ -328,6 +248,7 @@ private:
 		(ParamFloat<px4::params::SIH_DISTSNSR_OVR>) _sih_distance_snsr_override,
 		(ParamFloat<px4::params::SIH_T_TAU>) _sih_thrust_tau,
 		(ParamInt<px4::params::SIH_VEHICLE_TYPE>) _sih_vtype,
+		(ParamInt<px4::params::SIH_IMU_RATE>) _sih_imu_rate,
 		(ParamBool<px4::params::SYS_CTRL_ALLOC>) _sys_ctrl_alloc
 	)
 };
@@ -0,0 +1,211 @@
+/****************************************************************************
+*
+*   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+* 3. Neither the name PX4 nor the names of its contributors may be
+*    used to endorse or promote products derived from this software
+*    without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+* ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+****************************************************************************/
+
+
+/**
+ * @file sih_bench.cpp
+ * SIH model benchmark (px4_sih_bench)
+ *
+ * Measures how many simulated seconds per wall clock second the SIH vehicle model
+ * runs at when the IMU is sampled at a high rate, once stepping the model for every
+ * IMU sample and once with step batches of K sub-steps per simulation loop, as
+ * simulator_sih does with SIH_IMU_RATE.
+ */
+
+#include "sih_model.hpp"
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <vector>
+
+// Get current timestamp in microseconds
+static uint64_t micros()
+{
+	struct timeval t;
+	gettimeofday(&t, nullptr);
+	return t.tv_sec * ((uint64_t)1000000) + t.tv_usec;
+}
+
+static void usage(const char *name)
+{
+	printf("SIH model benchmark, simulated seconds per second\n\n");
+	printf("usage: %s [-r <rate>] [-i <imu rate>] [-t <duration>] [-n <vehicles>] [-v <type>]\n", name);
+	printf("  -r <rate>      simulation loop rate in Hz (default 400)\n");
+	printf("  -i <imu rate>  IMU sample rate in Hz (default 8000)\n");
+	printf("  -t <duration>  simulated time per vehicle in s (default 60)\n");
+	printf("  -n <vehicles>  number of vehicles (default 1)\n");
+	printf("  -v <type>      SIH_VEHICLE_TYPE, 0: multicopter, 1: fixed-wing, 2: tailsitter (default 0)\n");
+}
+
+// defaults of sih_params.c
+static SihModel::Params default_params(int vehicle_type)
+{
+	SihModel::Params params{};
+	params.vehicle_type = vehicle_type;
+	params.mass = 1.f;
+	params.ixx = 0.025f;
+	params.iyy = 0.025f;
+	params.izz = 0.03f;
+	params.t_max = 5.f;
+	params.q_max = 0.1f;
+	params.l_roll = 0.2f;
+	params.l_pitch = 0.2f;
+	params.kdv = 1.f;
+	params.kdw = 0.025f;
+	params.lat0 = 454671160;
+	params.lon0 = -737578370;
+	params.h0 = 32.34f;
+	params.mu_x = 0.179f;
+	params.mu_y = -0.045f;
+	params.mu_z = 0.504f;
+	params.t_tau = 0.05f;
+	return params;
+}
+
+/**
+ * Run the vehicles for duration_s simulated seconds, with substeps IMU samples per loop step.
+ * @return simulated seconds per second (of all vehicles)
+ */
+static double run(std::vector<SihModel> &models, float duration_s, int step_rate, int substeps)
+{
+	const float dt = 1.f / step_rate;
+	const int steps = (int)ceilf(duration_s * step_rate);
+
+	// slightly above hover for a multicopter, throttle and neutral surfaces for the others
+	const float u_sp[SihModel::NB_MOTORS] {0.6f, 0.6f, 0.6f, 0.6f, 0.f, 0.f};
+
+	SihModel::ImuBatch imu{};
+	float checksum = 0.f;
+
+	for (SihModel &model : models) {
+		model.reset();
+	}
+
+	const uint64_t start = micros();
+
+	for (int step = 0; step < steps; step++) {
+		for (SihModel &model : models) {
+			model.set_actuator_setpoints(u_sp);
+
+			if (substeps > 1) {
+				model.step(dt, substeps, imu);
+				checksum += imu.gyro_z[imu.samples - 1];
+
+			} else {
+				model.step(dt);
+				checksum += model.sensors().gyro[2];
+			}
+		}
+	}
+
+	const double elapsed_s = (micros() - start) * 1e-6;
+
+	// keep the results alive
+	if (!isfinite(checksum)) {
+		printf("invalid model state\n");
+	}
+
+	return models.size() * steps * (double)dt / elapsed_s;
+}
+
+int main(int argc, char *argv[])
+{
+	int step_rate = 400;
+	int imu_rate = 8000;
+	float duration_s = 60.f;
+	int num_vehicles = 1;
+	int vehicle_type = 0;
+
+	int ch;
+
+	while ((ch = getopt(argc, argv, "r:i:t:n:v:h")) != -1) {
+		switch (ch) {
+		case 'r':
+			step_rate = atoi(optarg);
+			break;
+
+		case 'i':
+			imu_rate = atoi(optarg);
+			break;
+
+		case 't':
+			duration_s = atof(optarg);
+			break;
+
+		case 'n':
+			num_vehicles = atoi(optarg);
+			break;
+
+		case 'v':
+			vehicle_type = atoi(optarg);
+			break;
+
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (step_rate <= 0 || imu_rate < step_rate || duration_s <= 0.f || num_vehicles < 1) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	const int substeps = math::constrain((int)roundf((float)imu_rate / step_rate), 1, SihModel::MAX_SUBSTEPS);
+
+	srand(1234);    // initialize the random seed once before calling generate_wgn()
+
+	std::vector<SihModel> models(num_vehicles);
+
+	for (SihModel &model : models) {
+		model.set_params(default_params(vehicle_type));
+	}
+
+	printf("%d vehicle(s), %.0f s simulated each, IMU at %d Hz\n", num_vehicles, (double)duration_s, imu_rate);
+
+	// every IMU sample as a complete step, as scheduling the simulation at the IMU rate would
+	const double per_sample = run(models, duration_s, step_rate * substeps, 1);
+	printf("step per IMU sample (%d Hz):                %8.1f sim s/s\n", step_rate * substeps, per_sample);
+
+	const double batched = run(models, duration_s, step_rate, substeps);
+	printf("batches of %2d sub-steps per step (%d Hz):  %8.1f sim s/s (%.2fx)\n", substeps, step_rate, batched,
+	       batched / per_sample);
+
+	const double single = run(models, duration_s, step_rate, 1);
+	printf("single IMU sample per step (%d Hz):         %8.1f sim s/s\n", step_rate, single);
+
+	return 0;
+}
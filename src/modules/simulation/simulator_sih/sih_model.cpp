@@ -0,0 +1,463 @@
+/****************************************************************************
+*
+*   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+* 3. Neither the name PX4 nor the names of its contributors may be
+*    used to endorse or promote products derived from this software
+*    without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+* ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+****************************************************************************/
+
+/**
+ * @file sih_model.cpp
+ * Vehicle model of the Simulator in Hardware
+ *
+ * @author Romain Chiappinelli      <romain.chiap@gmail.com>
+ */
+
+#include "sih_model.hpp"
+
+using namespace math;
+using namespace matrix;
+
+// store the parameters in a more convenient form
+void SihModel::set_params(const Params &params)
+{
+	_vehicle = (VehicleType)constrain(params.vehicle_type, static_cast<int32_t>(0), static_cast<int32_t>(2));
+
+	_T_MAX = params.t_max;
+	_Q_MAX = params.q_max;
+	_L_ROLL = params.l_roll;
+	_L_PITCH = params.l_pitch;
+	_KDV = params.kdv;
+	_KDW = params.kdw;
+	_H0 = params.h0;
+
+	_LAT0 = (double)params.lat0 * 1.0e-7;
+	_LON0 = (double)params.lon0 * 1.0e-7;
+	_COS_LAT0 = cosl((long double)radians(_LAT0));
+
+	_MASS = params.mass;
+
+	_W_I = Vector3f(0.0f, 0.0f, _MASS * CONSTANTS_ONE_G);
+
+	_I = diag(Vector3f(params.ixx, params.iyy, params.izz));
+	_I(0, 1) = _I(1, 0) = params.ixy;
+	_I(0, 2) = _I(2, 0) = params.ixz;
+	_I(1, 2) = _I(2, 1) = params.iyz;
+
+	// guards against too small determinants
+	_Im1 = 100.0f * inv(static_cast<typeof _I>(100.0f * _I));
+
+	_mu_I = Vector3f(params.mu_x, params.mu_y, params.mu_z);
+
+	_baro_offset_m = params.baro_offset;
+	_mag_offset_x = params.mag_offset_x;
+	_mag_offset_y = params.mag_offset_y;
+	_mag_offset_z = params.mag_offset_z;
+
+	_T_TAU = params.t_tau;
+}
+
+// initialization of the variables for the simulator
+void SihModel::reset()
+{
+	_p_I = Vector3f(0.0f, 0.0f, 0.0f);
+	_v_I = Vector3f(0.0f, 0.0f, 0.0f);
+	_q = Quatf(1.0f, 0.0f, 0.0f, 0.0f);
+	_w_B = Vector3f(0.0f, 0.0f, 0.0f);
+
+	for (int i = 0; i < NB_MOTORS; i++) {
+		_u[i] = _u_sp[i] = 0.0f;
+	}
+
+	_u_sp_updated = false;
+	_grounded = true;
+}
+
+void SihModel::set_actuator_setpoints(const float u_sp[NB_MOTORS])
+{
+	for (int i = 0; i < NB_MOTORS; i++) {
+		_u_sp[i] = u_sp[i];
+	}
+
+	_u_sp_updated = true;
+}
+
+void SihModel::step(float dt)
+{
+	_dt = dt;
+
+	update_motors();
+
+	generate_force_and_torques();
+
+	equations_of_motion();
+
+	reconstruct_imu();
+
+	reconstruct_sensors_signals();
+}
+
+void SihModel::step(float dt, int substeps, ImuBatch &imu)
+{
+	substeps = constrain(substeps, 1, MAX_SUBSTEPS);
+
+	// the motors follow the setpoints of the whole step
+	_dt = dt;
+	update_motors();
+
+	_dt = dt / substeps;
+	imu.samples = substeps;
+	imu.dt = _dt;
+
+	for (int axis = 0; axis < 6; axis++) {
+		generate_wgn_batch(_imu_noise[axis], substeps);
+	}
+
+	// forces and moments change at the rate of the actuators, evaluate them once and hold them over the
+	// sub-steps, only the rigid body is integrated at the IMU rate
+	generate_force_and_torques();
+
+	for (int i = 0; i < substeps; i++) {
+		equations_of_motion();
+
+		const Vector3f acc = specific_force();
+		imu.accel_x[i] = acc(0);
+		imu.accel_y[i] = acc(1);
+		imu.accel_z[i] = acc(2);
+		imu.gyro_x[i] = _w_B(0);
+		imu.gyro_y[i] = _w_B(1);
+		imu.gyro_z[i] = _w_B(2);
+	}
+
+	// add the noise of all the samples in a single pass, same levels as reconstruct_imu()
+	for (int i = 0; i < substeps; i++) {
+		imu.accel_x[i] += 0.5f * _imu_noise[0][i];
+		imu.accel_y[i] += 1.7f * _imu_noise[1][i];
+		imu.accel_z[i] += 1.4f * _imu_noise[2][i];
+		imu.gyro_x[i] += 0.14f * _imu_noise[3][i];
+		imu.gyro_y[i] += 0.07f * _imu_noise[4][i];
+		imu.gyro_z[i] += 0.03f * _imu_noise[5][i];
+	}
+
+	const int last = substeps - 1;
+	_sensors.accel[0] = imu.accel_x[last];
+	_sensors.accel[1] = imu.accel_y[last];
+	_sensors.accel[2] = imu.accel_z[last];
+	_sensors.gyro[0] = imu.gyro_x[last];
+	_sensors.gyro[1] = imu.gyro_y[last];
+	_sensors.gyro[2] = imu.gyro_z[last];
+
+	reconstruct_sensors_signals();
+}
+
+// apply the new motor setpoints
+void SihModel::update_motors()
+{
+	if (!_u_sp_updated) {
+		return;
+	}
+
+	_u_sp_updated = false;
+
+	for (int i = 0; i < NB_MOTORS; i++) {
+		if ((_vehicle == VehicleType::FW && i < 3) || (_vehicle == VehicleType::TS && i > 3)) {
+			_u[i] = _u_sp[i]; // control surfaces
+
+		} else {
+			_u[i] = _u[i] + _dt / _T_TAU * (_u_sp[i] - _u[i]); // first order transfer function with time constant tau
+		}
+	}
+}
+
+// generate the motors thrust and torque in the body frame
+void SihModel::generate_force_and_torques()
+{
+	if (_vehicle == VehicleType::MC) {
+		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (+_u[0] + _u[1] + _u[2] + _u[3]));
+		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (-_u[0] + _u[1] + _u[2] - _u[3]),
+				 _L_PITCH * _T_MAX * (+_u[0] - _u[1] + _u[2] - _u[3]),
+				 _Q_MAX * (+_u[0] + _u[1] - _u[2] - _u[3]));
+		_Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
+		_Ma_B = -_KDW * _w_B;   // first order angular damper
+
+	} else if (_vehicle == VehicleType::FW) {
+		_T_B = Vector3f(_T_MAX * _u[3], 0.0f, 0.0f); 	// forward thruster
+		// _Mt_B = Vector3f(_Q_MAX*_u[3], 0.0f,0.0f); 	// thruster torque
+		_Mt_B = Vector3f();
+		generate_fw_aerodynamics();
+
+	} else if (_vehicle == VehicleType::TS) {
+		_T_B = Vector3f(0.0f, 0.0f, -_T_MAX * (_u[0] + _u[1]));
+		_Mt_B = Vector3f(_L_ROLL * _T_MAX * (_u[1] - _u[0]), 0.0f, _Q_MAX * (_u[1] - _u[0]));
+		generate_ts_aerodynamics();
+
+		// _Fa_I = -_KDV * _v_I;   // first order drag to slow down the aircraft
+		// _Ma_B = -_KDW * _w_B;   // first order angular damper
+	}
+}
+
+void SihModel::generate_fw_aerodynamics()
+{
+	_v_B = _C_IB.transpose() * _v_I; 	// velocity in body frame [m/s]
+	float altitude = _H0 - _p_I(2);
+	_wing_l.update_aero(_v_B, _w_B, altitude, _u[0]*FLAP_MAX);
+	_wing_r.update_aero(_v_B, _w_B, altitude, -_u[0]*FLAP_MAX);
+	_tailplane.update_aero(_v_B, _w_B, altitude, _u[1]*FLAP_MAX, _T_MAX * _u[3]);
+	_fin.update_aero(_v_B, _w_B, altitude, _u[2]*FLAP_MAX, _T_MAX * _u[3]);
+	_fuselage.update_aero(_v_B, _w_B, altitude);
+	_Fa_I = _C_IB * (_wing_l.get_Fa() + _wing_r.get_Fa() + _tailplane.get_Fa() + _fin.get_Fa() + _fuselage.get_Fa())
+		- _KDV * _v_I; 	// sum of aerodynamic forces
+	_Ma_B = _wing_l.get_Ma() + _wing_r.get_Ma() + _tailplane.get_Ma() + _fin.get_Ma() + _fuselage.get_Ma() - _KDW *
+		_w_B; 	// aerodynamic moments
+}
+
+void SihModel::generate_ts_aerodynamics()
+{
+	_v_B = _C_IB.transpose() * _v_I; // velocity in body frame [m/s]
+	Vector3f Fa_ts = Vector3f();
+	Vector3f Ma_ts = Vector3f();
+	Vector3f v_ts = _C_BS.transpose() *
+			_v_B; // the aerodynamic is resolved in a frame like a standard aircraft (nose-right-belly)
+	Vector3f w_ts = _C_BS.transpose() * _w_B;
+	float altitude = _H0 - _p_I(2);
+
+	for (int i = 0; i < NB_TS_SEG; i++) {
+		if (i <= NB_TS_SEG / 2) {
+			_ts[i].update_aero(v_ts, w_ts, altitude, _u[5]*TS_DEF_MAX, _T_MAX * _u[1]);
+
+		} else {
+			_ts[i].update_aero(v_ts, w_ts, altitude, -_u[4]*TS_DEF_MAX, _T_MAX * _u[0]);
+		}
+
+		Fa_ts += _ts[i].get_Fa();
+		Ma_ts += _ts[i].get_Ma();
+	}
+
+	_Fa_I = _C_IB * _C_BS * Fa_ts - _KDV * _v_I; 	// sum of aerodynamic forces
+	_Ma_B = _C_BS * Ma_ts - _KDW * _w_B; 	// aerodynamic moments
+}
+
+// apply the equations of motion of a rigid body and integrate one step
+void SihModel::equations_of_motion()
+{
+	_C_IB = matrix::Dcm<float>(_q); // body to inertial transformation
+
+	// Equations of motion of a rigid body
+	_p_I_dot = _v_I;                        // position differential
+	_v_I_dot = (_W_I + _Fa_I + _C_IB * _T_B) / _MASS;   // conservation of linear momentum
+	// _q_dot = _q.derivative1(_w_B);              // attitude differential
+	_dq = Quatf::expq(0.5f * _dt * _w_B);
+	_w_B_dot = _Im1 * (_Mt_B + _Ma_B - _w_B.cross(_I * _w_B)); // conservation of angular momentum
+
+	// fake ground, avoid free fall
+	if (_p_I(2) > 0.0f && (_v_I_dot(2) > 0.0f || _v_I(2) > 0.0f)) {
+		if (_vehicle == VehicleType::MC || _vehicle == VehicleType::TS) {
+			if (!_grounded) {    // if we just hit the floor
+				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
+				_v_I_dot = -_v_I / _dt;
+
+			} else {
+				_v_I_dot.setZero();
+			}
+
+			_v_I.setZero();
+			_w_B.setZero();
+			_grounded = true;
+
+		} else if (_vehicle == VehicleType::FW) {
+			if (!_grounded) {    // if we just hit the floor
+				// for the accelerometer, compute the acceleration that will stop the vehicle in one time step
+				_v_I_dot(2) = -_v_I(2) / _dt;
+
+			} else {
+				// we only allow negative acceleration in order to takeoff
+				_v_I_dot(2) = fminf(_v_I_dot(2), 0.0f);
+			}
+
+			// integration: Euler forward
+			_p_I = _p_I + _p_I_dot * _dt;
+			_v_I = _v_I + _v_I_dot * _dt;
+			Eulerf RPY = Eulerf(_q);
+			RPY(0) = 0.0f;	// no roll
+			RPY(1) = radians(0.0f); // pitch slightly up if needed to get some lift
+			_q = Quatf(RPY);
+			_w_B.setZero();
+			_grounded = true;
+		}
+
+	} else {
+		// integration: Euler forward
+		_p_I = _p_I + _p_I_dot * _dt;
+		_v_I = _v_I + _v_I_dot * _dt;
+		_q = _q * _dq;
+		_q.normalize();
+		// integration Runge-Kutta 4
+		// rk4_update(_p_I, _v_I, _q, _w_B);
+		_w_B = constrain(_w_B + _w_B_dot * _dt, -6.0f * M_PI_F, 6.0f * M_PI_F);
+		_grounded = false;
+	}
+}
+
+// SihModel::States SihModel::eom_f(States x) 	// equations of motion f: x'=f(x)
+// {
+// 	States x_dot{}; 	// dx/dt
+
+// 	Dcmf C_IB = matrix::Dcm<float>(x.q); // body to inertial transformation
+// 	// Equations of motion of a rigid body
+// 	x_dot.p_I = x.v_I;                        // position differential
+// 	x_dot.v_I = (_W_I + _Fa_I + C_IB * _T_B) / _MASS;   // conservation of linear momentum
+// 	x_dot.q = x.q.derivative1(x.w_B);              // attitude differential
+// 	x_dot.w_B = _Im1 * (_Mt_B + _Ma_B - x.w_B.cross(_I * x.w_B)); // conservation of angular momentum
+
+// 	return x_dot;
+// }
+
+// The sensor signals reconstruction and noise levels are from [1]
+// [1] Bulka, Eitan, and Meyer Nahon. "Autonomous fixed-wing aerobatics: from theory to flight."
+//     In 2018 IEEE International Conference on Robotics and Automation (ICRA), pp. 6573-6580. IEEE, 2018.
+
+// specific force measured by the accelerometer in body frame
+Vector3f SihModel::specific_force() const
+{
+	return _C_IB.transpose() * (_v_I_dot - Vector3f(0.0f, 0.0f, CONSTANTS_ONE_G));
+}
+
+// reconstruct the noisy IMU signals
+void SihModel::reconstruct_imu()
+{
+	const Vector3f acc = specific_force() + noiseGauss3f(0.5f, 1.7f, 1.4f);
+	const Vector3f gyro = _w_B + noiseGauss3f(0.14f, 0.07f, 0.03f);
+	acc.copyTo(_sensors.accel);
+	gyro.copyTo(_sensors.gyro);
+}
+
+// reconstruct the other noisy sensor signals and the groundtruth
+void SihModel::reconstruct_sensors_signals()
+{
+	// magnetometer
+	const Vector3f mag = _C_IB.transpose() * _mu_I + noiseGauss3f(0.02f, 0.02f, 0.03f);
+	_sensors.mag[0] = mag(0) + _mag_offset_x;
+	_sensors.mag[1] = mag(1) + _mag_offset_y;
+	_sensors.mag[2] = mag(2) + _mag_offset_z;
+
+	// barometer
+	float altitude = (_H0 - _p_I(2)) + _baro_offset_m + generate_wgn() * 0.14f; // altitude with noise
+	_sensors.baro_pressure_mbar = CONSTANTS_STD_PRESSURE_MBAR *        // reconstructed pressure in mBar
+				      powf((1.0f + altitude * TEMP_GRADIENT / T1_K), -CONSTANTS_ONE_G / (TEMP_GRADIENT * CONSTANTS_AIR_GAS_CONST));
+	_sensors.baro_temperature_c = T1_K + CONSTANTS_ABSOLUTE_NULL_CELSIUS + TEMP_GRADIENT *
+				      altitude; // reconstructed temperture in Celsius
+
+	// GPS
+	_sensors.lat = _LAT0 + degrees((double)_p_I(0) / CONSTANTS_RADIUS_OF_EARTH);
+	_sensors.lon = _LON0 + degrees((double)_p_I(1) / CONSTANTS_RADIUS_OF_EARTH) / _COS_LAT0;
+	_sensors.alt = _H0 - _p_I(2);
+
+	_sensors.gps_lat = _sensors.lat + degrees((double)generate_wgn() * 0.2 / CONSTANTS_RADIUS_OF_EARTH);
+	_sensors.gps_lon = _sensors.lon + degrees((double)generate_wgn() * 0.2 / CONSTANTS_RADIUS_OF_EARTH) / _COS_LAT0;
+	_sensors.gps_alt = _sensors.alt + generate_wgn() * 0.5f;
+	const Vector3f gps_vel = _v_I + noiseGauss3f(0.06f, 0.077f, 0.158f);
+	gps_vel.copyTo(_sensors.gps_vel);
+
+	// airspeed
+	if (_vehicle == VehicleType::FW || _vehicle == VehicleType::TS) {
+		_sensors.true_airspeed = fmaxf(0.1f, _v_B(0) + generate_wgn() * 0.2f);
+		_sensors.indicated_airspeed = _sensors.true_airspeed * sqrtf(_wing_l.get_rho() / RHO);
+	}
+
+	// distance sensor
+	_sensors.distance_bottom = -_p_I(2) / _C_IB(2, 2);
+
+	// groundtruth
+	_q.copyTo(_sensors.q);
+	_w_B.copyTo(_sensors.w_B);
+	_sensors.grounded = _grounded;
+}
+
+float SihModel::generate_wgn()   // generate white Gaussian noise sample with std=1
+{
+	// algorithm 1:
+	// float temp=((float)(rand()+1))/(((float)RAND_MAX+1.0f));
+	// return sqrtf(-2.0f*logf(temp))*cosf(2.0f*M_PI_F*rand()/RAND_MAX);
+	// algorithm 2: from BlockRandGauss.hpp
+	static float V1, V2, S;
+	static bool phase = true;
+	float X;
+
+	if (phase) {
+		do {
+			float U1 = (float)rand() / (float)RAND_MAX;
+			float U2 = (float)rand() / (float)RAND_MAX;
+			V1 = 2.0f * U1 - 1.0f;
+			V2 = 2.0f * U2 - 1.0f;
+			S = V1 * V1 + V2 * V2;
+		} while (S >= 1.0f || fabsf(S) < 1e-8f);
+
+		X = V1 * float(sqrtf(-2.0f * float(logf(S)) / S));
+
+	} else {
+		X = V2 * float(sqrtf(-2.0f * float(logf(S)) / S));
+	}
+
+	phase = !phase;
+	return X;
+}
+
+void SihModel::generate_wgn_batch(float *out, int n)
+{
+	// rand() is too slow (and locked) to be called for every sample at kHz rates
+	static uint32_t state = 0;
+
+	if (state == 0) {
+		state = (uint32_t)rand() | 1u;
+	}
+
+	for (int i = 0; i < n; i += 2) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		const float u1 = ((state >> 8) + 1) * (1.0f / 16777216.0f); // (0, 1]
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		const float u2 = (state >> 8) * (1.0f / 16777216.0f);       // [0, 1)
+
+		const float r = sqrtf(-2.0f * logf(u1));
+		out[i] = r * cosf(2.0f * M_PI_F * u2);
+
+		if (i + 1 < n) {
+			out[i + 1] = r * sinf(2.0f * M_PI_F * u2);
+		}
+	}
+}
+
+// generate white Gaussian noise sample vector with specified std
+Vector3f SihModel::noiseGauss3f(float stdx, float stdy, float stdz)
+{
+	return Vector3f(generate_wgn() * stdx, generate_wgn() * stdy, generate_wgn() * stdz);
+}
+
@@ -0,0 +1,221 @@
+/****************************************************************************
+*
+*   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+* 3. Neither the name PX4 nor the names of its contributors may be
+*    used to endorse or promote products derived from this software
+*    without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+* ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+****************************************************************************/
+
+/**
+ * @file sih_model.hpp
+ * Vehicle model of the Simulator in Hardware (dynamics and sensor signals),
+ * independent of uORB so it can be stepped for many vehicles in one process.
+ *
+ * See sih.hpp for the references of the models.
+ */
+
+#pragma once
+
+#include "aero.hpp"
+
+#include <matrix/matrix/math.hpp>   // matrix, vectors, dcm, quaterions
+#include <conversion/rotation.h>    // math::radians,
+#include <lib/geo/geo.h>        // to get the physical constants
+
+class SihModel
+{
+public:
+	static constexpr int NB_MOTORS = 6;
+	static constexpr int MAX_SUBSTEPS = 32; // matches the sensor_gyro_fifo/sensor_accel_fifo length
+
+	enum class VehicleType {MC, FW, TS};
+
+	// parameters of the vehicle, see sih_params.c
+	struct Params {
+		int32_t vehicle_type;
+		float mass;
+		float ixx, iyy, izz, ixy, ixz, iyz;
+		float t_max, q_max, l_roll, l_pitch, kdv, kdw;
+		int32_t lat0, lon0;         // [1e-7 deg]
+		float h0;
+		float mu_x, mu_y, mu_z;
+		float baro_offset;
+		float mag_offset_x, mag_offset_y, mag_offset_z;
+		float t_tau;
+	};
+
+	// reconstructed sensor signals and groundtruth after a step, plain data to be shared between processes
+	struct Sensors {
+		float accel[3];             // [m/s^2]
+		float gyro[3];              // [rad/s]
+		float mag[3];               // [G]
+		float baro_pressure_mbar;
+		float baro_temperature_c;
+		double gps_lat, gps_lon;    // [deg]
+		float gps_alt;              // [m]
+		float gps_vel[3];           // NED [m/s]
+		float true_airspeed;        // [m/s]
+		float indicated_airspeed;   // [m/s]
+		float distance_bottom;      // distance to the ground along the body z axis [m]
+
+		// groundtruth
+		double lat, lon;            // [deg]
+		float alt;                  // [m]
+		float q[4];
+		float w_B[3];               // [rad/s]
+		bool grounded;
+	};
+
+	// IMU samples of the sub-steps of a batched step, one array per axis like the sensor FIFOs
+	struct ImuBatch {
+		int samples;
+		float dt;                   // interval between samples [s]
+		float accel_x[MAX_SUBSTEPS], accel_y[MAX_SUBSTEPS], accel_z[MAX_SUBSTEPS];  // [m/s^2]
+		float gyro_x[MAX_SUBSTEPS], gyro_y[MAX_SUBSTEPS], gyro_z[MAX_SUBSTEPS];     // [rad/s]
+	};
+
+	SihModel() = default;
+
+	void set_params(const Params &params);
+
+	// reset the vehicle to rest at the origin
+	void reset();
+
+	// new actuator setpoints in range [-1,1] for control surfaces and [0,1] for thrusters, applied at the next step
+	void set_actuator_setpoints(const float u_sp[NB_MOTORS]);
+
+	// integrate one step of dt [s] and reconstruct the sensor signals
+	void step(float dt);
+
+	// integrate one step of dt [s] as substeps equal sub-steps, sampling the IMU at the end of each of them,
+	// the forces and moments are held over the step and the other sensors are reconstructed once at its end
+	void step(float dt, int substeps, ImuBatch &imu);
+
+	const Sensors &sensors() const { return _sensors; }
+	VehicleType vehicle() const { return _vehicle; }
+
+	void print_status() const;
+
+	static float generate_wgn();    // generate white Gaussian noise sample
+
+	// generate n white Gaussian noise samples at once (Box-Muller on a xorshift generator seeded from rand())
+	static void generate_wgn_batch(float *out, int n);
+
+	// generate white Gaussian noise sample as a 3D vector with specified std
+	static matrix::Vector3f noiseGauss3f(float stdx, float stdy, float stdz);
+
+private:
+	// hard constants
+	static constexpr float T1_C = 15.0f;                        // ground temperature in Celsius
+	static constexpr float T1_K = T1_C - CONSTANTS_ABSOLUTE_NULL_CELSIUS;   // ground temperature in Kelvin
+	static constexpr float TEMP_GRADIENT  = -6.5f / 1000.0f;    // temperature gradient in degrees per metre
+	// Aerodynamic coefficients
+	static constexpr float RHO = 1.225f; 		// air density at sea level [kg/m^3]
+	static constexpr float SPAN = 0.86f; 	// wing span [m]
+	static constexpr float MAC = 0.21f; 	// wing mean aerodynamic chord [m]
+	static constexpr float RP = 0.1f; 	// radius of the propeller [m]
+	static constexpr float FLAP_MAX = M_PI_F / 12.0f; // 15 deg, maximum control surface deflection
+
+	void update_motors();
+	void generate_force_and_torques();
+	void equations_of_motion();
+	matrix::Vector3f specific_force() const;
+	void reconstruct_imu();
+	void reconstruct_sensors_signals();
+	void generate_fw_aerodynamics();
+	void generate_ts_aerodynamics();
+
+	float       _dt{0};         // sampling time [s]
+	bool        _grounded{true};// whether the vehicle is on the ground
+
+	matrix::Vector3f    _T_B;           // thrust force in body frame [N]
+	matrix::Vector3f    _Fa_I;          // aerodynamic force in inertial frame [N]
+	matrix::Vector3f    _Mt_B;          // thruster moments in the body frame [Nm]
+	matrix::Vector3f    _Ma_B;          // aerodynamic moments in the body frame [Nm]
+	matrix::Vector3f    _p_I;           // inertial position [m]
+	matrix::Vector3f    _v_I;           // inertial velocity [m/s]
+	matrix::Vector3f    _v_B;           // body frame velocity [m/s]
+	matrix::Vector3f    _p_I_dot;       // inertial position differential
+	matrix::Vector3f    _v_I_dot;       // inertial velocity differential
+	matrix::Quatf       _q;             // quaternion attitude
+	matrix::Dcmf        _C_IB;          // body to inertial transformation
+	matrix::Vector3f    _w_B;           // body rates in body frame [rad/s]
+	matrix::Quatf       _dq;            // quaternion differential
+	matrix::Vector3f    _w_B_dot;       // body rates differential
+	float       _u[NB_MOTORS] {};       // thruster signals
+	float       _u_sp[NB_MOTORS] {};    // thruster setpoints
+	bool        _u_sp_updated{false};
+
+	VehicleType _vehicle = VehicleType::MC;
+
+	// aerodynamic segments for the fixedwing
+	AeroSeg _wing_l = AeroSeg(SPAN / 2.0f, MAC, -4.0f, matrix::Vector3f(0.0f, -SPAN / 4.0f, 0.0f), 3.0f,
+				  SPAN / MAC, MAC / 3.0f);
+	AeroSeg _wing_r = AeroSeg(SPAN / 2.0f, MAC, -4.0f, matrix::Vector3f(0.0f, SPAN / 4.0f, 0.0f), -3.0f,
+				  SPAN / MAC, MAC / 3.0f);
+	AeroSeg _tailplane = AeroSeg(0.3f, 0.1f, 0.0f, matrix::Vector3f(-0.4f, 0.0f, 0.0f), 0.0f, -1.0f, 0.05f, RP);
+	AeroSeg _fin = AeroSeg(0.25, 0.18, 0.0f, matrix::Vector3f(-0.45f, 0.0f, -0.1f), -90.0f, -1.0f, 0.12f, RP);
+	AeroSeg _fuselage = AeroSeg(0.2, 0.8, 0.0f, matrix::Vector3f(0.0f, 0.0f, 0.0f), -90.0f);
+
+	// aerodynamic segments for the tailsitter
+	static constexpr const int NB_TS_SEG = 11;
+	static constexpr const float TS_AR = 3.13f;
+	static constexpr const float TS_CM = 0.115f;	// longitudinal position of the CM from trailing edge
+	static constexpr const float TS_RP = 0.0625f;	// propeller radius [m]
+	static constexpr const float TS_DEF_MAX = math::radians(39.0f); 	// max deflection
+	matrix::Dcmf _C_BS = matrix::Dcmf(matrix::Eulerf(0.0f, math::radians(90.0f), 0.0f)); // segment to body 90 deg pitch
+	AeroSeg _ts[NB_TS_SEG] = {
+		AeroSeg(0.0225f, 0.110f, 0.0f, matrix::Vector3f(0.083f - TS_CM, -0.239f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0383f, 0.125f, 0.0f, matrix::Vector3f(0.094f - TS_CM, -0.208f, 0.0f), 0.0f, TS_AR, 0.063f),
+		// AeroSeg(0.0884f, 0.148f, 0.0f, matrix::Vector3f(0.111f-TS_CM, -0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0884f, 0.085f, 0.0f, matrix::Vector3f(0.158f - TS_CM, -0.143f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0884f, 0.063f, 0.0f, matrix::Vector3f(0.047f - TS_CM, -0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0633f, 0.176f, 0.0f, matrix::Vector3f(0.132f - TS_CM, -0.068f, 0.0f), 0.0f, TS_AR, 0.063f),
+		AeroSeg(0.0750f, 0.231f, 0.0f, matrix::Vector3f(0.173f - TS_CM,  0.000f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0633f, 0.176f, 0.0f, matrix::Vector3f(0.132f - TS_CM,  0.068f, 0.0f), 0.0f, TS_AR, 0.063f),
+		// AeroSeg(0.0884f, 0.148f, 0.0f, matrix::Vector3f(0.111f-TS_CM,  0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0884f, 0.085f, 0.0f, matrix::Vector3f(0.158f - TS_CM,  0.143f, 0.0f), 0.0f, TS_AR),
+		AeroSeg(0.0884f, 0.063f, 0.0f, matrix::Vector3f(0.047f - TS_CM,  0.143f, 0.0f), 0.0f, TS_AR, 0.063f, TS_RP),
+		AeroSeg(0.0383f, 0.125f, 0.0f, matrix::Vector3f(0.094f - TS_CM,  0.208f, 0.0f), 0.0f, TS_AR, 0.063f),
+		AeroSeg(0.0225f, 0.110f, 0.0f, matrix::Vector3f(0.083f - TS_CM,  0.239f, 0.0f), 0.0f, TS_AR)
+	};
+
+	// sensors reconstruction
+	Sensors _sensors{};
+	float _imu_noise[6][MAX_SUBSTEPS] {};   // noise of the IMU samples of a batched step, per axis
+
+	// parameters
+	float _MASS, _T_MAX, _Q_MAX, _L_ROLL, _L_PITCH, _KDV, _KDW, _H0, _T_TAU;
+	double _LAT0, _LON0, _COS_LAT0;
+	matrix::Vector3f _W_I;  // weight of the vehicle in inertial frame [N]
+	matrix::Matrix3f _I;    // vehicle inertia matrix
+	matrix::Matrix3f _Im1;  // inverse of the inertia matrix
+	matrix::Vector3f _mu_I; // NED magnetic field in inertial frame [G]
+
+	float _baro_offset_m, _mag_offset_x, _mag_offset_y, _mag_offset_z;
+};
@@ -446,3 +446,19 @@ PARAM_DEFINE_FLOAT(SIH_T_TAU, 0.05f);
  * @group Simulation In Hardware
  */
 PARAM_DEFINE_INT32(SIH_VEHICLE_TYPE, 0);
+
+/**
+ * IMU FIFO sample rate
+ *
+ * If not 0, every simulation step is integrated as several sub-steps and the
+ * accelerometer and gyroscope samples of all the sub-steps are published as
+ * sensor_accel_fifo and sensor_gyro_fifo, like a FIFO IMU driver. Up to 32
+ * samples per step, not supported with the multi-vehicle server.
+ *
+ * @unit Hz
+ * @min 0
+ * @max 32000
+ * @reboot_required true
+ * @group Simulation In Hardware
+ */
+PARAM_DEFINE_INT32(SIH_IMU_RATE, 0);
@@ -0,0 +1,276 @@
+/****************************************************************************
+*
+*   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+* 3. Neither the name PX4 nor the names of its contributors may be
+*    used to endorse or promote products derived from this software
+*    without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+* ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+****************************************************************************/
+
+/**
+ * @file sih_server.cpp
+ * Multi-vehicle SIH server (px4_sih_server)
+ *
+ * Steps the vehicle models of many PX4 instances in a single process. Each PX4
+ * instance runs `simulator_sih start -s <index>` and exchanges its sensors and
+ * actuators with the server through shared memory (see sih_shm.hpp), so no
+ * simulation thread or socket per vehicle is needed. All vehicles are stepped
+ * in a batch and share the same simulation time.
+ */
+
+#include "sih_model.hpp"
+#include "sih_shm.hpp"
+
+#include <getopt.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <vector>
+
+static volatile sig_atomic_t should_exit = 0;
+
+static void signal_handler(int)
+{
+	should_exit = 1;
+}
+
+// Get current timestamp in microseconds
+static uint64_t micros()
+{
+	struct timeval t;
+	gettimeofday(&t, nullptr);
+	return t.tv_sec * ((uint64_t)1000000) + t.tv_usec;
+}
+
+static void usage(const char *name)
+{
+	printf("Multi-vehicle SIH server, PX4 instances connect with 'simulator_sih start -s <index>'\n\n");
+	printf("usage: %s [-n <vehicles>] [-r <rate>] [-f <speed factor>] [-t <timeout>]\n", name);
+	printf("  -n <vehicles>      maximum number of vehicles (default 16, max %d)\n", sih_shm::MAX_VEHICLES);
+	printf("  -r <rate>          simulation rate in Hz (default 250)\n");
+	printf("  -f <speed factor>  speed factor, 0 to run as fast as possible (default PX4_SIM_SPEED_FACTOR or 1)\n");
+	printf("  -t <timeout>       wall time in ms until a vehicle not responding is dropped (default 5000)\n");
+	printf("                     a dropped vehicle reconnects and continues, 0 to never drop\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int num_vehicles = 16;
+	int rate = 250;
+	float speed_factor = 1.f;
+	int timeout_ms = 5000;
+	const char *speedup = getenv("PX4_SIM_SPEED_FACTOR");
+
+	if (speedup) {
+		speed_factor = atof(speedup);
+	}
+
+	int ch;
+
+	while ((ch = getopt(argc, argv, "n:r:f:t:h")) != -1) {
+		switch (ch) {
+		case 'n':
+			num_vehicles = atoi(optarg);
+			break;
+
+		case 'r':
+			rate = atoi(optarg);
+			break;
+
+		case 'f':
+			speed_factor = atof(optarg);
+			break;
+
+		case 't':
+			timeout_ms = atoi(optarg);
+			break;
+
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (num_vehicles < 1 || num_vehicles > sih_shm::MAX_VEHICLES || rate <= 0 || speed_factor < 0.f
+	    || timeout_ms < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	// 200 - 2000 Hz, as the lockstep loop of simulator_sih
+	const int sim_interval_us = math::constrain(int(roundf(1e6f / rate)), 500, 5000);
+	const int rt_interval_us = speed_factor > 0.f ? int(roundf(sim_interval_us / speed_factor)) : 0;
+	const float dt = sim_interval_us * 1e-6f;
+
+	sih_shm::Layout *shm = sih_shm::create(num_vehicles);
+
+	if (shm == nullptr) {
+		printf("failed to create the shared memory %s\n", sih_shm::NAME);
+		return 1;
+	}
+
+	signal(SIGINT, signal_handler);
+	signal(SIGTERM, signal_handler);
+
+	printf("Simulating up to %d vehicles with %d us sim time interval, speed factor %.1f\n", num_vehicles, sim_interval_us,
+	       (double)speed_factor);
+
+	srand(1234);    // initialize the random seed once before calling generate_wgn()
+
+	// models are kept contiguous, so a step of all vehicles is a tight loop
+	std::vector<SihModel> models(num_vehicles);
+	std::vector<SihModel::Params> model_params(num_vehicles);
+	std::vector<bool> model_initialized(num_vehicles, false);
+	std::vector<int> active;
+	active.reserve(num_vehicles);
+
+	uint64_t time_us = 0;
+	uint32_t step = 0;
+
+	uint64_t stats_wall_time_us = micros();
+	uint32_t stats_steps = 0;
+
+	while (!should_exit) {
+		const uint64_t pre_compute_wall_time_us = micros();
+
+		// reset the models of the newly connected vehicles and collect the active ones
+		active.clear();
+
+		for (int i = 0; i < num_vehicles; i++) {
+			sih_shm::Slot &slot = shm->slots[i];
+			const sih_shm::SlotState state = (sih_shm::SlotState)slot.state.load();
+
+			if (state == sih_shm::SlotState::Connecting || state == sih_shm::SlotState::Reconnecting) {
+				// a vehicle dropped for being too slow continues where it was,
+				// its estimator kept running
+				const bool same_params = !memcmp(&model_params[i], &slot.params, sizeof(slot.params));
+				const bool resume = (state == sih_shm::SlotState::Reconnecting) && model_initialized[i]
+						    && same_params;
+
+				if (!resume) {
+					model_params[i] = slot.params;
+					models[i].set_params(model_params[i]);
+					models[i].reset();
+					model_initialized[i] = true;
+				}
+
+				slot.actuators_updated = false;
+				slot.state.store((uint32_t)sih_shm::SlotState::Active);
+				printf("vehicle %d %s\n", i, resume ? "reconnected" : "connected");
+			}
+
+			if (slot.state.load() == (uint32_t)sih_shm::SlotState::Active) {
+				active.push_back(i);
+			}
+		}
+
+		if (active.empty()) {
+			usleep(10000);
+			continue;
+		}
+
+		time_us += sim_interval_us;
+		step++;
+
+		// step all the vehicles with the actuators of the previous step
+		for (int i : active) {
+			sih_shm::Slot &slot = shm->slots[i];
+
+			if (slot.actuators_updated) {
+				models[i].set_actuator_setpoints(slot.actuators);
+			}
+
+			models[i].step(dt);
+		}
+
+		// then wake them up together
+		for (int i : active) {
+			sih_shm::Slot &slot = shm->slots[i];
+			slot.sensors = models[i].sensors();
+			slot.time_us = time_us;
+			slot.step = step;
+			sem_post(&slot.sensors_ready);
+		}
+
+		// wait until every vehicle replied with its actuators, drop the ones not responding
+		while (!should_exit) {
+			bool all_replied = true;
+
+			for (int i : active) {
+				const sih_shm::Slot &slot = shm->slots[i];
+
+				if (slot.step_ack != step && slot.state.load() == (uint32_t)sih_shm::SlotState::Active) {
+					all_replied = false;
+					break;
+				}
+			}
+
+			if (all_replied) {
+				break;
+			}
+
+			// the vehicles reconnect by themselves once they respond again
+			const uint32_t timeout_us = timeout_ms > 0 ? (uint32_t)timeout_ms * 1000 : 1000000;
+
+			if (!sih_shm::timed_wait(&shm->actuators_ready, timeout_us) && timeout_ms > 0) {
+				for (int i : active) {
+					sih_shm::Slot &slot = shm->slots[i];
+
+					if (slot.step_ack != step && slot.state.load() == (uint32_t)sih_shm::SlotState::Active) {
+						printf("vehicle %d not responding, disconnected\n", i);
+						slot.state.store((uint32_t)sih_shm::SlotState::Free);
+					}
+				}
+			}
+		}
+
+		stats_steps++;
+		const uint64_t current_wall_time_us = micros();
+
+		if (current_wall_time_us - stats_wall_time_us > 5000000) {
+			const float elapsed_s = (current_wall_time_us - stats_wall_time_us) * 1e-6f;
+			printf("%zu vehicles, %.0f steps/s, %.2fx realtime\n", active.size(), (double)(stats_steps / elapsed_s),
+			       (double)(stats_steps * dt / elapsed_s));
+			stats_wall_time_us = current_wall_time_us;
+			stats_steps = 0;
+		}
+
+		const int sleep_time = rt_interval_us - (int)(current_wall_time_us - pre_compute_wall_time_us);
+
+		if (sleep_time > 0) {
+			usleep(sleep_time);
+		}
+	}
+
+	shm_unlink(sih_shm::NAME);
+	sih_shm::unmap(shm);
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+/****************************************************************************
+*
+*   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+* 1. Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+* 3. Neither the name PX4 nor the names of its contributors may be
+*    used to endorse or promote products derived from this software
+*    without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+* ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+****************************************************************************/
+
+/**
+ * @file sih_shm.hpp
+ * Shared memory between the multi-vehicle SIH server (px4_sih_server) and the
+ * PX4 instances running simulator_sih as a client (simulator_sih start -s <index>).
+ *
+ * Every step the server integrates the models of all active vehicles, writes their
+ * sensors and posts each sensors_ready semaphore. Each vehicle publishes the sensors,
+ * runs its lockstep cycle, writes the actuator setpoints and posts actuators_ready.
+ */
+
+#pragma once
+
+#include "sih_model.hpp"
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <semaphore.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace sih_shm
+{
+
+static constexpr const char *NAME = "/px4_sih";
+static constexpr uint32_t MAGIC = 0x31484953; // "SIH1"
+static constexpr int MAX_VEHICLES = 256;
+
+enum class SlotState : uint32_t {
+	Free = 0,       ///< no vehicle
+	Connecting,     ///< params written by the vehicle, the server resets the model at the next step
+	Active,         ///< stepped by the server
+	Reconnecting    ///< as Connecting after being dropped, the model keeps its state if the params are the same
+};
+
+struct Slot {
+	std::atomic<uint32_t> state;
+	sem_t sensors_ready;            ///< posted by the server when sensors holds a new step
+	uint32_t step;                  ///< server step of sensors
+	uint32_t step_ack;              ///< last step the vehicle replied to (written by the vehicle)
+	uint64_t time_us;               ///< simulation time of sensors
+	SihModel::Params params;        ///< written by the vehicle before connecting
+	SihModel::Sensors sensors;
+	float actuators[SihModel::NB_MOTORS];
+	bool actuators_updated;         ///< actuators hold new setpoints
+};
+
+struct Layout {
+	uint32_t magic;
+	uint32_t num_slots;
+	sem_t actuators_ready;          ///< posted by each vehicle after writing its actuators
+	Slot slots[MAX_VEHICLES];
+};
+
+/**
+ * Create (or replace) the shared memory, to be called by the server.
+ * @return mapped layout or nullptr on error
+ */
+static inline Layout *create(int num_slots)
+{
+	shm_unlink(NAME);
+	int fd = shm_open(NAME, O_CREAT | O_EXCL | O_RDWR, 0666);
+
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	if (ftruncate(fd, sizeof(Layout)) != 0) {
+		close(fd);
+		shm_unlink(NAME);
+		return nullptr;
+	}
+
+	void *ptr = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (ptr == MAP_FAILED) {
+		shm_unlink(NAME);
+		return nullptr;
+	}
+
+	Layout *layout = static_cast<Layout *>(ptr);
+	memset(ptr, 0, sizeof(Layout));
+	sem_init(&layout->actuators_ready, 1, 0);
+
+	for (int i = 0; i < MAX_VEHICLES; i++) {
+		new (&layout->slots[i].state) std::atomic<uint32_t> {(uint32_t)SlotState::Free};
+		sem_init(&layout->slots[i].sensors_ready, 1, 0);
+	}
+
+	layout->num_slots = num_slots;
+	std::atomic_thread_fence(std::memory_order_release);
+	layout->magic = MAGIC;
+
+	return layout;
+}
+
+/**
+ * Open the shared memory created by the server, to be called by the vehicles.
+ * @return mapped layout or nullptr if the server is not running
+ */
+static inline Layout *open()
+{
+	int fd = shm_open(NAME, O_RDWR, 0);
+
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	void *ptr = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (ptr == MAP_FAILED) {
+		return nullptr;
+	}
+
+	Layout *layout = static_cast<Layout *>(ptr);
+
+	if (layout->magic != MAGIC) {
+		munmap(ptr, sizeof(Layout));
+		return nullptr;
+	}
+
+	return layout;
+}
+
+static inline void unmap(Layout *layout)
+{
+	munmap(layout, sizeof(Layout));
+}
+
+/**
+ * Wait on a semaphore of the shared memory with a timeout in wall time.
+ * @return true if the semaphore was taken
+ */
+static inline bool timed_wait(sem_t *sem, uint32_t timeout_us)
+{
+	timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	const uint64_t nsec = ts.tv_nsec + (uint64_t)timeout_us * 1000;
+	ts.tv_sec += nsec / 1000000000;
+	ts.tv_nsec = nsec % 1000000000;
+
+	int ret;
+
+	while ((ret = sem_timedwait(sem, &ts)) != 0 && errno == EINTR) {}
+
+	return ret == 0;
+}
+
+} // namespace sih_shm
@@ -57,6 +57,8 @@
 #include <inttypes.h>
 #include <sys/stat.h>
 
+#include <crc32.h>
+#include <lib/version/version.h>
 #include <parameters/param.h>
 #include "systemlib/err.h"
 
@@ -85,6 +87,7 @@ static int 	do_save(const char *param_file_name);
 static int	do_save_default();
 static int 	do_dump(const char *param_file_name);
 static int 	do_load(const char *param_file_name);
+static int	do_snapshot(const char *command, const char *snapshot_file_name, int argc, char *argv[]);
 static int	do_import(const char *param_file_name = nullptr);
 static int	do_show(const char *search_string, bool only_changed);
 static int	do_show_for_airframe();
@@ -139,6 +142,10 @@ $ reboot
 	PRINT_MODULE_USAGE_COMMAND_DESCR("dump", "Dump params from a file");
 	PRINT_MODULE_USAGE_ARG("<file>", "File name (use default if not given)", true);
 
+	PRINT_MODULE_USAGE_COMMAND_DESCR("snapshot", "Save/restore all params to/from a snapshot (POSIX)");
+	PRINT_MODULE_USAGE_ARG("load|save <file>", "Snapshot file name", false);
+	PRINT_MODULE_USAGE_ARG("<key1> [<key2>]", "Boot configuration, only restored with the same keys", true);
+
 	PRINT_MODULE_USAGE_COMMAND_DESCR("select", "Select default file");
 	PRINT_MODULE_USAGE_ARG("<file>", "File name", true);
 
@@ -239,6 +246,16 @@ param_main(int argc, char *argv[])
 			}
 		}
 
+		if (!strcmp(argv[1], "snapshot")) {
+			if (argc >= 4) {
+				return do_snapshot(argv[2], argv[3], argc - 4, argv + 4);
+
+			} else {
+				PX4_ERR("not enough arguments.\nTry 'param snapshot load|save <file> [<key1> ...]'");
+				return 1;
+			}
+		}
+
 		if (!strcmp(argv[1], "select")) {
 			if (argc >= 3) {
 				param_set_default_file(argv[2]);
@@ -511,9 +528,43 @@ do_load(const char *param_file_name)
 		return 1;
 	}
 
+	if (param_file_name && param_get_default_file() && (strcmp(param_file_name, param_get_default_file()) == 0)) {
+		// apply the changes saved since the default file was last written
+		param_load_default_journal();
+	}
+
 	return 0;
 }
 
+static int
+do_snapshot(const char *command, const char *snapshot_file_name, int argc, char *argv[])
+{
+	// the snapshot is only valid for the same boot configuration (e.g. airframe and instance)
+	uint32_t key = 0;
+
+	for (int i = 0; i < argc; i++) {
+		key = crc32part((const uint8_t *)argv[i], strlen(argv[i]) + 1, key);
+	}
+
+	const uint64_t build_id = px4_firmware_version_binary();
+
+	if (!strcmp(command, "load")) {
+		// silently fail, a missing or outdated snapshot is not an error
+		return (param_snapshot_load(snapshot_file_name, build_id, key) == 0) ? 0 : 1;
+
+	} else if (!strcmp(command, "save")) {
+		if (param_snapshot_save(snapshot_file_name, build_id, key) != 0) {
+			PX4_ERR("saving snapshot '%s' failed", snapshot_file_name);
+			return 1;
+		}
+
+		return 0;
+	}
+
+	PX4_ERR("unknown snapshot command '%s'", command);
+	return 1;
+}
+
 static int
 do_import(const char *param_file_name)
 {
@@ -551,6 +602,11 @@ do_import(const char *param_file_name)
 		return 1;
 	}
 
+	if (param_file_name && param_get_default_file() && (strcmp(param_file_name, param_get_default_file()) == 0)) {
+		// apply the changes saved since the default file was last written
+		param_load_default_journal();
+	}
+
 	return 0;
 }
 
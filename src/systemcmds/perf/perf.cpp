@@ -47,7 +47,7 @@ static void print_usage()
 
 	PRINT_MODULE_USAGE_NAME_SIMPLE("perf", "command");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("reset", "Reset all counters");
-	PRINT_MODULE_USAGE_COMMAND_DESCR("latency", "Print HRT timer latency histogram");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("latency", "Print HRT timer latency histogram (and callout jitter on POSIX)");
 
 	PRINT_MODULE_USAGE_PARAM_COMMENT("Prints all performance counters if no arguments given");
 }
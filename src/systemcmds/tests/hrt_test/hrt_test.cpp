@@ -54,6 +54,15 @@ px4::AppState HRTTest::appState;
 static struct hrt_call t1;
 static int update_interval = 1;
 
+static constexpr int periodic_count = 16;
+static struct hrt_call periodic_calls[periodic_count];
+static unsigned periodic_counters[periodic_count];
+
+static void periodic_expired(void *arg)
+{
+	periodic_counters[(intptr_t)arg]++;
+}
+
 static void timer_expired(void *arg)
 {
 	static int i = 0;
@@ -91,5 +100,25 @@ int HRTTest::main()
 	hrt_cancel(&t1);
 	PX4_INFO("HRT_CALL + %d\n", hrt_called(&t1));
 
+	// periodic callouts at 100 Hz to 1.6 kHz, then report how late they were invoked
+	memset(periodic_calls, 0, sizeof(periodic_calls));
+	memset(periodic_counters, 0, sizeof(periodic_counters));
+
+	for (int i = 0; i < periodic_count; i++) {
+		const hrt_abstime interval = 10000 / (i + 1);
+		hrt_call_every(&periodic_calls[i], interval, interval, periodic_expired, (void *)(intptr_t)i);
+	}
+
+	px4_sleep(1);
+
+#if defined(__PX4_POSIX)
+	hrt_print_callout_jitter(1 /* stdout */);
+#endif
+
+	for (int i = 0; i < periodic_count; i++) {
+		hrt_cancel(&periodic_calls[i]);
+		PX4_INFO("periodic callout %d: %u calls in 1 sec (expected %d)\n", i, periodic_counters[i], 100 * (i + 1));
+	}
+
 	return 0;
 }
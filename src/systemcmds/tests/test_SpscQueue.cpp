@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ *  Copyright (C) 2022 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <unit_test.h>
+#include <containers/SpscQueue.hpp>
+#include <pthread.h>
+
+class SpscQueueTest : public UnitTest
+{
+public:
+	virtual bool run_tests();
+
+	bool test_push_pop();
+	bool test_full();
+	bool test_wrap_around();
+	bool test_threaded();
+
+private:
+	static constexpr int THREADED_ITEMS{100000};
+	static void *producer(void *arg);
+};
+
+bool SpscQueueTest::run_tests()
+{
+	ut_run_test(test_push_pop);
+	ut_run_test(test_full);
+	ut_run_test(test_wrap_around);
+	ut_run_test(test_threaded);
+
+	return (_tests_failed == 0);
+}
+
+bool SpscQueueTest::test_push_pop()
+{
+	SpscQueue<int, 16> q;
+
+	ut_assert_true(q.empty());
+	ut_compare("size initially 0", q.size(), 0);
+
+	int item = -1;
+	ut_assert_false(q.pop(item));
+
+	for (int i = 0; i < 10; i++) {
+		ut_assert_true(q.push(i));
+		ut_compare("size increasing with i", q.size(), i + 1);
+	}
+
+	// items come out in FIFO order
+	for (int i = 0; i < 10; i++) {
+		ut_assert_true(q.pop(item));
+		ut_compare("FIFO order", item, i);
+	}
+
+	ut_assert_true(q.empty());
+	ut_assert_false(q.pop(item));
+
+	return true;
+}
+
+bool SpscQueueTest::test_full()
+{
+	SpscQueue<int, 8> q;
+
+	for (size_t i = 0; i < q.capacity(); i++) {
+		ut_assert_true(q.push(i));
+	}
+
+	ut_compare("size at capacity", q.size(), q.capacity());
+
+	// full queue rejects items and keeps the existing ones
+	ut_assert_false(q.push(100));
+
+	int item = -1;
+	ut_assert_true(q.pop(item));
+	ut_compare("oldest item", item, 0);
+
+	ut_assert_true(q.push(100));
+	ut_assert_false(q.push(101));
+
+	return true;
+}
+
+bool SpscQueueTest::test_wrap_around()
+{
+	SpscQueue<int, 4> q;
+
+	int item = -1;
+
+	for (int i = 0; i < 50; i++) {
+		ut_assert_true(q.push(2 * i));
+		ut_assert_true(q.push(2 * i + 1));
+		ut_compare("size 2", q.size(), 2);
+
+		ut_assert_true(q.pop(item));
+		ut_compare("wrap around order", item, 2 * i);
+		ut_assert_true(q.pop(item));
+		ut_compare("wrap around order", item, 2 * i + 1);
+	}
+
+	ut_assert_true(q.empty());
+
+	return true;
+}
+
+void *SpscQueueTest::producer(void *arg)
+{
+	SpscQueue<int, 64> *q = static_cast<SpscQueue<int, 64> *>(arg);
+
+	for (int i = 0; i < THREADED_ITEMS; i++) {
+		while (!q->push(i)) {
+			// spin until the consumer made space
+		}
+	}
+
+	return nullptr;
+}
+
+bool SpscQueueTest::test_threaded()
+{
+	SpscQueue<int, 64> q;
+
+	pthread_t thread;
+	ut_assert_true(pthread_create(&thread, nullptr, &SpscQueueTest::producer, &q) == 0);
+
+	int expected = 0;
+	bool in_order = true;
+
+	while (expected < THREADED_ITEMS) {
+		int item;
+
+		if (q.pop(item)) {
+			in_order = in_order && (item == expected);
+			expected++;
+		}
+	}
+
+	pthread_join(thread, nullptr);
+
+	ut_assert_true(in_order);
+	ut_assert_true(q.empty());
+
+	return true;
+}
+
+ut_declare_test_c(test_SpscQueue, SpscQueueTest)
@@ -63,6 +63,8 @@ int test_dataman(int argc, char *argv[]);
 
 #define DM_MAX_DATA_SIZE sizeof(struct mission_s)
 
+#define NUM_BULK_ITEMS_TEST 100
+
 static int
 task_main(int argc, char *argv[])
 {
@@ -155,6 +157,82 @@ fail:
 	return -1;
 }
 
+static int
+test_bulk(void)
+{
+	static struct mission_item_s items[NUM_BULK_ITEMS_TEST];
+	struct mission_item_s item;
+
+	/* upload a mission item by item, like the mavlink mission manager does */
+	hrt_abstime wstart = hrt_absolute_time();
+
+	for (unsigned i = 0; i < NUM_BULK_ITEMS_TEST; i++) {
+		memset(&item, 0, sizeof(item));
+		item.lat = 47.0 + i * 1e-4;
+		item.lon = 8.0 - i * 1e-4;
+		item.altitude = (float)i;
+		item.nav_cmd = NAV_CMD_WAYPOINT;
+
+		if (dm_write(DM_KEY_WAYPOINTS_OFFBOARD_1, i, &item, sizeof(item)) != sizeof(item)) {
+			PX4_ERR("bulk test: write %u failed", i);
+			return -1;
+		}
+	}
+
+	hrt_abstime rstart = hrt_absolute_time();
+
+	for (unsigned i = 0; i < NUM_BULK_ITEMS_TEST; i++) {
+		if (dm_read(DM_KEY_WAYPOINTS_OFFBOARD_1, i, &items[i], sizeof(items[i])) != sizeof(items[i])) {
+			PX4_ERR("bulk test: read %u failed", i);
+			return -1;
+		}
+	}
+
+	hrt_abstime bstart = hrt_absolute_time();
+
+	/* the bulk read stops at the first empty item */
+	memset(items, 0, sizeof(items));
+	ssize_t ret = dm_read_bulk(DM_KEY_WAYPOINTS_OFFBOARD_1, 0, items, sizeof(items[0]), NUM_BULK_ITEMS_TEST);
+
+	hrt_abstime bend = hrt_absolute_time();
+
+	if (ret != NUM_BULK_ITEMS_TEST) {
+		PX4_ERR("bulk test: bulk read returned %zd", ret);
+		return -1;
+	}
+
+	for (unsigned i = 0; i < NUM_BULK_ITEMS_TEST; i++) {
+		if (items[i].altitude != (float)i || items[i].nav_cmd != NAV_CMD_WAYPOINT) {
+			PX4_ERR("bulk test: data verification failed, index %u", i);
+			return -1;
+		}
+
+		items[i].altitude = -(float)i;
+	}
+
+	if (dm_write_bulk(DM_KEY_WAYPOINTS_OFFBOARD_1, 0, items, sizeof(items[0]), NUM_BULK_ITEMS_TEST) != NUM_BULK_ITEMS_TEST) {
+		PX4_ERR("bulk test: bulk write failed");
+		return -1;
+	}
+
+	if (dm_read(DM_KEY_WAYPOINTS_OFFBOARD_1, NUM_BULK_ITEMS_TEST - 1, &item, sizeof(item)) != sizeof(item)
+	    || item.altitude != -(float)(NUM_BULK_ITEMS_TEST - 1)) {
+		PX4_ERR("bulk test: data verification after bulk write failed");
+		return -1;
+	}
+
+	dm_clear(DM_KEY_WAYPOINTS_OFFBOARD_1);
+
+	if (dm_read_bulk(DM_KEY_WAYPOINTS_OFFBOARD_1, 0, items, sizeof(items[0]), NUM_BULK_ITEMS_TEST) != -1) {
+		PX4_ERR("bulk test: bulk read of cleared items failed");
+		return -1;
+	}
+
+	PX4_INFO("%d mission items: upload %" PRIu64 "us, load %" PRIu64 "us, bulk load %" PRIu64 "us",
+		 NUM_BULK_ITEMS_TEST, rstart - wstart, bstart - rstart, bend - bstart);
+	return 0;
+}
+
 int test_dataman(int argc, char *argv[])
 {
 	int i = 0;
@@ -215,5 +293,5 @@ int test_dataman(int argc, char *argv[])
 		}
 	}
 
-	return 0;
+	return test_bulk();
 }
@@ -101,6 +101,7 @@ const struct {
 	{"rc",			test_rc,		OPT_NOJIGTEST | OPT_NOALLTEST},
 	{"search_min",		test_search_min,	0},
 	{"sleep",		test_sleep,		OPT_NOJIGTEST},
+	{"SpscQueue",		test_SpscQueue,		0},
 	{"uart_loopback",	test_uart_loopback,	OPT_NOJIGTEST | OPT_NOALLTEST},
 	{"uart_send",		test_uart_send,		OPT_NOJIGTEST | OPT_NOALLTEST},
 	{"versioning",		test_versioning,	0},
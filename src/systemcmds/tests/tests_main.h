@@ -70,6 +70,7 @@ extern int test_ppm(int argc, char *argv[]);
 extern int test_rc(int argc, char *argv[]);
 extern int test_search_min(int argc, char *argv[]);
 extern int test_sleep(int argc, char *argv[]);
+extern int test_SpscQueue(int argc, char *argv[]);
 extern int test_time(int argc, char *argv[]);
 extern int test_uart_baudchange(int argc, char *argv[]);
 extern int test_uart_break(int argc, char *argv[]);
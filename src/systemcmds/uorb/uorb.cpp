@@ -31,6 +31,7 @@
  *
  ****************************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <uORB/uORB.h>
@@ -59,6 +60,19 @@ int uorb_main(int argc, char *argv[])
 		return uorb_top(argv + 2, argc - 2);
 	}
 
+#if defined(__PX4_LINUX)
+
+	if (!strcmp(argv[1], "shm") && argc >= 3) {
+		if (!strcmp(argv[2], "start")) {
+			return uorb_shm_start(argc >= 4 ? strtoul(argv[3], nullptr, 10) : 0);
+
+		} else if (!strcmp(argv[2], "status")) {
+			return uorb_shm_status();
+		}
+	}
+
+#endif
+
 	usage();
 	return 0;
 }
@@ -84,6 +98,10 @@ modules are allowed to publish which topics. This is used for system-wide replay
 ### Examples
 Monitor topic publication rates. Besides `top`, this is an important command for general system inspection:
 $ uorb top
+
+On Linux, topics can be shared with other processes on the same host (see platforms/common/uORB/shm_client).
+Topics are shared on their first publication, earlier ones when sharing is started:
+$ uorb shm start 0
 )DESCR_STR");
 
 	PRINT_MODULE_USAGE_NAME("uorb", "communication");
@@ -92,4 +110,6 @@ $ uorb top
 	PRINT_MODULE_USAGE_PARAM_FLAG('a', "print all instead of only currently publishing topics with subscribers", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('1', "run only once, then exit", true);
 	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match (implies -a)", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("shm", "Share topics with other processes in shared memory (Linux)");
+	PRINT_MODULE_USAGE_ARG("start [<instance>]|status", "Start for a PX4 instance (default 0), or print status", false);
 }